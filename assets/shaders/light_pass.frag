@@ -3,6 +3,11 @@
 
 const float PI = 3.14159265359;
 
+// must match graphics/light_clusters.h
+#define CLUSTER_COUNT_X 16u
+#define CLUSTER_COUNT_Y 9u
+#define CLUSTER_COUNT_Z 24u
+
 struct PointLight
 {
     float pos[3];
@@ -27,6 +32,16 @@ layout(binding = 2, std430) readonly buffer camera
     float camera_position[3];
 };
 
+// written by light_cull.comp, offset and count into light_indices for each cluster
+layout(binding = 4, std430) readonly buffer light_grid
+{
+    uvec2 clusters[];
+};
+
+layout(binding = 5, std430) readonly buffer light_index_list
+{
+    uint light_indices[];
+};
 
 layout(bindless_sampler, location = 0) uniform sampler2D albedo_texture;
 layout(bindless_sampler, location = 1) uniform sampler2D normal_texture;
@@ -40,6 +55,25 @@ layout(location = 0) in vec2 uv;
 
 layout(location = 0) out vec4 out_color;
 
+uint cluster_index(vec3 world_pos)
+{
+    vec4 view_pos = view * vec4(world_pos, 1.0);
+    vec4 clip = projection * view_pos;
+
+    vec2 ndc = clip.w > 0.0 ? clamp(clip.xy / clip.w, -1.0, 1.0) : vec2(0.0);
+    uvec2 tile = min(uvec2((ndc * 0.5 + 0.5) * vec2(CLUSTER_COUNT_X, CLUSTER_COUNT_Y)), uvec2(CLUSTER_COUNT_X - 1u, CLUSTER_COUNT_Y - 1u));
+
+    float near_plane = projection[3][2] / (projection[2][2] - 1.0);
+    float far_plane = projection[3][2] / (projection[2][2] + 1.0);
+    float depth = -view_pos.z;
+
+    uint slice = depth <= near_plane
+        ? 0u
+        : min(uint(log(depth / near_plane) * float(CLUSTER_COUNT_Z) / log(far_plane / near_plane)), CLUSTER_COUNT_Z - 1u);
+
+    return tile.x + (tile.y * CLUSTER_COUNT_X) + (slice * CLUSTER_COUNT_X * CLUSTER_COUNT_Y);
+}
+
 vec3 fresnelSchlick(float cosTheta, vec3 F0)
 {
     return F0 + (1.0 - F0) * pow(clamp(1.0 - cosTheta, 0.0, 1.0), 5.0);
@@ -142,10 +176,12 @@ void main()
     vec3 F0 = vec3(0.04);
     F0 = mix(F0, albedo, metallic);
 
+    uvec2 cluster = clusters[cluster_index(frag_pos)];
+
     vec3 Lo = vec3(0.0);
-    for(uint i = 0; i < num_point_lights; i++)
+    for(uint i = 0; i < cluster.y; i++)
     {
-        Lo += calculate_point_light(point_lights[i], view_pos, view_dir, normal, frag_pos, albedo, F0, metallic, roughness, ao);
+        Lo += calculate_point_light(point_lights[light_indices[cluster.x + i]], view_pos, view_dir, normal, frag_pos, albedo, F0, metallic, roughness, ao);
     }
 
     vec3 ambient = ambient_color * albedo * ao;
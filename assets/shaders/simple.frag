@@ -1,13 +1,12 @@
 #version 460 core
 #extension GL_ARB_bindless_texture : require
 
-struct VertexData
+struct CompactVertex
 {
     float position[3];
-    float normal[3];
-    float tangent[3];
-    float bitangent[3];
-    float uv[2];
+    uint normal;
+    uint tangent;
+    uint uv;
 };
 
 struct ObjectData
@@ -25,7 +24,7 @@ struct MaterialData
 };
 
 layout(binding = 0, std430) readonly buffer vertices {
-    VertexData data[];
+    CompactVertex data[];
 };
 
 layout(binding = 1, std430) readonly buffer camera {
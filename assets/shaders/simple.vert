@@ -1,12 +1,11 @@
 #version 460 core
 
-struct VertexData
+struct CompactVertex
 {
     float position[3];
-    float normal[3];
-    float tangent[3];
-    float bitangent[3];
-    float uv[2];
+    uint normal;
+    uint tangent;
+    uint uv;
 };
 
 struct ObjectData
@@ -25,7 +24,7 @@ struct MaterialData
 
 layout(binding = 0, std430) readonly buffer vertices
 {
-    VertexData data[];
+    CompactVertex data[];
 };
 
 layout(binding = 1, std430) readonly buffer camera
@@ -62,34 +61,35 @@ vec3 get_position(uint index)
         data[index].position[2]
     );
 }
+vec3 octahedral_decode(vec2 f)
+{
+    vec3 n = vec3(f, 1.0 - abs(f.x) - abs(f.y));
+    float fold = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -fold : fold;
+    n.y += n.y >= 0.0 ? -fold : fold;
+    return normalize(n);
+}
 vec3 get_normal(uint index)
 {
-    return vec3(
-        data[index].normal[0],
-        data[index].normal[1],
-        data[index].normal[2]
-    );
+    return octahedral_decode(unpackSnorm2x16(data[index].normal));
 }
 vec3 get_tangent(uint index)
 {
-    return vec3(
-        data[index].tangent[0],
-        data[index].tangent[1],
-        data[index].tangent[2]
-    );
+    // x is a snorm16 in the low half, y a snorm15 above it, the top bit is the bitangent sign
+    int packed_tangent = int(data[index].tangent);
+    return octahedral_decode(vec2(
+        max(float(bitfieldExtract(packed_tangent, 0, 16)) / 32767.0, -1.0),
+        max(float(bitfieldExtract(packed_tangent, 16, 15)) / 16383.0, -1.0)
+    ));
 }
 vec3 get_bitangent(uint index)
 {
-    return vec3(
-        data[index].bitangent[0],
-        data[index].bitangent[1],
-        data[index].bitangent[2]
-    );
+    float bitangent_sign = (data[index].tangent >> 31u) != 0u ? -1.0 : 1.0;
+    return bitangent_sign * cross(get_normal(index), get_tangent(index));
 }
 vec2 get_uv(uint index)
 {
-    return vec2(data[index].uv[0],
-                data[index].uv[1]);
+    return unpackHalf2x16(data[index].uv);
 }
 
 layout (location = 0) out flat uint material_index;
@@ -1,17 +1,16 @@
 #version 460 core
 
-struct VertexData
+struct CompactVertex
 {
     float position[3];
-    float normal[3];
-    float tangent[3];
-    float bitangent[3];
-    float uv[2];
+    uint normal;
+    uint tangent;
+    uint uv;
 };
 
 layout(binding = 0, std430) readonly buffer vertices
 {
-    VertexData data[];
+    CompactVertex data[];
 };
 
 vec3 get_position(uint index)
@@ -24,8 +23,7 @@ vec3 get_position(uint index)
 }
 vec2 get_uv(uint index)
 {
-    return vec2(data[index].uv[0],
-                data[index].uv[1]);
+    return unpackHalf2x16(data[index].uv);
 }
 
 layout (location = 0) out vec2 uv;
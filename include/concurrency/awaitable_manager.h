@@ -82,6 +82,12 @@ namespace ufps
             return Awaitable{*this, wait_time};
         }
 
+        // resumes h on the pool at the next pump, lets work finishing on other threads hand its coroutine back
+        auto resume_next_tick(std::coroutine_handle<> h) -> void
+        {
+            _next_tick_queue.push(std::move(h));
+        }
+
         auto pump() -> void
         {
             auto to_process = _next_tick_queue.yield();
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+namespace ufps
+{
+    // bounded lock free multi producer multi consumer queue (Vyukov), every slot carries a sequence number that says
+    // whether it is ready to be written or read for a given lap of the ring
+    template <class T>
+        requires std::is_trivially_copyable_v<T>
+    class MpmcQueue
+    {
+    public:
+        explicit MpmcQueue(std::size_t capacity);
+
+        MpmcQueue(const MpmcQueue &) = delete;
+        auto operator=(const MpmcQueue &) -> MpmcQueue & = delete;
+
+        // false if the queue is full
+        auto try_push(T value) -> bool;
+
+        auto try_pop() -> std::optional<T>;
+
+        // only a hint when other threads are using the queue
+        auto empty() const -> bool;
+
+        auto capacity() const -> std::size_t;
+
+    private:
+        struct Slot
+        {
+            std::atomic<std::size_t> sequence;
+            T value;
+        };
+
+        std::size_t _mask;
+        std::unique_ptr<Slot[]> _slots;
+        alignas(64) std::atomic<std::size_t> _push_position;
+        alignas(64) std::atomic<std::size_t> _pop_position;
+    };
+
+    template <class T>
+        requires std::is_trivially_copyable_v<T>
+    MpmcQueue<T>::MpmcQueue(std::size_t capacity)
+        : _mask{std::bit_ceil(std::max(capacity, 2zu)) - 1zu},
+          _slots{std::make_unique<Slot[]>(_mask + 1zu)},
+          _push_position{0zu},
+          _pop_position{0zu}
+    {
+        for (auto i = 0zu; i <= _mask; ++i)
+        {
+            _slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    template <class T>
+        requires std::is_trivially_copyable_v<T>
+    auto MpmcQueue<T>::try_push(T value) -> bool
+    {
+        auto position = _push_position.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            auto &slot = _slots[position & _mask];
+            const auto sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+
+            if (diff == 0)
+            {
+                if (_push_position.compare_exchange_weak(position, position + 1zu, std::memory_order_relaxed))
+                {
+                    slot.value = value;
+                    slot.sequence.store(position + 1zu, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                // the slot from the previous lap has not been read yet
+                return false;
+            }
+            else
+            {
+                position = _push_position.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    template <class T>
+        requires std::is_trivially_copyable_v<T>
+    auto MpmcQueue<T>::try_pop() -> std::optional<T>
+    {
+        auto position = _pop_position.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            auto &slot = _slots[position & _mask];
+            const auto sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position + 1zu);
+
+            if (diff == 0)
+            {
+                if (_pop_position.compare_exchange_weak(position, position + 1zu, std::memory_order_relaxed))
+                {
+                    const auto value = slot.value;
+                    slot.sequence.store(position + _mask + 1zu, std::memory_order_release);
+                    return value;
+                }
+            }
+            else if (diff < 0)
+            {
+                // nothing has been written to the slot this lap
+                return std::nullopt;
+            }
+            else
+            {
+                position = _pop_position.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    template <class T>
+        requires std::is_trivially_copyable_v<T>
+    auto MpmcQueue<T>::empty() const -> bool
+    {
+        return _push_position.load(std::memory_order_relaxed) == _pop_position.load(std::memory_order_relaxed);
+    }
+
+    template <class T>
+        requires std::is_trivially_copyable_v<T>
+    auto MpmcQueue<T>::capacity() const -> std::size_t
+    {
+        return _mask + 1zu;
+    }
+}
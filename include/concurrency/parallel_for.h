@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <ranges>
+
+#include "concurrency/thread_pool.h"
+
+namespace ufps
+{
+    // calls func(first, last) for consecutive chunks of [first, last) of at most grain indices, blocks until every chunk
+    // has run
+    // the calling thread takes chunks as well so this is safe to call from inside a job on the same pool
+    template <class F>
+        requires std::invocable<F &, std::size_t, std::size_t>
+    auto parallel_for(ThreadPool &pool, std::size_t first, std::size_t last, std::size_t grain, F &&func) -> void;
+
+    // calls func(element) for every element of range, grain elements per chunk
+    template <std::ranges::random_access_range R, class F>
+        requires std::ranges::sized_range<R> && std::invocable<F &, std::ranges::range_reference_t<R>>
+    auto parallel_for(ThreadPool &pool, R &&range, std::size_t grain, F &&func) -> void;
+
+    namespace impl
+    {
+        // shared with the helper jobs, which may only get to run after parallel_for has returned, in which case they
+        // find no chunks left and never touch func
+        template <class F>
+        struct ParallelForState
+        {
+            F *func;
+            std::size_t first;
+            std::size_t last;
+            std::size_t grain;
+            std::size_t chunk_count;
+            std::atomic<std::size_t> next_chunk;
+            std::atomic<std::size_t> remaining_chunks;
+
+            auto run_chunks() -> void
+            {
+                for (auto chunk = next_chunk++; chunk < chunk_count; chunk = next_chunk++)
+                {
+                    const auto chunk_first = first + chunk * grain;
+                    (*func)(chunk_first, std::min(chunk_first + grain, last));
+
+                    if (--remaining_chunks == 0zu)
+                    {
+                        remaining_chunks.notify_all();
+                    }
+                }
+            }
+        };
+    }
+
+    template <class F>
+        requires std::invocable<F &, std::size_t, std::size_t>
+    auto parallel_for(ThreadPool &pool, std::size_t first, std::size_t last, std::size_t grain, F &&func) -> void
+    {
+        if (first >= last)
+        {
+            return;
+        }
+
+        grain = std::max(grain, 1zu);
+        const auto chunk_count = (last - first + grain - 1zu) / grain;
+
+        if (chunk_count == 1zu)
+        {
+            func(first, last);
+            return;
+        }
+
+        auto state = std::make_shared<impl::ParallelForState<std::remove_reference_t<F>>>(
+            std::addressof(func), first, last, grain, chunk_count, 0zu, chunk_count);
+
+        // one chunk is always left for this thread
+        const auto helper_count = std::min<std::size_t>(pool.worker_count(), chunk_count - 1zu);
+        for (auto i = 0zu; i < helper_count; ++i)
+        {
+            pool.add([state] { state->run_chunks(); });
+        }
+
+        state->run_chunks();
+
+        // every chunk has been claimed, wait for the helpers still running theirs
+        auto remaining = state->remaining_chunks.load();
+        while (remaining != 0zu)
+        {
+            state->remaining_chunks.wait(remaining);
+            remaining = state->remaining_chunks.load();
+        }
+    }
+
+    template <std::ranges::random_access_range R, class F>
+        requires std::ranges::sized_range<R> && std::invocable<F &, std::ranges::range_reference_t<R>>
+    auto parallel_for(ThreadPool &pool, R &&range, std::size_t grain, F &&func) -> void
+    {
+        const auto begin = std::ranges::begin(range);
+
+        parallel_for(
+            pool,
+            0zu,
+            std::ranges::size(range),
+            grain,
+            [&](const auto chunk_first, const auto chunk_last)
+            {
+                for (auto i = chunk_first; i < chunk_last; ++i)
+                {
+                    func(begin[static_cast<std::ranges::range_difference_t<R>>(i)]);
+                }
+            });
+    }
+}
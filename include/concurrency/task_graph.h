@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+#include "concurrency/thread_pool.h"
+
+namespace ufps
+{
+    // a set of jobs with dependencies that is run on a pool and waited on as a whole, independently of anything else on
+    // the pool
+    // tasks can only depend on tasks added before them so the graph is always acyclic, once built a graph can be run
+    // again (e.g. once per frame) after the previous run has finished
+    class TaskGraph
+    {
+    public:
+        using TaskId = std::uint32_t;
+
+        TaskGraph(ThreadPool &pool);
+        ~TaskGraph();
+
+        TaskGraph(const TaskGraph &) = delete;
+        auto operator=(const TaskGraph &) -> TaskGraph & = delete;
+
+        auto add(Job job, std::initializer_list<TaskId> dependencies = {}) -> TaskId;
+
+        // starts every task without dependencies, the rest start as their dependencies finish
+        auto run() -> void;
+
+        // blocks until every task of the current run has finished, must not be called from one of the graph's own tasks
+        auto wait() const -> void;
+
+        auto done() const -> bool;
+        auto task_count() const -> std::uint32_t;
+
+    private:
+        struct Task
+        {
+            Job job;
+            std::vector<TaskId> dependents;
+            std::uint32_t dependency_count;
+            std::atomic<std::uint32_t> pending_count;
+        };
+
+        auto schedule(TaskId id) -> void;
+        auto execute(TaskId id) -> void;
+
+        ThreadPool &_pool;
+        std::deque<Task> _tasks;
+
+        // shared with the tasks, the last one to finish notifies through it after which the graph may already be gone
+        std::shared_ptr<std::atomic<std::uint32_t>> _remaining_count;
+    };
+}
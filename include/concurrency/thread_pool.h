@@ -4,16 +4,19 @@
 #include <cstdint>
 #include <format>
 #include <functional>
+#include <memory>
 #include <vector>
 
-#include "concurrency/concurrent_queue.h"
-#include "concurrency/cond_var.h"
+#include "concurrency/mpmc_queue.h"
 #include "concurrency/thread.h"
+#include "concurrency/work_stealing_deque.h"
 
 namespace ufps
 {
     using Job = std::move_only_function<void()>;
 
+    // every worker owns a deque that jobs added from that worker go to, jobs added from any other thread go to a shared
+    // injection queue, idle workers steal from each other and spin for a while before parking
     class ThreadPool
     {
     public:
@@ -25,16 +28,21 @@ namespace ufps
 
         auto worker_count() -> std::uint32_t;
 
+        // blocks until every job added so far (and any they added) has finished
         auto drain() const -> void;
 
     private:
-        auto worker(std::stop_token stop_token) -> void;
+        auto worker(std::uint32_t index, std::stop_token stop_token) -> void;
+        auto find_job(std::uint32_t index) -> Job *;
+        auto run(Job *job) -> void;
+        auto wake() -> void;
 
         std::uint32_t _worker_count;
-        ConcurrentQueue<Job> _job_queue;
-        Lock<> _worker_lock;
-        CondVar _worker_cv;
+        MpmcQueue<Job *> _injection_queue;
+        std::vector<std::unique_ptr<WorkStealingDeque<Job *>>> _deques;
         std::atomic<std::uint32_t> _job_count;
+        std::atomic<std::uint32_t> _sleeping_count;
+        std::atomic<std::uint32_t> _wake_epoch;
         std::vector<Thread> _workers;
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace ufps
+{
+    // Chase-Lev deque (with the memory orderings from Le et al. "Correct and Efficient Work-Stealing for Weak Memory
+    // Models"), the owning thread pushes and pops at the bottom, any other thread steals from the top
+    // the buffer grows when full, old buffers are kept alive until the deque is destroyed as a thief may still be reading
+    template <class T>
+        requires std::is_trivially_copyable_v<T>
+    class WorkStealingDeque
+    {
+    public:
+        explicit WorkStealingDeque(std::size_t capacity = 256zu);
+
+        WorkStealingDeque(const WorkStealingDeque &) = delete;
+        auto operator=(const WorkStealingDeque &) -> WorkStealingDeque & = delete;
+
+        // owner only
+        auto push(T value) -> void;
+
+        // owner only
+        auto pop() -> std::optional<T>;
+
+        // any thread, may fail spuriously if it races with another steal or the last pop
+        auto steal() -> std::optional<T>;
+
+        // only a hint when other threads are using the deque
+        auto size() const -> std::size_t;
+        auto empty() const -> bool;
+
+    private:
+        class Buffer
+        {
+        public:
+            explicit Buffer(std::size_t capacity)
+                : _mask{capacity - 1zu},
+                  _elements{std::make_unique<std::atomic<T>[]>(capacity)}
+            {
+            }
+
+            auto capacity() const -> std::size_t
+            {
+                return _mask + 1zu;
+            }
+
+            auto get(std::int64_t index) const -> T
+            {
+                return _elements[static_cast<std::size_t>(index) & _mask].load(std::memory_order_relaxed);
+            }
+
+            auto put(std::int64_t index, T value) -> void
+            {
+                _elements[static_cast<std::size_t>(index) & _mask].store(value, std::memory_order_relaxed);
+            }
+
+        private:
+            std::size_t _mask;
+            std::unique_ptr<std::atomic<T>[]> _elements;
+        };
+
+        auto grow(Buffer *buffer, std::int64_t bottom, std::int64_t top) -> Buffer *;
+
+        // top and bottom are on separate cache lines as thieves hammer one and the owner the other
+        alignas(64) std::atomic<std::int64_t> _top;
+        alignas(64) std::atomic<std::int64_t> _bottom;
+        alignas(64) std::atomic<Buffer *> _buffer;
+        std::vector<std::unique_ptr<Buffer>> _buffers;
+    };
+
+    template <class T>
+        requires std::is_trivially_copyable_v<T>
+    WorkStealingDeque<T>::WorkStealingDeque(std::size_t capacity)
+        : _top{0},
+          _bottom{0},
+          _buffer{},
+          _buffers{}
+    {
+        _buffers.push_back(std::make_unique<Buffer>(std::bit_ceil(std::max(capacity, 2zu))));
+        _buffer.store(_buffers.back().get(), std::memory_order_relaxed);
+    }
+
+    template <class T>
+        requires std::is_trivially_copyable_v<T>
+    auto WorkStealingDeque<T>::push(T value) -> void
+    {
+        const auto bottom = _bottom.load(std::memory_order_relaxed);
+        const auto top = _top.load(std::memory_order_acquire);
+        auto *buffer = _buffer.load(std::memory_order_relaxed);
+
+        if (bottom - top > static_cast<std::int64_t>(buffer->capacity()) - 1)
+        {
+            buffer = grow(buffer, bottom, top);
+        }
+
+        buffer->put(bottom, value);
+        _bottom.store(bottom + 1, std::memory_order_release);
+    }
+
+    template <class T>
+        requires std::is_trivially_copyable_v<T>
+    auto WorkStealingDeque<T>::pop() -> std::optional<T>
+    {
+        const auto bottom = _bottom.load(std::memory_order_relaxed) - 1;
+        auto *buffer = _buffer.load(std::memory_order_relaxed);
+        _bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto top = _top.load(std::memory_order_relaxed);
+
+        if (top > bottom)
+        {
+            // empty
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+
+        auto value = std::make_optional(buffer->get(bottom));
+
+        if (top == bottom)
+        {
+            // last element, race thieves for it
+            if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                value.reset();
+            }
+
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+
+        return value;
+    }
+
+    template <class T>
+        requires std::is_trivially_copyable_v<T>
+    auto WorkStealingDeque<T>::steal() -> std::optional<T>
+    {
+        auto top = _top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const auto bottom = _bottom.load(std::memory_order_acquire);
+
+        if (top >= bottom)
+        {
+            return std::nullopt;
+        }
+
+        const auto *buffer = _buffer.load(std::memory_order_acquire);
+        const auto value = buffer->get(top);
+
+        if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            return std::nullopt;
+        }
+
+        return value;
+    }
+
+    template <class T>
+        requires std::is_trivially_copyable_v<T>
+    auto WorkStealingDeque<T>::size() const -> std::size_t
+    {
+        const auto bottom = _bottom.load(std::memory_order_relaxed);
+        const auto top = _top.load(std::memory_order_relaxed);
+        return bottom > top ? static_cast<std::size_t>(bottom - top) : 0zu;
+    }
+
+    template <class T>
+        requires std::is_trivially_copyable_v<T>
+    auto WorkStealingDeque<T>::empty() const -> bool
+    {
+        return size() == 0zu;
+    }
+
+    template <class T>
+        requires std::is_trivially_copyable_v<T>
+    auto WorkStealingDeque<T>::grow(Buffer *buffer, std::int64_t bottom, std::int64_t top) -> Buffer *
+    {
+        auto grown = std::make_unique<Buffer>(buffer->capacity() * 2zu);
+        for (auto i = top; i < bottom; ++i)
+        {
+            grown->put(i, buffer->get(i));
+        }
+
+        auto *new_buffer = grown.get();
+        _buffers.push_back(std::move(grown));
+        _buffer.store(new_buffer, std::memory_order_release);
+
+        return new_buffer;
+    }
+}
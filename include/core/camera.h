@@ -3,6 +3,7 @@
 #include <array>
 #include <span>
 
+#include "math/frustum.h"
 #include "math/matrix4.h"
 #include "math/vector3.h"
 #include "utils/data_buffer.h"
@@ -55,6 +56,7 @@ namespace ufps
         constexpr auto far_plane() const -> float;
 
         constexpr auto frustum_corners() const -> std::array<Vector3, 8u>;
+        constexpr auto frustum() const -> Frustum;
 
         // auto invert_pitch(bool invert) -> void;
         // auto invert_yaw(bool invert) -> void;
@@ -269,6 +271,11 @@ namespace ufps
         return corners;
     }
 
+    constexpr auto Camera::frustum() const -> Frustum
+    {
+        return Frustum::from_corners(frustum_corners());
+    }
+
     constexpr auto Camera::clamp_pitch() -> void
     {
         constexpr auto pitch_eps = 0.0001f;
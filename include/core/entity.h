@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <span>
 #include <string>
 #include <vector>
@@ -33,12 +34,16 @@ namespace ufps
         constexpr auto emissive_strength() const -> float;
         constexpr auto set_emissive_strength(float strength) -> void;
 
+        // bumped whenever state that ends up on the gpu changes, lets consumers skip unchanged entities
+        constexpr auto version() const -> std::uint32_t;
+
     private:
         std::string _name;
         std::vector<RenderEntity> _render_entities;
         Transform _transform;
         AABB _aabb;
         float _emissive_strength;
+        std::uint32_t _version;
     };
 
     constexpr Entity::Entity(std::string name, std::vector<RenderEntity> render_entities, Transform transform)
@@ -46,7 +51,8 @@ namespace ufps
           _render_entities{std::move(render_entities)},
           _transform{std::move(transform)},
           _aabb{create_aabb(_render_entities)},
-          _emissive_strength{1.f}
+          _emissive_strength{1.f},
+          _version{}
     {
     }
 
@@ -68,6 +74,7 @@ namespace ufps
     constexpr auto Entity::set_transform(const Transform &transform) -> void
     {
         _transform = transform;
+        ++_version;
     }
 
     constexpr auto Entity::aabb() const -> const AABB &
@@ -92,5 +99,11 @@ namespace ufps
     constexpr auto Entity::set_emissive_strength(float strength) -> void
     {
         _emissive_strength = strength;
+        ++_version;
+    }
+
+    constexpr auto Entity::version() const -> std::uint32_t
+    {
+        return _version;
     }
 }
\ No newline at end of file
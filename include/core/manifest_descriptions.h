@@ -28,10 +28,9 @@ namespace ufps
         StringUnorderedMap<std::vector<ModelManifest>> models;
     };
 
+    // the texture data itself is the pack chunk of the same name
     struct TextureManifest
     {
-        std::uint32_t offset;
-        std::uint32_t size;
         bool is_srgb;
     };
 
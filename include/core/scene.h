@@ -6,6 +6,7 @@
 
 #include "core/camera.h"
 #include "core/entity.h"
+#include "core/scene_bvh.h"
 #include "core/sparse_set.h"
 #include "graphics/color.h"
 #include "graphics/mesh_manager.h"
@@ -19,6 +20,7 @@ namespace ufps
 {
     using PointLightHandle = SparseSet<PointLight>::handle_type;
 
+    // position and distance are in world space
     struct IntersectionResult
     {
         Entity *entity;
@@ -92,6 +94,16 @@ namespace ufps
         float threshold = 1.f;
     };
 
+    struct CullingOptions
+    {
+        bool gpu_driven = false;
+        // only takes effect when gpu_driven is set
+        bool occlusion_culling = false;
+        // draws each meshlet that survives frustum and backface culling on its own, only takes effect when gpu_driven is
+        // set
+        bool cluster_culling = false;
+    };
+
     class Scene
     {
     public:
@@ -105,6 +117,7 @@ namespace ufps
             VignetteOptions vignette_options;
             FilmGrainOptions film_grain_options;
             BloomOptions bloom_options;
+            CullingOptions culling_options;
             LightData lights;
             std::vector<Entity::Description> entities;
         };
@@ -121,6 +134,7 @@ namespace ufps
                         VignetteOptions vignette_options,
                         FilmGrainOptions film_grain_options,
                         BloomOptions bloom_options,
+                        CullingOptions culling_options,
                         const StringUnorderedMap<Entity> &entity_cache);
 
         constexpr Scene(MeshManager &mesh_manager,
@@ -151,9 +165,13 @@ namespace ufps
         constexpr auto &vignette_options(this auto &&self);
         constexpr auto &film_grain_options(this auto &&self);
         constexpr auto &bloom_options(this auto &&self);
+        constexpr auto &culling_options(this auto &&self);
 
         constexpr auto description(this auto &&self) -> Description;
 
+        // bumped whenever entities are added or removed, entity indices are only stable between changes
+        constexpr auto revision() const -> std::uint32_t;
+
         constexpr auto remove(const Entity &entity) -> void;
         constexpr auto remove(PointLightHandle light) -> void;
 
@@ -172,53 +190,20 @@ namespace ufps
         VignetteOptions _vignette_options;
         FilmGrainOptions _film_grain_options;
         BloomOptions _bloom_options;
+        CullingOptions _culling_options;
+        std::uint32_t _revision;
+        SceneBvh _bvh;
     };
 
     constexpr auto Scene::intersect_ray(const Ray &ray) -> std::optional<IntersectionResult>
     {
-        auto result = std::optional<IntersectionResult>{};
-        auto min_distance = std::numeric_limits<float>::max();
+        _bvh.update(_entities, _revision, _mesh_manager);
 
-        for (auto &entity : _entities)
-        {
-            const auto inv_transform = Matrix4::invert(entity.transform());
-            const auto transformed_ray =
-                Ray{inv_transform * Vector4{ray.origin, 1.0f}, inv_transform * Vector4{ray.direction, 0.0f}};
-
-            if (!!intersect(transformed_ray, entity.aabb()))
+        return _bvh.intersect_ray(ray).transform(
+            [this](const auto &hit)
             {
-                for (auto &render_entity : entity.render_entities())
-                {
-                    if (!intersect(transformed_ray, render_entity.aabb()))
-                    {
-                        continue;
-                    }
-
-                    const auto mesh_view = render_entity.mesh_view();
-                    const auto index_data = _mesh_manager.index_data(mesh_view);
-                    const auto vertex_data = _mesh_manager.vertex_data(mesh_view);
-
-                    for (const auto &indices : std::views::chunk(index_data, 3))
-                    {
-                        const auto v0 = vertex_data[indices[0]].position;
-                        const auto v1 = vertex_data[indices[1]].position;
-                        const auto v2 = vertex_data[indices[2]].position;
-
-                        if (const auto distance = intersect(transformed_ray, v0, v1, v2); distance)
-                        {
-                            const auto intersection_point = transformed_ray.origin + transformed_ray.direction * (*distance);
-
-                            if (*distance < min_distance)
-                            {
-                                result = IntersectionResult{.entity = &entity, .position = intersection_point, .distance = *distance};
-                                min_distance = *distance;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        return result;
+                return IntersectionResult{.entity = &_entities[hit.entity_index], .position = hit.position, .distance = hit.distance};
+            });
     }
 
     constexpr Scene::Scene(MeshManager &mesh_manager, TextureManager &texture_manager, Camera camera, LightData lights,
@@ -226,6 +211,7 @@ namespace ufps
                            FogOptions fog_options, ChromaticAbberationOptions chromatic_abberation_options,
                            VignetteOptions vignette_options, FilmGrainOptions film_grain_options,
                            BloomOptions bloom_options,
+                           CullingOptions culling_options,
                            const StringUnorderedMap<Entity> &entity_cache)
         : _entities{},
           _entity_cache{},
@@ -240,7 +226,10 @@ namespace ufps
           _chromatic_abberation_options{std::move(chromatic_abberation_options)},
           _vignette_options{std::move(vignette_options)},
           _film_grain_options{std::move(film_grain_options)},
-          _bloom_options{std::move(bloom_options)}
+          _bloom_options{std::move(bloom_options)},
+          _culling_options{std::move(culling_options)},
+          _revision{},
+          _bvh{}
     {
         for (const auto &[name, entity] : entity_cache)
         {
@@ -262,7 +251,11 @@ namespace ufps
           _fog_options{description.fog_options},
           _chromatic_abberation_options{description.chromatic_abberation_options},
           _vignette_options{description.vignette_options},
-          _film_grain_options{description.film_grain_options}
+          _film_grain_options{description.film_grain_options},
+          _bloom_options{description.bloom_options},
+          _culling_options{description.culling_options},
+          _revision{},
+          _bvh{}
     {
         for (const auto &[name, entity] : entity_cache)
         {
@@ -288,6 +281,7 @@ namespace ufps
 
         auto &new_entity = _entities.emplace_back(*cached);
         new_entity.set_transform({});
+        ++_revision;
 
         return &new_entity;
     }
@@ -367,6 +361,11 @@ namespace ufps
         return self._bloom_options;
     }
 
+    constexpr auto &Scene::culling_options(this auto &&self)
+    {
+        return self._culling_options;
+    }
+
     constexpr auto Scene::description(this auto &&self) -> Description
     {
         return Description{
@@ -378,6 +377,7 @@ namespace ufps
             .vignette_options = self._vignette_options,
             .film_grain_options = self._film_grain_options,
             .bloom_options = self._bloom_options,
+            .culling_options = self._culling_options,
             .lights = self._lights,
             .entities = self._entities | std::views::transform([](const auto &e)
                                                                { return e.description(); }) |
@@ -391,6 +391,12 @@ namespace ufps
         expect(iter != std::ranges::cend(_entities), "Entity not found");
 
         _entities.erase(iter);
+        ++_revision;
+    }
+
+    constexpr auto Scene::revision() const -> std::uint32_t
+    {
+        return _revision;
     }
 
     constexpr auto Scene::remove(PointLightHandle light) -> void
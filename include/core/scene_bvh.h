@@ -0,0 +1,223 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <optional>
+#include <ranges>
+#include <vector>
+
+#include "graphics/mesh_view.h"
+#include "math/aabb.h"
+#include "math/bvh.h"
+#include "math/matrix4.h"
+#include "math/ray.h"
+#include "math/utils.h"
+#include "math/vector3.h"
+#include "math/vector4.h"
+
+namespace ufps
+{
+    // world space hit, entity_index is into the range last passed to SceneBvh::update
+    struct RayHit
+    {
+        std::uint32_t entity_index;
+        Vector3 position;
+        float distance;
+    };
+
+    // two level bvh for ray queries, a blas per mesh view that is built the first time the mesh is seen and a tlas over every
+    // render entity that is refit when entity versions change and rebuilt when the scene revision changes
+    class SceneBvh
+    {
+    public:
+        constexpr SceneBvh();
+
+        template <class R, class M>
+        constexpr auto update(R &&entities, std::uint32_t revision, const M &mesh_manager) -> void;
+
+        constexpr auto intersect_ray(const Ray &ray) const -> std::optional<RayHit>;
+
+        constexpr auto blas_count() const -> std::size_t;
+        constexpr auto instance_count() const -> std::size_t;
+
+    private:
+        struct Instance
+        {
+            std::uint32_t entity_index;
+            std::uint32_t blas_index;
+        };
+
+        struct EntityState
+        {
+            std::uint32_t version;
+            Matrix4 inverse_model;
+            std::uint32_t first_instance;
+            std::uint32_t instance_count;
+        };
+
+        template <class M>
+        constexpr auto blas_index(MeshView mesh_view, const M &mesh_manager) -> std::uint32_t;
+
+        std::vector<Blas> _blas;
+        std::map<MeshView, std::uint32_t> _blas_lookup;
+        std::vector<Instance> _instances;
+        std::vector<AABB> _instance_bounds;
+        std::vector<EntityState> _entities;
+        Bvh _tlas;
+        std::optional<std::uint32_t> _revision;
+    };
+
+    constexpr SceneBvh::SceneBvh()
+        : _blas{},
+          _blas_lookup{},
+          _instances{},
+          _instance_bounds{},
+          _entities{},
+          _tlas{},
+          _revision{}
+    {
+    }
+
+    template <class R, class M>
+    constexpr auto SceneBvh::update(R &&entities, std::uint32_t revision, const M &mesh_manager) -> void
+    {
+        if (_revision != revision || _entities.size() != std::ranges::size(entities))
+        {
+            _instances.clear();
+            _instance_bounds.clear();
+            _entities.clear();
+
+            for (const auto &[entity_index, entity] : std::views::enumerate(entities))
+            {
+                const auto model = Matrix4{entity.transform()};
+
+                _entities.push_back({
+                    .version = entity.version(),
+                    .inverse_model = Matrix4::invert(model),
+                    .first_instance = static_cast<std::uint32_t>(_instances.size()),
+                    .instance_count = static_cast<std::uint32_t>(std::ranges::size(entity.render_entities())),
+                });
+
+                for (const auto &render_entity : entity.render_entities())
+                {
+                    const auto blas = blas_index(render_entity.mesh_view(), mesh_manager);
+                    _instances.push_back({.entity_index = static_cast<std::uint32_t>(entity_index), .blas_index = blas});
+                    _instance_bounds.push_back(transform(_blas[blas].aabb(), model));
+                }
+            }
+
+            _tlas = Bvh{_instance_bounds};
+            _revision = revision;
+
+            return;
+        }
+
+        auto moved = false;
+
+        for (const auto &[entity_index, entity] : std::views::enumerate(entities))
+        {
+            auto &state = _entities[entity_index];
+            if (state.version == entity.version())
+            {
+                continue;
+            }
+
+            const auto model = Matrix4{entity.transform()};
+            state.version = entity.version();
+            state.inverse_model = Matrix4::invert(model);
+
+            for (auto i = state.first_instance; i < state.first_instance + state.instance_count; ++i)
+            {
+                _instance_bounds[i] = transform(_blas[_instances[i].blas_index].aabb(), model);
+            }
+
+            moved = true;
+        }
+
+        if (moved)
+        {
+            _tlas.refit(_instance_bounds);
+        }
+    }
+
+    constexpr auto SceneBvh::intersect_ray(const Ray &ray) const -> std::optional<RayHit>
+    {
+        auto entity_index = 0u;
+
+        const auto distance = _tlas.intersect(
+            ray,
+            std::numeric_limits<float>::infinity(),
+            [&](const auto index, const auto max_distance) -> std::optional<float>
+            {
+                const auto &instance = _instances[index];
+                const auto &inverse_model = _entities[instance.entity_index].inverse_model;
+
+                const auto direction = Vector3{inverse_model * Vector4{ray.direction, 0.f}};
+
+                // distances along the object space ray are scaled by the transform, convert to and from world space
+                const auto scale = direction.length();
+                if (scale == 0.f)
+                {
+                    return std::nullopt;
+                }
+
+                const auto object_ray = Ray{inverse_model * Vector4{ray.origin, 1.f}, direction};
+                const auto hit = _blas[instance.blas_index].intersect(object_ray, max_distance * scale);
+                if (!hit || *hit / scale >= max_distance)
+                {
+                    return std::nullopt;
+                }
+
+                entity_index = instance.entity_index;
+                return *hit / scale;
+            });
+
+        if (!distance)
+        {
+            return std::nullopt;
+        }
+
+        return RayHit{.entity_index = entity_index, .position = ray.origin + ray.direction * (*distance), .distance = *distance};
+    }
+
+    constexpr auto SceneBvh::blas_count() const -> std::size_t
+    {
+        return _blas.size();
+    }
+
+    constexpr auto SceneBvh::instance_count() const -> std::size_t
+    {
+        return _instances.size();
+    }
+
+    template <class M>
+    constexpr auto SceneBvh::blas_index(MeshView mesh_view, const M &mesh_manager) -> std::uint32_t
+    {
+        if (const auto existing = _blas_lookup.find(mesh_view); existing != std::ranges::cend(_blas_lookup))
+        {
+            return existing->second;
+        }
+
+        const auto vertex_data = mesh_manager.vertex_data(mesh_view);
+
+        auto triangles = mesh_manager.index_data(mesh_view) |
+                         std::views::chunk(3) |
+                         std::views::transform(
+                             [&vertex_data](const auto &indices)
+                             {
+                                 return Triangle{
+                                     .v0 = vertex_data[indices[0]].position,
+                                     .v1 = vertex_data[indices[1]].position,
+                                     .v2 = vertex_data[indices[2]].position};
+                             }) |
+                         std::ranges::to<std::vector>();
+
+        const auto index = static_cast<std::uint32_t>(_blas.size());
+        _blas.emplace_back(std::move(triangles));
+        _blas_lookup.emplace(mesh_view, index);
+
+        return index;
+    }
+}
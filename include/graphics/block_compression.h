@@ -0,0 +1,27 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "concurrency/thread_pool.h"
+#include "graphics/texture_data.h"
+
+namespace ufps
+{
+    // every BC format this encodes stores a 4x4 block of texels in 16 bytes
+    using CompressedBlock = std::array<std::byte, 16zu>;
+
+    // pixels are the 16 rgba texels of a block in row order
+    // always uses mode 6 (one subset, 7 bit endpoints with a p-bit each and 4 bit indices), which handles colour and
+    // alpha together and is good enough for everything but the sharpest multi colour blocks
+    auto encode_bc7_block(std::span<const std::uint8_t, 64zu> pixels) -> CompressedBlock;
+
+    // pixels are the 16 rgba texels of a block in row order, only red and green are encoded
+    auto encode_bc5_block(std::span<const std::uint8_t, 64zu> pixels) -> CompressedBlock;
+
+    // encodes every mip of an 8 bit RGBA or SRGBA texture to format (BC7, BC7_SRGB or BC5U), blocks are spread over
+    // the pool and the calling thread
+    auto block_compress(const TextureData &texture, TextureFormat format, ThreadPool &pool) -> TextureData;
+}
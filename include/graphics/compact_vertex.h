@@ -0,0 +1,130 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <stdfloat>
+
+#include "graphics/vertex_data.h"
+#include "math/vector3.h"
+
+namespace ufps
+{
+    // the vertex layout the gpu reads, 24 bytes rather than the 56 of VertexData
+    //
+    //   position  kept at full precision, quantizing it would need per mesh bounds in every shader that reads vertices
+    //   normal    octahedral, two snorm16 with x in the low half (unpackSnorm2x16)
+    //   tangent   octahedral, x as snorm16 in the low half, y as snorm15 above it and the top bit set when the bitangent
+    //             is -cross(normal, tangent)
+    //   uv        two halves with u in the low half (unpackHalf2x16), so tiling uvs outside [0, 1] still work
+    //
+    // must match CompactVertex in the vertex shaders
+    struct CompactVertex
+    {
+        Vector3 position;
+        std::uint32_t normal;
+        std::uint32_t tangent;
+        std::uint32_t uv;
+    };
+
+    static_assert(sizeof(CompactVertex) == 24zu);
+
+    namespace impl
+    {
+        // maps the unit sphere onto the [-1, 1] square, the lower hemisphere is folded over the diagonals
+        inline auto octahedral_encode(const Vector3 &v) -> std::array<float, 2zu>
+        {
+            const auto length = std::abs(v.x) + std::abs(v.y) + std::abs(v.z);
+            if (length == 0.0f)
+            {
+                return {0.0f, 0.0f};
+            }
+
+            const auto x = v.x / length;
+            const auto y = v.y / length;
+
+            if (v.z >= 0.0f)
+            {
+                return {x, y};
+            }
+
+            return {
+                (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f),
+                (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f),
+            };
+        }
+
+        inline auto octahedral_decode(float x, float y) -> Vector3
+        {
+            auto v = Vector3{x, y, 1.0f - std::abs(x) - std::abs(y)};
+
+            const auto fold = std::max(-v.z, 0.0f);
+            v.x += v.x >= 0.0f ? -fold : fold;
+            v.y += v.y >= 0.0f ? -fold : fold;
+
+            return Vector3::normalize(v);
+        }
+
+        // the low bits of a two's complement snorm, scaled so -1 and 1 are both exact
+        inline auto to_snorm(float value, std::uint32_t bits) -> std::uint32_t
+        {
+            const auto scale = static_cast<float>((1u << (bits - 1u)) - 1u);
+            const auto quantized = static_cast<std::int32_t>(std::round(std::clamp(value, -1.0f, 1.0f) * scale));
+
+            return static_cast<std::uint32_t>(quantized) & ((1u << bits) - 1u);
+        }
+
+        inline auto from_snorm(std::uint32_t value, std::uint32_t bits) -> float
+        {
+            const auto shift = 32u - bits;
+            const auto extended = static_cast<std::int32_t>(value << shift) >> shift;
+            const auto scale = static_cast<float>((1u << (bits - 1u)) - 1u);
+
+            return std::max(static_cast<float>(extended) / scale, -1.0f);
+        }
+
+        inline auto to_half(float value) -> std::uint32_t
+        {
+            return std::bit_cast<std::uint16_t>(static_cast<std::float16_t>(value));
+        }
+
+        inline auto from_half(std::uint32_t value) -> float
+        {
+            return static_cast<float>(std::bit_cast<std::float16_t>(static_cast<std::uint16_t>(value)));
+        }
+    }
+
+    inline auto encode_vertex(const VertexData &vertex) -> CompactVertex
+    {
+        const auto [normal_x, normal_y] = impl::octahedral_encode(vertex.normal);
+        const auto [tangent_x, tangent_y] = impl::octahedral_encode(vertex.tangent);
+
+        const auto flip_bitangent = Vector3::dot(Vector3::cross(vertex.normal, vertex.tangent), vertex.bitangent) < 0.0f;
+
+        return {
+            .position = vertex.position,
+            .normal = impl::to_snorm(normal_x, 16u) | (impl::to_snorm(normal_y, 16u) << 16u),
+            .tangent = impl::to_snorm(tangent_x, 16u) | (impl::to_snorm(tangent_y, 15u) << 16u) | (flip_bitangent ? 0x80000000u : 0u),
+            .uv = impl::to_half(vertex.uv.s) | (impl::to_half(vertex.uv.t) << 16u),
+        };
+    }
+
+    // the bitangent is rebuilt from the normal and tangent so is always unit length and orthogonal to them
+    inline auto decode_vertex(const CompactVertex &vertex) -> VertexData
+    {
+        const auto normal = impl::octahedral_decode(impl::from_snorm(vertex.normal, 16u), impl::from_snorm(vertex.normal >> 16u, 16u));
+        const auto tangent = impl::octahedral_decode(
+            impl::from_snorm(vertex.tangent, 16u), impl::from_snorm((vertex.tangent >> 16u) & 0x7fffu, 15u));
+        const auto bitangent_sign = (vertex.tangent & 0x80000000u) != 0u ? -1.0f : 1.0f;
+
+        return {
+            .position = vertex.position,
+            .normal = normal,
+            .tangent = tangent,
+            .bitangent = Vector3::cross(normal, tangent) * bitangent_sign,
+            .uv = {impl::from_half(vertex.uv), impl::from_half(vertex.uv >> 16u)},
+        };
+    }
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <format>
+#include <ranges>
+#include <string>
+#include <vector>
+
+#include "math/frustum.h"
+#include "math/matrix4.h"
+#include "math/utils.h"
+
+namespace ufps
+{
+    enum class EntityFilterMode
+    {
+        ALL,
+        OPAQUE,
+        TRANSPARENT
+    };
+
+    struct DrawItem
+    {
+        std::uint32_t entity_index;
+        std::uint32_t render_entity_index;
+    };
+
+    struct CullingStats
+    {
+        std::uint32_t visible_entities;
+        std::uint32_t culled_entities;
+        std::uint32_t visible_draws;
+        std::uint32_t culled_draws;
+    };
+
+    struct CullResult
+    {
+        std::vector<DrawItem> draws;
+        CullingStats stats;
+    };
+
+    template <class T>
+    constexpr auto matches_filter(const T &render_entity, EntityFilterMode filter_mode) -> bool
+    {
+        switch (filter_mode)
+        {
+            using enum EntityFilterMode;
+            case OPAQUE:
+                return render_entity.opacity() > 0.9999f;
+            case TRANSPARENT:
+                return render_entity.opacity() < 1.f;
+            case ALL:
+            default:
+                return true;
+        }
+    }
+
+    // tests each entity's bounds first and only descends into its render entities if that is (partially) visible
+    // draws are emitted in scene order so anything indexed by draw (e.g. ObjectData) can be built from the same list
+    template <std::ranges::input_range R>
+    constexpr auto cull(R &&entities, const Frustum &frustum, EntityFilterMode filter_mode) -> CullResult
+    {
+        auto result = CullResult{};
+        auto entity_index = 0u;
+
+        for (const auto &entity : entities)
+        {
+            const auto render_entities = entity.render_entities();
+            const auto candidates = static_cast<std::uint32_t>(
+                std::ranges::count_if(render_entities, [filter_mode](const auto &e) { return matches_filter(e, filter_mode); }));
+
+            if (candidates != 0u)
+            {
+                const auto model = Matrix4{entity.transform()};
+
+                if (!intersect(frustum, transform(entity.aabb(), model)))
+                {
+                    ++result.stats.culled_entities;
+                    result.stats.culled_draws += candidates;
+                }
+                else
+                {
+                    ++result.stats.visible_entities;
+
+                    for (const auto &[render_entity_index, render_entity] : render_entities | std::views::enumerate)
+                    {
+                        if (!matches_filter(render_entity, filter_mode))
+                        {
+                            continue;
+                        }
+
+                        if (intersect(frustum, transform(render_entity.aabb(), model)))
+                        {
+                            result.draws.push_back({entity_index, static_cast<std::uint32_t>(render_entity_index)});
+                            ++result.stats.visible_draws;
+                        }
+                        else
+                        {
+                            ++result.stats.culled_draws;
+                        }
+                    }
+                }
+            }
+
+            ++entity_index;
+        }
+
+        return result;
+    }
+
+    inline auto to_string(const CullingStats &obj) -> std::string
+    {
+        return std::format(
+            "entities: {} visible {} culled, draws: {} visible {} culled",
+            obj.visible_entities,
+            obj.culled_entities,
+            obj.visible_draws,
+            obj.culled_draws);
+    }
+}
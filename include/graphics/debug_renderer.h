@@ -39,7 +39,7 @@ namespace ufps
         std::optional<MouseButtonEvent> _click;
         std::variant<std::monostate, Entity *, PointLightHandle> _selected;
         std::vector<LineData> _debug_lines;
-        MultiBuffer<PersistentBuffer> _debug_line_buffer;
+        MultiBuffer<PersistentBuffer, 3zu, GpuFence> _debug_line_buffer;
         Program _debug_line_program;
         Program _debug_light_program;
 
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <chrono>
+
+#include "graphics/opengl.h"
+#include "utils/auto_release.h"
+
+namespace ufps
+{
+    // a glFenceSync that can be signalled and waited on again and again, e.g. once per frame
+    class GpuFence
+    {
+    public:
+        GpuFence();
+
+        // fences every command issued so far, replacing whatever was fenced before
+        auto signal() -> void;
+
+        // blocks until the gpu is done with the commands fenced by the last signal(), returns how long that took, which
+        // is nothing if they were already done or nothing was fenced
+        auto wait() -> std::chrono::nanoseconds;
+
+    private:
+        AutoRelease<::GLsync, nullptr> _sync;
+    };
+}
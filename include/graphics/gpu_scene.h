@@ -0,0 +1,45 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "core/scene.h"
+#include "graphics/buffer.h"
+#include "graphics/gpu_fence.h"
+#include "graphics/instance_table.h"
+#include "graphics/multi_buffer.h"
+#include "graphics/persistent_buffer.h"
+
+namespace ufps
+{
+    // persistent per render entity instance and object data, only slots that changed since the last update are uploaded
+    // object data is triple buffered so changed slots are copied into each frame region in turn as the frames advance
+    class GpuScene
+    {
+    public:
+        GpuScene();
+
+        // returns true if slots were reassigned, anything indexed by slot from previous frames is stale
+        auto update(const Scene &scene) -> bool;
+        auto advance() -> void;
+
+        // how long the last advance() waited for the gpu to finish with the next object data region
+        auto fence_wait() const -> std::chrono::nanoseconds;
+
+        auto instance_count() const -> std::uint32_t;
+
+        // meshlets across every instance, the most draws cluster culling can emit
+        auto meshlet_count() const -> std::uint32_t;
+        auto table() const -> const InstanceTable &;
+        auto instance_buffer() const -> const Buffer &;
+        auto object_data_buffer() const -> const MultiBuffer<PersistentBuffer, 3zu, GpuFence> &;
+
+    private:
+        InstanceTable _table;
+        FrameDirtySlots<3zu> _object_data_dirty;
+        Buffer _instance_buffer;
+        MultiBuffer<PersistentBuffer, 3zu, GpuFence> _object_data_buffer;
+        std::uint32_t _texture_revision;
+        std::uint32_t _meshlet_count;
+    };
+}
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <format>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "math/aabb.h"
+#include "math/matrix4.h"
+#include "math/vector4.h"
+#include "utils/ensure.h"
+
+namespace ufps
+{
+    // screen space bounds of a projected box, xy in [0, 1] uv space and the depth closest to the camera
+    struct ScreenBounds
+    {
+        float min_x;
+        float min_y;
+        float max_x;
+        float max_y;
+        float min_depth;
+    };
+
+    constexpr auto hiz_mip_count(std::uint32_t width, std::uint32_t height) -> std::uint32_t
+    {
+        return static_cast<std::uint32_t>(std::bit_width(std::max(width, height)));
+    }
+
+    constexpr auto hiz_mip_size(std::uint32_t size, std::uint32_t level) -> std::uint32_t
+    {
+        return std::max(size >> level, 1u);
+    }
+
+    // each texel is the max (i.e. furthest) depth of the texels it covers in the level above, odd sized levels fold the
+    // extra row/column into the last texel so nothing is ever skipped
+    constexpr auto downsample_depth(std::span<const float> depth, std::uint32_t width, std::uint32_t height) -> std::vector<float>
+    {
+        expect(depth.size() == width * height, "depth size {} does not match {}x{}", depth.size(), width, height);
+
+        const auto dst_width = hiz_mip_size(width, 1u);
+        const auto dst_height = hiz_mip_size(height, 1u);
+
+        auto result = std::vector<float>(dst_width * dst_height);
+
+        for (auto y = 0u; y < dst_height; ++y)
+        {
+            const auto src_y_begin = std::min(y * 2u, height - 1u);
+            const auto src_y_end = y == dst_height - 1u ? height : std::min(src_y_begin + 2u, height);
+
+            for (auto x = 0u; x < dst_width; ++x)
+            {
+                const auto src_x_begin = std::min(x * 2u, width - 1u);
+                const auto src_x_end = x == dst_width - 1u ? width : std::min(src_x_begin + 2u, width);
+
+                auto max_depth = 0.f;
+                for (auto src_y = src_y_begin; src_y < src_y_end; ++src_y)
+                {
+                    for (auto src_x = src_x_begin; src_x < src_x_end; ++src_x)
+                    {
+                        max_depth = std::max(max_depth, depth[src_y * width + src_x]);
+                    }
+                }
+
+                result[y * dst_width + x] = max_depth;
+            }
+        }
+
+        return result;
+    }
+
+    // cpu version of the pyramid built by shaders/hiz_build.comp
+    class HiZPyramid
+    {
+    public:
+        constexpr HiZPyramid(std::span<const float> depth, std::uint32_t width, std::uint32_t height);
+
+        constexpr auto mip_count() const -> std::uint32_t;
+        constexpr auto width(std::uint32_t level) const -> std::uint32_t;
+        constexpr auto height(std::uint32_t level) const -> std::uint32_t;
+        constexpr auto depth(std::uint32_t level, std::uint32_t x, std::uint32_t y) const -> float;
+
+    private:
+        std::uint32_t _width;
+        std::uint32_t _height;
+        std::vector<std::vector<float>> _levels;
+    };
+
+    // returns nullopt if the box crosses the near plane, in which case it has to be treated as visible
+    constexpr auto project_aabb(const AABB &aabb, const Matrix4 &view_projection) -> std::optional<ScreenBounds>
+    {
+        auto bounds = ScreenBounds{.min_x = 1.f, .min_y = 1.f, .max_x = 0.f, .max_y = 0.f, .min_depth = 1.f};
+
+        for (auto i = 0u; i < 8u; ++i)
+        {
+            const auto corner = Vector4{
+                (i & 1u) ? aabb.max.x : aabb.min.x,
+                (i & 2u) ? aabb.max.y : aabb.min.y,
+                (i & 4u) ? aabb.max.z : aabb.min.z,
+                1.f};
+
+            const auto clip = view_projection * corner;
+            if (clip.w <= 0.f)
+            {
+                return std::nullopt;
+            }
+
+            const auto x = (clip.x / clip.w) * .5f + .5f;
+            const auto y = (clip.y / clip.w) * .5f + .5f;
+            const auto depth = (clip.z / clip.w) * .5f + .5f;
+
+            bounds.min_x = std::min(bounds.min_x, x);
+            bounds.min_y = std::min(bounds.min_y, y);
+            bounds.max_x = std::max(bounds.max_x, x);
+            bounds.max_y = std::max(bounds.max_y, y);
+            bounds.min_depth = std::min(bounds.min_depth, depth);
+        }
+
+        bounds.min_x = std::clamp(bounds.min_x, 0.f, 1.f);
+        bounds.min_y = std::clamp(bounds.min_y, 0.f, 1.f);
+        bounds.max_x = std::clamp(bounds.max_x, 0.f, 1.f);
+        bounds.max_y = std::clamp(bounds.max_y, 0.f, 1.f);
+
+        return bounds;
+    }
+
+    // picks the level at which the bounds cover at most 2x2 texels
+    constexpr auto hiz_mip_level(const ScreenBounds &bounds, std::uint32_t width, std::uint32_t height) -> std::uint32_t
+    {
+        const auto size = std::max((bounds.max_x - bounds.min_x) * static_cast<float>(width), (bounds.max_y - bounds.min_y) * static_cast<float>(height));
+
+        auto pixels = static_cast<std::uint32_t>(size);
+        if (static_cast<float>(pixels) < size)
+        {
+            ++pixels;
+        }
+
+        const auto level = static_cast<std::uint32_t>(std::bit_width(std::max(pixels, 1u) - 1u));
+        return std::min(level, hiz_mip_count(width, height) - 1u);
+    }
+
+    constexpr auto is_occluded(const HiZPyramid &pyramid, const ScreenBounds &bounds) -> bool
+    {
+        const auto width = pyramid.width(0u);
+        const auto height = pyramid.height(0u);
+        const auto level = hiz_mip_level(bounds, width, height);
+
+        // go via the level 0 pixel so texels that absorbed an odd row/column are still found
+        const auto to_texel = [level](float uv, std::uint32_t size)
+        {
+            const auto pixel = std::min(static_cast<std::uint32_t>(uv * static_cast<float>(size)), size - 1u);
+            return std::min(pixel >> level, hiz_mip_size(size, level) - 1u);
+        };
+
+        const auto x0 = to_texel(bounds.min_x, width);
+        const auto x1 = to_texel(bounds.max_x, width);
+        const auto y0 = to_texel(bounds.min_y, height);
+        const auto y1 = to_texel(bounds.max_y, height);
+
+        auto max_depth = 0.f;
+        for (auto y = y0; y <= y1; ++y)
+        {
+            for (auto x = x0; x <= x1; ++x)
+            {
+                max_depth = std::max(max_depth, pyramid.depth(level, x, y));
+            }
+        }
+
+        return bounds.min_depth > max_depth;
+    }
+
+    constexpr HiZPyramid::HiZPyramid(std::span<const float> depth, std::uint32_t width, std::uint32_t height)
+        : _width{width},
+          _height{height},
+          _levels{}
+    {
+        expect(width != 0u && height != 0u, "hiz pyramid cannot be empty");
+
+        _levels.emplace_back(std::ranges::begin(depth), std::ranges::end(depth));
+
+        for (auto level = 1u; level < hiz_mip_count(width, height); ++level)
+        {
+            _levels.push_back(downsample_depth(_levels.back(), this->width(level - 1u), this->height(level - 1u)));
+        }
+    }
+
+    constexpr auto HiZPyramid::mip_count() const -> std::uint32_t
+    {
+        return static_cast<std::uint32_t>(_levels.size());
+    }
+
+    constexpr auto HiZPyramid::width(std::uint32_t level) const -> std::uint32_t
+    {
+        return hiz_mip_size(_width, level);
+    }
+
+    constexpr auto HiZPyramid::height(std::uint32_t level) const -> std::uint32_t
+    {
+        return hiz_mip_size(_height, level);
+    }
+
+    constexpr auto HiZPyramid::depth(std::uint32_t level, std::uint32_t x, std::uint32_t y) const -> float
+    {
+        expect(level < _levels.size(), "level {} out of range", level);
+        expect(x < width(level) && y < height(level), "texel {} {} out of range", x, y);
+
+        return _levels[level][y * width(level) + x];
+    }
+
+    inline auto to_string(const ScreenBounds &obj) -> std::string
+    {
+        return std::format("min: {} {} max: {} {} depth: {}", obj.min_x, obj.min_y, obj.max_x, obj.max_y, obj.min_depth);
+    }
+}
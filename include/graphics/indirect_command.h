@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+
+namespace ufps
+{
+    // layout of DrawElementsIndirectCommand, also mirrored by the culling compute shader
+    struct IndirectCommand
+    {
+        std::uint32_t count;
+        std::uint32_t instanceCount;
+        std::uint32_t first_index;
+        std::int32_t base_vertex;
+        std::uint32_t baseInstance;
+    };
+}
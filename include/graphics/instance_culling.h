@@ -0,0 +1,187 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <vector>
+
+#include "graphics/culling.h"
+#include "graphics/indirect_command.h"
+#include "graphics/instance_data.h"
+#include "graphics/meshlet.h"
+#include "math/aabb.h"
+#include "math/frustum.h"
+#include "math/matrix4.h"
+#include "math/utils.h"
+#include "math/vector3.h"
+#include "math/vector4.h"
+
+namespace ufps
+{
+    // mirrors the PHASE_ defines in shaders/frustum_cull.comp
+    enum class CullingPhase : std::uint32_t
+    {
+        FRUSTUM,
+        LAST_FRAME_VISIBLE,
+        OCCLUSION
+    };
+
+    inline constexpr auto opaque_filter_flag = 1u << 0u;
+    inline constexpr auto transparent_filter_flag = 1u << 1u;
+
+    constexpr auto filter_flags(float opacity) -> std::uint32_t
+    {
+        return (opacity > 0.9999f ? opaque_filter_flag : 0u) | (opacity < 1.f ? transparent_filter_flag : 0u);
+    }
+
+    constexpr auto filter_mask(EntityFilterMode filter_mode) -> std::uint32_t
+    {
+        switch (filter_mode)
+        {
+            using enum EntityFilterMode;
+            case OPAQUE:
+                return opaque_filter_flag;
+            case TRANSPARENT:
+                return transparent_filter_flag;
+            case ALL:
+            default:
+                return opaque_filter_flag | transparent_filter_flag;
+        }
+    }
+
+    template <class E, class R>
+    constexpr auto create_instance_data(const E &entity, const R &render_entity) -> InstanceData
+    {
+        const auto mesh_view = render_entity.mesh_view();
+
+        return {
+            .model = entity.transform(),
+            .aabb_min = {render_entity.aabb().min, 1.f},
+            .aabb_max = {render_entity.aabb().max, 1.f},
+            .index_count = mesh_view.index_count,
+            .first_index = mesh_view.index_offset,
+            .base_vertex = static_cast<std::int32_t>(mesh_view.vertex_offset),
+            .filter_flags = filter_flags(render_entity.opacity()),
+            .meshlet_offset = mesh_view.meshlet_offset,
+            .meshlet_count = mesh_view.meshlet_count,
+        };
+    }
+
+    // cpu reference of shaders/frustum_cull.comp, the shader emits the same commands but in no particular order
+    constexpr auto cull_instances(std::span<const InstanceData> instances, const Frustum &frustum, std::uint32_t mask)
+        -> std::vector<IndirectCommand>
+    {
+        auto commands = std::vector<IndirectCommand>{};
+
+        for (const auto &[slot, instance] : instances | std::views::enumerate)
+        {
+            if ((instance.filter_flags & mask) == 0u)
+            {
+                continue;
+            }
+
+            const auto aabb = AABB{.min = instance.aabb_min, .max = instance.aabb_max};
+            if (!intersect(frustum, transform(aabb, instance.model)))
+            {
+                continue;
+            }
+
+            commands.push_back({
+                .count = instance.index_count,
+                .instanceCount = 1u,
+                .first_index = instance.first_index,
+                .base_vertex = instance.base_vertex,
+                .baseInstance = static_cast<std::uint32_t>(slot),
+            });
+        }
+
+        return commands;
+    }
+
+    // true if every triangle of the meshlet faces away from a camera at camera_position, which has to be in mesh space
+    // facing is unchanged by the model transform so testing in mesh space avoids transforming the cone
+    constexpr auto is_backfacing(const Meshlet &meshlet, const Vector3 &camera_position) -> bool
+    {
+        const auto cos_cone = meshlet.cone.w;
+        if (cos_cone <= 0.f)
+        {
+            return false;
+        }
+
+        const auto to_centre = Vector3{meshlet.sphere} - camera_position;
+        const auto distance = to_centre.length();
+        if (distance <= meshlet.sphere.w)
+        {
+            return false;
+        }
+
+        const auto cos_view = Vector3::dot(Vector3{meshlet.cone}, to_centre) / distance;
+        const auto sin_view = std::sqrt(std::max(1.f - cos_view * cos_view, 0.f));
+        const auto sin_cone = std::sqrt(std::max(1.f - cos_cone * cos_cone, 0.f));
+
+        // cos(view + cone) is the least any normal in the cone points away from the camera, it has to do so by more than
+        // the radius for the whole sphere to be behind every triangle's plane
+        return (cos_view * cos_cone - sin_view * sin_cone) * distance >= meshlet.sphere.w;
+    }
+
+    // true if any part of the meshlet's bounding sphere, transformed by model, is on the inside of every plane
+    constexpr auto intersect(const Frustum &frustum, const Meshlet &meshlet, const Matrix4 &model) -> bool
+    {
+        const auto m = model.data();
+        const auto scale = std::max(
+            {Vector3{m[0], m[1], m[2]}.length(), Vector3{m[4], m[5], m[6]}.length(), Vector3{m[8], m[9], m[10]}.length()});
+
+        const auto centre = Vector3{model * Vector4{Vector3{meshlet.sphere}, 1.f}};
+        const auto radius = meshlet.sphere.w * scale;
+
+        return std::ranges::all_of(frustum.planes, [&](const auto &plane) { return plane.distance_to(centre) >= -radius; });
+    }
+
+    // cpu reference of shaders/cluster_cull.comp, instances are culled as a whole first then each of their meshlets is
+    // frustum and backface culled and drawn on its own, the shader emits the same commands but in no particular order
+    constexpr auto cull_meshlets(
+        std::span<const InstanceData> instances,
+        std::span<const Meshlet> meshlets,
+        const Frustum &frustum,
+        const Vector3 &camera_position,
+        std::uint32_t mask) -> std::vector<IndirectCommand>
+    {
+        auto commands = std::vector<IndirectCommand>{};
+
+        for (const auto &[slot, instance] : instances | std::views::enumerate)
+        {
+            if ((instance.filter_flags & mask) == 0u)
+            {
+                continue;
+            }
+
+            const auto aabb = AABB{.min = instance.aabb_min, .max = instance.aabb_max};
+            if (!intersect(frustum, transform(aabb, instance.model)))
+            {
+                continue;
+            }
+
+            const auto local_camera_position = Vector3{Matrix4::invert(instance.model) * Vector4{camera_position, 1.f}};
+
+            for (const auto &meshlet : meshlets.subspan(instance.meshlet_offset, instance.meshlet_count))
+            {
+                if (!intersect(frustum, meshlet, instance.model) || is_backfacing(meshlet, local_camera_position))
+                {
+                    continue;
+                }
+
+                commands.push_back({
+                    .count = meshlet.index_count,
+                    .instanceCount = 1u,
+                    .first_index = instance.first_index + meshlet.index_offset,
+                    .base_vertex = instance.base_vertex,
+                    .baseInstance = static_cast<std::uint32_t>(slot),
+                });
+            }
+        }
+
+        return commands;
+    }
+}
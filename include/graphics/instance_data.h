@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+
+#include "math/matrix4.h"
+#include "math/vector4.h"
+
+namespace ufps
+{
+    // per render entity data consumed by the culling compute shader
+    struct alignas(16) InstanceData
+    {
+        Matrix4 model;
+        Vector4 aabb_min;
+        Vector4 aabb_max;
+        std::uint32_t index_count;
+        std::uint32_t first_index;
+        std::int32_t base_vertex;
+        std::uint32_t filter_flags;
+        std::uint32_t meshlet_offset;
+        std::uint32_t meshlet_count;
+    };
+}
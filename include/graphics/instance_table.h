@@ -0,0 +1,252 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <vector>
+
+#include "graphics/culling.h"
+#include "utils/ensure.h"
+
+namespace ufps
+{
+    struct SlotRange
+    {
+        std::uint32_t first;
+        std::uint32_t count;
+
+        constexpr auto operator==(const SlotRange &) const -> bool = default;
+    };
+
+    class DirtySlots
+    {
+    public:
+        constexpr auto mark(std::uint32_t first, std::uint32_t count = 1u) -> void;
+        constexpr auto ranges() const -> std::vector<SlotRange>;
+        constexpr auto empty() const -> bool;
+        constexpr auto clear() -> void;
+
+    private:
+        std::vector<SlotRange> _ranges;
+    };
+
+    // dirty slots for each frame region of a MultiBuffer, a slot is only clean once it has been written to every region
+    template <std::size_t Frames>
+    class FrameDirtySlots
+    {
+    public:
+        constexpr auto mark(std::uint32_t first, std::uint32_t count = 1u) -> void;
+        constexpr auto mark(const DirtySlots &dirty) -> void;
+        constexpr auto current() const -> const DirtySlots &;
+        constexpr auto clear_current() -> void;
+        constexpr auto advance() -> void;
+
+    private:
+        std::array<DirtySlots, Frames> _frames;
+        std::size_t _current = 0zu;
+    };
+
+    // assigns every render entity in a scene a slot, slots stay put until entities are added or removed
+    class InstanceTable
+    {
+    public:
+        // returns true if slots were reassigned
+        template <std::ranges::sized_range R>
+        constexpr auto sync(R &&entities, std::uint32_t scene_revision) -> bool;
+
+        constexpr auto slot_count() const -> std::uint32_t;
+        constexpr auto entity_slots(std::uint32_t entity_index) const -> SlotRange;
+        constexpr auto slot(const DrawItem &draw) const -> std::uint32_t;
+        constexpr auto owner(std::uint32_t slot) const -> DrawItem;
+
+        constexpr auto dirty() const -> const DirtySlots &;
+        constexpr auto mark_all_dirty() -> void;
+        constexpr auto clear_dirty() -> void;
+
+    private:
+        std::optional<std::uint32_t> _scene_revision;
+        std::vector<SlotRange> _entity_slots;
+        std::vector<std::uint32_t> _entity_versions;
+        std::vector<DrawItem> _owners;
+        DirtySlots _dirty;
+    };
+
+    constexpr auto DirtySlots::mark(std::uint32_t first, std::uint32_t count) -> void
+    {
+        if (count == 0u)
+        {
+            return;
+        }
+
+        // marks usually arrive in slot order so extending the last range catches the common case
+        if (!_ranges.empty())
+        {
+            auto &last = _ranges.back();
+            if (first >= last.first && first <= last.first + last.count)
+            {
+                last.count = std::max(last.count, first + count - last.first);
+                return;
+            }
+        }
+
+        _ranges.push_back({first, count});
+    }
+
+    constexpr auto DirtySlots::ranges() const -> std::vector<SlotRange>
+    {
+        auto sorted = _ranges;
+        std::ranges::sort(sorted, {}, &SlotRange::first);
+
+        auto merged = std::vector<SlotRange>{};
+        for (const auto &range : sorted)
+        {
+            if (!merged.empty() && range.first <= merged.back().first + merged.back().count)
+            {
+                auto &last = merged.back();
+                last.count = std::max(last.count, range.first + range.count - last.first);
+            }
+            else
+            {
+                merged.push_back(range);
+            }
+        }
+
+        return merged;
+    }
+
+    constexpr auto DirtySlots::empty() const -> bool
+    {
+        return _ranges.empty();
+    }
+
+    constexpr auto DirtySlots::clear() -> void
+    {
+        _ranges.clear();
+    }
+
+    template <std::size_t Frames>
+    constexpr auto FrameDirtySlots<Frames>::mark(std::uint32_t first, std::uint32_t count) -> void
+    {
+        for (auto &frame : _frames)
+        {
+            frame.mark(first, count);
+        }
+    }
+
+    template <std::size_t Frames>
+    constexpr auto FrameDirtySlots<Frames>::mark(const DirtySlots &dirty) -> void
+    {
+        for (const auto &range : dirty.ranges())
+        {
+            mark(range.first, range.count);
+        }
+    }
+
+    template <std::size_t Frames>
+    constexpr auto FrameDirtySlots<Frames>::current() const -> const DirtySlots &
+    {
+        return _frames[_current];
+    }
+
+    template <std::size_t Frames>
+    constexpr auto FrameDirtySlots<Frames>::clear_current() -> void
+    {
+        _frames[_current].clear();
+    }
+
+    template <std::size_t Frames>
+    constexpr auto FrameDirtySlots<Frames>::advance() -> void
+    {
+        _current = (_current + 1zu) % Frames;
+    }
+
+    template <std::ranges::sized_range R>
+    constexpr auto InstanceTable::sync(R &&entities, std::uint32_t scene_revision) -> bool
+    {
+        if (_scene_revision != scene_revision || _entity_slots.size() != std::ranges::size(entities))
+        {
+            _entity_slots.clear();
+            _entity_versions.clear();
+            _owners.clear();
+            _dirty.clear();
+
+            for (const auto &[entity_index, entity] : entities | std::views::enumerate)
+            {
+                const auto render_entity_count = static_cast<std::uint32_t>(entity.render_entities().size());
+
+                _entity_slots.push_back({static_cast<std::uint32_t>(_owners.size()), render_entity_count});
+                _entity_versions.push_back(entity.version());
+
+                for (auto i = 0u; i < render_entity_count; ++i)
+                {
+                    _owners.push_back({static_cast<std::uint32_t>(entity_index), i});
+                }
+            }
+
+            _scene_revision = scene_revision;
+            mark_all_dirty();
+
+            return true;
+        }
+
+        for (const auto &[entity_index, entity] : entities | std::views::enumerate)
+        {
+            if (entity.version() != _entity_versions[entity_index])
+            {
+                _entity_versions[entity_index] = entity.version();
+                const auto &slots = _entity_slots[entity_index];
+                _dirty.mark(slots.first, slots.count);
+            }
+        }
+
+        return false;
+    }
+
+    constexpr auto InstanceTable::slot_count() const -> std::uint32_t
+    {
+        return static_cast<std::uint32_t>(_owners.size());
+    }
+
+    constexpr auto InstanceTable::entity_slots(std::uint32_t entity_index) const -> SlotRange
+    {
+        expect(entity_index < _entity_slots.size(), "entity index {} out of range", entity_index);
+        return _entity_slots[entity_index];
+    }
+
+    constexpr auto InstanceTable::slot(const DrawItem &draw) const -> std::uint32_t
+    {
+        return entity_slots(draw.entity_index).first + draw.render_entity_index;
+    }
+
+    constexpr auto InstanceTable::owner(std::uint32_t slot) const -> DrawItem
+    {
+        expect(slot < _owners.size(), "slot {} out of range", slot);
+        return _owners[slot];
+    }
+
+    constexpr auto InstanceTable::dirty() const -> const DirtySlots &
+    {
+        return _dirty;
+    }
+
+    constexpr auto InstanceTable::mark_all_dirty() -> void
+    {
+        _dirty.clear();
+        _dirty.mark(0u, slot_count());
+    }
+
+    constexpr auto InstanceTable::clear_dirty() -> void
+    {
+        _dirty.clear();
+    }
+
+    inline auto to_string(const SlotRange &obj) -> std::string
+    {
+        return std::format("[{}, {})", obj.first, obj.first + obj.count);
+    }
+}
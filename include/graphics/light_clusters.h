@@ -0,0 +1,232 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <compare>
+#include <cstdint>
+#include <format>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "core/camera.h"
+#include "graphics/point_light.h"
+#include "math/aabb.h"
+#include "math/matrix4.h"
+#include "math/vector3.h"
+#include "math/vector4.h"
+
+namespace ufps
+{
+    // these must match the defines in shaders/light_cull.comp, shaders/light_pass.frag and shaders/transparancy.frag
+    inline constexpr auto cluster_count_x = 16u;
+    inline constexpr auto cluster_count_y = 9u;
+    inline constexpr auto cluster_count_z = 24u;
+    inline constexpr auto cluster_count = cluster_count_x * cluster_count_y * cluster_count_z;
+    inline constexpr auto max_lights_per_cluster = 128u;
+
+    // contribution below which a light is considered to have no effect
+    inline constexpr auto light_range_threshold = 1.f / 256.f;
+
+    // slice of the light index list belonging to a cluster, laid out as a uvec2 on the gpu
+    struct ClusterRange
+    {
+        std::uint32_t offset;
+        std::uint32_t count;
+
+        constexpr auto operator==(const ClusterRange &) const -> bool = default;
+    };
+
+    struct LightClusters
+    {
+        std::vector<ClusterRange> clusters;
+        std::vector<std::uint32_t> light_indices;
+    };
+
+    // distance at which the attenuated light drops below the threshold, infinite if it never does
+    constexpr auto light_range(const PointLight &light, float threshold = light_range_threshold) -> float
+    {
+        const auto brightness = light.intensity * std::max({light.color.r, light.color.g, light.color.b});
+        const auto limit = brightness / threshold;
+
+        if (limit <= light.constant_attenuation)
+        {
+            return 0.f;
+        }
+
+        if (light.quadratic_attenuation > 0.f)
+        {
+            // solve constant + linear * d + quadratic * d^2 = limit for d
+            const auto discriminant = (light.linear_attenuation * light.linear_attenuation) -
+                                      (4.f * light.quadratic_attenuation * (light.constant_attenuation - limit));
+            return (-light.linear_attenuation + std::sqrt(discriminant)) / (2.f * light.quadratic_attenuation);
+        }
+
+        if (light.linear_attenuation > 0.f)
+        {
+            return (limit - light.constant_attenuation) / light.linear_attenuation;
+        }
+
+        return std::numeric_limits<float>::infinity();
+    }
+
+    constexpr auto projection_near_plane(const Matrix4 &projection) -> float
+    {
+        const auto elements = projection.data();
+        return elements[14] / (elements[10] - 1.f);
+    }
+
+    constexpr auto projection_far_plane(const Matrix4 &projection) -> float
+    {
+        const auto elements = projection.data();
+        return elements[14] / (elements[10] + 1.f);
+    }
+
+    // depth slices are exponential so clusters stay roughly cube shaped as they get further away
+    constexpr auto cluster_slice(float view_depth, float near_plane, float far_plane) -> std::uint32_t
+    {
+        if (view_depth <= near_plane)
+        {
+            return 0u;
+        }
+
+        const auto slice = std::log(view_depth / near_plane) * static_cast<float>(cluster_count_z) / std::log(far_plane / near_plane);
+        return std::min(static_cast<std::uint32_t>(slice), cluster_count_z - 1u);
+    }
+
+    constexpr auto cluster_index(std::uint32_t x, std::uint32_t y, std::uint32_t z) -> std::uint32_t
+    {
+        return x + (y * cluster_count_x) + (z * cluster_count_x * cluster_count_y);
+    }
+
+    // cluster a world space position falls into, positions outside of the view are clamped to the nearest cluster
+    constexpr auto cluster_index(const Vector3 &world_position, const CameraData &camera) -> std::uint32_t
+    {
+        const auto view_position = camera.view * Vector4{world_position, 1.f};
+        const auto clip = camera.projection * view_position;
+
+        const auto to_tile = [&clip](float value, std::uint32_t count)
+        {
+            const auto ndc = clip.w > 0.f ? std::clamp(value / clip.w, -1.f, 1.f) : 0.f;
+            return std::min(static_cast<std::uint32_t>((ndc * .5f + .5f) * static_cast<float>(count)), count - 1u);
+        };
+
+        const auto slice = cluster_slice(
+            -view_position.z, projection_near_plane(camera.projection), projection_far_plane(camera.projection));
+
+        return cluster_index(to_tile(clip.x, cluster_count_x), to_tile(clip.y, cluster_count_y), slice);
+    }
+
+    // view space box enclosing a cluster
+    constexpr auto cluster_bounds(std::uint32_t x, std::uint32_t y, std::uint32_t z, const Matrix4 &projection) -> AABB
+    {
+        const auto elements = projection.data();
+        const auto near_plane = projection_near_plane(projection);
+        const auto far_plane = projection_far_plane(projection);
+
+        const auto slice_depth = [&](std::uint32_t slice)
+        { return near_plane * std::pow(far_plane / near_plane, static_cast<float>(slice) / static_cast<float>(cluster_count_z)); };
+
+        const auto depth_near = slice_depth(z);
+        const auto depth_far = slice_depth(z + 1u);
+
+        const auto to_ndc = [](std::uint32_t tile, std::uint32_t count)
+        { return -1.f + (2.f * static_cast<float>(tile) / static_cast<float>(count)); };
+
+        // undo the projection of a ndc coordinate at a given view depth
+        const auto to_view = [](float ndc, float depth, float scale, float offset)
+        { return (ndc + offset) * depth / scale; };
+
+        const auto min_x = to_ndc(x, cluster_count_x);
+        const auto max_x = to_ndc(x + 1u, cluster_count_x);
+        const auto min_y = to_ndc(y, cluster_count_y);
+        const auto max_y = to_ndc(y + 1u, cluster_count_y);
+
+        return {
+            .min = {
+                std::min(to_view(min_x, depth_near, elements[0], elements[8]), to_view(min_x, depth_far, elements[0], elements[8])),
+                std::min(to_view(min_y, depth_near, elements[5], elements[9]), to_view(min_y, depth_far, elements[5], elements[9])),
+                -depth_far},
+            .max = {
+                std::max(to_view(max_x, depth_near, elements[0], elements[8]), to_view(max_x, depth_far, elements[0], elements[8])),
+                std::max(to_view(max_y, depth_near, elements[5], elements[9]), to_view(max_y, depth_far, elements[5], elements[9])),
+                -depth_near}};
+    }
+
+    constexpr auto sphere_intersects(const AABB &aabb, const Vector3 &centre, float radius) -> bool
+    {
+        const auto closest = Vector3{
+            std::clamp(centre.x, aabb.min.x, aabb.max.x),
+            std::clamp(centre.y, aabb.min.y, aabb.max.y),
+            std::clamp(centre.z, aabb.min.z, aabb.max.z)};
+
+        const auto delta = centre - closest;
+        return Vector3::dot(delta, delta) <= radius * radius;
+    }
+
+    // cpu version of shaders/light_cull.comp, the gpu writes each cluster at a fixed offset of
+    // cluster * max_lights_per_cluster whereas this packs the index list but the cluster contents are the same
+    constexpr auto assign_lights(std::span<const PointLight> lights, const CameraData &camera) -> LightClusters
+    {
+        struct ViewLight
+        {
+            std::uint32_t index;
+            Vector3 centre;
+            float radius;
+        };
+
+        const auto view_lights = lights |
+                                 std::views::enumerate |
+                                 std::views::transform(
+                                     [&camera](const auto &element)
+                                     {
+                                         const auto &[index, light] = element;
+                                         const auto centre = camera.view * Vector4{light.position, 1.f};
+
+                                         return ViewLight{
+                                             .index = static_cast<std::uint32_t>(index),
+                                             .centre = {centre.x, centre.y, centre.z},
+                                             .radius = light_range(light)};
+                                     }) |
+                                 std::views::filter([](const auto &light) { return light.radius > 0.f; }) |
+                                 std::ranges::to<std::vector>();
+
+        auto result = LightClusters{.clusters = std::vector<ClusterRange>(cluster_count), .light_indices = {}};
+
+        for (auto z = 0u; z < cluster_count_z; ++z)
+        {
+            for (auto y = 0u; y < cluster_count_y; ++y)
+            {
+                for (auto x = 0u; x < cluster_count_x; ++x)
+                {
+                    const auto bounds = cluster_bounds(x, y, z, camera.projection);
+                    auto &range = result.clusters[cluster_index(x, y, z)];
+                    range.offset = static_cast<std::uint32_t>(result.light_indices.size());
+
+                    for (const auto &light : view_lights)
+                    {
+                        if (range.count == max_lights_per_cluster)
+                        {
+                            break;
+                        }
+
+                        if (sphere_intersects(bounds, light.centre, light.radius))
+                        {
+                            result.light_indices.push_back(light.index);
+                            ++range.count;
+                        }
+                    }
+                }
+            }
+        }
+
+        return result;
+    }
+
+    inline auto to_string(const ClusterRange &obj) -> std::string
+    {
+        return std::format("offset: {} count: {}", obj.offset, obj.count);
+    }
+}
@@ -1,19 +1,29 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <span>
 #include <string>
 #include <string_view>
 
 #include "graphics/buffer.h"
+#include "graphics/compact_vertex.h"
 #include "graphics/mesh_data.h"
 #include "graphics/mesh_view.h"
+#include "graphics/meshlet.h"
 #include "graphics/opengl.h"
+#include "graphics/staging_ring.h"
 #include "graphics/vertex_data.h"
+#include "utils/data_buffer.h"
 #include "utils/string_unordered_map.h"
 
 namespace ufps
 {
+    inline constexpr auto mesh_staging_size = 16zu * 1024zu * 1024zu;
+
+    // mesh data is kept on the cpu and mirrored into one gpu buffer each for vertices, indices and meshlets
+    // a load only uploads what it appended, staged through a ring and copied into place on the gpu, and a buffer that
+    // runs out of room doubles with a gpu side copy of what it held, so neither waits for the gpu to be idle
     class MeshManager
     {
     public:
@@ -22,13 +32,17 @@ namespace ufps
         MeshManager(
             std::vector<VertexData> vertex_data,
             std::vector<std::uint32_t> index_data,
+            std::vector<Meshlet> meshlet_data,
             StringUnorderedMap<std::vector<MeshView>> mesh_lookup);
 
+        // raw_vertex_data is CompactVertex and raw_meshlet_data Meshlet, as written by resource_packer
         MeshManager(
             DataBufferView raw_vertex_data,
             DataBufferView raw_index_data,
+            DataBufferView raw_meshlet_data,
             StringUnorderedMap<std::vector<MeshView>> mesh_lookup);
 
+        // meshlets are built here, which reorders each mesh's triangles
         auto load(std::string_view name, std::span<const MeshData> meshes) -> std::span<const MeshView>;
 
         auto mesh(std::string_view name) -> std::span<const MeshView>;
@@ -36,17 +50,25 @@ namespace ufps
         auto mesh_names() const -> std::vector<std::string>;
 
         auto native_handle() const -> std::tuple<::GLuint, ::GLuint>;
+        auto meshlet_native_handle() const -> ::GLuint;
 
         auto index_data(MeshView view) const -> std::span<const std::uint32_t>;
-        auto vertex_data(MeshView view) const -> std::span<const VertexData>;
+        auto vertex_data(MeshView view) const -> std::span<const CompactVertex>;
+        auto meshlet_data(MeshView view) const -> std::span<const Meshlet>;
 
         auto to_string() const -> std::string;
 
     private:
-        std::vector<VertexData> _vertex_data_cpu;
+        // uploads the bytes of cpu_data from uploaded on, everything before that is already in gpu_data
+        auto upload(DataBufferView cpu_data, std::size_t uploaded, Buffer &gpu_data) -> void;
+
+        std::vector<CompactVertex> _vertex_data_cpu;
         std::vector<std::uint32_t> _index_data_cpu;
+        std::vector<Meshlet> _meshlet_data_cpu;
         Buffer _vertex_data_gpu;
         Buffer _index_data_gpu;
+        Buffer _meshlet_data_gpu;
         StringUnorderedMap<std::vector<MeshView>> _mesh_lookup;
+        StagingRing _staging;
     };
 }
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "graphics/mesh_data.h"
+#include "graphics/vertex_data.h"
+
+namespace ufps
+{
+    // roughly what current hardware keeps of transformed vertices, only used to measure and to split clusters
+    inline constexpr auto vertex_cache_size = 16u;
+
+    struct VertexCacheStats
+    {
+        // transformed vertices per triangle, 3 is no reuse at all and 0.5 is the ideal for a large regular grid
+        float acmr;
+
+        // transformed vertices per vertex, 1 is ideal
+        float atvr;
+    };
+
+    // simulates a FIFO post transform cache over the triangle list
+    auto analyze_vertex_cache(std::span<const std::uint32_t> indices, std::size_t vertex_count, std::uint32_t cache_size = vertex_cache_size)
+        -> VertexCacheStats;
+
+    // merges bitwise identical vertices, keeping the first of each in order
+    auto weld_vertices(const MeshData &mesh) -> MeshData;
+
+    // reorders triangles for post transform cache reuse (Forsyth's linear speed algorithm)
+    auto optimize_vertex_cache(std::span<const std::uint32_t> indices, std::size_t vertex_count) -> std::vector<std::uint32_t>;
+
+    // reorders clusters of a cache optimized triangle list so outward facing ones are drawn first, which cuts overdraw
+    // from any view point, clusters are only split where that costs at most threshold times the current ACMR
+    auto optimize_overdraw(std::span<const std::uint32_t> indices, std::span<const VertexData> vertices, float threshold = 1.05f)
+        -> std::vector<std::uint32_t>;
+
+    // reorders vertices into first use order so fetches walk memory forwards, unused vertices are dropped
+    auto optimize_vertex_fetch(const MeshData &mesh) -> MeshData;
+
+    // every stage above in the order they have to run
+    auto optimize_mesh(const MeshData &mesh) -> MeshData;
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <compare>
 #include <cstdint>
 
 namespace ufps
@@ -10,5 +11,9 @@ namespace ufps
         std::uint32_t vertex_count;
         std::uint32_t index_offset;
         std::uint32_t index_count;
+        std::uint32_t meshlet_offset;
+        std::uint32_t meshlet_count;
+
+        constexpr auto operator<=>(const MeshView &) const = default;
     };
 }
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "graphics/mesh_data.h"
+#include "math/vector4.h"
+
+namespace ufps
+{
+    // small enough that a meshlet's bounds are tight, large enough that per meshlet draws stay cheap
+    inline constexpr auto meshlet_max_vertices = 64u;
+    inline constexpr auto meshlet_max_triangles = 124u;
+
+    // a cluster of a mesh's triangles, drawn as its own contiguous range of the mesh's indices
+    // bounds are in mesh space, must match Meshlet in shaders/cluster_cull.comp
+    struct alignas(16) Meshlet
+    {
+        // xyz centre, w radius
+        Vector4 sphere;
+
+        // xyz the average triangle normal, w the cosine of the largest angle between it and any triangle normal
+        // w is 0 when the triangles face too many ways for the cone to ever cull
+        Vector4 cone;
+
+        // relative to the mesh's first index
+        std::uint32_t index_offset;
+        std::uint32_t index_count;
+
+        std::uint32_t vertex_count;
+        std::uint32_t pad;
+
+        constexpr auto operator==(const Meshlet &) const -> bool = default;
+    };
+
+    static_assert(sizeof(Meshlet) == 48zu);
+
+    struct MeshletData
+    {
+        // the input with its triangles reordered so every meshlet is a contiguous range of indices
+        MeshData mesh;
+        std::vector<Meshlet> meshlets;
+    };
+
+    // greedily grows meshlets from connected triangles that add the fewest new vertices, the output only depends on the
+    // input so rebuilding an unchanged mesh gives an identical result
+    // triangles keep their relative order within a meshlet and meshlets are in order of their first triangle, so most
+    // of a cache optimized order survives
+    auto build_meshlets(const MeshData &mesh) -> MeshletData;
+}
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "graphics/texture_data.h"
+#include "utils/data_buffer.h"
+#include "utils/ensure.h"
+#include "utils/exception.h"
+
+namespace ufps
+{
+    // where one level of a mip chain lives in TextureData::data, levels are stored largest first and tightly packed
+    struct MipLevel
+    {
+        std::uint32_t width;
+        std::uint32_t height;
+        std::size_t offset;
+        std::size_t size;
+
+        constexpr auto operator==(const MipLevel &) const -> bool = default;
+    };
+
+    constexpr auto is_block_compressed(TextureFormat format) -> bool
+    {
+        switch (format)
+        {
+            using enum TextureFormat;
+        case BC5U:
+        case BC7:
+        case BC7_SRGB:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    constexpr auto bytes_per_pixel(TextureFormat format) -> std::size_t
+    {
+        switch (format)
+        {
+            using enum TextureFormat;
+        case R:
+            return 1zu;
+        case RGB:
+        case SRGB:
+            return 3zu;
+        case RGBA:
+        case SRGBA:
+        case RG16F:
+        case R32F:
+        case DEPTH24:
+            return 4zu;
+        case RGB16F:
+            return 6zu;
+        case RGBA16F:
+            return 8zu;
+        default:
+            throw Exception("no bytes per pixel for block compressed format: {}", to_string(format));
+        }
+    }
+
+    constexpr auto mip_level_size(TextureFormat format, std::uint32_t width, std::uint32_t height) -> std::size_t
+    {
+        // both BC5 and BC7 store a 4x4 block in 16 bytes
+        if (is_block_compressed(format))
+        {
+            return ((width + 3zu) / 4zu) * ((height + 3zu) / 4zu) * 16zu;
+        }
+
+        return static_cast<std::size_t>(width) * height * bytes_per_pixel(format);
+    }
+
+    // every level down to 1x1
+    constexpr auto full_mip_count(std::uint32_t width, std::uint32_t height) -> std::uint32_t
+    {
+        return static_cast<std::uint32_t>(std::bit_width(std::max({width, height, 1u})));
+    }
+
+    constexpr auto mip_chain(TextureFormat format, std::uint32_t width, std::uint32_t height, std::uint32_t levels) -> std::vector<MipLevel>
+    {
+        auto chain = std::vector<MipLevel>{};
+        auto offset = 0zu;
+
+        for (auto level = 0u; level < levels; ++level)
+        {
+            const auto level_width = std::max(width >> level, 1u);
+            const auto level_height = std::max(height >> level, 1u);
+            const auto size = mip_level_size(format, level_width, level_height);
+
+            chain.push_back({.width = level_width, .height = level_height, .offset = offset, .size = size});
+            offset += size;
+        }
+
+        return chain;
+    }
+
+    constexpr auto mip_chain(const TextureData &texture) -> std::vector<MipLevel>
+    {
+        return mip_chain(texture.format, texture.width, texture.height, texture.mip_levels);
+    }
+
+    // the levels [first_mip, mip_levels) of texture as a texture of their own
+    inline auto drop_mips(const TextureData &texture, std::uint32_t first_mip) -> TextureData
+    {
+        ensure(first_mip < texture.mip_levels, "cannot drop {} of {} mips", first_mip, texture.mip_levels);
+
+        const auto chain = mip_chain(texture);
+        const auto &first = chain[first_mip];
+
+        auto dropped = TextureData{
+            .width = first.width,
+            .height = first.height,
+            .format = texture.format,
+            .data = std::nullopt,
+            .is_compressed = texture.is_compressed,
+            .mip_levels = texture.mip_levels - first_mip,
+        };
+
+        if (texture.data)
+        {
+            dropped.data = DataBuffer(texture.data->begin() + first.offset, texture.data->begin() + chain.back().offset + chain.back().size);
+        }
+
+        return dropped;
+    }
+
+    namespace impl
+    {
+        inline auto srgb_to_linear(std::uint8_t value) -> float
+        {
+            static const auto table = []
+            {
+                auto table = std::array<float, 256zu>{};
+                for (auto i = 0zu; i < table.size(); ++i)
+                {
+                    const auto c = static_cast<float>(i) / 255.f;
+                    table[i] = c <= .04045f ? c / 12.92f : std::pow((c + .055f) / 1.055f, 2.4f);
+                }
+
+                return table;
+            }();
+
+            return table[value];
+        }
+
+        inline auto linear_to_srgb(float value) -> std::uint8_t
+        {
+            const auto c = value <= .0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.f / 2.4f) - .055f;
+            return static_cast<std::uint8_t>(std::clamp(c * 255.f + .5f, 0.f, 255.f));
+        }
+    }
+
+    // box filters an 8 bit per channel texture down to 1x1, averaging colour in linear space for srgb formats
+    inline auto generate_mips(const TextureData &texture) -> TextureData
+    {
+        ensure(!texture.is_compressed, "cannot generate mips for compressed format: {}", to_string(texture.format));
+        ensure(texture.data.has_value(), "cannot generate mips without texture data");
+
+        const auto channels = bytes_per_pixel(texture.format);
+        const auto is_srgb = texture.format == TextureFormat::SRGB || texture.format == TextureFormat::SRGBA;
+        ensure(
+            texture.format == TextureFormat::R || texture.format == TextureFormat::RGB || texture.format == TextureFormat::RGBA || is_srgb,
+            "cannot generate mips for format: {}",
+            to_string(texture.format));
+
+        const auto levels = full_mip_count(texture.width, texture.height);
+        const auto chain = mip_chain(texture.format, texture.width, texture.height, levels);
+
+        auto data = DataBuffer(chain.back().offset + chain.back().size);
+        std::ranges::copy(texture.data->begin(), texture.data->begin() + chain.front().size, data.begin());
+
+        for (auto level = 1zu; level < chain.size(); ++level)
+        {
+            const auto &src = chain[level - 1zu];
+            const auto &dst = chain[level];
+            const auto *src_pixels = reinterpret_cast<const std::uint8_t *>(data.data() + src.offset);
+            auto *dst_pixels = reinterpret_cast<std::uint8_t *>(data.data() + dst.offset);
+
+            for (auto y = 0u; y < dst.height; ++y)
+            {
+                for (auto x = 0u; x < dst.width; ++x)
+                {
+                    // odd sizes clamp so the last row or column is counted twice rather than read past the edge
+                    const auto x0 = std::min(x * 2u, src.width - 1u);
+                    const auto x1 = std::min(x * 2u + 1u, src.width - 1u);
+                    const auto y0 = std::min(y * 2u, src.height - 1u);
+                    const auto y1 = std::min(y * 2u + 1u, src.height - 1u);
+
+                    for (auto c = 0zu; c < channels; ++c)
+                    {
+                        const auto texel = [&](std::uint32_t sx, std::uint32_t sy)
+                        { return src_pixels[(static_cast<std::size_t>(sy) * src.width + sx) * channels + c]; };
+
+                        auto &out = dst_pixels[(static_cast<std::size_t>(y) * dst.width + x) * channels + c];
+
+                        if (is_srgb && c < 3zu)
+                        {
+                            const auto sum = impl::srgb_to_linear(texel(x0, y0)) + impl::srgb_to_linear(texel(x1, y0)) +
+                                             impl::srgb_to_linear(texel(x0, y1)) + impl::srgb_to_linear(texel(x1, y1));
+                            out = impl::linear_to_srgb(sum * .25f);
+                        }
+                        else
+                        {
+                            const auto sum = texel(x0, y0) + texel(x1, y0) + texel(x0, y1) + texel(x1, y1);
+                            out = static_cast<std::uint8_t>((sum + 2u) / 4u);
+                        }
+                    }
+                }
+            }
+        }
+
+        return {
+            .width = texture.width,
+            .height = texture.height,
+            .format = texture.format,
+            .data = std::move(data),
+            .is_compressed = false,
+            .mip_levels = levels,
+        };
+    }
+}
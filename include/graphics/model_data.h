@@ -2,14 +2,19 @@
 
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "graphics/mesh_data.h"
+#include "graphics/meshlet.h"
 
 namespace ufps
 {
     struct ModelData
     {
         MeshData mesh_data;
+
+        // empty until the packer has built them, see build_meshlets
+        std::vector<Meshlet> meshlets;
         std::optional<std::string> albedo;
         std::optional<std::string> normal;
         std::optional<std::string> specular;
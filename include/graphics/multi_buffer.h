@@ -1,5 +1,8 @@
 #pragma once
 
+#include <array>
+#include <chrono>
+#include <concepts>
 #include <string_view>
 
 #include "utils/data_buffer.h"
@@ -7,29 +10,56 @@
 
 namespace ufps
 {
+    template <class T>
+    concept IsFence = std::default_initializable<T> && requires(T t) {
+        { t.signal() };
+        { t.wait() } -> std::same_as<std::chrono::nanoseconds>;
+    };
+
+    // for buffers the driver already orders writes to, e.g. Buffer which writes with glNamedBufferSubData
+    struct NoFence
+    {
+        auto signal() -> void
+        {
+        }
+
+        auto wait() -> std::chrono::nanoseconds
+        {
+            return {};
+        }
+    };
 
     /**
      * A multi buffer wrapper of a Buffer type. Will allocate size * Frames amount of data an can advance through it
+     *
+     * Each frame region has a Fence, which is signalled when advancing past the region and waited on when advancing
+     * back to it, so a buffer written by the cpu (e.g. a PersistentBuffer with GpuFence) is never written while the gpu
+     * could still be reading that region
      */
-    template <IsBuffer Buffer, std::size_t Frames = 3zu>
+    template <IsBuffer Buffer, std::size_t Frames = 3zu, IsFence Fence = NoFence>
     class MultiBuffer
     {
     public:
         MultiBuffer(std::size_t size, std::string_view name)
             : _buffer{size * Frames, name},
               _size{size},
-              _frame_offset{}
+              _frame{},
+              _fences{},
+              _fence_wait{}
         {
         }
 
         auto write(DataBufferView data, std::size_t offset) -> void
         {
-            _buffer.write(data, offset + _frame_offset);
+            _buffer.write(data, offset + frame_offset_bytes());
         }
 
+        // call once every command reading the current region has been issued
         auto advance() -> void
         {
-            _frame_offset = (_frame_offset + _size) % (_size * Frames);
+            _fences[_frame].signal();
+            _frame = (_frame + 1zu) % Frames;
+            _fence_wait = _fences[_frame].wait();
         }
 
         auto native_handle() const
@@ -49,7 +79,13 @@ namespace ufps
 
         auto frame_offset_bytes() const -> std::size_t
         {
-            return _frame_offset;
+            return _frame * _size;
+        }
+
+        // how long the last advance() blocked waiting for the gpu to finish with the region it moved to
+        auto fence_wait() const -> std::chrono::nanoseconds
+        {
+            return _fence_wait;
         }
 
         auto name() const -> std::string_view
@@ -60,6 +96,8 @@ namespace ufps
     private:
         Buffer _buffer;
         std::size_t _size;
-        std::size_t _frame_offset;
+        std::size_t _frame;
+        std::array<Fence, Frames> _fences;
+        std::chrono::nanoseconds _fence_wait;
     };
-}
\ No newline at end of file
+}
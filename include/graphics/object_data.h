@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 
 #include "math/matrix4.h"
 
@@ -20,4 +21,23 @@ namespace ufps
         std::uint32_t normal_compressed;
         std::uint32_t pad;
     };
-}
\ No newline at end of file
+
+    // resolve maps the bindless handles render entities hold to the ones to sample, e.g. TextureManager::resolve
+    template <class E, class R, class F = std::identity>
+    constexpr auto create_object_data(const E &entity, const R &render_entity, F &&resolve = {}) -> ObjectData
+    {
+        return {
+            .model = entity.transform(),
+            .albedo_texture_bindless_handle = resolve(render_entity.albedo_texture_bindless_handle()),
+            .normal_texture_bindless_handle = resolve(render_entity.normal_texture_bindless_handle()),
+            .specular_texture_bindless_handle = resolve(render_entity.specular_texture_bindless_handle()),
+            .roughness_texture_bindless_handle = resolve(render_entity.roughness_texture_bindless_handle()),
+            .ao_texture_bindless_handle = resolve(render_entity.ao_texture_bindless_handle()),
+            .emissive_texture_bindless_handle = resolve(render_entity.emissive_texture_bindless_handle()),
+            .opacity = render_entity.opacity(),
+            .emissive_strength = render_entity.emissive_intensity() * entity.emissive_strength(),
+            .normal_compressed = render_entity.normal_compressed() ? 1u : 0u,
+            .pad{},
+        };
+    }
+}
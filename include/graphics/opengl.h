@@ -59,6 +59,7 @@
     DO(::PFNGLENABLEVERTEXARRAYATTRIBPROC, glEnableVertexArrayAttrib)                         \
     DO(::PFNGLVERTEXARRAYATTRIBFORMATPROC, glVertexArrayAttribFormat)                         \
     DO(::PFNGLNAMEDBUFFERSUBDATAPROC, glNamedBufferSubData)                                   \
+    DO(::PFNGLCOPYNAMEDBUFFERSUBDATAPROC, glCopyNamedBufferSubData)                           \
     DO(::PFNGLVERTEXARRAYELEMENTBUFFERPROC, glVertexArrayElementBuffer)                       \
     DO(::PFNGLVERTEXARRAYATTRIBBINDINGPROC, glVertexArrayAttribBinding)                       \
     DO(::PFNGLBINDBUFFERBASEPROC, glBindBufferBase)                                           \
@@ -94,11 +95,16 @@
     DO(::PFNGLVALIDATEPROGRAMPROC, glValidateProgram)                                         \
     DO(::PFNGLMULTIDRAWARRAYSINDIRECTPROC, glMultiDrawArraysIndirect)                         \
     DO(::PFNGLMULTIDRAWELEMENTSINDIRECTPROC, glMultiDrawElementsIndirect)                     \
+    DO(::PFNGLMULTIDRAWELEMENTSINDIRECTCOUNTPROC, glMultiDrawElementsIndirectCount)           \
     DO(::PFNGLMAPNAMEDBUFFERRANGEPROC, glMapNamedBufferRange)                                 \
     DO(::PFNGLDISPATCHCOMPUTEPROC, glDispatchCompute)                                         \
     DO(::PFNGLMEMORYBARRIERPROC, glMemoryBarrier)                                             \
+    DO(::PFNGLBINDIMAGETEXTUREPROC, glBindImageTexture)                                       \
     DO(::PFNGLGETNAMEDBUFFERSUBDATAPROC, glGetNamedBufferSubData)                             \
-    DO(::PFNGLUNMAPNAMEDBUFFERPROC, glUnmapNamedBuffer)
+    DO(::PFNGLUNMAPNAMEDBUFFERPROC, glUnmapNamedBuffer)                                       \
+    DO(::PFNGLFENCESYNCPROC, glFenceSync)                                                     \
+    DO(::PFNGLCLIENTWAITSYNCPROC, glClientWaitSync)                                           \
+    DO(::PFNGLDELETESYNCPROC, glDeleteSync)
 
 #define DO_INLINE(TYPE, NAME) inline TYPE NAME;
 FOR_OPENGL_FUNCTIONS(DO_INLINE)
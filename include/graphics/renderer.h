@@ -1,16 +1,22 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 
 #include "core/scene.h"
 #include "graphics/command_buffer.h"
+#include "graphics/culling.h"
 #include "graphics/frame_buffer.h"
+#include "graphics/gpu_fence.h"
+#include "graphics/gpu_scene.h"
+#include "graphics/instance_culling.h"
 #include "graphics/mesh_manager.h"
 #include "graphics/multi_buffer.h"
 #include "graphics/opengl.h"
 #include "graphics/persistent_buffer.h"
 #include "graphics/program.h"
 #include "graphics/sampler.h"
+#include "graphics/texture.h"
 #include "graphics/texture_manager.h"
 #include "resources/resource_loader.h"
 #include "utils/auto_release.h"
@@ -62,13 +68,18 @@ namespace ufps
         CommandBuffer _forward_transparancy_command_buffer;
         CommandBuffer _post_processing_command_buffer;
         Entity _post_process_sprite;
-        MultiBuffer<PersistentBuffer> _camera_buffer;
-        MultiBuffer<PersistentBuffer> _light_buffer;
-        MultiBuffer<PersistentBuffer> _object_data_buffer;
-        MultiBuffer<PersistentBuffer> _transparent_object_data_buffer;
+        MultiBuffer<PersistentBuffer, 3zu, GpuFence> _camera_buffer;
+        MultiBuffer<PersistentBuffer, 3zu, GpuFence> _light_buffer;
         Buffer _luminance_histogram_buffer;
         Buffer _average_luminance_buffer;
         Buffer _ssao_samples_buffer;
+        Buffer _gpu_command_buffer;
+        Buffer _draw_count_buffer;
+        Buffer _frustum_planes_buffer;
+        Buffer _visibility_buffer;
+        Buffer _light_grid_buffer;
+        Buffer _light_index_buffer;
+        GpuScene _gpu_scene;
         Program _gbuffer_program;
         Program _light_pass_program;
         Program _forward_transparancy_program;
@@ -81,9 +92,15 @@ namespace ufps
         Program _bloom_downsample_program;
         Program _bloom_upsample_program;
         Program _bloom_mix_program;
+        Program _frustum_cull_program;
+        Program _cluster_cull_program;
+        Program _hiz_build_program;
+        Program _light_cull_program;
         Sampler _ssao_noise_sampler;
         std::uint64_t _ssao_noise_texture_bindless_handle;
         Sampler _fb_sampler;
+        Sampler _hiz_sampler;
+        Texture _hiz_texture;
         RenderTarget _gbuffer_rt;
         RenderTarget _light_pass_rt;
         RenderTarget _forward_transparancy_rt;
@@ -94,9 +111,20 @@ namespace ufps
         std::vector<RenderTarget> _bloom_mips;
         RenderTarget _bloom_rt;
         FrameBuffer *_final_fb;
+        CullingStats _opaque_culling_stats;
+        CullingStats _transparent_culling_stats;
+
+        // cpu time the last frame spent waiting for the gpu to finish with the per frame buffers it reuses
+        std::chrono::nanoseconds _fence_wait;
 
     private:
+        auto update_gpu_scene(Scene &scene) -> void;
+        auto execute_gpu_culling_pass(Scene &scene, EntityFilterMode filter_mode, CullingPhase phase) -> void;
+        auto execute_hiz_pass() -> void;
         auto execute_gbuffer_pass(Scene &scene) -> void;
+        auto execute_gpu_driven_gbuffer_pass(Scene &scene) -> void;
+        auto draw_gpu_culled(Scene &scene) -> void;
+        auto execute_light_culling_pass(Scene &scene) -> void;
         auto execute_lighting_pass(Scene &scene) -> void;
         auto execute_bloom_pass(Scene &scene) -> void;
         auto execute_forward_transparancy_pass(Scene &scene) -> void;
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <optional>
+
+namespace ufps
+{
+    // the offset bookkeeping behind StagingRing, free of gl so it can be tested on its own
+    // allocations are taken from the head of the ring, close_region() groups everything allocated since the last call
+    // into a region that stays in use until release_oldest(), regions are released in the order they were closed
+    class RingAllocator
+    {
+    public:
+        explicit RingAllocator(std::size_t size);
+
+        // the offset of size bytes aligned to alignment, or nullopt if they only fit once the oldest region has been
+        // released, size must not be larger than the ring
+        auto allocate(std::size_t size, std::size_t alignment) -> std::optional<std::size_t>;
+
+        // false if nothing was allocated since the last close, so there is no region to fence
+        auto close_region() -> bool;
+
+        auto release_oldest() -> void;
+
+        auto size() const -> std::size_t;
+
+        // bytes held by closed and open regions, including padding skipped for alignment and at the end of the ring
+        auto used() const -> std::size_t;
+
+        auto region_count() const -> std::size_t;
+
+    private:
+        std::size_t _size;
+        std::size_t _head;
+        std::size_t _used;
+        std::size_t _open;
+        std::deque<std::size_t> _regions;
+    };
+
+    // the capacity a device buffer has to grow to to hold required bytes, doubling so a run of appends only reallocates
+    // (and copies) a logarithmic number of times
+    constexpr auto grown_capacity(std::size_t capacity, std::size_t required) -> std::size_t
+    {
+        auto grown = capacity == 0zu ? 1zu : capacity;
+        while (grown < required)
+        {
+            grown *= 2zu;
+        }
+
+        return grown;
+    }
+}
@@ -11,6 +11,7 @@ namespace ufps
     enum class FilterType
     {
         LINEAR_MIPMAP,
+        NEAREST_MIPMAP,
         LINEAR,
         NEAREST
     };
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <string_view>
+
+#include "graphics/opengl.h"
+#include "graphics/persistent_buffer.h"
+#include "graphics/ring_allocator.h"
+#include "utils/data_buffer.h"
+
+namespace ufps
+{
+    // a persistently mapped buffer used as a ring of upload staging memory
+    // data is copied in with write(), the gpu reads it with commands issued against native_handle() at the returned
+    // offset, and fence() then marks everything written so far as in flight, a later write that would overwrite memory
+    // still in flight waits for the gpu to be done with it
+    class StagingRing
+    {
+    public:
+        StagingRing(std::size_t size, std::string_view name);
+        ~StagingRing();
+
+        StagingRing(const StagingRing &) = delete;
+        auto operator=(const StagingRing &) -> StagingRing & = delete;
+
+        // returns the offset the data was written to, data must fit in the ring
+        auto write(DataBufferView data, std::size_t alignment = 16zu) -> std::size_t;
+
+        auto fence() -> void;
+
+        auto native_handle() const -> ::GLuint;
+        auto size() const -> std::size_t;
+
+    private:
+        auto retire_oldest() -> void;
+
+        PersistentBuffer _buffer;
+        RingAllocator _allocator;
+
+        // one per region closed in _allocator, oldest first
+        std::deque<::GLsync> _in_flight;
+    };
+}
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 
 #include "graphics/opengl.h"
 #include "graphics/sampler.h"
+#include "graphics/staging_ring.h"
 #include "graphics/texture_data.h"
 #include "utils/auto_release.h"
 
@@ -13,6 +15,9 @@ namespace ufps
     {
     public:
         Texture(const TextureData &texture, const std::string &name, const Sampler &sampler);
+
+        // uploads the pixels from offset in the staging ring instead of from texture.data
+        Texture(const TextureData &texture, const std::string &name, const Sampler &sampler, const StagingRing &staging, std::size_t offset);
         ~Texture();
         Texture(Texture &&) = default;
         auto operator=(Texture &&) -> Texture & = default;
@@ -26,6 +31,8 @@ namespace ufps
         auto height() const -> std::uint32_t;
 
     private:
+        Texture(const TextureData &texture, const std::string &name, const Sampler &sampler, ::GLuint unpack_buffer, const void *pixels);
+
         AutoRelease<::GLuint> _handle;
         ::GLuint64 _bindless_handle;
         std::string _name;
@@ -18,6 +18,7 @@ namespace ufps
         SRGBA,
         RGB16F,
         RGBA16F,
+        R32F,
         DEPTH24,
         BC5U,
         BC7,
@@ -31,6 +32,7 @@ namespace ufps
         TextureFormat format;
         std::optional<DataBuffer> data;
         bool is_compressed;
+        std::uint32_t mip_levels = 1u;
     };
 
     inline auto to_string(TextureFormat obj) -> std::string
@@ -54,6 +56,8 @@ namespace ufps
             return "RGB16F";
         case RGBA16F:
             return "RGB16AF";
+        case R32F:
+            return "R32F";
         case DEPTH24:
             return "DEPTH24";
         case BC5U:
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+
+#include "concurrency/thread_pool.h"
+#include "core/manifest_descriptions.h"
+#include "graphics/sampler.h"
+#include "graphics/staging_ring.h"
+#include "graphics/texture_manager.h"
+#include "graphics/texture_streamer.h"
+#include "resources/pack.h"
+
+namespace ufps
+{
+    inline constexpr auto texture_staging_size = 64zu * 1024zu * 1024zu;
+
+    // decodes textures on the thread pool while the calling (gl) thread uploads each one through a staging ring as soon
+    // as it is ready
+    class TextureLoader
+    {
+    public:
+        explicit TextureLoader(ThreadPool &pool, std::size_t staging_size = texture_staging_size);
+
+        // every texture in the manifest is added to the texture manager in one go, in manifest order
+        auto load(const Pack &pack, const TextureManifestDescription &manifest, TextureManager &texture_manager, const Sampler &sampler) -> void;
+
+        // as above but textures larger than the streaming tail are only loaded down to it and handed to streamer
+        auto load(
+            const Pack &pack,
+            const TextureManifestDescription &manifest,
+            TextureManager &texture_manager,
+            const Sampler &sampler,
+            TextureStreamer &streamer) -> void;
+
+    private:
+        auto load(
+            const Pack &pack,
+            const TextureManifestDescription &manifest,
+            TextureManager &texture_manager,
+            const Sampler &sampler,
+            TextureStreamer *streamer) -> void;
+
+        ThreadPool &_pool;
+        StagingRing _staging;
+    };
+}
@@ -1,22 +1,34 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
-#include <deque>
+#include <optional>
+#include <string_view>
+#include <vector>
 
 #include "graphics/buffer.h"
 #include "graphics/opengl.h"
 #include "graphics/texture.h"
+#include "graphics/texture_registry.h"
 
 namespace ufps
 {
+    inline constexpr auto texture_manager_default_capacity = 1024zu;
+
     class TextureManager
     {
     public:
-        TextureManager();
+        // room for capacity bindless handles is reserved up front, beyond that the gpu buffer doubles
+        explicit TextureManager(std::size_t capacity = texture_manager_default_capacity);
 
+        // outside of a batch every add is uploaded straight away
         auto add(Texture texture) -> std::uint32_t;
         auto add(std::vector<Texture> textures) -> std::uint32_t;
 
+        // adds until commit() are uploaded together, as one write of just the handles added
+        auto begin_batch() -> void;
+        auto commit() -> void;
+
         auto native_handle() -> ::GLuint;
 
         auto texture(const std::uint32_t indiex) const -> const Texture *;
@@ -26,9 +38,21 @@ namespace ufps
         auto texture_index(std::string_view name) const -> std::uint32_t;
         auto textures(const std::vector<std::uint32_t> &indices) const -> std::vector<const Texture *>;
 
+        // has shaders sample bindless_handle in place of texture index, e.g. a streamed in texture with more mips
+        auto redirect(std::uint32_t index, std::uint64_t bindless_handle) -> void;
+
+        // the handle to sample for a texture's own handle, which is what entities hold
+        auto resolve(std::uint64_t bindless_handle) const -> std::uint64_t;
+
+        // bumped on every redirect, anything built from resolved handles is stale
+        auto revision() const -> std::uint32_t;
+
     private:
+        auto upload() -> void;
+
         Buffer _gpu_buffer;
-        std::vector<::GLuint64> _cpu_buffer;
-        std::deque<Texture> _textures;
+        TextureRegistry<Texture> _registry;
+        bool _in_batch;
+        std::uint32_t _revision;
     };
-}
\ No newline at end of file
+}
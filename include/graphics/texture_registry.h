@@ -0,0 +1,155 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "utils/ensure.h"
+#include "utils/string_unordered_map.h"
+
+namespace ufps
+{
+    namespace impl
+    {
+        template <class T>
+        concept RegistrableTexture = std::movable<T> && requires(const T t) {
+            { t.name() } -> std::convertible_to<std::string_view>;
+            { t.bindless_handle() } -> std::convertible_to<std::uint64_t>;
+        };
+    }
+
+    // owns textures in the order they were added along with a flat array of their bindless handles, as read by shaders,
+    // and finds either by name or by handle without a scan
+    // handles added since the last clear_pending() are the pending range, which is all that needs uploading
+    template <impl::RegistrableTexture T>
+    class TextureRegistry
+    {
+    public:
+        auto reserve(std::size_t capacity) -> void;
+
+        // if the name is already taken lookups by name keep finding the first texture
+        auto add(T texture) -> std::uint32_t;
+
+        auto size() const -> std::uint32_t;
+        auto texture(std::uint32_t index) const -> const T *;
+        auto try_get_index(std::string_view name) const -> std::optional<std::uint32_t>;
+        auto try_get_index(std::uint64_t bindless_handle) const -> std::optional<std::uint32_t>;
+
+        auto handles() const -> const std::vector<std::uint64_t> &;
+
+        // points the handle shaders read for index elsewhere, lookups by handle keep using the texture's own handle
+        auto set_handle(std::uint32_t index, std::uint64_t bindless_handle) -> void;
+
+        // the first index not yet uploaded, equal to size() when nothing is pending
+        auto pending_first() const -> std::uint32_t;
+        auto mark_all_pending() -> void;
+        auto clear_pending() -> void;
+
+    private:
+        // a deque so textures handed out by pointer never move
+        std::deque<T> _textures;
+        std::vector<std::uint64_t> _handles;
+        StringUnorderedMap<std::uint32_t> _name_lookup;
+        std::unordered_map<std::uint64_t, std::uint32_t> _handle_lookup;
+        std::uint32_t _pending_first = 0u;
+    };
+
+    template <impl::RegistrableTexture T>
+    auto TextureRegistry<T>::reserve(std::size_t capacity) -> void
+    {
+        _handles.reserve(capacity);
+        _name_lookup.reserve(capacity);
+        _handle_lookup.reserve(capacity);
+    }
+
+    template <impl::RegistrableTexture T>
+    auto TextureRegistry<T>::add(T texture) -> std::uint32_t
+    {
+        const auto index = size();
+        const auto &new_texture = _textures.emplace_back(std::move(texture));
+
+        _handles.push_back(new_texture.bindless_handle());
+        _name_lookup.emplace(new_texture.name(), index);
+        _handle_lookup.emplace(new_texture.bindless_handle(), index);
+
+        return index;
+    }
+
+    template <impl::RegistrableTexture T>
+    auto TextureRegistry<T>::size() const -> std::uint32_t
+    {
+        return static_cast<std::uint32_t>(_textures.size());
+    }
+
+    template <impl::RegistrableTexture T>
+    auto TextureRegistry<T>::texture(std::uint32_t index) const -> const T *
+    {
+        expect(index < _textures.size(), "texture index {} out of range", index);
+
+        return std::addressof(_textures[index]);
+    }
+
+    template <impl::RegistrableTexture T>
+    auto TextureRegistry<T>::try_get_index(std::string_view name) const -> std::optional<std::uint32_t>
+    {
+        const auto iter = _name_lookup.find(name);
+        if (iter == std::ranges::cend(_name_lookup))
+        {
+            return std::nullopt;
+        }
+
+        return iter->second;
+    }
+
+    template <impl::RegistrableTexture T>
+    auto TextureRegistry<T>::try_get_index(std::uint64_t bindless_handle) const -> std::optional<std::uint32_t>
+    {
+        const auto iter = _handle_lookup.find(bindless_handle);
+        if (iter == std::ranges::cend(_handle_lookup))
+        {
+            return std::nullopt;
+        }
+
+        return iter->second;
+    }
+
+    template <impl::RegistrableTexture T>
+    auto TextureRegistry<T>::handles() const -> const std::vector<std::uint64_t> &
+    {
+        return _handles;
+    }
+
+    template <impl::RegistrableTexture T>
+    auto TextureRegistry<T>::set_handle(std::uint32_t index, std::uint64_t bindless_handle) -> void
+    {
+        expect(index < _handles.size(), "texture index {} out of range", index);
+
+        _handles[index] = bindless_handle;
+        _pending_first = std::min(_pending_first, index);
+    }
+
+    template <impl::RegistrableTexture T>
+    auto TextureRegistry<T>::pending_first() const -> std::uint32_t
+    {
+        return _pending_first;
+    }
+
+    template <impl::RegistrableTexture T>
+    auto TextureRegistry<T>::mark_all_pending() -> void
+    {
+        _pending_first = 0u;
+    }
+
+    template <impl::RegistrableTexture T>
+    auto TextureRegistry<T>::clear_pending() -> void
+    {
+        _pending_first = size();
+    }
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "concurrency/thread_pool.h"
+#include "core/scene.h"
+#include "graphics/sampler.h"
+#include "graphics/staging_ring.h"
+#include "graphics/texture.h"
+#include "graphics/texture_data.h"
+#include "graphics/texture_manager.h"
+#include "graphics/texture_streaming.h"
+#include "resources/pack.h"
+
+namespace ufps
+{
+    inline constexpr auto texture_streaming_default_budget = 512zu * 1024zu * 1024zu;
+    inline constexpr auto texture_streaming_staging_size = 32zu * 1024zu * 1024zu;
+
+    // at most this many detail textures are decoded at once, the rest wait for a later frame
+    inline constexpr auto texture_streaming_max_loads = 4u;
+
+    namespace impl
+    {
+        struct StreamingState;
+    }
+
+    // keeps the finer mips of textures resident only while something on screen needs them
+    // every streamed texture is registered with the texture manager holding just its tail mips, whose handle is what
+    // entities keep, and a detail texture with more mips is decoded on the thread pool and redirected to once uploaded
+    class TextureStreamer
+    {
+    public:
+        TextureStreamer(
+            ThreadPool &pool,
+            const Pack &pack,
+            TextureManager &texture_manager,
+            const Sampler &sampler,
+            std::size_t budget = texture_streaming_default_budget);
+        ~TextureStreamer();
+
+        TextureStreamer(const TextureStreamer &) = delete;
+        auto operator=(const TextureStreamer &) -> TextureStreamer & = delete;
+
+        // texture is the full packed chain as described by its header, index is where its tail is in the texture manager
+        auto add(const std::string &name, bool is_srgb, std::uint32_t index, const TextureData &texture, std::uint32_t tail_mip) -> void;
+
+        // asks for the mips a texture covering extent pixels on screen needs this frame, the finest ask wins
+        auto request(std::uint64_t bindless_handle, float extent) -> void;
+
+        // requests for every texture of every entity in view of the scene camera
+        auto request(const Scene &scene) -> void;
+
+        // once a frame on the gl thread, uploads finished loads, frees retired textures and starts new loads
+        auto update() -> void;
+
+        auto resident_bytes() const -> std::size_t;
+
+    private:
+        struct Streamed
+        {
+            std::string name;
+            bool is_srgb;
+            std::uint32_t index;
+            StreamedTexture state;
+            std::optional<Texture> detail;
+            std::optional<std::uint32_t> loading_mip;
+            bool failed;
+        };
+
+        struct Retired
+        {
+            Texture texture;
+            std::uint64_t frame;
+        };
+
+        auto install(std::uint32_t streamed_index, std::uint32_t first_mip, const TextureData &texture) -> void;
+        auto retire(Streamed &streamed) -> void;
+
+        ThreadPool &_pool;
+        const Pack &_pack;
+        TextureManager &_texture_manager;
+        const Sampler &_sampler;
+        std::size_t _budget;
+        StagingRing _staging;
+        std::vector<Streamed> _streamed;
+        std::unordered_map<std::uint64_t, std::uint32_t> _handle_lookup;
+        std::vector<Retired> _retired;
+        std::shared_ptr<impl::StreamingState> _state;
+        std::vector<std::uint32_t> _free_slots;
+        std::uint64_t _frame;
+    };
+}
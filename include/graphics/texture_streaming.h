@@ -0,0 +1,136 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <vector>
+
+#include "graphics/mip_chain.h"
+#include "graphics/texture_data.h"
+
+namespace ufps
+{
+    // streamed textures always keep the mips at or below this size resident
+    inline constexpr auto texture_streaming_tail_size = 256u;
+
+    // what the streamer knows about one texture, mips are numbered as in the full packed chain
+    // tail_mip is the first always resident mip, a resident_mip equal to it means there is no detail texture
+    struct StreamedTexture
+    {
+        TextureFormat format;
+        std::uint32_t width;
+        std::uint32_t height;
+        std::uint32_t mip_levels;
+        std::uint32_t tail_mip;
+        std::uint32_t resident_mip;
+        std::uint32_t desired_mip;
+    };
+
+    // make texture index hold mips from first_mip, a first_mip equal to its tail_mip means drop the detail texture
+    struct MipChange
+    {
+        std::uint32_t index;
+        std::uint32_t first_mip;
+
+        constexpr auto operator==(const MipChange &) const -> bool = default;
+    };
+
+    // the first mip no larger than max_size in either dimension
+    constexpr auto first_mip_within(std::uint32_t width, std::uint32_t height, std::uint32_t mip_levels, std::uint32_t max_size) -> std::uint32_t
+    {
+        auto mip = 0u;
+        while (mip + 1u < mip_levels && std::max(width >> mip, height >> mip) > max_size)
+        {
+            ++mip;
+        }
+
+        return mip;
+    }
+
+    // height in pixels of a sphere of radius seen from distance with a vertical fov in radians
+    inline auto screen_extent(float radius, float distance, float fov, float viewport_height) -> float
+    {
+        if (distance <= radius)
+        {
+            return viewport_height;
+        }
+
+        return std::min(radius / (distance * std::tan(fov / 2.f)) * viewport_height, viewport_height);
+    }
+
+    // the coarsest mip that still has at least one texel per pixel when the texture covers extent pixels
+    inline auto desired_mip(std::uint32_t width, std::uint32_t height, std::uint32_t mip_levels, float extent) -> std::uint32_t
+    {
+        const auto size = static_cast<float>(std::max(width, height));
+        const auto mip = std::floor(std::log2(size / std::max(extent, 1.f)));
+
+        return std::min(static_cast<std::uint32_t>(std::max(mip, 0.f)), mip_levels - 1u);
+    }
+
+    // bytes a detail texture holding mips [first_mip, mip_levels) needs, nothing if it would not be finer than the tail
+    constexpr auto detail_size(const StreamedTexture &texture, std::uint32_t first_mip) -> std::size_t
+    {
+        if (first_mip >= texture.tail_mip)
+        {
+            return 0zu;
+        }
+
+        const auto chain = mip_chain(texture.format, texture.width, texture.height, texture.mip_levels);
+        return chain.back().offset + chain.back().size - chain[first_mip].offset;
+    }
+
+    // picks the mips every texture should hold so detail textures fit in budget bytes, textures missing the most mips
+    // are served first and the rest get the finest mip that still fits
+    // drops come before loads so memory is given back before more is asked for
+    inline auto plan_mip_changes(std::span<const StreamedTexture> textures, std::size_t budget) -> std::vector<MipChange>
+    {
+        const auto missing = [&](std::uint32_t i)
+        {
+            const auto &texture = textures[i];
+            return texture.tail_mip - std::min(texture.desired_mip, texture.tail_mip);
+        };
+
+        auto order = std::vector<std::uint32_t>(textures.size());
+        std::iota(std::ranges::begin(order), std::ranges::end(order), 0u);
+        std::ranges::stable_sort(order, [&](auto a, auto b) { return missing(a) > missing(b); });
+
+        auto drops = std::vector<MipChange>{};
+        auto loads = std::vector<MipChange>{};
+        auto remaining = budget;
+
+        for (const auto i : order)
+        {
+            const auto &texture = textures[i];
+
+            // a texture holding just one mip finer than it needs keeps it, stops textures flickering between two mips
+            auto target = std::min(texture.desired_mip, texture.tail_mip);
+            if (target == texture.resident_mip + 1u && target != texture.tail_mip)
+            {
+                target = texture.resident_mip;
+            }
+
+            while (target < texture.tail_mip && detail_size(texture, target) > remaining)
+            {
+                ++target;
+            }
+
+            remaining -= detail_size(texture, target);
+
+            if (target > texture.resident_mip)
+            {
+                drops.push_back({.index = i, .first_mip = target});
+            }
+            else if (target < texture.resident_mip)
+            {
+                loads.push_back({.index = i, .first_mip = target});
+            }
+        }
+
+        drops.append_range(loads);
+
+        return drops;
+    }
+}
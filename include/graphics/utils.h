@@ -36,9 +36,9 @@ namespace ufps
             }
 
             ufps::log::info("growing {} buffer {} -> {}", gpu_buffer.name(), gpu_buffer.size(), new_size);
-            // opengl barrier in case gpu using previous frame
-            ::glFinish();
 
+            // no need to wait for the gpu, gl only deletes the old buffer once the commands using it are done and
+            // nothing has read the new one yet
             gpu_buffer = Buffer{new_size, gpu_buffer.name()};
         }
     }
@@ -46,6 +46,9 @@ namespace ufps
     auto load_texture(ResourceLoader &resource_loader, std::string id, bool is_srgb) -> TextureData;
     auto load_texture(DataBufferView image_data, bool is_srgb) -> TextureData;
 
+    // a DDS with a DX10 header holding every mip of texture, which must be in a format DDS can describe
+    auto encode_dds(const TextureData &texture) -> DataBuffer;
+
     auto load_model(std::string file_name, DataBufferView model_data, std::string format = "") -> std::tuple<std::string, std::vector<ModelData>>;
 
     template <class... Args>
@@ -0,0 +1,380 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "math/aabb.h"
+#include "math/ray.h"
+#include "math/ray_packet.h"
+#include "math/triangle.h"
+#include "math/utils.h"
+#include "math/vector3.h"
+#include "utils/ensure.h"
+
+namespace ufps
+{
+    namespace impl
+    {
+        constexpr auto empty_aabb() -> AABB
+        {
+            return {.min = {std::numeric_limits<float>::max()}, .max = {std::numeric_limits<float>::lowest()}};
+        }
+
+        constexpr auto merge(const AABB &a, const AABB &b) -> AABB
+        {
+            return {
+                .min = {std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z)},
+                .max = {std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z)}};
+        }
+
+        constexpr auto component(const Vector3 &v, std::uint32_t axis) -> float
+        {
+            return axis == 0u ? v.x : axis == 1u ? v.y
+                                                 : v.z;
+        }
+    }
+
+    // a leaf references count primitives starting at first, an interior node has a count of 0 and its children at first
+    // and first + 1
+    struct BvhNode
+    {
+        AABB aabb;
+        std::uint32_t first;
+        std::uint32_t count;
+    };
+
+    class Bvh
+    {
+    public:
+        static constexpr auto max_leaf_size = 4u;
+
+        constexpr Bvh();
+        constexpr explicit Bvh(std::span<const AABB> bounds);
+
+        // recomputes the node bounds for moved primitives but keeps the tree, quality degrades the further things move
+        constexpr auto refit(std::span<const AABB> bounds) -> void;
+
+        // intersect_primitive(primitive_index, max_distance) -> std::optional<float> is called for every primitive in a leaf
+        // the ray reaches, nodes further away than the closest hit so far are skipped
+        template <class F>
+        constexpr auto intersect(const Ray &ray, float max_distance, F &&intersect_primitive) const -> std::optional<float>;
+
+        // same traversal as intersect but intersect_leaf(node_index, max_distance) -> std::optional<float> is called once per
+        // leaf, for callers that test a whole leaf at a time
+        template <class F>
+        constexpr auto intersect_leaves(const Ray &ray, float max_distance, F &&intersect_leaf) const -> std::optional<float>;
+
+        constexpr auto nodes() const -> std::span<const BvhNode>;
+        constexpr auto primitives() const -> std::span<const std::uint32_t>;
+
+    private:
+        std::vector<BvhNode> _nodes;
+        std::vector<std::uint32_t> _primitives;
+    };
+
+    // bottom level structure over the triangles of a single mesh, in object space
+    // the triangles of each leaf are stored as packets so a leaf is tested with one batched intersection per packet
+    class Blas
+    {
+    public:
+        static constexpr auto packet_size = 4zu;
+
+        explicit Blas(std::vector<Triangle> triangles);
+
+        auto intersect(const Ray &ray, float max_distance = std::numeric_limits<float>::infinity()) const -> std::optional<float>;
+
+        constexpr auto aabb() const -> AABB;
+        constexpr auto triangle_count() const -> std::size_t;
+
+    private:
+        std::size_t _triangle_count;
+        Bvh _bvh;
+        std::vector<TrianglePacket<packet_size>> _packets;
+        // index of the first packet of every leaf node, unused for interior nodes
+        std::vector<std::uint32_t> _leaf_packets;
+    };
+
+    constexpr Bvh::Bvh()
+        : _nodes{},
+          _primitives{}
+    {
+    }
+
+    constexpr Bvh::Bvh(std::span<const AABB> bounds)
+        : _nodes{},
+          _primitives{std::views::iota(0u, static_cast<std::uint32_t>(bounds.size())) | std::ranges::to<std::vector>()}
+    {
+        if (bounds.empty())
+        {
+            return;
+        }
+
+        const auto centres = bounds |
+                             std::views::transform([](const auto &aabb) { return (aabb.min + aabb.max) * .5f; }) |
+                             std::ranges::to<std::vector>();
+
+        _nodes.push_back({.aabb = {}, .first = 0u, .count = static_cast<std::uint32_t>(bounds.size())});
+
+        // split on the median centre along the widest axis until leaves are small enough
+        auto pending = std::vector<std::uint32_t>{0u};
+        while (!pending.empty())
+        {
+            const auto index = pending.back();
+            pending.pop_back();
+
+            const auto node = _nodes[index];
+            if (node.count <= max_leaf_size)
+            {
+                continue;
+            }
+
+            const auto node_primitives = std::span{_primitives}.subspan(node.first, node.count);
+
+            auto centre_bounds = impl::empty_aabb();
+            for (const auto primitive : node_primitives)
+            {
+                centre_bounds = impl::merge(centre_bounds, {.min = centres[primitive], .max = centres[primitive]});
+            }
+
+            const auto extent = centre_bounds.max - centre_bounds.min;
+            const auto axis = extent.x > extent.y ? (extent.x > extent.z ? 0u : 2u) : (extent.y > extent.z ? 1u : 2u);
+
+            // every centre is in the same place so there is nothing to split on
+            if (impl::component(extent, axis) <= 0.f)
+            {
+                continue;
+            }
+
+            const auto left_count = node.count / 2u;
+            std::ranges::nth_element(
+                node_primitives,
+                std::ranges::begin(node_primitives) + left_count,
+                std::ranges::less{},
+                [&centres, axis](const auto primitive) { return impl::component(centres[primitive], axis); });
+
+            const auto left = static_cast<std::uint32_t>(_nodes.size());
+            _nodes.push_back({.aabb = {}, .first = node.first, .count = left_count});
+            _nodes.push_back({.aabb = {}, .first = node.first + left_count, .count = node.count - left_count});
+            _nodes[index].first = left;
+            _nodes[index].count = 0u;
+
+            pending.push_back(left);
+            pending.push_back(left + 1u);
+        }
+
+        refit(bounds);
+    }
+
+    constexpr auto Bvh::refit(std::span<const AABB> bounds) -> void
+    {
+        expect(bounds.size() == _primitives.size(), "bvh built with {} primitives, refit with {}", _primitives.size(), bounds.size());
+
+        // children are always after their parent so walking backwards visits them first
+        for (auto &node : std::views::reverse(_nodes))
+        {
+            if (node.count == 0u)
+            {
+                node.aabb = impl::merge(_nodes[node.first].aabb, _nodes[node.first + 1u].aabb);
+                continue;
+            }
+
+            node.aabb = impl::empty_aabb();
+            for (const auto primitive : std::span{_primitives}.subspan(node.first, node.count))
+            {
+                node.aabb = impl::merge(node.aabb, bounds[primitive]);
+            }
+        }
+    }
+
+    template <class F>
+    constexpr auto Bvh::intersect(const Ray &ray, float max_distance, F &&intersect_primitive) const -> std::optional<float>
+    {
+        return intersect_leaves(
+            ray,
+            max_distance,
+            [this, &intersect_primitive](const auto index, float leaf_max_distance)
+            {
+                auto closest = std::optional<float>{};
+                const auto &node = _nodes[index];
+
+                for (const auto primitive : std::span{_primitives}.subspan(node.first, node.count))
+                {
+                    if (const auto hit = intersect_primitive(primitive, leaf_max_distance); hit && *hit < leaf_max_distance)
+                    {
+                        leaf_max_distance = *hit;
+                        closest = hit;
+                    }
+                }
+
+                return closest;
+            });
+    }
+
+    template <class F>
+    constexpr auto Bvh::intersect_leaves(const Ray &ray, float max_distance, F &&intersect_leaf) const -> std::optional<float>
+    {
+        auto closest = std::optional<float>{};
+
+        if (_nodes.empty())
+        {
+            return closest;
+        }
+
+        const auto node_distance = [&ray](const BvhNode &node)
+        {
+            const auto distance = ufps::intersect(ray, node.aabb);
+            return distance ? std::max(*distance, 0.f) : std::numeric_limits<float>::infinity();
+        };
+
+        // median splits keep the depth at log2 of the primitive count, so this is plenty
+        auto pending = std::array<std::pair<std::uint32_t, float>, 64u>{};
+        auto pending_count = 0zu;
+
+        if (const auto distance = node_distance(_nodes.front()); distance < max_distance)
+        {
+            pending[pending_count++] = {0u, distance};
+        }
+
+        while (pending_count != 0zu)
+        {
+            const auto [index, distance] = pending[--pending_count];
+
+            // a closer hit may have been found since this node was pushed
+            if (distance >= max_distance)
+            {
+                continue;
+            }
+
+            const auto &node = _nodes[index];
+
+            if (node.count != 0u)
+            {
+                if (const auto hit = intersect_leaf(index, max_distance); hit && *hit < max_distance)
+                {
+                    max_distance = *hit;
+                    closest = hit;
+                }
+
+                continue;
+            }
+
+            auto closer = std::pair{node.first, node_distance(_nodes[node.first])};
+            auto further = std::pair{node.first + 1u, node_distance(_nodes[node.first + 1u])};
+            if (further.second < closer.second)
+            {
+                std::swap(closer, further);
+            }
+
+            // push the further child first so the closer one is visited next
+            if (further.second < max_distance)
+            {
+                pending[pending_count++] = further;
+            }
+
+            if (closer.second < max_distance)
+            {
+                pending[pending_count++] = closer;
+            }
+        }
+
+        return closest;
+    }
+
+    constexpr auto Bvh::nodes() const -> std::span<const BvhNode>
+    {
+        return _nodes;
+    }
+
+    constexpr auto Bvh::primitives() const -> std::span<const std::uint32_t>
+    {
+        return _primitives;
+    }
+
+    inline Blas::Blas(std::vector<Triangle> triangles)
+        : _triangle_count{triangles.size()},
+          _bvh{},
+          _packets{},
+          _leaf_packets{}
+    {
+        const auto bounds = triangles |
+                            std::views::transform(
+                                [](const auto &triangle)
+                                {
+                                    return impl::merge(
+                                        impl::merge({.min = triangle.v0, .max = triangle.v0}, {.min = triangle.v1, .max = triangle.v1}),
+                                        {.min = triangle.v2, .max = triangle.v2});
+                                }) |
+                            std::ranges::to<std::vector>();
+
+        _bvh = Bvh{bounds};
+        _leaf_packets.resize(_bvh.nodes().size());
+
+        // leaves are usually max_leaf_size triangles but can be bigger if every centre is in the same place
+        for (const auto &[index, node] : std::views::enumerate(_bvh.nodes()))
+        {
+            if (node.count == 0u)
+            {
+                continue;
+            }
+
+            _leaf_packets[index] = static_cast<std::uint32_t>(_packets.size());
+
+            const auto leaf_triangles = _bvh.primitives().subspan(node.first, node.count) |
+                                        std::views::transform([&triangles](const auto primitive) { return triangles[primitive]; }) |
+                                        std::ranges::to<std::vector>();
+
+            for (const auto &chunk : std::views::chunk(leaf_triangles, packet_size))
+            {
+                _packets.push_back(create_triangle_packet<packet_size>(std::span{chunk}));
+            }
+        }
+    }
+
+    inline auto Blas::intersect(const Ray &ray, float max_distance) const -> std::optional<float>
+    {
+        return _bvh.intersect_leaves(
+            ray,
+            max_distance,
+            [this, &ray](const auto index, float leaf_max_distance)
+            {
+                auto closest = std::optional<float>{};
+
+                const auto count = (_bvh.nodes()[index].count + packet_size - 1zu) / packet_size;
+                for (const auto &packet : std::span{_packets}.subspan(_leaf_packets[index], count))
+                {
+                    const auto hits = ufps::intersect(ray, packet);
+
+                    for (auto mask = hits.mask; mask != 0u; mask &= mask - 1u)
+                    {
+                        const auto distance = hits.distance[std::countr_zero(mask)];
+                        if (distance < leaf_max_distance)
+                        {
+                            leaf_max_distance = distance;
+                            closest = distance;
+                        }
+                    }
+                }
+
+                return closest;
+            });
+    }
+
+    constexpr auto Blas::aabb() const -> AABB
+    {
+        return _bvh.nodes().empty() ? impl::empty_aabb() : _bvh.nodes().front().aabb;
+    }
+
+    constexpr auto Blas::triangle_count() const -> std::size_t
+    {
+        return _triangle_count;
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <format>
+#include <string>
+
+#include "math/vector3.h"
+#include "utils/formatter.h"
+
+namespace ufps
+{
+    struct Plane
+    {
+        static constexpr auto from_points(const Vector3 &a, const Vector3 &b, const Vector3 &c) -> Plane;
+
+        constexpr auto distance_to(const Vector3 &point) const -> float;
+
+        Vector3 normal;
+        float distance;
+    };
+
+    struct Frustum
+    {
+        // corners are expected in the same order as Camera::frustum_corners(), near then far, each TL, TR, BR, BL
+        static constexpr auto from_corners(const std::array<Vector3, 8u> &corners) -> Frustum;
+
+        std::array<Plane, 6u> planes;
+    };
+
+    constexpr auto Plane::from_points(const Vector3 &a, const Vector3 &b, const Vector3 &c) -> Plane
+    {
+        const auto normal = Vector3::normalize(Vector3::cross(b - a, c - a));
+        return {.normal = normal, .distance = -Vector3::dot(normal, a)};
+    }
+
+    constexpr auto Plane::distance_to(const Vector3 &point) const -> float
+    {
+        return Vector3::dot(normal, point) + distance;
+    }
+
+    constexpr auto Frustum::from_corners(const std::array<Vector3, 8u> &corners) -> Frustum
+    {
+        auto frustum = Frustum{
+            .planes = {
+                Plane::from_points(corners[0], corners[1], corners[2]), // near
+                Plane::from_points(corners[4], corners[5], corners[6]), // far
+                Plane::from_points(corners[0], corners[3], corners[7]), // left
+                Plane::from_points(corners[1], corners[2], corners[6]), // right
+                Plane::from_points(corners[0], corners[1], corners[5]), // top
+                Plane::from_points(corners[3], corners[2], corners[6]), // bottom
+            }};
+
+        auto centre = Vector3{};
+        for (const auto &corner : corners)
+        {
+            centre += corner;
+        }
+        centre /= static_cast<float>(corners.size());
+
+        // orient every plane so the inside of the frustum is on the positive side, regardless of winding
+        for (auto &plane : frustum.planes)
+        {
+            if (plane.distance_to(centre) < 0.f)
+            {
+                plane.normal = -plane.normal;
+                plane.distance = -plane.distance;
+            }
+        }
+
+        return frustum;
+    }
+
+    inline auto to_string(const Plane &obj) -> std::string
+    {
+        return std::format("normal: {} distance: {}", obj.normal, obj.distance);
+    }
+}
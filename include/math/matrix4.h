@@ -1,6 +1,8 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <format>
 #include <initializer_list>
@@ -8,12 +10,209 @@
 #include <span>
 
 #include "math/quaternion.h"
+#include "math/simd.h"
 #include "math/vector3.h"
 #include "math/vector4.h"
 #include "utils/ensure.h"
 
 namespace ufps
 {
+    // the scalar versions are used at compile time (and as the benchmark baseline), the simd versions at runtime, both
+    // do the same float operations in the same order so they give identical results
+    namespace impl
+    {
+        using Elements = std::array<float, 16u>;
+
+        // every cofactor in cofactors_scalar sums six products of three elements, each already carrying its sign, which
+        // is sign * (+p0, -p1, -p2, +p3, +p4, -p5)
+        // the signs have to go on each product before the sum, flipping the sum afterwards turns a +0 into a -0 for every
+        // cofactor whose products are all zero (e.g. most of the identity)
+        inline constexpr auto cofactor_signs =
+            std::array<float, 16u>{1.f, -1.f, 1.f, -1.f, -1.f, 1.f, -1.f, 1.f, 1.f, -1.f, 1.f, -1.f, -1.f, 1.f, -1.f, 1.f};
+
+        inline constexpr auto cofactor_products = std::array<std::array<std::array<std::uint32_t, 3u>, 6u>, 16u>{{
+            {{{5u, 10u, 15u}, {5u, 11u, 14u}, {9u, 6u, 15u}, {9u, 7u, 14u}, {13u, 6u, 11u}, {13u, 7u, 10u}}},
+            {{{1u, 10u, 15u}, {1u, 11u, 14u}, {9u, 2u, 15u}, {9u, 3u, 14u}, {13u, 2u, 11u}, {13u, 3u, 10u}}},
+            {{{1u, 6u, 15u}, {1u, 7u, 14u}, {5u, 2u, 15u}, {5u, 3u, 14u}, {13u, 2u, 7u}, {13u, 3u, 6u}}},
+            {{{1u, 6u, 11u}, {1u, 7u, 10u}, {5u, 2u, 11u}, {5u, 3u, 10u}, {9u, 2u, 7u}, {9u, 3u, 6u}}},
+            {{{4u, 10u, 15u}, {4u, 11u, 14u}, {8u, 6u, 15u}, {8u, 7u, 14u}, {12u, 6u, 11u}, {12u, 7u, 10u}}},
+            {{{0u, 10u, 15u}, {0u, 11u, 14u}, {8u, 2u, 15u}, {8u, 3u, 14u}, {12u, 2u, 11u}, {12u, 3u, 10u}}},
+            {{{0u, 6u, 15u}, {0u, 7u, 14u}, {4u, 2u, 15u}, {4u, 3u, 14u}, {12u, 2u, 7u}, {12u, 3u, 6u}}},
+            {{{0u, 6u, 11u}, {0u, 7u, 10u}, {4u, 2u, 11u}, {4u, 3u, 10u}, {8u, 2u, 7u}, {8u, 3u, 6u}}},
+            {{{4u, 9u, 15u}, {4u, 11u, 13u}, {8u, 5u, 15u}, {8u, 7u, 13u}, {12u, 5u, 11u}, {12u, 7u, 9u}}},
+            {{{0u, 9u, 15u}, {0u, 11u, 13u}, {8u, 1u, 15u}, {8u, 3u, 13u}, {12u, 1u, 11u}, {12u, 3u, 9u}}},
+            {{{0u, 5u, 15u}, {0u, 7u, 13u}, {4u, 1u, 15u}, {4u, 3u, 13u}, {12u, 1u, 7u}, {12u, 3u, 5u}}},
+            {{{0u, 5u, 11u}, {0u, 7u, 9u}, {4u, 1u, 11u}, {4u, 3u, 9u}, {8u, 1u, 7u}, {8u, 3u, 5u}}},
+            {{{4u, 9u, 14u}, {4u, 10u, 13u}, {8u, 5u, 14u}, {8u, 6u, 13u}, {12u, 5u, 10u}, {12u, 6u, 9u}}},
+            {{{0u, 9u, 14u}, {0u, 10u, 13u}, {8u, 1u, 14u}, {8u, 2u, 13u}, {12u, 1u, 10u}, {12u, 2u, 9u}}},
+            {{{0u, 5u, 14u}, {0u, 6u, 13u}, {4u, 1u, 14u}, {4u, 2u, 13u}, {12u, 1u, 6u}, {12u, 2u, 5u}}},
+            {{{0u, 5u, 10u}, {0u, 6u, 9u}, {4u, 1u, 10u}, {4u, 2u, 9u}, {8u, 1u, 6u}, {8u, 2u, 5u}}},
+        }};
+
+        constexpr auto multiply_scalar(const Elements &m1, const Elements &m2) -> Elements
+        {
+            auto result = Elements{};
+            for (auto i = 0u; i < 4u; i++)
+            {
+                for (auto j = 0u; j < 4u; j++)
+                {
+                    auto sum = 0.f;
+                    for (auto k = 0u; k < 4u; ++k)
+                    {
+                        sum += m1[i + k * 4] * m2[k + j * 4];
+                    }
+                    result[i + j * 4] = sum;
+                }
+            }
+
+            return result;
+        }
+
+        // out may point at either input, every column of m2 is read before the same column of out is written
+        inline auto multiply_simd(const float *m1, const float *m2, float *out) -> void
+        {
+            const auto columns = std::array{
+                simd::load<4zu>(m1), simd::load<4zu>(m1 + 4), simd::load<4zu>(m1 + 8), simd::load<4zu>(m1 + 12)};
+
+            for (auto j = 0u; j < 4u; ++j)
+            {
+                auto sum = simd::broadcast<4zu>(0.f);
+                for (auto k = 0u; k < 4u; ++k)
+                {
+                    sum = sum + columns[k] * simd::broadcast<4zu>(m2[k + j * 4]);
+                }
+                simd::store(sum, out + j * 4);
+            }
+        }
+
+        constexpr auto transform_scalar(const Elements &m, const Vector4 &v) -> Vector4
+        {
+            return {
+                m[0] * v.x + m[4] * v.y + m[8] * v.z + m[12] * v.w,
+                m[1] * v.x + m[5] * v.y + m[9] * v.z + m[13] * v.w,
+                m[2] * v.x + m[6] * v.y + m[10] * v.z + m[14] * v.w,
+                m[3] * v.x + m[7] * v.y + m[11] * v.z + m[15] * v.w,
+            };
+        }
+
+        inline auto transform_simd(const std::array<simd::FloatN<4zu>, 4u> &columns, const Vector4 &v) -> Vector4
+        {
+            const auto result = columns[0] * simd::broadcast<4zu>(v.x) + columns[1] * simd::broadcast<4zu>(v.y) +
+                                columns[2] * simd::broadcast<4zu>(v.z) + columns[3] * simd::broadcast<4zu>(v.w);
+
+            auto lanes = std::array<float, 4u>{};
+            simd::store(result, lanes.data());
+
+            return {lanes[0], lanes[1], lanes[2], lanes[3]};
+        }
+
+        inline auto load_columns(const Elements &m) -> std::array<simd::FloatN<4zu>, 4u>
+        {
+            return {simd::load<4zu>(m.data()), simd::load<4zu>(m.data() + 4), simd::load<4zu>(m.data() + 8), simd::load<4zu>(m.data() + 12)};
+        }
+
+        constexpr auto cofactors_scalar(const Elements &m) -> Elements
+        {
+            auto inv = Elements{};
+
+            inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] +
+                     m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+
+            inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] -
+                     m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+
+            inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] +
+                     m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+
+            inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] -
+                     m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+
+            inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] -
+                     m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+
+            inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] +
+                     m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+
+            inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] -
+                     m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+
+            inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] +
+                     m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+
+            inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] +
+                     m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+
+            inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] -
+                     m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+
+            inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] +
+                      m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+
+            inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] - m[4] * m[3] * m[9] -
+                      m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+
+            inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] -
+                      m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+
+            inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] +
+                      m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+
+            inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] -
+                      m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+
+            inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] -
+                      m[8] * m[2] * m[5];
+
+            return inv;
+        }
+
+        // lane l of a factor is the element used by cofactor First + l, the indices are template arguments so every
+        // gather is four loads from constant offsets
+        template <std::size_t First, std::size_t Term, std::size_t Factor>
+        inline auto cofactor_factor(const Elements &m) -> simd::FloatN<4zu>
+        {
+            constexpr auto indices = std::array<std::uint32_t, 4u>{
+                cofactor_products[First][Term][Factor],
+                cofactor_products[First + 1zu][Term][Factor],
+                cofactor_products[First + 2zu][Term][Factor],
+                cofactor_products[First + 3zu][Term][Factor]};
+
+            return simd::gather<4zu>(m.data(), indices);
+        }
+
+        template <std::size_t First, std::size_t Term>
+        inline auto cofactor_product(const Elements &m) -> simd::FloatN<4zu>
+        {
+            return cofactor_factor<First, Term, 0zu>(m) * cofactor_factor<First, Term, 1zu>(m) * cofactor_factor<First, Term, 2zu>(m);
+        }
+
+        template <std::size_t First>
+        inline auto cofactors_simd(const Elements &m, Elements &inv) -> void
+        {
+            // a - b is exactly a + -b, so adding the negated products matches the scalar subtractions
+            const auto signs = simd::load<4zu>(cofactor_signs.data() + First);
+            const auto flipped = -signs;
+
+            const auto cofactors = cofactor_product<First, 0zu>(m) * signs + cofactor_product<First, 1zu>(m) * flipped +
+                                   cofactor_product<First, 2zu>(m) * flipped + cofactor_product<First, 3zu>(m) * signs +
+                                   cofactor_product<First, 4zu>(m) * signs + cofactor_product<First, 5zu>(m) * flipped;
+
+            simd::store(cofactors, inv.data() + First);
+        }
+
+        inline auto cofactors_simd(const Elements &m) -> Elements
+        {
+            auto inv = Elements{};
+
+            cofactors_simd<0zu>(m, inv);
+            cofactors_simd<4zu>(m, inv);
+            cofactors_simd<8zu>(m, inv);
+            cofactors_simd<12zu>(m, inv);
+
+            return inv;
+        }
+    }
+
     class Matrix4
     {
     public:
@@ -165,6 +364,12 @@ namespace ufps
 
         static constexpr auto invert(const Matrix4 &matrix) -> Matrix4;
 
+        // batched operator*, out[i] = lhs[i] * rhs[i] and may be the same span as lhs or rhs
+        static constexpr auto multiply(std::span<const Matrix4> lhs, std::span<const Matrix4> rhs, std::span<Matrix4> out) -> void;
+
+        // batched operator* for vectors, out[i] = matrix * vectors[i]
+        static constexpr auto transform(const Matrix4 &matrix, std::span<const Vector4> vectors, std::span<Vector4> out) -> void;
+
         constexpr auto data() const -> std::span<const float>
         {
             return _elements;
@@ -183,7 +388,7 @@ namespace ufps
         // }
 
         friend constexpr auto operator*=(Matrix4 &m1, const Matrix4 &m2) -> Matrix4 &;
-        friend constexpr auto operator*(Matrix4 &m1, const Vector4 &v) -> Vector4;
+        friend constexpr auto operator*(const Matrix4 &m, const Vector4 &v) -> Vector4;
 
         constexpr auto operator==(const Matrix4 &) const -> bool = default;
 
@@ -195,21 +400,15 @@ namespace ufps
 
     constexpr auto operator*=(Matrix4 &m1, const Matrix4 &m2) -> Matrix4 &
     {
-        auto result = Matrix4{};
-        for (auto i = 0u; i < 4u; i++)
+        if consteval
         {
-            for (auto j = 0u; j < 4u; j++)
-            {
-                auto sum = 0.f;
-                for (auto k = 0u; k < 4u; ++k)
-                {
-                    sum += m1._elements[i + k * 4] * m2._elements[k + j * 4];
-                }
-                result._elements[i + j * 4] = sum;
-            }
+            m1._elements = impl::multiply_scalar(m1._elements, m2._elements);
+        }
+        else
+        {
+            impl::multiply_simd(m1._elements.data(), m2._elements.data(), m1._elements.data());
         }
 
-        m1 = result;
         return m1;
     }
 
@@ -221,12 +420,14 @@ namespace ufps
 
     constexpr auto operator*(const Matrix4 &m, const Vector4 &v) -> Vector4
     {
-        return {
-            m[0] * v.x + m[4] * v.y + m[8] * v.z + m[12] * v.w,
-            m[1] * v.x + m[5] * v.y + m[9] * v.z + m[13] * v.w,
-            m[2] * v.x + m[6] * v.y + m[10] * v.z + m[14] * v.w,
-            m[3] * v.x + m[7] * v.y + m[11] * v.z + m[15] * v.w,
-        };
+        if consteval
+        {
+            return impl::transform_scalar(m._elements, v);
+        }
+        else
+        {
+            return impl::transform_simd(impl::load_columns(m._elements), v);
+        }
     }
 
     inline constexpr auto Matrix4::look_at(const Vector3 &eye, const Vector3 &look_at, const Vector3 &up) -> Matrix4
@@ -287,53 +488,14 @@ namespace ufps
         auto result = Matrix4{};
         auto &inv = result._elements;
 
-        inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] +
-                 m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
-
-        inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] -
-                 m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
-
-        inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] +
-                 m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
-
-        inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] -
-                 m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
-
-        inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] -
-                 m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
-
-        inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] +
-                 m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
-
-        inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] -
-                 m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
-
-        inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] +
-                 m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
-
-        inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] +
-                 m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
-
-        inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] -
-                 m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
-
-        inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] +
-                  m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
-
-        inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] - m[4] * m[3] * m[9] -
-                  m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
-
-        inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] -
-                  m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
-
-        inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] +
-                  m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
-
-        inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] -
-                  m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
-
-        inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] -
-                  m[8] * m[2] * m[5];
+        if consteval
+        {
+            inv = impl::cofactors_scalar(m);
+        }
+        else
+        {
+            inv = impl::cofactors_simd(m);
+        }
 
         auto det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
         expect(det != 0.0f, "matrix is singular and cannot be inverted");
@@ -348,6 +510,45 @@ namespace ufps
         return result;
     }
 
+    constexpr auto Matrix4::multiply(std::span<const Matrix4> lhs, std::span<const Matrix4> rhs, std::span<Matrix4> out) -> void
+    {
+        expect(lhs.size() == rhs.size() && lhs.size() == out.size(), "mismatched sizes {} {} {}", lhs.size(), rhs.size(), out.size());
+
+        for (auto i = 0zu; i < lhs.size(); ++i)
+        {
+            if consteval
+            {
+                out[i]._elements = impl::multiply_scalar(lhs[i]._elements, rhs[i]._elements);
+            }
+            else
+            {
+                impl::multiply_simd(lhs[i]._elements.data(), rhs[i]._elements.data(), out[i]._elements.data());
+            }
+        }
+    }
+
+    constexpr auto Matrix4::transform(const Matrix4 &matrix, std::span<const Vector4> vectors, std::span<Vector4> out) -> void
+    {
+        expect(vectors.size() == out.size(), "mismatched sizes {} {}", vectors.size(), out.size());
+
+        if consteval
+        {
+            for (auto i = 0zu; i < vectors.size(); ++i)
+            {
+                out[i] = impl::transform_scalar(matrix._elements, vectors[i]);
+            }
+        }
+        else
+        {
+            // columns are loaded once for the whole batch
+            const auto columns = impl::load_columns(matrix._elements);
+            for (auto i = 0zu; i < vectors.size(); ++i)
+            {
+                out[i] = impl::transform_simd(columns, vectors[i]);
+            }
+        }
+    }
+
     inline auto Matrix4::to_string() const -> std::string
     {
         const auto *d = data().data();
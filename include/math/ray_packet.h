@@ -0,0 +1,186 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#include "math/aabb.h"
+#include "math/ray.h"
+#include "math/simd.h"
+#include "math/triangle.h"
+#include "utils/ensure.h"
+
+namespace ufps
+{
+    // structure of arrays, lane i holds triangle i
+    template <std::size_t N>
+    struct TrianglePacket
+    {
+        std::array<float, N> v0_x;
+        std::array<float, N> v0_y;
+        std::array<float, N> v0_z;
+        std::array<float, N> v1_x;
+        std::array<float, N> v1_y;
+        std::array<float, N> v1_z;
+        std::array<float, N> v2_x;
+        std::array<float, N> v2_y;
+        std::array<float, N> v2_z;
+    };
+
+    // structure of arrays, lane i holds ray i
+    template <std::size_t N>
+    struct RayPacket
+    {
+        std::array<float, N> origin_x;
+        std::array<float, N> origin_y;
+        std::array<float, N> origin_z;
+        std::array<float, N> direction_x;
+        std::array<float, N> direction_y;
+        std::array<float, N> direction_z;
+    };
+
+    // bit i of mask is set if lane i hit, distances of lanes that missed are meaningless
+    template <std::size_t N>
+    struct PacketHits
+    {
+        std::uint32_t mask;
+        std::array<float, N> distance;
+
+        constexpr auto hit(std::size_t lane) const -> std::optional<float>
+        {
+            return (mask & (1u << lane)) != 0u ? std::make_optional(distance[lane]) : std::nullopt;
+        }
+    };
+
+    // unused lanes are zero sized triangles, which never hit
+    template <std::size_t N>
+    constexpr auto create_triangle_packet(std::span<const Triangle> triangles) -> TrianglePacket<N>
+    {
+        expect(triangles.size() <= N, "{} triangles do not fit in a packet of {}", triangles.size(), N);
+
+        auto packet = TrianglePacket<N>{};
+
+        for (auto i = 0zu; i < triangles.size(); ++i)
+        {
+            const auto &triangle = triangles[i];
+            packet.v0_x[i] = triangle.v0.x;
+            packet.v0_y[i] = triangle.v0.y;
+            packet.v0_z[i] = triangle.v0.z;
+            packet.v1_x[i] = triangle.v1.x;
+            packet.v1_y[i] = triangle.v1.y;
+            packet.v1_z[i] = triangle.v1.z;
+            packet.v2_x[i] = triangle.v2.x;
+            packet.v2_y[i] = triangle.v2.y;
+            packet.v2_z[i] = triangle.v2.z;
+        }
+
+        return packet;
+    }
+
+    // unused lanes repeat the first ray
+    template <std::size_t N>
+    constexpr auto create_ray_packet(std::span<const Ray> rays) -> RayPacket<N>
+    {
+        expect(!rays.empty() && rays.size() <= N, "{} rays do not fit in a packet of {}", rays.size(), N);
+
+        auto packet = RayPacket<N>{};
+
+        for (auto i = 0zu; i < N; ++i)
+        {
+            const auto &ray = i < rays.size() ? rays[i] : rays.front();
+            packet.origin_x[i] = ray.origin.x;
+            packet.origin_y[i] = ray.origin.y;
+            packet.origin_z[i] = ray.origin.z;
+            packet.direction_x[i] = ray.direction.x;
+            packet.direction_y[i] = ray.direction.y;
+            packet.direction_z[i] = ray.direction.z;
+        }
+
+        return packet;
+    }
+
+    // one ray against N triangles, lane for lane the same as intersect(ray, v0, v1, v2) in math/utils.h
+    template <std::size_t N>
+    inline auto intersect(const Ray &ray, const TrianglePacket<N> &triangles) -> PacketHits<N>
+    {
+        const auto load = [](const std::array<float, N> &lanes) { return simd::load<N>(lanes.data()); };
+
+        const auto zero = simd::broadcast<N>(0.f);
+        const auto one = simd::broadcast<N>(1.f);
+        const auto epsilon = simd::broadcast<N>(1e-8f);
+
+        const auto origin_x = simd::broadcast<N>(ray.origin.x);
+        const auto origin_y = simd::broadcast<N>(ray.origin.y);
+        const auto origin_z = simd::broadcast<N>(ray.origin.z);
+        const auto direction_x = simd::broadcast<N>(ray.direction.x);
+        const auto direction_y = simd::broadcast<N>(ray.direction.y);
+        const auto direction_z = simd::broadcast<N>(ray.direction.z);
+
+        const auto v0_x = load(triangles.v0_x);
+        const auto v0_y = load(triangles.v0_y);
+        const auto v0_z = load(triangles.v0_z);
+
+        const auto edge1_x = load(triangles.v1_x) - v0_x;
+        const auto edge1_y = load(triangles.v1_y) - v0_y;
+        const auto edge1_z = load(triangles.v1_z) - v0_z;
+        const auto edge2_x = load(triangles.v2_x) - v0_x;
+        const auto edge2_y = load(triangles.v2_y) - v0_y;
+        const auto edge2_z = load(triangles.v2_z) - v0_z;
+
+        // cross and dot are spelled out in the same order as Vector3::cross and Vector3::dot
+        const auto h_x = (direction_y * edge2_z) - (direction_z * edge2_y);
+        const auto h_y = -((direction_x * edge2_z) - (direction_z * edge2_x));
+        const auto h_z = (direction_x * edge2_y) - (direction_y * edge2_x);
+        const auto a = edge1_x * h_x + edge1_y * h_y + edge1_z * h_z;
+
+        const auto f = one / a;
+        const auto s_x = origin_x - v0_x;
+        const auto s_y = origin_y - v0_y;
+        const auto s_z = origin_z - v0_z;
+        const auto u = f * (s_x * h_x + s_y * h_y + s_z * h_z);
+
+        const auto q_x = (s_y * edge1_z) - (s_z * edge1_y);
+        const auto q_y = -((s_x * edge1_z) - (s_z * edge1_x));
+        const auto q_z = (s_x * edge1_y) - (s_y * edge1_x);
+        const auto v = f * (direction_x * q_x + direction_y * q_y + direction_z * q_z);
+        const auto t = f * (edge2_x * q_x + edge2_y * q_y + edge2_z * q_z);
+
+        const auto miss = (simd::abs(a) < epsilon) | (u < zero) | (u > one) | (v < zero) | ((u + v) > one);
+
+        auto result = PacketHits<N>{.mask = simd::to_bits(simd::and_not(miss, t > epsilon)), .distance = {}};
+        simd::store(t, result.distance.data());
+
+        return result;
+    }
+
+    // N rays against one box, lane for lane the same as intersect(ray, aabb) in math/utils.h
+    template <std::size_t N>
+    inline auto intersect(const RayPacket<N> &rays, const AABB &aabb) -> PacketHits<N>
+    {
+        const auto load = [](const std::array<float, N> &lanes) { return simd::load<N>(lanes.data()); };
+
+        const auto origin_x = load(rays.origin_x);
+        const auto origin_y = load(rays.origin_y);
+        const auto origin_z = load(rays.origin_z);
+
+        const auto t1_x = (simd::broadcast<N>(aabb.min.x) - origin_x) / load(rays.direction_x);
+        const auto t1_y = (simd::broadcast<N>(aabb.min.y) - origin_y) / load(rays.direction_y);
+        const auto t1_z = (simd::broadcast<N>(aabb.min.z) - origin_z) / load(rays.direction_z);
+        const auto t2_x = (simd::broadcast<N>(aabb.max.x) - origin_x) / load(rays.direction_x);
+        const auto t2_y = (simd::broadcast<N>(aabb.max.y) - origin_y) / load(rays.direction_y);
+        const auto t2_z = (simd::broadcast<N>(aabb.max.z) - origin_z) / load(rays.direction_z);
+
+        const auto tmin = simd::max(simd::max(simd::min(t1_x, t2_x), simd::min(t1_y, t2_y)), simd::min(t1_z, t2_z));
+        const auto tmax = simd::min(simd::min(simd::max(t1_x, t2_x), simd::max(t1_y, t2_y)), simd::max(t1_z, t2_z));
+
+        const auto miss = (tmax < simd::broadcast<N>(0.f)) | (tmin > tmax);
+        const auto lanes = N == 32zu ? ~0u : (1u << N) - 1u;
+
+        auto result = PacketHits<N>{.mask = ~simd::to_bits(miss) & lanes, .distance = {}};
+        simd::store(tmin, result.distance.data());
+
+        return result;
+    }
+}
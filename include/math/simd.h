@@ -0,0 +1,412 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define UFPS_SIMD_AVX
+#define UFPS_SIMD_SSE
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define UFPS_SIMD_SSE
+#endif
+
+// thin lane wise wrappers used by the packet kernels in math/ray_packet.h and the runtime paths of math/matrix4.h
+// every operation matches the scalar float operation bit for bit (including std::min/std::max argument order and nan
+// handling) so kernels written against these produce exactly what the scalar code in math/utils.h does
+// 4 wide uses sse, 8 wide uses avx (enable with UFPS_ENABLE_AVX2), anything else falls back to a loop over the lanes
+
+namespace ufps::simd
+{
+    template <std::size_t N>
+    struct FloatN
+    {
+        std::array<float, N> lanes;
+    };
+
+    template <std::size_t N>
+    struct MaskN
+    {
+        std::array<bool, N> lanes;
+    };
+
+    template <std::size_t N>
+    inline auto broadcast(float value) -> FloatN<N>
+    {
+        auto result = FloatN<N>{};
+        result.lanes.fill(value);
+        return result;
+    }
+
+    template <std::size_t N>
+    inline auto load(const float *src) -> FloatN<N>
+    {
+        auto result = FloatN<N>{};
+        for (auto i = 0zu; i < N; ++i)
+        {
+            result.lanes[i] = src[i];
+        }
+        return result;
+    }
+
+    template <std::size_t N>
+    inline auto gather(const float *src, const std::array<std::uint32_t, N> &indices) -> FloatN<N>
+    {
+        auto result = FloatN<N>{};
+        for (auto i = 0zu; i < N; ++i)
+        {
+            result.lanes[i] = src[indices[i]];
+        }
+        return result;
+    }
+
+    template <std::size_t N>
+    inline auto store(const FloatN<N> &value, float *dst) -> void
+    {
+        for (auto i = 0zu; i < N; ++i)
+        {
+            dst[i] = value.lanes[i];
+        }
+    }
+
+    template <std::size_t N, class Op>
+    inline auto apply(const FloatN<N> &a, const FloatN<N> &b, Op op) -> FloatN<N>
+    {
+        auto result = FloatN<N>{};
+        for (auto i = 0zu; i < N; ++i)
+        {
+            result.lanes[i] = op(a.lanes[i], b.lanes[i]);
+        }
+        return result;
+    }
+
+    template <std::size_t N, class Op>
+    inline auto compare(const FloatN<N> &a, const FloatN<N> &b, Op op) -> MaskN<N>
+    {
+        auto result = MaskN<N>{};
+        for (auto i = 0zu; i < N; ++i)
+        {
+            result.lanes[i] = op(a.lanes[i], b.lanes[i]);
+        }
+        return result;
+    }
+
+    template <std::size_t N>
+    inline auto operator+(const FloatN<N> &a, const FloatN<N> &b) -> FloatN<N>
+    {
+        return apply(a, b, [](float x, float y) { return x + y; });
+    }
+
+    template <std::size_t N>
+    inline auto operator-(const FloatN<N> &a, const FloatN<N> &b) -> FloatN<N>
+    {
+        return apply(a, b, [](float x, float y) { return x - y; });
+    }
+
+    template <std::size_t N>
+    inline auto operator*(const FloatN<N> &a, const FloatN<N> &b) -> FloatN<N>
+    {
+        return apply(a, b, [](float x, float y) { return x * y; });
+    }
+
+    template <std::size_t N>
+    inline auto operator/(const FloatN<N> &a, const FloatN<N> &b) -> FloatN<N>
+    {
+        return apply(a, b, [](float x, float y) { return x / y; });
+    }
+
+    template <std::size_t N>
+    inline auto operator-(const FloatN<N> &a) -> FloatN<N>
+    {
+        return apply(a, a, [](float x, float) { return -x; });
+    }
+
+    template <std::size_t N>
+    inline auto abs(const FloatN<N> &a) -> FloatN<N>
+    {
+        return apply(a, a, [](float x, float) { return std::bit_cast<float>(std::bit_cast<std::uint32_t>(x) & 0x7fffffffu); });
+    }
+
+    // std::min(a, b), i.e. (b < a) ? b : a
+    template <std::size_t N>
+    inline auto min(const FloatN<N> &a, const FloatN<N> &b) -> FloatN<N>
+    {
+        return apply(a, b, [](float x, float y) { return (y < x) ? y : x; });
+    }
+
+    // std::max(a, b), i.e. (a < b) ? b : a
+    template <std::size_t N>
+    inline auto max(const FloatN<N> &a, const FloatN<N> &b) -> FloatN<N>
+    {
+        return apply(a, b, [](float x, float y) { return (x < y) ? y : x; });
+    }
+
+    template <std::size_t N>
+    inline auto operator<(const FloatN<N> &a, const FloatN<N> &b) -> MaskN<N>
+    {
+        return compare(a, b, [](float x, float y) { return x < y; });
+    }
+
+    template <std::size_t N>
+    inline auto operator>(const FloatN<N> &a, const FloatN<N> &b) -> MaskN<N>
+    {
+        return compare(a, b, [](float x, float y) { return x > y; });
+    }
+
+    template <std::size_t N>
+    inline auto operator|(const MaskN<N> &a, const MaskN<N> &b) -> MaskN<N>
+    {
+        auto result = MaskN<N>{};
+        for (auto i = 0zu; i < N; ++i)
+        {
+            result.lanes[i] = a.lanes[i] || b.lanes[i];
+        }
+        return result;
+    }
+
+    // lanes set in b but not in a
+    template <std::size_t N>
+    inline auto and_not(const MaskN<N> &a, const MaskN<N> &b) -> MaskN<N>
+    {
+        auto result = MaskN<N>{};
+        for (auto i = 0zu; i < N; ++i)
+        {
+            result.lanes[i] = !a.lanes[i] && b.lanes[i];
+        }
+        return result;
+    }
+
+    // bit i is set if lane i is set
+    template <std::size_t N>
+    inline auto to_bits(const MaskN<N> &mask) -> std::uint32_t
+    {
+        auto result = 0u;
+        for (auto i = 0zu; i < N; ++i)
+        {
+            result |= mask.lanes[i] ? (1u << i) : 0u;
+        }
+        return result;
+    }
+
+#if defined(UFPS_SIMD_SSE)
+    template <>
+    struct FloatN<4zu>
+    {
+        ::__m128 value;
+    };
+
+    template <>
+    struct MaskN<4zu>
+    {
+        ::__m128 value;
+    };
+
+    template <>
+    inline auto broadcast<4zu>(float value) -> FloatN<4zu>
+    {
+        return {::_mm_set1_ps(value)};
+    }
+
+    template <>
+    inline auto load<4zu>(const float *src) -> FloatN<4zu>
+    {
+        return {::_mm_loadu_ps(src)};
+    }
+
+    template <>
+    inline auto gather<4zu>(const float *src, const std::array<std::uint32_t, 4zu> &indices) -> FloatN<4zu>
+    {
+        return {::_mm_setr_ps(src[indices[0]], src[indices[1]], src[indices[2]], src[indices[3]])};
+    }
+
+    inline auto store(const FloatN<4zu> &value, float *dst) -> void
+    {
+        ::_mm_storeu_ps(dst, value.value);
+    }
+
+    inline auto operator+(const FloatN<4zu> &a, const FloatN<4zu> &b) -> FloatN<4zu>
+    {
+        return {::_mm_add_ps(a.value, b.value)};
+    }
+
+    inline auto operator-(const FloatN<4zu> &a, const FloatN<4zu> &b) -> FloatN<4zu>
+    {
+        return {::_mm_sub_ps(a.value, b.value)};
+    }
+
+    inline auto operator*(const FloatN<4zu> &a, const FloatN<4zu> &b) -> FloatN<4zu>
+    {
+        return {::_mm_mul_ps(a.value, b.value)};
+    }
+
+    inline auto operator/(const FloatN<4zu> &a, const FloatN<4zu> &b) -> FloatN<4zu>
+    {
+        return {::_mm_div_ps(a.value, b.value)};
+    }
+
+    inline auto operator-(const FloatN<4zu> &a) -> FloatN<4zu>
+    {
+        return {::_mm_xor_ps(a.value, ::_mm_set1_ps(-0.f))};
+    }
+
+    inline auto abs(const FloatN<4zu> &a) -> FloatN<4zu>
+    {
+        return {::_mm_andnot_ps(::_mm_set1_ps(-0.f), a.value)};
+    }
+
+    // _mm_min_ps(x, y) is (x < y) ? x : y so the arguments are swapped to get std::min
+    inline auto min(const FloatN<4zu> &a, const FloatN<4zu> &b) -> FloatN<4zu>
+    {
+        return {::_mm_min_ps(b.value, a.value)};
+    }
+
+    inline auto max(const FloatN<4zu> &a, const FloatN<4zu> &b) -> FloatN<4zu>
+    {
+        return {::_mm_max_ps(b.value, a.value)};
+    }
+
+    inline auto operator<(const FloatN<4zu> &a, const FloatN<4zu> &b) -> MaskN<4zu>
+    {
+        return {::_mm_cmplt_ps(a.value, b.value)};
+    }
+
+    inline auto operator>(const FloatN<4zu> &a, const FloatN<4zu> &b) -> MaskN<4zu>
+    {
+        return {::_mm_cmpgt_ps(a.value, b.value)};
+    }
+
+    inline auto operator|(const MaskN<4zu> &a, const MaskN<4zu> &b) -> MaskN<4zu>
+    {
+        return {::_mm_or_ps(a.value, b.value)};
+    }
+
+    inline auto and_not(const MaskN<4zu> &a, const MaskN<4zu> &b) -> MaskN<4zu>
+    {
+        return {::_mm_andnot_ps(a.value, b.value)};
+    }
+
+    inline auto to_bits(const MaskN<4zu> &mask) -> std::uint32_t
+    {
+        return static_cast<std::uint32_t>(::_mm_movemask_ps(mask.value));
+    }
+#endif
+
+#if defined(UFPS_SIMD_AVX)
+    template <>
+    struct FloatN<8zu>
+    {
+        ::__m256 value;
+    };
+
+    template <>
+    struct MaskN<8zu>
+    {
+        ::__m256 value;
+    };
+
+    template <>
+    inline auto broadcast<8zu>(float value) -> FloatN<8zu>
+    {
+        return {::_mm256_set1_ps(value)};
+    }
+
+    template <>
+    inline auto load<8zu>(const float *src) -> FloatN<8zu>
+    {
+        return {::_mm256_loadu_ps(src)};
+    }
+
+    // indices are read as signed 32 bit by the gather instruction, which is fine for anything a mesh can index
+    template <>
+    inline auto gather<8zu>(const float *src, const std::array<std::uint32_t, 8zu> &indices) -> FloatN<8zu>
+    {
+#if defined(__AVX2__)
+        const auto offsets = ::_mm256_loadu_si256(reinterpret_cast<const ::__m256i *>(indices.data()));
+        return {::_mm256_i32gather_ps(src, offsets, 4)};
+#else
+        return {::_mm256_setr_ps(
+            src[indices[0]],
+            src[indices[1]],
+            src[indices[2]],
+            src[indices[3]],
+            src[indices[4]],
+            src[indices[5]],
+            src[indices[6]],
+            src[indices[7]])};
+#endif
+    }
+
+    inline auto store(const FloatN<8zu> &value, float *dst) -> void
+    {
+        ::_mm256_storeu_ps(dst, value.value);
+    }
+
+    inline auto operator+(const FloatN<8zu> &a, const FloatN<8zu> &b) -> FloatN<8zu>
+    {
+        return {::_mm256_add_ps(a.value, b.value)};
+    }
+
+    inline auto operator-(const FloatN<8zu> &a, const FloatN<8zu> &b) -> FloatN<8zu>
+    {
+        return {::_mm256_sub_ps(a.value, b.value)};
+    }
+
+    inline auto operator*(const FloatN<8zu> &a, const FloatN<8zu> &b) -> FloatN<8zu>
+    {
+        return {::_mm256_mul_ps(a.value, b.value)};
+    }
+
+    inline auto operator/(const FloatN<8zu> &a, const FloatN<8zu> &b) -> FloatN<8zu>
+    {
+        return {::_mm256_div_ps(a.value, b.value)};
+    }
+
+    inline auto operator-(const FloatN<8zu> &a) -> FloatN<8zu>
+    {
+        return {::_mm256_xor_ps(a.value, ::_mm256_set1_ps(-0.f))};
+    }
+
+    inline auto abs(const FloatN<8zu> &a) -> FloatN<8zu>
+    {
+        return {::_mm256_andnot_ps(::_mm256_set1_ps(-0.f), a.value)};
+    }
+
+    inline auto min(const FloatN<8zu> &a, const FloatN<8zu> &b) -> FloatN<8zu>
+    {
+        return {::_mm256_min_ps(b.value, a.value)};
+    }
+
+    inline auto max(const FloatN<8zu> &a, const FloatN<8zu> &b) -> FloatN<8zu>
+    {
+        return {::_mm256_max_ps(b.value, a.value)};
+    }
+
+    inline auto operator<(const FloatN<8zu> &a, const FloatN<8zu> &b) -> MaskN<8zu>
+    {
+        return {::_mm256_cmp_ps(a.value, b.value, _CMP_LT_OQ)};
+    }
+
+    inline auto operator>(const FloatN<8zu> &a, const FloatN<8zu> &b) -> MaskN<8zu>
+    {
+        return {::_mm256_cmp_ps(a.value, b.value, _CMP_GT_OQ)};
+    }
+
+    inline auto operator|(const MaskN<8zu> &a, const MaskN<8zu> &b) -> MaskN<8zu>
+    {
+        return {::_mm256_or_ps(a.value, b.value)};
+    }
+
+    inline auto and_not(const MaskN<8zu> &a, const MaskN<8zu> &b) -> MaskN<8zu>
+    {
+        return {::_mm256_andnot_ps(a.value, b.value)};
+    }
+
+    inline auto to_bits(const MaskN<8zu> &mask) -> std::uint32_t
+    {
+        return static_cast<std::uint32_t>(::_mm256_movemask_ps(mask.value));
+    }
+#endif
+}
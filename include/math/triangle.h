@@ -0,0 +1,13 @@
+#pragma once
+
+#include "math/vector3.h"
+
+namespace ufps
+{
+    struct Triangle
+    {
+        Vector3 v0;
+        Vector3 v1;
+        Vector3 v2;
+    };
+}
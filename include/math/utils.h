@@ -1,8 +1,12 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <optional>
 
 #include "math/aabb.h"
+#include "math/frustum.h"
+#include "math/matrix4.h"
 #include "math/ray.h"
 #include "math/vector3.h"
 
@@ -61,4 +65,50 @@ namespace ufps
 
         return std::make_optional(tmin);
     }
+
+    // conservative world space bounds of a transformed box (Arvo)
+    constexpr auto transform(const AABB &aabb, const Matrix4 &matrix) -> AABB
+    {
+        const auto m = matrix.data();
+        const auto min = std::array<float, 3u>{aabb.min.x, aabb.min.y, aabb.min.z};
+        const auto max = std::array<float, 3u>{aabb.max.x, aabb.max.y, aabb.max.z};
+
+        auto result_min = std::array<float, 3u>{m[12], m[13], m[14]};
+        auto result_max = result_min;
+
+        for (auto i = 0u; i < 3u; ++i)
+        {
+            for (auto j = 0u; j < 3u; ++j)
+            {
+                const auto a = m[i + j * 4u] * min[j];
+                const auto b = m[i + j * 4u] * max[j];
+                result_min[i] += std::min(a, b);
+                result_max[i] += std::max(a, b);
+            }
+        }
+
+        return {
+            .min = {result_min[0], result_min[1], result_min[2]},
+            .max = {result_max[0], result_max[1], result_max[2]}};
+    }
+
+    // true if any part of the box is on the inside of every plane
+    constexpr auto intersect(const Frustum &frustum, const AABB &aabb) -> bool
+    {
+        for (const auto &plane : frustum.planes)
+        {
+            const auto positive_vertex = Vector3{
+                plane.normal.x >= 0.f ? aabb.max.x : aabb.min.x,
+                plane.normal.y >= 0.f ? aabb.max.y : aabb.min.y,
+                plane.normal.z >= 0.f ? aabb.max.z : aabb.min.z,
+            };
+
+            if (plane.distance_to(positive_vertex) < 0.f)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
 }
\ No newline at end of file
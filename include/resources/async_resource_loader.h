@@ -0,0 +1,171 @@
+#pragma once
+
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <map>
+#include <optional>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "concurrency/awaitable_manager.h"
+#include "concurrency/cond_var.h"
+#include "concurrency/lock.h"
+#include "concurrency/thread.h"
+#include "resources/resource_loader.h"
+#include "utils/data_buffer.h"
+
+namespace ufps
+{
+    // the most requests a worker takes at once, read together through ResourceLoader::load_data_buffers
+    inline constexpr auto async_resource_loader_batch_size = 64u;
+
+    enum class LoadPriority : std::uint32_t
+    {
+        HIGH,
+        NORMAL,
+        LOW
+    };
+
+    // reads resources from a loader on its own io workers so a coroutine can wait on them without blocking the thread
+    // pool or the render loop, e.g.
+    //
+    //   const auto buffer = co_await async_loader.load_async("textures/crate.png");
+    //
+    // finished loads resume their coroutine through the awaitable manager, so on the pool at the next pump
+    // requests are served highest priority first and in the order they were made within a priority, each worker takes
+    // the most urgent in batches so a loader that reads many at once (e.g. through io_uring) can overlap them
+    class AsyncResourceLoader
+    {
+    public:
+        AsyncResourceLoader(ResourceLoader &loader, AwaitableManager &awaitable_manager, std::uint32_t worker_count = 2u);
+        ~AsyncResourceLoader();
+
+        AsyncResourceLoader(const AsyncResourceLoader &) = delete;
+        auto operator=(const AsyncResourceLoader &) -> AsyncResourceLoader & = delete;
+
+        // stopping stop_token while the request is still queued removes it and resumes with std::nullopt at the next
+        // pump, once a worker has taken the request the read always completes
+        // a resource that cannot be loaded rethrows the loader's exception in the awaiting coroutine
+        auto load_async(std::string_view name, LoadPriority priority = LoadPriority::NORMAL, std::stop_token stop_token = {})
+        {
+            struct Awaitable
+            {
+                auto await_ready()
+                {
+                    return false;
+                }
+
+                auto await_suspend(std::coroutine_handle<> h) -> bool
+                {
+                    // registered before the request is queued, as from then on a worker can resume the coroutine (and
+                    // destroy this) at any point
+                    on_stop.emplace(stop_token, CancelRequest{.self = &self, .key = &key});
+
+                    // false if already stopped, carrying on straight away with nothing loaded
+                    return self.submit(
+                        {
+                            .name = std::move(name),
+                            .result = &result,
+                            .exception = &exception,
+                            .key = &key,
+                            .on_stop = &on_stop,
+                            .handle = h,
+                        },
+                        priority,
+                        stop_token);
+                }
+
+                auto await_resume() -> std::optional<DataBuffer>
+                {
+                    if (exception)
+                    {
+                        std::rethrow_exception(exception);
+                    }
+
+                    return std::move(result);
+                }
+
+                AsyncResourceLoader &self;
+                std::string name;
+                LoadPriority priority;
+                std::stop_token stop_token;
+                std::optional<DataBuffer> result;
+                std::exception_ptr exception;
+                std::optional<RequestKey> key;
+
+                // last so it is destroyed first, waiting out a callback running on another thread while the rest is
+                // still alive
+                std::optional<std::stop_callback<CancelRequest>> on_stop;
+            };
+
+            return Awaitable{
+                .self = *this,
+                .name = std::string{name},
+                .priority = priority,
+                .stop_token = std::move(stop_token),
+                .result = std::nullopt,
+                .exception = nullptr,
+                .key = std::nullopt,
+                .on_stop = std::nullopt,
+            };
+        }
+
+        // requests waiting for a worker, not counting those being read
+        auto queued_count() const -> std::uint32_t;
+
+    private:
+        struct RequestKey
+        {
+            LoadPriority priority;
+            std::uint64_t sequence;
+
+            // the most urgent, oldest request sorts first
+            auto operator<=>(const RequestKey &) const = default;
+        };
+
+        struct CancelRequest
+        {
+            AsyncResourceLoader *self;
+
+            // empty until the request is queued
+            const std::optional<RequestKey> *key;
+
+            auto operator()() const -> void
+            {
+                self->cancel(*key);
+            }
+        };
+
+        struct Request
+        {
+            std::string name;
+
+            // all live in the suspended coroutine's awaitable
+            std::optional<DataBuffer> *result;
+            std::exception_ptr *exception;
+            std::optional<RequestKey> *key;
+            std::optional<std::stop_callback<CancelRequest>> *on_stop;
+
+            std::coroutine_handle<> handle;
+        };
+
+        auto submit(Request request, LoadPriority priority, const std::stop_token &stop_token) -> bool;
+        auto cancel(const std::optional<RequestKey> &key) -> void;
+        auto worker(std::stop_token stop_token) -> void;
+        auto load(std::span<Request> batch) -> void;
+
+        ResourceLoader &_loader;
+        AwaitableManager &_awaitable_manager;
+
+        // ordered rather than a heap so a cancelled request can be taken out from anywhere
+        std::map<RequestKey, Request> _requests;
+        std::uint64_t _next_sequence;
+        mutable Lock<> _lock;
+        CondVar _cv;
+        std::vector<Thread> _workers;
+    };
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+
+#include "concurrency/lock.h"
+
+namespace ufps
+{
+    inline constexpr auto batch_reader_queue_depth = 64u;
+
+    // a read of the start of a file into memory owned by the caller
+    struct BatchRead
+    {
+        std::filesystem::path path;
+        std::span<std::byte> buffer;
+
+        // set by the read, less than the buffer size if the file is shorter
+        std::size_t bytes_read;
+    };
+
+    // reads many files with as few syscalls as possible, up to queue_depth reads are in flight at once through io_uring
+    // falls back to pread, one file at a time, where io_uring is unavailable (old kernels, seccomp) or not wanted
+    // meant to be created once and shared, batches from different threads take turns on the one ring
+    class BatchReader
+    {
+    public:
+        explicit BatchReader(std::uint32_t queue_depth = batch_reader_queue_depth, bool use_io_uring = true);
+        ~BatchReader();
+
+        BatchReader(const BatchReader &) = delete;
+        auto operator=(const BatchReader &) -> BatchReader & = delete;
+
+        // fills in bytes_read for every read, throws if any file cannot be opened or read once every read still in
+        // flight has finished with its buffer
+        auto read(std::span<BatchRead> reads) -> void;
+
+        auto uses_io_uring() const -> bool;
+
+    private:
+        struct Ring;
+
+        auto read_io_uring(std::span<BatchRead> reads) -> void;
+        auto read_fallback(std::span<BatchRead> reads) -> void;
+
+        std::uint32_t _queue_depth;
+        std::unique_ptr<Ring> _ring;
+        Lock<> _ring_lock;
+    };
+}
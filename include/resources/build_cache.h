@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "graphics/model_data.h"
+#include "utils/data_buffer.h"
+
+namespace ufps
+{
+    // content addressed store of build intermediates, one file per key, so a build only has to redo the work whose
+    // inputs changed
+    // keys should cover everything the output depends on (source bytes, settings and a version for the code producing
+    // it), entries are never invalidated otherwise
+    // safe to use from multiple threads
+    class BuildCache
+    {
+    public:
+        explicit BuildCache(std::filesystem::path directory);
+
+        auto find(std::uint64_t key) -> std::optional<DataBuffer>;
+
+        // entries are written to the side and renamed into place so an interrupted build never leaves a truncated one
+        auto store(std::uint64_t key, DataBufferView data) -> void;
+
+        auto hits() const -> std::size_t;
+        auto misses() const -> std::size_t;
+
+    private:
+        auto path(std::uint64_t key) const -> std::filesystem::path;
+
+        std::filesystem::path _directory;
+        std::atomic<std::size_t> _hits;
+        std::atomic<std::size_t> _misses;
+        std::atomic<std::uint32_t> _next_temp;
+    };
+
+    // what importing a model file produces, cached so unchanged models skip the importer
+    struct ImportedModel
+    {
+        std::string name;
+        std::vector<ModelData> sub_models;
+    };
+
+    auto encode_imported_model(const ImportedModel &model) -> DataBuffer;
+    auto decode_imported_model(DataBufferView data) -> ImportedModel;
+}
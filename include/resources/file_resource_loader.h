@@ -1,12 +1,17 @@
 #pragma once
 
+#include <cstddef>
 #include <filesystem>
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
 
+#include "resources/batch_reader.h"
+#include "resources/pack.h"
 #include "resources/resource_loader.h"
 #include "utils/data_buffer.h"
+#include "utils/string_unordered_map.h"
 
 namespace ufps
 {
@@ -20,8 +25,23 @@ namespace ufps
         auto load_string(std::string_view name) -> std::string override;
         auto load_data_buffer(std::string_view name) -> DataBuffer override;
         auto resources(std::string_view) -> std::vector<std::string> override;
+        auto load_pack(std::string_view name) -> Pack override;
+        auto load_data_buffers(std::span<const std::string_view> names) -> std::vector<DataBuffer> override;
 
     private:
+        struct IndexEntry
+        {
+            std::filesystem::path path;
+            std::size_t size;
+        };
+
+        auto find(std::string_view name) const -> const IndexEntry &;
+
         std::vector<std::filesystem::path> _roots;
+
+        // every file under the roots, built once so lookups never touch the filesystem, the first root with a name wins
+        StringUnorderedMap<IndexEntry> _index;
+
+        BatchReader _reader;
     };
 }
\ No newline at end of file
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "resources/file.h"
+#include "utils/compress.h"
+#include "utils/data_buffer.h"
+#include "utils/decompress.h"
+#include "utils/string_unordered_map.h"
+
+namespace ufps
+{
+    // a pack is a single file of named chunks, laid out as
+    //
+    //   PackHeader | PackChunk[chunk_count] | names | chunk data...
+    //
+    // every chunk starts on a multiple of the header alignment and is either stored as is, so it can be used straight
+    // out of the mapped file, or as its own zstd frame
+    // all integers are little endian
+
+    inline constexpr auto pack_magic = std::array<char, 4zu>{'U', 'F', 'P', 'K'};
+    inline constexpr auto pack_version = 1u;
+
+    // a page, so uncompressed chunks are suitably aligned for anything and can be mapped or advised on their own
+    inline constexpr auto pack_default_alignment = 4096u;
+
+    enum class PackCompression : std::uint32_t
+    {
+        NONE,
+        ZSTD
+    };
+
+    struct PackHeader
+    {
+        std::array<char, 4zu> magic;
+        std::uint32_t version;
+        std::uint32_t chunk_count;
+        std::uint32_t alignment;
+        std::uint64_t names_offset;
+        std::uint64_t names_size;
+    };
+
+    struct PackChunk
+    {
+        std::uint64_t offset;
+        std::uint64_t stored_size;
+        std::uint64_t size;
+        std::uint32_t name_offset;
+        std::uint32_t name_size;
+        PackCompression compression;
+        std::uint32_t pad;
+    };
+
+    class Pack;
+
+    class PackWriter
+    {
+    public:
+        // chunks whose contents match a chunk of the same name in previous are copied from it as stored instead of
+        // being compressed again, previous must outlive every call to add
+        explicit PackWriter(
+            std::uint32_t alignment = pack_default_alignment,
+            const CompressOptions &options = {},
+            const Pack *previous = nullptr);
+
+        // with ZSTD the chunk is only kept compressed if that makes it smaller
+        auto add(std::string_view name, DataBufferView data, PackCompression compression) -> void;
+
+        auto write(std::ostream &out) const -> void;
+
+        // total size of the chunk data as stored, excluding headers and padding
+        auto stored_size() const -> std::size_t;
+
+        // number of chunks copied from the previous pack
+        auto reused_count() const -> std::size_t;
+
+    private:
+        struct Entry
+        {
+            std::string name;
+            DataBuffer data;
+            std::uint64_t size;
+            PackCompression compression;
+        };
+
+        auto reuse(std::string_view name, DataBufferView data, PackCompression compression, Entry &entry) const -> bool;
+
+        std::uint32_t _alignment;
+        CompressOptions _options;
+        const Pack *_previous;
+        std::size_t _reused_count;
+        std::vector<Entry> _entries;
+        StringUnorderedMap<std::size_t> _lookup;
+    };
+
+    // read only view of a pack, nothing is copied or decompressed until a chunk is loaded
+    class Pack
+    {
+    public:
+        // the data must outlive the pack
+        explicit Pack(DataBufferView data);
+        explicit Pack(DataBuffer data);
+        explicit Pack(std::unique_ptr<File> file);
+
+        Pack(Pack &&) = default;
+        auto operator=(Pack &&) -> Pack & = default;
+
+        auto has(std::string_view name) const -> bool;
+        auto chunk(std::string_view name) const -> const PackChunk &;
+        auto chunks() const -> std::span<const PackChunk>;
+        auto name(const PackChunk &chunk) const -> std::string_view;
+
+        // the stored bytes of an uncompressed chunk, in place
+        auto view(std::string_view name) const -> DataBufferView;
+
+        // the bytes of any chunk exactly as stored, still compressed if the chunk is
+        auto stored(std::string_view name) const -> DataBufferView;
+
+        auto load(std::string_view name) const -> DataBuffer;
+        auto load(std::string_view name, std::span<std::byte> destination) const -> void;
+        auto load_string(std::string_view name) const -> std::string;
+
+        // hands the chunk to the consumer chunk_size bytes at a time without ever holding all of it decompressed
+        auto stream(std::string_view name, const DataConsumer &consumer, std::size_t chunk_size = decompress_chunk_size) const -> void;
+
+    private:
+        auto open() -> void;
+        auto stored(const PackChunk &chunk) const -> DataBufferView;
+
+        std::unique_ptr<File> _file;
+        DataBuffer _owned;
+        DataBufferView _data;
+        std::span<const PackChunk> _chunks;
+        std::string_view _names;
+        StringUnorderedMap<std::uint32_t> _lookup;
+    };
+}
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <span>
 #include <string>
 #include <string_view>
+#include <vector>
 
+#include "resources/pack.h"
 #include "utils/data_buffer.h"
 
 namespace ufps
@@ -16,5 +19,25 @@ namespace ufps
         virtual auto load_string(std::string_view name) -> std::string = 0;
         virtual auto load_data_buffer(std::string_view name) -> DataBuffer = 0;
         virtual auto resources(std::string_view type) -> std::vector<std::string> = 0;
+
+        // loaders that can read many resources at once override this, by default they are loaded one at a time
+        virtual auto load_data_buffers(std::span<const std::string_view> names) -> std::vector<DataBuffer>
+        {
+            auto buffers = std::vector<DataBuffer>{};
+            buffers.reserve(names.size());
+
+            for (const auto name : names)
+            {
+                buffers.push_back(load_data_buffer(name));
+            }
+
+            return buffers;
+        }
+
+        // loaders that can map files override this to read the pack in place rather than from a copy
+        virtual auto load_pack(std::string_view name) -> Pack
+        {
+            return Pack{load_data_buffer(name)};
+        }
     };
 }
\ No newline at end of file
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "concurrency/lock.h"
+#include "resources/batch_reader.h"
+#include "resources/file.h"
+#include "resources/pack.h"
+#include "resources/resource_loader.h"
+#include "utils/data_buffer.h"
+#include "utils/string_unordered_map.h"
+
+namespace ufps
+{
+    enum class VfsBacking : std::uint32_t
+    {
+        FILE,
+        PACK,
+        MEMORY
+    };
+
+    // one name in the index and where its bytes live
+    struct VfsEntry
+    {
+        std::string name;
+        std::uint64_t hash;
+        std::uint64_t size;
+        VfsBacking backing;
+
+        // FILE only
+        std::filesystem::path path;
+
+        // PACK only
+        const Pack *pack;
+
+        // MEMORY and uncompressed PACK chunks, empty otherwise
+        DataBufferView data;
+    };
+
+    // a named blob for mounting many at once with Vfs::mount_memory
+    struct VfsMemory
+    {
+        std::string_view name;
+        DataBufferView data;
+    };
+
+    // a single index over every resource in directories, packs and memory (e.g. #embed data), mounted at startup
+    //
+    // a mount overlays every mount before it with the same or a lower priority, so e.g. a patch directory mounted last
+    // replaces files from the base pack, and the index only ever holds the winning entry per name
+    // lookups hash the name once and probe an open addressed table, entries are kept sorted by name so listing a
+    // directory is a binary search and a scan
+    //
+    // mounting rebuilds the index so has to happen before the vfs is shared, everything else is safe to call from any
+    // thread
+    class Vfs : public ResourceLoader
+    {
+    public:
+        Vfs();
+        ~Vfs() override = default;
+
+        // every regular file under root, named by its path relative to it
+        auto mount_directory(const std::filesystem::path &root, std::int32_t priority = 0) -> void;
+
+        // every chunk in the pack, which the vfs keeps alive
+        auto mount_pack(Pack pack, std::int32_t priority = 0) -> void;
+
+        // the data must outlive the vfs
+        auto mount_memory(std::string_view name, DataBufferView data, std::int32_t priority = 0) -> void;
+
+        // as one mount with a single rebuild of the index, mounting blobs one at a time rebuilds it for each
+        auto mount_memory(std::span<const VfsMemory> resources, std::int32_t priority = 0) -> void;
+
+        // nullptr if nothing is mounted with the name
+        auto find(std::string_view name) const -> const VfsEntry *;
+
+        // the resource's bytes without a copy, files are mapped on first use and stay mapped for the lifetime of the
+        // vfs, throws for compressed pack chunks which have to be loaded
+        auto view(std::string_view name) const -> DataBufferView;
+
+        auto has_resource(std::string_view name) -> bool override;
+        auto load_string(std::string_view name) -> std::string override;
+        auto load_data_buffer(std::string_view name) -> DataBuffer override;
+
+        // files are read together through a BatchReader, sized from the index
+        auto load_data_buffers(std::span<const std::string_view> names) -> std::vector<DataBuffer> override;
+        auto resources(std::string_view type) -> std::vector<std::string> override;
+        auto load_pack(std::string_view name) -> Pack override;
+
+        auto entries() const -> std::span<const VfsEntry>;
+
+    private:
+        struct Candidate
+        {
+            VfsEntry entry;
+            std::int32_t priority;
+            std::uint32_t mount;
+        };
+
+        auto add(VfsEntry entry, std::int32_t priority) -> void;
+        auto rebuild() -> void;
+        auto entry(std::string_view name) const -> const VfsEntry &;
+
+        // every entry of every mount, including those overlaid by a later one
+        std::vector<Candidate> _candidates;
+        std::uint32_t _mount_count;
+
+        std::vector<std::unique_ptr<Pack>> _packs;
+        std::vector<VfsEntry> _entries;
+
+        struct Slot
+        {
+            std::uint32_t tag;
+
+            // into _entries, or empty_slot
+            std::uint32_t index;
+        };
+
+        // open addressed with linear probing, sized to a power of two at least twice the entry count
+        std::vector<Slot> _table;
+
+        mutable Lock<> _mapped_lock;
+        mutable StringUnorderedMap<std::unique_ptr<File>> _mapped;
+
+        BatchReader _reader;
+    };
+}
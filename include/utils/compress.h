@@ -1,8 +1,56 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
 #include "utils/data_buffer.h"
 
+struct ZSTD_CCtx_s;
+
 namespace ufps
 {
+    inline constexpr auto compress_chunk_size = 128zu * 1024zu;
+
+    struct CompressOptions
+    {
+        std::int32_t level = 1;
+
+        // finds matches far back in large inputs (e.g. repeated meshes in a vertex blob), raises the window to 128MiB
+        bool long_distance_matching = false;
+
+        // log2 of the match window, 0 leaves it to zstd, above 27 the data can only be decompressed by a Decompressor
+        // created with a matching window_log_max
+        std::uint32_t window_log = 0u;
+    };
+
     auto compress(DataBufferView data) -> DataBuffer;
+    auto compress(DataBufferView data, const CompressOptions &options) -> DataBuffer;
+
+    // compresses a single frame from input fed a piece at a time, compressed output is handed on in chunks of at most
+    // chunk_size bytes
+    class Compressor
+    {
+    public:
+        explicit Compressor(const CompressOptions &options = {}, std::size_t chunk_size = compress_chunk_size);
+
+        // records the total input size in the frame header, must be called before any input is fed
+        auto set_content_size(std::size_t size) -> void;
+
+        auto compress(DataBufferView data, const DataConsumer &consumer) -> void;
+
+        // ends the frame and flushes everything left, the compressor can then start a new frame
+        auto finish(const DataConsumer &consumer) -> void;
+
+    private:
+        struct ContextDeleter
+        {
+            auto operator()(::ZSTD_CCtx_s *context) const -> void;
+        };
+
+        auto stream(DataBufferView data, bool end, const DataConsumer &consumer) -> void;
+
+        std::unique_ptr<::ZSTD_CCtx_s, ContextDeleter> _context;
+        DataBuffer _buffer;
+    };
 }
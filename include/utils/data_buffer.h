@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <span>
 #include <vector>
 
@@ -7,4 +8,7 @@ namespace ufps
 {
     using DataBuffer = std::vector<std::byte>;
     using DataBufferView = std::span<const std::byte>;
-}
\ No newline at end of file
+
+    // receives data a piece at a time, the view is only valid for the duration of the call
+    using DataConsumer = std::function<void(DataBufferView)>;
+}
@@ -1,8 +1,58 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+
 #include "utils/data_buffer.h"
 
+struct ZSTD_DCtx_s;
+
 namespace ufps
 {
+    inline constexpr auto decompress_chunk_size = 128zu * 1024zu;
+
     auto decompress(DataBufferView data) -> DataBuffer;
+
+    // decompresses a single frame into a destination of exactly its decompressed size
+    auto decompress(DataBufferView data, std::span<std::byte> destination) -> void;
+
+    // decompresses a single frame through a buffer of chunk_size bytes, the consumer sees every chunk as soon as it is
+    // full so memory use stays at the buffer plus the zstd window no matter how large the frame
+    auto decompress(DataBufferView data, std::size_t chunk_size, const DataConsumer &consumer) -> void;
+
+    // decompresses a single frame from input fed a piece at a time, e.g. as it is read from disk
+    class Decompressor
+    {
+    public:
+        explicit Decompressor(std::size_t chunk_size = decompress_chunk_size, std::uint32_t window_log_max = 27u);
+
+        // every chunk is chunk_size bytes apart from the last one of the frame
+        auto decompress(DataBufferView data, const DataConsumer &consumer) -> void;
+
+        // writes straight into destination after anything written by earlier calls for this frame, returns the number
+        // of bytes written by this call
+        auto decompress(DataBufferView data, std::span<std::byte> destination) -> std::size_t;
+
+        auto finished() const -> bool;
+
+        // abandons the current frame
+        auto reset() -> void;
+
+        // the zstd context and the chunk buffer
+        auto memory_usage() const -> std::size_t;
+
+    private:
+        struct ContextDeleter
+        {
+            auto operator()(::ZSTD_DCtx_s *context) const -> void;
+        };
+
+        std::unique_ptr<::ZSTD_DCtx_s, ContextDeleter> _context;
+        DataBuffer _buffer;
+        std::size_t _buffered;
+        std::size_t _written;
+        bool _finished;
+    };
 }
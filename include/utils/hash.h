@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "utils/data_buffer.h"
+
+namespace ufps
+{
+    inline constexpr auto hash_seed = 0xcbf29ce484222325ull;
+
+    // 64 bit FNV-1a, used to content address build outputs so it only has to be stable and spread well, not be secure
+    constexpr auto hash_bytes(DataBufferView data, std::uint64_t seed = hash_seed) -> std::uint64_t
+    {
+        auto hash = seed;
+        for (const auto byte : data)
+        {
+            hash ^= static_cast<std::uint64_t>(byte);
+            hash *= 0x100000001b3ull;
+        }
+
+        return hash;
+    }
+
+    constexpr auto hash_string(std::string_view str, std::uint64_t seed = hash_seed) -> std::uint64_t
+    {
+        auto hash = seed;
+        for (const auto c : str)
+        {
+            hash ^= static_cast<std::uint8_t>(c);
+            hash *= 0x100000001b3ull;
+        }
+
+        return hash;
+    }
+
+    // folds value into seed, order matters so (a, b) and (b, a) differ
+    constexpr auto hash_combine(std::uint64_t seed, std::uint64_t value) -> std::uint64_t
+    {
+        return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6u) + (seed >> 2u));
+    }
+}
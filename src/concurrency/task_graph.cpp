@@ -0,0 +1,115 @@
+#include "concurrency/task_graph.h"
+
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+
+#include "concurrency/thread_pool.h"
+#include "utils/ensure.h"
+
+namespace ufps
+{
+    TaskGraph::TaskGraph(ThreadPool &pool)
+        : _pool{pool},
+          _tasks{},
+          _remaining_count{std::make_shared<std::atomic<std::uint32_t>>(0u)}
+    {
+    }
+
+    TaskGraph::~TaskGraph()
+    {
+        // queued tasks still point at the graph
+        wait();
+    }
+
+    auto TaskGraph::add(Job job, std::initializer_list<TaskId> dependencies) -> TaskId
+    {
+        ensure(done(), "cannot add tasks to a running graph");
+
+        const auto id = task_count();
+
+        for (const auto dependency : dependencies)
+        {
+            ensure(dependency < id, "task {} cannot depend on unknown task {}", id, dependency);
+            _tasks[dependency].dependents.push_back(id);
+        }
+
+        auto &task = _tasks.emplace_back();
+        task.job = std::move(job);
+        task.dependency_count = static_cast<std::uint32_t>(dependencies.size());
+
+        return id;
+    }
+
+    auto TaskGraph::run() -> void
+    {
+        ensure(done(), "task graph is already running");
+
+        if (_tasks.empty())
+        {
+            return;
+        }
+
+        for (auto &task : _tasks)
+        {
+            task.pending_count.store(task.dependency_count, std::memory_order_relaxed);
+        }
+
+        *_remaining_count = task_count();
+
+        for (auto id = 0u; id < task_count(); ++id)
+        {
+            if (_tasks[id].dependency_count == 0u)
+            {
+                schedule(id);
+            }
+        }
+    }
+
+    auto TaskGraph::wait() const -> void
+    {
+        auto count = _remaining_count->load();
+        while (count != 0u)
+        {
+            _remaining_count->wait(count);
+            count = _remaining_count->load();
+        }
+    }
+
+    auto TaskGraph::done() const -> bool
+    {
+        return _remaining_count->load() == 0u;
+    }
+
+    auto TaskGraph::task_count() const -> std::uint32_t
+    {
+        return static_cast<std::uint32_t>(_tasks.size());
+    }
+
+    auto TaskGraph::schedule(TaskId id) -> void
+    {
+        _pool.add([this, id] { execute(id); });
+    }
+
+    auto TaskGraph::execute(TaskId id) -> void
+    {
+        auto &task = _tasks[id];
+        task.job();
+
+        // added from a worker so the dependents go on its own deque and likely run next on the same thread
+        for (const auto dependent : task.dependents)
+        {
+            if (--_tasks[dependent].pending_count == 0u)
+            {
+                schedule(dependent);
+            }
+        }
+
+        // once the count hits zero wait() can return and the graph be destroyed, so only the copy is touched after
+        const auto remaining_count = _remaining_count;
+        if (--*remaining_count == 0u)
+        {
+            remaining_count->notify_all();
+        }
+    }
+}
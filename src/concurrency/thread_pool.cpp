@@ -2,15 +2,46 @@
 
 #include <algorithm>
 #include <chrono>
+#include <memory>
 #include <thread>
 
-#include "concurrency/concurrent_queue.h"
-#include "concurrency/cond_var.h"
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+#include "concurrency/mpmc_queue.h"
 #include "concurrency/thread.h"
+#include "concurrency/work_stealing_deque.h"
 #include "log.h"
 
 using namespace std::literals;
 
+namespace
+{
+    constexpr auto injection_queue_capacity = 16384zu;
+
+    // how many times an idle worker looks for work before yielding, and then before parking
+    constexpr auto spin_count = 64u;
+    constexpr auto yield_count = 16u;
+
+    struct WorkerContext
+    {
+        const ufps::ThreadPool *pool;
+        std::uint32_t index;
+    };
+
+    thread_local auto current_worker = WorkerContext{.pool = nullptr, .index = 0u};
+
+    auto cpu_relax() -> void
+    {
+#if defined(__x86_64__) || defined(_M_X64)
+        ::_mm_pause();
+#else
+        std::this_thread::yield();
+#endif
+    }
+}
+
 namespace ufps
 {
     ThreadPool::ThreadPool()
@@ -20,19 +51,27 @@ namespace ufps
 
     ThreadPool::ThreadPool(std::uint32_t worker_count)
         : _worker_count{worker_count},
-          _job_queue{},
-          _worker_cv{},
+          _injection_queue{injection_queue_capacity},
+          _deques{},
           _job_count{},
+          _sleeping_count{},
+          _wake_epoch{},
           _workers{}
     {
         log::info("starting thread poll with {} workers", worker_count);
 
+        // every deque has to exist before any worker can try to steal from it
+        for (auto i = 0u; i < worker_count; ++i)
+        {
+            _deques.push_back(std::make_unique<WorkStealingDeque<Job *>>());
+        }
+
         for (auto i = 0u; i < worker_count; ++i)
         {
             const auto name = std::format("worker_{}", i);
 
-            _workers.push_back({name, [this](std::stop_token stop_token)
-                                { worker(std::move(stop_token)); }});
+            _workers.push_back({name, [this, i](std::stop_token stop_token)
+                                { worker(i, std::move(stop_token)); }});
         }
     }
 
@@ -45,16 +84,49 @@ namespace ufps
             thread.request_stop();
         }
 
+        // parked workers only notice the stop request once woken
+        ++_wake_epoch;
+        _wake_epoch.notify_all();
+
         _workers.clear();
 
+        // anything still queued is never run
+        while (const auto job = _injection_queue.try_pop())
+        {
+            delete *job;
+        }
+
+        for (auto &deque : _deques)
+        {
+            while (const auto job = deque->pop())
+            {
+                delete *job;
+            }
+        }
+
         std::this_thread::sleep_for(100ms);
     }
 
     auto ThreadPool::add(Job job) -> void
     {
         ++_job_count;
-        _job_queue.push(std::move(job));
-        _worker_cv.notify_one();
+
+        auto *queued = new Job{std::move(job)};
+
+        if (current_worker.pool == this)
+        {
+            _deques[current_worker.index]->push(queued);
+        }
+        else
+        {
+            while (!_injection_queue.try_push(queued))
+            {
+                // full, wait for the workers to make some room
+                std::this_thread::yield();
+            }
+        }
+
+        wake();
     }
 
     auto ThreadPool::worker_count() -> std::uint32_t
@@ -72,37 +144,107 @@ namespace ufps
         }
     }
 
-    auto ThreadPool::worker(std::stop_token stop_token) -> void
+    auto ThreadPool::worker(std::uint32_t index, std::stop_token stop_token) -> void
     {
         log::info("starting worker thread: {}", std::this_thread::get_id());
 
+        current_worker = {.pool = this, .index = index};
+
+        auto idle_count = 0u;
+
         while (!stop_token.stop_requested())
         {
-            auto job = Job{};
+            if (auto *job = find_job(index); job != nullptr)
+            {
+                run(job);
+                idle_count = 0u;
+                continue;
+            }
 
+            if (idle_count < spin_count)
             {
-                auto lock = std::unique_lock{_worker_lock};
-                _worker_cv.wait(
-                    lock,
-                    stop_token,
-                    [&]
-                    { return !_job_queue.empty(); });
-
-                if (stop_token.stop_requested())
-                {
-                    break;
-                }
-
-                job = _job_queue.pop();
+                ++idle_count;
+                cpu_relax();
+                continue;
             }
 
-            job();
+            if (idle_count < spin_count + yield_count)
+            {
+                ++idle_count;
+                std::this_thread::yield();
+                continue;
+            }
+
+            // announce we are going to sleep before the last look for work, so an add either sees us sleeping and
+            // bumps the epoch or we see its job
+            const auto epoch = _wake_epoch.load();
+            ++_sleeping_count;
+            std::atomic_thread_fence(std::memory_order_seq_cst);
 
-            if (--_job_count == 0u)
+            if (auto *job = find_job(index); job != nullptr)
             {
-                _job_count.notify_all();
+                --_sleeping_count;
+                run(job);
+                idle_count = 0u;
+                continue;
             }
+
+            if (!stop_token.stop_requested())
+            {
+                _wake_epoch.wait(epoch);
+            }
+
+            --_sleeping_count;
+            idle_count = 0u;
         }
+
+        current_worker = {.pool = nullptr, .index = 0u};
+
         log::info("ending worker thread: {}", std::this_thread::get_id());
     }
-}
\ No newline at end of file
+
+    auto ThreadPool::find_job(std::uint32_t index) -> Job *
+    {
+        if (const auto job = _deques[index]->pop())
+        {
+            return *job;
+        }
+
+        if (const auto job = _injection_queue.try_pop())
+        {
+            return *job;
+        }
+
+        for (auto i = 1u; i < _worker_count; ++i)
+        {
+            if (const auto job = _deques[(index + i) % _worker_count]->steal())
+            {
+                return *job;
+            }
+        }
+
+        return nullptr;
+    }
+
+    auto ThreadPool::run(Job *job) -> void
+    {
+        const auto owned = std::unique_ptr<Job>{job};
+        (*owned)();
+
+        if (--_job_count == 0u)
+        {
+            _job_count.notify_all();
+        }
+    }
+
+    auto ThreadPool::wake() -> void
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (_sleeping_count.load() != 0u)
+        {
+            ++_wake_epoch;
+            _wake_epoch.notify_one();
+        }
+    }
+}
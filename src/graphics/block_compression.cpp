@@ -0,0 +1,446 @@
+#include "graphics/block_compression.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <utility>
+
+#include "concurrency/parallel_for.h"
+#include "concurrency/thread_pool.h"
+#include "graphics/mip_chain.h"
+#include "graphics/texture_data.h"
+#include "utils/data_buffer.h"
+#include "utils/ensure.h"
+
+namespace
+{
+    constexpr auto bc7_weights = std::array<std::uint32_t, 16zu>{0u, 4u, 9u, 13u, 17u, 21u, 26u, 30u, 34u, 38u, 43u, 47u, 51u, 55u, 60u, 64u};
+
+    // blocks per parallel_for chunk, a block is only a few microseconds of work
+    constexpr auto blocks_per_chunk = 64zu;
+
+    using Colour = std::array<float, 4zu>;
+
+    // writes fields lsb first, as BC blocks are laid out
+    class BitWriter
+    {
+    public:
+        auto write(std::uint32_t value, std::uint32_t bits) -> void
+        {
+            for (auto i = 0u; i < bits; ++i, ++_position)
+            {
+                if ((value >> i) & 1u)
+                {
+                    _block[_position / 8u] |= static_cast<std::byte>(1u << (_position % 8u));
+                }
+            }
+        }
+
+        auto block() const -> const ufps::CompressedBlock &
+        {
+            return _block;
+        }
+
+    private:
+        ufps::CompressedBlock _block{};
+        std::uint32_t _position = 0u;
+    };
+
+    // a mode 6 endpoint pair, each channel is 7 bits with the p-bit as the shared lsb
+    struct Bc7Endpoints
+    {
+        std::array<std::array<std::uint32_t, 4zu>, 2zu> quantised;
+        std::array<std::uint32_t, 2zu> p_bits;
+
+        auto value(std::size_t endpoint, std::size_t channel) const -> std::uint32_t
+        {
+            return (quantised[endpoint][channel] << 1u) | p_bits[endpoint];
+        }
+    };
+
+    struct Bc7Fit
+    {
+        Bc7Endpoints endpoints;
+        std::array<std::uint32_t, 16zu> indices;
+        float error;
+    };
+
+    auto quantise(const Colour &colour, std::uint32_t p_bit) -> std::array<std::uint32_t, 4zu>
+    {
+        auto quantised = std::array<std::uint32_t, 4zu>{};
+        for (auto c = 0zu; c < 4zu; ++c)
+        {
+            const auto q = std::round((colour[c] - static_cast<float>(p_bit)) / 2.f);
+            quantised[c] = static_cast<std::uint32_t>(std::clamp(q, 0.f, 127.f));
+        }
+
+        return quantised;
+    }
+
+    // picks the closest palette entry for every pixel
+    auto fit_indices(std::span<const std::uint8_t, 64zu> pixels, const Bc7Endpoints &endpoints) -> Bc7Fit
+    {
+        auto palette = std::array<Colour, 16zu>{};
+        for (auto i = 0zu; i < palette.size(); ++i)
+        {
+            for (auto c = 0zu; c < 4zu; ++c)
+            {
+                const auto e0 = endpoints.value(0zu, c);
+                const auto e1 = endpoints.value(1zu, c);
+                palette[i][c] = static_cast<float>(((64u - bc7_weights[i]) * e0 + bc7_weights[i] * e1 + 32u) >> 6u);
+            }
+        }
+
+        auto fit = Bc7Fit{.endpoints = endpoints, .indices = {}, .error = 0.f};
+
+        for (auto p = 0zu; p < 16zu; ++p)
+        {
+            auto best_error = std::numeric_limits<float>::max();
+
+            for (auto i = 0u; i < palette.size(); ++i)
+            {
+                auto error = 0.f;
+                for (auto c = 0zu; c < 4zu; ++c)
+                {
+                    const auto d = palette[i][c] - static_cast<float>(pixels[p * 4zu + c]);
+                    error += d * d;
+                }
+
+                if (error < best_error)
+                {
+                    best_error = error;
+                    fit.indices[p] = i;
+                }
+            }
+
+            fit.error += best_error;
+        }
+
+        return fit;
+    }
+
+    // tries every p-bit combination for a pair of unquantised endpoints
+    auto fit_endpoints(std::span<const std::uint8_t, 64zu> pixels, const Colour &low, const Colour &high) -> Bc7Fit
+    {
+        auto best = Bc7Fit{.endpoints = {}, .indices = {}, .error = std::numeric_limits<float>::max()};
+
+        for (auto p0 = 0u; p0 < 2u; ++p0)
+        {
+            for (auto p1 = 0u; p1 < 2u; ++p1)
+            {
+                const auto endpoints = Bc7Endpoints{.quantised = {quantise(low, p0), quantise(high, p1)}, .p_bits = {p0, p1}};
+                const auto fit = fit_indices(pixels, endpoints);
+
+                if (fit.error < best.error)
+                {
+                    best = fit;
+                }
+            }
+        }
+
+        return best;
+    }
+
+    // least squares endpoints for the indices of fit, nullopt if every pixel uses the same weight
+    auto refine(std::span<const std::uint8_t, 64zu> pixels, const Bc7Fit &fit) -> std::optional<std::array<Colour, 2zu>>
+    {
+        auto aa = 0.f;
+        auto ab = 0.f;
+        auto bb = 0.f;
+        auto ax = Colour{};
+        auto bx = Colour{};
+
+        for (auto p = 0zu; p < 16zu; ++p)
+        {
+            const auto w = static_cast<float>(bc7_weights[fit.indices[p]]) / 64.f;
+            aa += (1.f - w) * (1.f - w);
+            ab += (1.f - w) * w;
+            bb += w * w;
+
+            for (auto c = 0zu; c < 4zu; ++c)
+            {
+                ax[c] += (1.f - w) * static_cast<float>(pixels[p * 4zu + c]);
+                bx[c] += w * static_cast<float>(pixels[p * 4zu + c]);
+            }
+        }
+
+        const auto det = aa * bb - ab * ab;
+        if (std::abs(det) < 1e-6f)
+        {
+            return std::nullopt;
+        }
+
+        auto endpoints = std::array<Colour, 2zu>{};
+        for (auto c = 0zu; c < 4zu; ++c)
+        {
+            endpoints[0][c] = std::clamp((ax[c] * bb - bx[c] * ab) / det, 0.f, 255.f);
+            endpoints[1][c] = std::clamp((bx[c] * aa - ax[c] * ab) / det, 0.f, 255.f);
+        }
+
+        return endpoints;
+    }
+
+    // the pixels' extent along their principal axis, which is where a single line of colours fits them best
+    auto principal_endpoints(std::span<const std::uint8_t, 64zu> pixels) -> std::array<Colour, 2zu>
+    {
+        auto mean = Colour{};
+        auto low = Colour{255.f, 255.f, 255.f, 255.f};
+        auto high = Colour{};
+
+        for (auto p = 0zu; p < 16zu; ++p)
+        {
+            for (auto c = 0zu; c < 4zu; ++c)
+            {
+                const auto value = static_cast<float>(pixels[p * 4zu + c]);
+                mean[c] += value / 16.f;
+                low[c] = std::min(low[c], value);
+                high[c] = std::max(high[c], value);
+            }
+        }
+
+        auto covariance = std::array<std::array<float, 4zu>, 4zu>{};
+        for (auto p = 0zu; p < 16zu; ++p)
+        {
+            for (auto i = 0zu; i < 4zu; ++i)
+            {
+                for (auto j = 0zu; j < 4zu; ++j)
+                {
+                    covariance[i][j] += (pixels[p * 4zu + i] - mean[i]) * (pixels[p * 4zu + j] - mean[j]);
+                }
+            }
+        }
+
+        // power iteration from the bounding box diagonal converges in a handful of steps for 4x4 matrices
+        auto axis = Colour{};
+        for (auto c = 0zu; c < 4zu; ++c)
+        {
+            axis[c] = high[c] - low[c];
+        }
+
+        for (auto iteration = 0u; iteration < 8u; ++iteration)
+        {
+            auto next = Colour{};
+            for (auto i = 0zu; i < 4zu; ++i)
+            {
+                for (auto j = 0zu; j < 4zu; ++j)
+                {
+                    next[i] += covariance[i][j] * axis[j];
+                }
+            }
+
+            const auto length = std::sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2] + next[3] * next[3]);
+            if (length < 1e-6f)
+            {
+                break;
+            }
+
+            for (auto c = 0zu; c < 4zu; ++c)
+            {
+                axis[c] = next[c] / length;
+            }
+        }
+
+        const auto length = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2] + axis[3] * axis[3]);
+        if (length < 1e-6f)
+        {
+            return {mean, mean};
+        }
+
+        auto t_min = std::numeric_limits<float>::max();
+        auto t_max = std::numeric_limits<float>::lowest();
+        for (auto p = 0zu; p < 16zu; ++p)
+        {
+            auto t = 0.f;
+            for (auto c = 0zu; c < 4zu; ++c)
+            {
+                t += (pixels[p * 4zu + c] - mean[c]) * axis[c] / length;
+            }
+
+            t_min = std::min(t_min, t);
+            t_max = std::max(t_max, t);
+        }
+
+        auto endpoints = std::array<Colour, 2zu>{};
+        for (auto c = 0zu; c < 4zu; ++c)
+        {
+            endpoints[0][c] = std::clamp(mean[c] + axis[c] / length * t_min, 0.f, 255.f);
+            endpoints[1][c] = std::clamp(mean[c] + axis[c] / length * t_max, 0.f, 255.f);
+        }
+
+        return endpoints;
+    }
+
+    auto encode_bc4_block(std::span<const std::uint8_t, 64zu> pixels, std::size_t channel, BitWriter &writer) -> void
+    {
+        auto high = 0u;
+        auto low = 255u;
+        for (auto p = 0zu; p < 16zu; ++p)
+        {
+            high = std::max<std::uint32_t>(high, pixels[p * 4zu + channel]);
+            low = std::min<std::uint32_t>(low, pixels[p * 4zu + channel]);
+        }
+
+        // red0 > red1 selects the eight value palette, a flat block just uses index 0
+        auto palette = std::array<std::uint32_t, 8zu>{high, low};
+        for (auto i = 2u; i < 8u; ++i)
+        {
+            palette[i] = ((8u - i) * high + (i - 1u) * low + 3u) / 7u;
+        }
+
+        writer.write(high, 8u);
+        writer.write(low, 8u);
+
+        for (auto p = 0zu; p < 16zu; ++p)
+        {
+            const auto value = static_cast<std::int32_t>(pixels[p * 4zu + channel]);
+            const auto best = std::ranges::min_element(
+                palette, {}, [value](auto entry) { return std::abs(static_cast<std::int32_t>(entry) - value); });
+
+            writer.write(high == low ? 0u : static_cast<std::uint32_t>(std::distance(palette.begin(), best)), 3u);
+        }
+    }
+
+    auto is_supported_target(ufps::TextureFormat format) -> bool
+    {
+        using enum ufps::TextureFormat;
+        return format == BC7 || format == BC7_SRGB || format == BC5U;
+    }
+}
+
+namespace ufps
+{
+    auto encode_bc7_block(std::span<const std::uint8_t, 64zu> pixels) -> CompressedBlock
+    {
+        const auto [low, high] = principal_endpoints(pixels);
+        auto fit = fit_endpoints(pixels, low, high);
+
+        for (auto iteration = 0u; iteration < 2u && fit.error > 0.f; ++iteration)
+        {
+            const auto refined = refine(pixels, fit);
+            if (!refined)
+            {
+                break;
+            }
+
+            const auto candidate = fit_endpoints(pixels, (*refined)[0], (*refined)[1]);
+            if (candidate.error >= fit.error)
+            {
+                break;
+            }
+
+            fit = candidate;
+        }
+
+        // the msb of the first index is implied zero, swapping the endpoints flips every index to make it so
+        if (fit.indices[0] >= 8u)
+        {
+            std::ranges::swap(fit.endpoints.quantised[0], fit.endpoints.quantised[1]);
+            std::ranges::swap(fit.endpoints.p_bits[0], fit.endpoints.p_bits[1]);
+            std::ranges::transform(fit.indices, fit.indices.begin(), [](auto index) { return 15u - index; });
+        }
+
+        auto writer = BitWriter{};
+        writer.write(1u << 6u, 7u);
+
+        for (auto c = 0zu; c < 4zu; ++c)
+        {
+            writer.write(fit.endpoints.quantised[0][c], 7u);
+            writer.write(fit.endpoints.quantised[1][c], 7u);
+        }
+
+        writer.write(fit.endpoints.p_bits[0], 1u);
+        writer.write(fit.endpoints.p_bits[1], 1u);
+
+        for (auto p = 0zu; p < 16zu; ++p)
+        {
+            writer.write(fit.indices[p], p == 0zu ? 3u : 4u);
+        }
+
+        return writer.block();
+    }
+
+    auto encode_bc5_block(std::span<const std::uint8_t, 64zu> pixels) -> CompressedBlock
+    {
+        auto writer = BitWriter{};
+        encode_bc4_block(pixels, 0zu, writer);
+        encode_bc4_block(pixels, 1zu, writer);
+
+        return writer.block();
+    }
+
+    auto block_compress(const TextureData &texture, TextureFormat format, ThreadPool &pool) -> TextureData
+    {
+        ensure(
+            texture.format == TextureFormat::RGBA || texture.format == TextureFormat::SRGBA,
+            "can only block compress RGBA textures: {}",
+            to_string(texture.format));
+        ensure(texture.data.has_value(), "cannot block compress without texture data");
+        ensure(is_supported_target(format), "cannot block compress to: {}", to_string(format));
+
+        const auto source_chain = mip_chain(texture);
+        const auto chain = mip_chain(format, texture.width, texture.height, texture.mip_levels);
+
+        ensure(
+            texture.data->size() >= source_chain.back().offset + source_chain.back().size,
+            "texture data too small for {} mips: {}",
+            texture.mip_levels,
+            texture.data->size());
+
+        auto data = DataBuffer(chain.back().offset + chain.back().size);
+        const auto *source = reinterpret_cast<const std::uint8_t *>(texture.data->data());
+
+        for (const auto &[source_mip, mip] : std::views::zip(source_chain, chain))
+        {
+            const auto blocks_x = (mip.width + 3u) / 4u;
+            const auto blocks_y = (mip.height + 3u) / 4u;
+
+            parallel_for(
+                pool,
+                0zu,
+                static_cast<std::size_t>(blocks_x) * blocks_y,
+                blocks_per_chunk,
+                [&](std::size_t first, std::size_t last)
+                {
+                    for (auto block = first; block < last; ++block)
+                    {
+                        const auto bx = static_cast<std::uint32_t>(block % blocks_x) * 4u;
+                        const auto by = static_cast<std::uint32_t>(block / blocks_x) * 4u;
+
+                        // blocks hanging off the edge of a mip repeat its last row and column
+                        auto pixels = std::array<std::uint8_t, 64zu>{};
+                        for (auto y = 0u; y < 4u; ++y)
+                        {
+                            for (auto x = 0u; x < 4u; ++x)
+                            {
+                                const auto sx = std::min(bx + x, source_mip.width - 1u);
+                                const auto sy = std::min(by + y, source_mip.height - 1u);
+                                const auto *texel = source + source_mip.offset + (static_cast<std::size_t>(sy) * source_mip.width + sx) * 4zu;
+
+                                std::memcpy(pixels.data() + (y * 4u + x) * 4u, texel, 4zu);
+                            }
+                        }
+
+                        const auto encoded = format == TextureFormat::BC5U ? encode_bc5_block(pixels) : encode_bc7_block(pixels);
+                        std::memcpy(data.data() + mip.offset + block * encoded.size(), encoded.data(), encoded.size());
+                    }
+                });
+        }
+
+        return {
+            .width = texture.width,
+            .height = texture.height,
+            .format = format,
+            .data = std::move(data),
+            .is_compressed = true,
+            .mip_levels = texture.mip_levels,
+        };
+    }
+}
@@ -1,11 +1,16 @@
 #include "graphics/command_buffer.h"
 
+#include <chrono>
 #include <cstdint>
 #include <ranges>
+#include <span>
 #include <string>
 #include <string_view>
 
 #include "core/scene.h"
+#include "graphics/culling.h"
+#include "graphics/indirect_command.h"
+#include "graphics/instance_table.h"
 #include "graphics/multi_buffer.h"
 #include "graphics/opengl.h"
 #include "graphics/persistent_buffer.h"
@@ -13,19 +18,6 @@
 #include "log.h"
 #include "utils/formatter.h"
 
-namespace
-{
-    struct IndirectCommand
-    {
-        std::uint32_t count;
-        std::uint32_t instanceCount;
-        std::uint32_t first_index;
-        std::int32_t base_vertex;
-        std::uint32_t baseInstance;
-    };
-
-}
-
 namespace ufps
 {
     CommandBuffer::CommandBuffer(std::string_view name)
@@ -33,36 +25,22 @@ namespace ufps
     {
     }
 
-    auto CommandBuffer::build(const Scene &scene, EntityFilterMode filter_mode) -> std::uint32_t
+    auto CommandBuffer::build(const Scene &scene, std::span<const DrawItem> draws, const InstanceTable &table) -> std::uint32_t
     {
-        const auto command = scene.entities() |
-                             std::views::transform(
-                                 [](const auto &e)
-                                 { return e.render_entities(); }) |
-                             std::views::join |
-                             std::views::filter([filter_mode](const auto &e)
-                                                { 
-                                                    switch(filter_mode)
-                                                    {
-                                                        using enum EntityFilterMode;
-                                                        case ALL:
-                                                            return true;
-                                                        case OPAQUE:
-                                                            return e.opacity() > 0.9999f;
-                                                        case TRANSPARENT:
-                                                            return e.opacity() < 1.f; 
-                                                        default:
-                                                            return true;
-                                                    } }) |
+        const auto entities = scene.entities();
+
+        // base instance is the slot of the draw, shaders use it to look up their ObjectData
+        const auto command = draws |
                              std::views::transform(
-                                 [](const auto &e)
+                                 [&entities, &table](const auto &draw)
                                  {
+                                     const auto &e = entities[draw.entity_index].render_entities()[draw.render_entity_index];
                                      return IndirectCommand{
                                          .count = e.mesh_view().index_count,
                                          .instanceCount = 1u,
                                          .first_index = e.mesh_view().index_offset,
                                          .base_vertex = static_cast<std::int32_t>(e.mesh_view().vertex_offset),
-                                         .baseInstance = 0u};
+                                         .baseInstance = table.slot(draw)};
                                  }) |
                              std::ranges::to<std::vector>();
 
@@ -109,6 +87,11 @@ namespace ufps
         _command_buffer.advance();
     }
 
+    auto CommandBuffer::fence_wait() const -> std::chrono::nanoseconds
+    {
+        return _command_buffer.fence_wait();
+    }
+
     auto CommandBuffer::offset_bytes() const -> std::size_t
     {
         return _command_buffer.frame_offset_bytes();
@@ -1,10 +1,14 @@
 #include "graphics/debug_renderer.h"
 
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
 #include <cstring>
 #include <ranges>
 #include <string>
 #include <type_traits>
+#include <utility>
 
 #include <imgui.h>
 
@@ -52,23 +56,29 @@ namespace
 
     auto create_aabb_lines(const ufps::AABB &aabb, const ufps::Matrix4 &transform, const ufps::Color &color) -> std::vector<ufps::LineData>
     {
-        auto lines = std::vector<ufps::LineData>{};
-        lines.reserve(24);
+        // bit 0, 1 and 2 of the index pick max over min for x, y and z
+        auto corners = std::array<ufps::Vector4, 8u>{};
+        for (const auto &[index, corner] : std::views::enumerate(corners))
+        {
+            corner = ufps::Vector4{
+                (index & 1) ? aabb.max.x : aabb.min.x,
+                (index & 2) ? aabb.max.y : aabb.min.y,
+                (index & 4) ? aabb.max.z : aabb.min.z,
+                1.f};
+        }
 
-        draw_line(transform * ufps::Vector4{aabb.max.x, aabb.max.y, aabb.max.z, 1.f}, transform * ufps::Vector4{aabb.min.x, aabb.max.y, aabb.max.z, 1.f}, color, lines);
-        draw_line(transform * ufps::Vector4{aabb.min.x, aabb.max.y, aabb.max.z, 1.f}, transform * ufps::Vector4{aabb.min.x, aabb.max.y, aabb.min.z, 1.f}, color, lines);
-        draw_line(transform * ufps::Vector4{aabb.min.x, aabb.max.y, aabb.min.z, 1.f}, transform * ufps::Vector4{aabb.max.x, aabb.max.y, aabb.min.z, 1.f}, color, lines);
-        draw_line(transform * ufps::Vector4{aabb.max.x, aabb.max.y, aabb.min.z, 1.f}, transform * ufps::Vector4{aabb.max.x, aabb.max.y, aabb.max.z, 1.f}, color, lines); //
+        ufps::Matrix4::transform(transform, corners, corners);
 
-        draw_line(transform * ufps::Vector4{aabb.max.x, aabb.max.y, aabb.max.z, 1.f}, transform * ufps::Vector4{aabb.max.x, aabb.min.y, aabb.max.z, 1.f}, color, lines);
-        draw_line(transform * ufps::Vector4{aabb.min.x, aabb.max.y, aabb.max.z, 1.f}, transform * ufps::Vector4{aabb.min.x, aabb.min.y, aabb.max.z, 1.f}, color, lines);
-        draw_line(transform * ufps::Vector4{aabb.min.x, aabb.max.y, aabb.min.z, 1.f}, transform * ufps::Vector4{aabb.min.x, aabb.min.y, aabb.min.z, 1.f}, color, lines);
-        draw_line(transform * ufps::Vector4{aabb.max.x, aabb.max.y, aabb.min.z, 1.f}, transform * ufps::Vector4{aabb.max.x, aabb.min.y, aabb.min.z, 1.f}, color, lines); //
+        static constexpr auto edges = std::array<std::pair<std::size_t, std::size_t>, 12u>{
+            {{7u, 6u}, {6u, 2u}, {2u, 3u}, {3u, 7u}, {7u, 5u}, {6u, 4u}, {2u, 0u}, {3u, 1u}, {5u, 4u}, {4u, 0u}, {0u, 1u}, {1u, 5u}}};
 
-        draw_line(transform * ufps::Vector4{aabb.max.x, aabb.min.y, aabb.max.z, 1.f}, transform * ufps::Vector4{aabb.min.x, aabb.min.y, aabb.max.z, 1.f}, color, lines);
-        draw_line(transform * ufps::Vector4{aabb.min.x, aabb.min.y, aabb.max.z, 1.f}, transform * ufps::Vector4{aabb.min.x, aabb.min.y, aabb.min.z, 1.f}, color, lines);
-        draw_line(transform * ufps::Vector4{aabb.min.x, aabb.min.y, aabb.min.z, 1.f}, transform * ufps::Vector4{aabb.max.x, aabb.min.y, aabb.min.z, 1.f}, color, lines);
-        draw_line(transform * ufps::Vector4{aabb.max.x, aabb.min.y, aabb.min.z, 1.f}, transform * ufps::Vector4{aabb.max.x, aabb.min.y, aabb.max.z, 1.f}, color, lines);
+        auto lines = std::vector<ufps::LineData>{};
+        lines.reserve(edges.size() * 2u);
+
+        for (const auto &[start, end] : edges)
+        {
+            draw_line(corners[start], corners[end], color, lines);
+        }
 
         return lines;
     }
@@ -268,6 +278,9 @@ namespace ufps
 
         ::ImGui::LabelText("FPS", "%0.1f", io.Framerate);
         ::ImGui::LabelText("Debug Line Count", "%zu", debug_line_count);
+        ::ImGui::LabelText("Opaque Draws", "%u visible / %u culled", _opaque_culling_stats.visible_draws, _opaque_culling_stats.culled_draws);
+        ::ImGui::LabelText("Transparent Draws", "%u visible / %u culled", _transparent_culling_stats.visible_draws, _transparent_culling_stats.culled_draws);
+        ::ImGui::LabelText("Fence Wait", "%0.3f ms", std::chrono::duration<float, std::milli>{_fence_wait}.count());
 
         if (::ImGui::Button("save"))
         {
@@ -386,6 +399,32 @@ namespace ufps
             }
         }
 
+        ::ImGui::Text("Culling options");
+
+        {
+            auto value = scene.culling_options().gpu_driven;
+            if (::ImGui::Checkbox("gpu driven", &value))
+            {
+                scene.culling_options().gpu_driven = value;
+            }
+        }
+
+        {
+            auto value = scene.culling_options().occlusion_culling;
+            if (::ImGui::Checkbox("occlusion culling", &value))
+            {
+                scene.culling_options().occlusion_culling = value;
+            }
+        }
+
+        {
+            auto value = scene.culling_options().cluster_culling;
+            if (::ImGui::Checkbox("cluster culling", &value))
+            {
+                scene.culling_options().cluster_culling = value;
+            }
+        }
+
         ::ImGui::Text("fog options");
 
         {
@@ -0,0 +1,51 @@
+#include "graphics/gpu_fence.h"
+
+#include <chrono>
+#include <cstdint>
+
+#include "graphics/opengl.h"
+#include "utils/auto_release.h"
+#include "utils/ensure.h"
+
+namespace
+{
+    constexpr auto wait_timeout = std::uint64_t{1'000'000'000u};
+}
+
+namespace ufps
+{
+    GpuFence::GpuFence()
+        : _sync{}
+    {
+    }
+
+    auto GpuFence::signal() -> void
+    {
+        _sync = {::glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), [](auto sync) { ::glDeleteSync(sync); }};
+    }
+
+    auto GpuFence::wait() -> std::chrono::nanoseconds
+    {
+        if (!_sync)
+        {
+            return {};
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+
+        for (;;)
+        {
+            const auto result = ::glClientWaitSync(_sync, GL_SYNC_FLUSH_COMMANDS_BIT, wait_timeout);
+            ensure(result != GL_WAIT_FAILED, "failed to wait for fence");
+
+            if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED)
+            {
+                break;
+            }
+        }
+
+        _sync.reset(nullptr);
+
+        return std::chrono::steady_clock::now() - start;
+    }
+}
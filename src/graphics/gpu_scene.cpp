@@ -0,0 +1,177 @@
+#include "graphics/gpu_scene.h"
+
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <vector>
+
+#include "core/scene.h"
+#include "graphics/buffer.h"
+#include "graphics/gpu_fence.h"
+#include "graphics/instance_culling.h"
+#include "graphics/instance_data.h"
+#include "graphics/instance_table.h"
+#include "graphics/multi_buffer.h"
+#include "graphics/object_data.h"
+#include "graphics/persistent_buffer.h"
+#include "graphics/texture_manager.h"
+#include "log.h"
+
+namespace
+{
+    template <class T, class B>
+    auto grow(B &buffer, std::uint32_t count) -> bool
+    {
+        const auto required_size = count * sizeof(T);
+        if (buffer.size() >= required_size)
+        {
+            return false;
+        }
+
+        const auto new_size = std::max(required_size, buffer.size() * 2zu);
+        ufps::log::info("growing {} buffer {} -> {}", buffer.name(), buffer.size(), new_size);
+
+        buffer = B{new_size, buffer.name()};
+
+        return true;
+    }
+
+    template <class T, class R, class F>
+    auto upload(
+        const ufps::InstanceTable &table,
+        const R &entities,
+        const ufps::TextureManager &texture_manager,
+        const ufps::DirtySlots &dirty,
+        F &&write) -> void
+    {
+        for (const auto &range : dirty.ranges())
+        {
+            const auto data = std::views::iota(range.first, range.first + range.count) |
+                              std::views::transform(
+                                  [&](const auto slot)
+                                  {
+                                      const auto owner = table.owner(slot);
+                                      const auto &entity = entities[owner.entity_index];
+                                      const auto &render_entity = entity.render_entities()[owner.render_entity_index];
+
+                                      if constexpr (std::same_as<T, ufps::InstanceData>)
+                                      {
+                                          return ufps::create_instance_data(entity, render_entity);
+                                      }
+                                      else
+                                      {
+                                          return ufps::create_object_data(
+                                              entity,
+                                              render_entity,
+                                              [&](auto handle) { return texture_manager.resolve(handle); });
+                                      }
+                                  }) |
+                              std::ranges::to<std::vector>();
+
+            write(std::as_bytes(std::span{data}), range.first * sizeof(T));
+        }
+    }
+}
+
+namespace ufps
+{
+    GpuScene::GpuScene()
+        : _table{},
+          _object_data_dirty{},
+          _instance_buffer{sizeof(InstanceData), "gpu_scene_instance_buffer"},
+          _object_data_buffer{sizeof(ObjectData), "gpu_scene_object_data_buffer"},
+          _texture_revision{},
+          _meshlet_count{}
+    {
+    }
+
+    auto GpuScene::update(const Scene &scene) -> bool
+    {
+        const auto entities = scene.entities();
+        const auto slots_changed = _table.sync(entities, scene.revision());
+
+        if (slots_changed)
+        {
+            _meshlet_count = 0u;
+            for (const auto slot : std::views::iota(0u, _table.slot_count()))
+            {
+                const auto owner = _table.owner(slot);
+                _meshlet_count += entities[owner.entity_index].render_entities()[owner.render_entity_index].mesh_view().meshlet_count;
+            }
+        }
+
+        // new buffers start out empty so everything needs uploading again
+        if (grow<InstanceData>(_instance_buffer, _table.slot_count()))
+        {
+            _table.mark_all_dirty();
+        }
+
+        _object_data_dirty.mark(_table.dirty());
+
+        // a redirected texture handle could be in any object's data
+        const auto texture_revision = scene.texture_manager().revision();
+        if (grow<ObjectData>(_object_data_buffer, _table.slot_count()) || texture_revision != _texture_revision)
+        {
+            _object_data_dirty.mark(0u, _table.slot_count());
+            _texture_revision = texture_revision;
+        }
+
+        upload<InstanceData>(
+            _table,
+            entities,
+            scene.texture_manager(),
+            _table.dirty(),
+            [this](auto data, auto offset) { _instance_buffer.write(data, offset); });
+
+        upload<ObjectData>(
+            _table,
+            entities,
+            scene.texture_manager(),
+            _object_data_dirty.current(),
+            [this](auto data, auto offset) { _object_data_buffer.write(data, offset); });
+
+        _table.clear_dirty();
+        _object_data_dirty.clear_current();
+
+        return slots_changed;
+    }
+
+    auto GpuScene::advance() -> void
+    {
+        _object_data_buffer.advance();
+        _object_data_dirty.advance();
+    }
+
+    auto GpuScene::fence_wait() const -> std::chrono::nanoseconds
+    {
+        return _object_data_buffer.fence_wait();
+    }
+
+    auto GpuScene::instance_count() const -> std::uint32_t
+    {
+        return _table.slot_count();
+    }
+
+    auto GpuScene::meshlet_count() const -> std::uint32_t
+    {
+        return _meshlet_count;
+    }
+
+    auto GpuScene::table() const -> const InstanceTable &
+    {
+        return _table;
+    }
+
+    auto GpuScene::instance_buffer() const -> const Buffer &
+    {
+        return _instance_buffer;
+    }
+
+    auto GpuScene::object_data_buffer() const -> const MultiBuffer<PersistentBuffer, 3zu, GpuFence> &
+    {
+        return _object_data_buffer;
+    }
+}
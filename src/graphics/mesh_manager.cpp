@@ -1,16 +1,24 @@
 #include "graphics/mesh_manager.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <ranges>
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
 
 #include "graphics/buffer.h"
+#include "graphics/compact_vertex.h"
 #include "graphics/mesh_data.h"
-#include "graphics/utils.h"
+#include "graphics/meshlet.h"
+#include "graphics/opengl.h"
+#include "graphics/ring_allocator.h"
+#include "graphics/staging_ring.h"
 #include "graphics/vertex_data.h"
 #include "log.h"
+#include "utils/data_buffer.h"
 #include "utils/ensure.h"
 #include "utils/formatter.h"
 #include "utils/string_unordered_map.h"
@@ -20,52 +28,66 @@ namespace ufps
     MeshManager::MeshManager()
         : _vertex_data_cpu{},
           _index_data_cpu{},
-          _vertex_data_gpu{sizeof(VertexData), "vertex_mesh_data"},
+          _meshlet_data_cpu{},
+          _vertex_data_gpu{sizeof(CompactVertex), "vertex_mesh_data"},
           _index_data_gpu{sizeof(std::uint32_t), "index_mesh_data"},
-          _mesh_lookup{}
+          _meshlet_data_gpu{sizeof(Meshlet), "meshlet_mesh_data"},
+          _mesh_lookup{},
+          _staging{mesh_staging_size, "mesh_staging"}
     {
     }
 
     MeshManager::MeshManager(
         std::vector<VertexData> vertex_data,
         std::vector<std::uint32_t> index_data,
+        std::vector<Meshlet> meshlet_data,
         StringUnorderedMap<std::vector<MeshView>> mesh_lookup)
-        : _vertex_data_cpu{std::move(vertex_data)},
+        : _vertex_data_cpu{vertex_data | std::views::transform(encode_vertex) | std::ranges::to<std::vector>()},
           _index_data_cpu{std::move(index_data)},
-          _vertex_data_gpu{sizeof(VertexData), "vertex_mesh_data"},
+          _meshlet_data_cpu{std::move(meshlet_data)},
+          _vertex_data_gpu{sizeof(CompactVertex), "vertex_mesh_data"},
           _index_data_gpu{sizeof(std::uint32_t), "index_mesh_data"},
-          _mesh_lookup{std::move(mesh_lookup)}
+          _meshlet_data_gpu{sizeof(Meshlet), "meshlet_mesh_data"},
+          _mesh_lookup{std::move(mesh_lookup)},
+          _staging{mesh_staging_size, "mesh_staging"}
     {
-        resize_gpu_buffer(_vertex_data_cpu, _vertex_data_gpu);
-        const auto vertex_data_view = DataBufferView{
-            reinterpret_cast<const std::byte *>(_vertex_data_cpu.data()), _vertex_data_gpu.size() * sizeof(VertexData)};
-        _vertex_data_gpu.write(vertex_data_view, 0u);
-
-        resize_gpu_buffer(_index_data_cpu, _index_data_gpu);
-        const auto index_data_view = DataBufferView{
-            reinterpret_cast<const std::byte *>(_index_data_cpu.data()), _index_data_cpu.size() * sizeof(std::uint32_t)};
-        _index_data_gpu.write(index_data_view, 0u);
+        upload(std::as_bytes(std::span{_vertex_data_cpu}), 0zu, _vertex_data_gpu);
+        upload(std::as_bytes(std::span{_index_data_cpu}), 0zu, _index_data_gpu);
+        upload(std::as_bytes(std::span{_meshlet_data_cpu}), 0zu, _meshlet_data_gpu);
     }
 
     MeshManager::MeshManager(
         DataBufferView raw_vertex_data,
         DataBufferView raw_index_data,
+        DataBufferView raw_meshlet_data,
         StringUnorderedMap<std::vector<MeshView>> mesh_lookup)
         : _vertex_data_cpu{
-              reinterpret_cast<const VertexData *>(raw_vertex_data.data()),
-              reinterpret_cast<const VertexData *>(raw_vertex_data.data() + raw_vertex_data.size())},
+              reinterpret_cast<const CompactVertex *>(raw_vertex_data.data()),
+              reinterpret_cast<const CompactVertex *>(raw_vertex_data.data() + raw_vertex_data.size())},
           _index_data_cpu{
               reinterpret_cast<const std::uint32_t *>(raw_index_data.data()),
               reinterpret_cast<const std::uint32_t *>(raw_index_data.data() + raw_index_data.size())},
-          _vertex_data_gpu{sizeof(VertexData), "vertex_mesh_data"},
+          _meshlet_data_cpu{
+              reinterpret_cast<const Meshlet *>(raw_meshlet_data.data()),
+              reinterpret_cast<const Meshlet *>(raw_meshlet_data.data() + raw_meshlet_data.size())},
+          _vertex_data_gpu{sizeof(CompactVertex), "vertex_mesh_data"},
           _index_data_gpu{sizeof(std::uint32_t), "index_mesh_data"},
-          _mesh_lookup{std::move(mesh_lookup)}
+          _meshlet_data_gpu{sizeof(Meshlet), "meshlet_mesh_data"},
+          _mesh_lookup{std::move(mesh_lookup)},
+          _staging{mesh_staging_size, "mesh_staging"}
     {
-        resize_gpu_buffer(_vertex_data_cpu, _vertex_data_gpu);
-        _vertex_data_gpu.write(raw_vertex_data, 0u);
-
-        resize_gpu_buffer(_index_data_cpu, _index_data_gpu);
-        _index_data_gpu.write(raw_index_data, 0u);
+        ensure(
+            raw_vertex_data.size() % sizeof(CompactVertex) == 0zu,
+            "vertex data is {} bytes, not a whole number of vertices, was it packed with an older resource_packer",
+            raw_vertex_data.size());
+        ensure(
+            raw_meshlet_data.size() % sizeof(Meshlet) == 0zu,
+            "meshlet data is {} bytes, not a whole number of meshlets",
+            raw_meshlet_data.size());
+
+        upload(raw_vertex_data, 0zu, _vertex_data_gpu);
+        upload(raw_index_data, 0zu, _index_data_gpu);
+        upload(raw_meshlet_data, 0zu, _meshlet_data_gpu);
     }
 
     auto MeshManager::load(std::string_view name, std::span<const MeshData> meshes) -> std::span<const MeshView>
@@ -74,30 +96,34 @@ namespace ufps
 
         auto mesh_views = std::vector<MeshView>{};
 
-        for (const auto &mesh_data : meshes)
+        const auto uploaded_vertices = _vertex_data_cpu.size() * sizeof(CompactVertex);
+        const auto uploaded_indices = _index_data_cpu.size() * sizeof(std::uint32_t);
+        const auto uploaded_meshlets = _meshlet_data_cpu.size() * sizeof(Meshlet);
+
+        for (const auto &[mesh_data, meshlets] : meshes | std::views::transform(build_meshlets))
         {
             const auto offset = _index_data_cpu.size();
             const auto base_vertex = _vertex_data_cpu.size();
+            const auto meshlet_offset = _meshlet_data_cpu.size();
 
-            _vertex_data_cpu.append_range(mesh_data.vertices);
-
-            resize_gpu_buffer(_vertex_data_cpu, _vertex_data_gpu);
-
-            auto vertex_data_view = DataBufferView{reinterpret_cast<const std::byte *>(_vertex_data_cpu.data()), _vertex_data_cpu.size() * sizeof(VertexData)};
-            _vertex_data_gpu.write(vertex_data_view, 0zu);
-
+            _vertex_data_cpu.append_range(mesh_data.vertices | std::views::transform(encode_vertex));
             _index_data_cpu.append_range(mesh_data.indices);
-            resize_gpu_buffer(_index_data_cpu, _index_data_gpu);
-            auto index_data_view = DataBufferView{reinterpret_cast<const std::byte *>(_index_data_cpu.data()), _index_data_cpu.size() * sizeof(std::uint32_t)};
-            _index_data_gpu.write(index_data_view, 0zu);
+            _meshlet_data_cpu.append_range(meshlets);
 
             mesh_views.push_back(
                 {.vertex_offset = static_cast<std::uint32_t>(base_vertex),
                  .vertex_count = static_cast<std::uint32_t>(mesh_data.vertices.size()),
                  .index_offset = static_cast<std::uint32_t>(offset),
-                 .index_count = static_cast<std::uint32_t>(mesh_data.indices.size())});
+                 .index_count = static_cast<std::uint32_t>(mesh_data.indices.size()),
+                 .meshlet_offset = static_cast<std::uint32_t>(meshlet_offset),
+                 .meshlet_count = static_cast<std::uint32_t>(meshlets.size())});
         }
 
+        // every submesh in one upload per buffer
+        upload(std::as_bytes(std::span{_vertex_data_cpu}), uploaded_vertices, _vertex_data_gpu);
+        upload(std::as_bytes(std::span{_index_data_cpu}), uploaded_indices, _index_data_gpu);
+        upload(std::as_bytes(std::span{_meshlet_data_cpu}), uploaded_meshlets, _meshlet_data_gpu);
+
         const auto &[iter, _] = _mesh_lookup.emplace(name, mesh_views);
 
         return iter->second;
@@ -121,16 +147,54 @@ namespace ufps
         return {_vertex_data_gpu.native_handle(), _index_data_gpu.native_handle()};
     }
 
+    auto MeshManager::meshlet_native_handle() const -> ::GLuint
+    {
+        return _meshlet_data_gpu.native_handle();
+    }
+
     auto MeshManager::index_data(MeshView view) const -> std::span<const std::uint32_t>
     {
         return {_index_data_cpu.data() + view.index_offset, view.index_count};
     }
 
-    auto MeshManager::vertex_data(MeshView view) const -> std::span<const VertexData>
+    auto MeshManager::vertex_data(MeshView view) const -> std::span<const CompactVertex>
     {
         return {_vertex_data_cpu.data() + view.vertex_offset, view.vertex_count};
     }
 
+    auto MeshManager::meshlet_data(MeshView view) const -> std::span<const Meshlet>
+    {
+        return {_meshlet_data_cpu.data() + view.meshlet_offset, view.meshlet_count};
+    }
+
+    auto MeshManager::upload(DataBufferView cpu_data, std::size_t uploaded, Buffer &gpu_data) -> void
+    {
+        if (cpu_data.size() > gpu_data.size())
+        {
+            auto grown = Buffer{grown_capacity(gpu_data.size(), cpu_data.size()), gpu_data.name()};
+            log::info("growing {} buffer {} -> {}", gpu_data.name(), gpu_data.size(), grown.size());
+
+            // ordered after anything already reading the old buffer, which gl only deletes once that is done
+            if (uploaded != 0zu)
+            {
+                ::glCopyNamedBufferSubData(gpu_data.native_handle(), grown.native_handle(), 0, 0, uploaded);
+            }
+
+            gpu_data = std::move(grown);
+        }
+
+        for (auto offset = uploaded; offset < cpu_data.size();)
+        {
+            const auto chunk = cpu_data.subspan(offset, std::min(cpu_data.size() - offset, _staging.size()));
+            const auto staged = _staging.write(chunk);
+
+            ::glCopyNamedBufferSubData(_staging.native_handle(), gpu_data.native_handle(), staged, offset, chunk.size());
+            offset += chunk.size();
+        }
+
+        _staging.fence();
+    }
+
     auto MeshManager::to_string() const -> std::string
     {
         return std::format("mesh manager: vertex count: {}, index count:", _vertex_data_cpu.size(), _index_data_cpu.size());
@@ -0,0 +1,446 @@
+#include "graphics/mesh_optimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "graphics/mesh_data.h"
+#include "graphics/vertex_data.h"
+#include "math/vector3.h"
+#include "utils/ensure.h"
+#include "utils/hash.h"
+
+namespace
+{
+    constexpr auto no_index = std::numeric_limits<std::uint32_t>::max();
+
+    // the LRU cache Forsyth's scoring models, larger than the hardware one so the ordering still suits bigger caches
+    constexpr auto forsyth_cache_size = 32u;
+
+    struct VertexHash
+    {
+        auto operator()(const ufps::VertexData &vertex) const -> std::size_t
+        {
+            return static_cast<std::size_t>(ufps::hash_bytes(std::as_bytes(std::span{&vertex, 1zu})));
+        }
+    };
+
+    // bitwise so -0 and 0 stay apart and NaNs still weld, the vertex was authored that way
+    struct VertexEqual
+    {
+        auto operator()(const ufps::VertexData &a, const ufps::VertexData &b) const -> bool
+        {
+            return std::memcmp(&a, &b, sizeof(ufps::VertexData)) == 0;
+        }
+    };
+
+    auto vertex_score(std::int32_t cache_position, std::uint32_t remaining_triangles) -> float
+    {
+        if (remaining_triangles == 0u)
+        {
+            return -1.0f;
+        }
+
+        auto score = 0.0f;
+        if (cache_position >= 0)
+        {
+            // the last triangle's vertices score the same so the next triangle does not favour one of its edges
+            score = cache_position < 3
+                        ? 0.75f
+                        : std::pow(1.0f - static_cast<float>(cache_position - 3) / static_cast<float>(forsyth_cache_size - 3u), 1.5f);
+        }
+
+        // favour vertices with few triangles left so they are finished off and leave the cache for good
+        return score + 2.0f / std::sqrt(static_cast<float>(remaining_triangles));
+    }
+
+    // post transform cache that evicts the oldest vertex on every miss
+    class FifoCache
+    {
+    public:
+        FifoCache(std::size_t vertex_count, std::uint32_t cache_size)
+            : _loaded_at(vertex_count, no_index),
+              _time{},
+              _flushed_at{},
+              _cache_size{cache_size}
+        {
+        }
+
+        // true on a miss, which loads the vertex
+        auto access(std::uint32_t vertex) -> bool
+        {
+            const auto loaded_at = _loaded_at[vertex];
+            if (loaded_at != no_index && loaded_at >= _flushed_at && _time - loaded_at < _cache_size)
+            {
+                return false;
+            }
+
+            _loaded_at[vertex] = _time++;
+            return true;
+        }
+
+        auto access(std::span<const std::uint32_t> triangle) -> std::uint32_t
+        {
+            auto misses = 0u;
+            for (const auto vertex : triangle)
+            {
+                misses += access(vertex) ? 1u : 0u;
+            }
+
+            return misses;
+        }
+
+        auto flush() -> void
+        {
+            _flushed_at = _time;
+        }
+
+    private:
+        std::vector<std::uint32_t> _loaded_at;
+        std::uint32_t _time;
+        std::uint32_t _flushed_at;
+        std::uint32_t _cache_size;
+    };
+}
+
+namespace ufps
+{
+    auto analyze_vertex_cache(std::span<const std::uint32_t> indices, std::size_t vertex_count, std::uint32_t cache_size) -> VertexCacheStats
+    {
+        const auto triangle_count = indices.size() / 3zu;
+        if (triangle_count == 0zu)
+        {
+            return {.acmr = 0.0f, .atvr = 0.0f};
+        }
+
+        auto cache = FifoCache{vertex_count, cache_size};
+        auto total_misses = 0zu;
+        for (const auto index : indices)
+        {
+            total_misses += cache.access(index) ? 1zu : 0zu;
+        }
+
+        auto used = std::vector<bool>(vertex_count);
+        for (const auto index : indices)
+        {
+            used[index] = true;
+        }
+
+        return {
+            .acmr = static_cast<float>(total_misses) / static_cast<float>(triangle_count),
+            .atvr = static_cast<float>(total_misses) / static_cast<float>(std::ranges::count(used, true)),
+        };
+    }
+
+    auto weld_vertices(const MeshData &mesh) -> MeshData
+    {
+        auto welded = MeshData{};
+        welded.indices.reserve(mesh.indices.size());
+
+        auto lookup = std::unordered_map<VertexData, std::uint32_t, VertexHash, VertexEqual>{};
+        lookup.reserve(mesh.vertices.size());
+
+        for (const auto index : mesh.indices)
+        {
+            const auto &vertex = mesh.vertices[index];
+            const auto [entry, inserted] = lookup.try_emplace(vertex, static_cast<std::uint32_t>(welded.vertices.size()));
+            if (inserted)
+            {
+                welded.vertices.push_back(vertex);
+            }
+
+            welded.indices.push_back(entry->second);
+        }
+
+        return welded;
+    }
+
+    auto optimize_vertex_cache(std::span<const std::uint32_t> indices, std::size_t vertex_count) -> std::vector<std::uint32_t>
+    {
+        ensure(indices.size() % 3zu == 0zu, "index count {} is not a triangle list", indices.size());
+
+        const auto triangle_count = indices.size() / 3zu;
+
+        // triangles using each vertex, the live ones for vertex v are adjacency[offsets[v], offsets[v] + remaining[v])
+        auto remaining = std::vector<std::uint32_t>(vertex_count);
+        for (const auto index : indices)
+        {
+            ++remaining[index];
+        }
+
+        auto offsets = std::vector<std::uint32_t>(vertex_count + 1zu);
+        std::inclusive_scan(remaining.begin(), remaining.end(), offsets.begin() + 1);
+
+        auto adjacency = std::vector<std::uint32_t>(indices.size());
+        {
+            auto cursor = offsets;
+            for (auto i = 0zu; i < indices.size(); ++i)
+            {
+                adjacency[cursor[indices[i]]++] = static_cast<std::uint32_t>(i / 3zu);
+            }
+        }
+
+        auto cache_position = std::vector<std::int32_t>(vertex_count, -1);
+        auto scores = std::vector<float>(vertex_count);
+        for (auto v = 0zu; v < vertex_count; ++v)
+        {
+            scores[v] = vertex_score(-1, remaining[v]);
+        }
+
+        auto triangle_scores = std::vector<float>(triangle_count);
+        for (auto t = 0zu; t < triangle_count; ++t)
+        {
+            triangle_scores[t] = scores[indices[t * 3zu]] + scores[indices[t * 3zu + 1zu]] + scores[indices[t * 3zu + 2zu]];
+        }
+
+        auto emitted = std::vector<bool>(triangle_count);
+        auto next_unemitted = 0zu;
+
+        auto cache = std::vector<std::uint32_t>{};
+        auto new_cache = std::vector<std::uint32_t>{};
+        cache.reserve(forsyth_cache_size + 3u);
+        new_cache.reserve(forsyth_cache_size + 3u);
+
+        auto result = std::vector<std::uint32_t>{};
+        result.reserve(indices.size());
+
+        auto best = triangle_count == 0zu
+                        ? no_index
+                        : static_cast<std::uint32_t>(std::ranges::distance(triangle_scores.begin(), std::ranges::max_element(triangle_scores)));
+
+        while (best != no_index)
+        {
+            emitted[best] = true;
+
+            const auto triangle = indices.subspan(best * 3zu, 3zu);
+            result.append_range(triangle);
+
+            for (const auto vertex : triangle)
+            {
+                const auto live = std::span{adjacency}.subspan(offsets[vertex], remaining[vertex]);
+                std::ranges::swap(*std::ranges::find(live, best), live.back());
+                --remaining[vertex];
+            }
+
+            // the emitted triangle moves to the front, everything else shifts back and may fall off the end
+            // degenerate triangles repeat a vertex, which must still only be cached once
+            new_cache.clear();
+            for (const auto vertex : triangle)
+            {
+                if (!std::ranges::contains(new_cache, vertex))
+                {
+                    new_cache.push_back(vertex);
+                }
+            }
+
+            for (const auto vertex : cache)
+            {
+                if (!std::ranges::contains(triangle, vertex))
+                {
+                    new_cache.push_back(vertex);
+                }
+            }
+
+            for (auto position = 0u; position < new_cache.size(); ++position)
+            {
+                const auto vertex = new_cache[position];
+                cache_position[vertex] = position < forsyth_cache_size ? static_cast<std::int32_t>(position) : -1;
+                scores[vertex] = vertex_score(cache_position[vertex], remaining[vertex]);
+            }
+
+            // evicted vertices still need their triangles rescored, after which they are forgotten
+            best = no_index;
+            auto best_score = -1.0f;
+
+            for (const auto vertex : new_cache)
+            {
+                for (const auto t : std::span{adjacency}.subspan(offsets[vertex], remaining[vertex]))
+                {
+                    triangle_scores[t] = scores[indices[t * 3zu]] + scores[indices[t * 3zu + 1zu]] + scores[indices[t * 3zu + 2zu]];
+
+                    if (cache_position[vertex] != -1 && triangle_scores[t] > best_score)
+                    {
+                        best = t;
+                        best_score = triangle_scores[t];
+                    }
+                }
+            }
+
+            new_cache.resize(std::min<std::size_t>(new_cache.size(), forsyth_cache_size));
+            std::swap(cache, new_cache);
+
+            // nothing left around the cache, carry on from the first triangle not yet drawn rather than searching them
+            // all, which keeps this linear
+            if (best == no_index)
+            {
+                while (next_unemitted < triangle_count && emitted[next_unemitted])
+                {
+                    ++next_unemitted;
+                }
+
+                if (next_unemitted < triangle_count)
+                {
+                    best = static_cast<std::uint32_t>(next_unemitted);
+                }
+            }
+        }
+
+        return result;
+    }
+
+    auto optimize_overdraw(std::span<const std::uint32_t> indices, std::span<const VertexData> vertices, float threshold)
+        -> std::vector<std::uint32_t>
+    {
+        ensure(indices.size() % 3zu == 0zu, "index count {} is not a triangle list", indices.size());
+
+        const auto triangle_count = indices.size() / 3zu;
+        if (triangle_count == 0zu)
+        {
+            return {};
+        }
+
+        const auto target_acmr = analyze_vertex_cache(indices, vertices.size()).acmr * threshold;
+
+        // once reordered every cluster starts with a cold cache, so that is how they are simulated
+        // a triangle missing on every vertex is where the cache optimizer started afresh, so splitting there is free,
+        // otherwise a cluster is only closed once it is as cache friendly as the whole mesh within threshold
+        auto cache = FifoCache{vertices.size(), vertex_cache_size};
+        auto cluster_starts = std::vector<std::size_t>{0zu};
+        auto cluster_misses = 0u;
+
+        for (auto t = 0zu; t < triangle_count; ++t)
+        {
+            const auto cluster_size = t - cluster_starts.back();
+            if (cluster_size != 0zu && static_cast<float>(cluster_misses) <= target_acmr * static_cast<float>(cluster_size))
+            {
+                cluster_starts.push_back(t);
+                cluster_misses = 0u;
+                cache.flush();
+            }
+
+            const auto triangle = indices.subspan(t * 3zu, 3zu);
+            auto misses = cache.access(triangle);
+
+            if (misses == 3u && t != cluster_starts.back())
+            {
+                cluster_starts.push_back(t);
+                cluster_misses = 0u;
+                cache.flush();
+                misses = cache.access(triangle);
+            }
+
+            cluster_misses += misses;
+        }
+
+        cluster_starts.push_back(triangle_count);
+
+        struct Cluster
+        {
+            std::size_t first;
+            std::size_t last;
+            Vector3 centre;
+            Vector3 normal;
+            float score;
+        };
+
+        auto mesh_centre = Vector3{};
+        auto mesh_area = 0.0f;
+
+        auto clusters = std::vector<Cluster>{};
+
+        for (const auto [first, last] : cluster_starts | std::views::pairwise)
+        {
+            auto centre = Vector3{};
+            auto normal = Vector3{};
+            auto area = 0.0f;
+
+            for (auto t = first; t < last; ++t)
+            {
+                const auto &a = vertices[indices[t * 3zu]].position;
+                const auto &b = vertices[indices[t * 3zu + 1zu]].position;
+                const auto &c = vertices[indices[t * 3zu + 2zu]].position;
+
+                // twice the area weighted normal, which is all the averages below need
+                const auto n = Vector3::cross(b - a, c - a);
+                const auto triangle_area = n.length();
+
+                centre += (a + b + c) * (triangle_area / 3.0f);
+                normal += n;
+                area += triangle_area;
+            }
+
+            mesh_centre += centre;
+            mesh_area += area;
+
+            clusters.push_back({
+                .first = first,
+                .last = last,
+                .centre = area == 0.0f ? Vector3{} : centre / area,
+                .normal = normal.length() == 0.0f ? Vector3{} : Vector3::normalize(normal),
+                .score = 0.0f,
+            });
+        }
+
+        if (mesh_area != 0.0f)
+        {
+            mesh_centre /= mesh_area;
+        }
+
+        // clusters facing away from the middle of the mesh are the ones that occlude the rest
+        for (auto &cluster : clusters)
+        {
+            cluster.score = Vector3::dot(cluster.centre - mesh_centre, cluster.normal);
+        }
+
+        std::ranges::stable_sort(clusters, std::ranges::greater{}, &Cluster::score);
+
+        auto result = std::vector<std::uint32_t>{};
+        result.reserve(indices.size());
+
+        for (const auto &cluster : clusters)
+        {
+            result.append_range(indices.subspan(cluster.first * 3zu, (cluster.last - cluster.first) * 3zu));
+        }
+
+        return result;
+    }
+
+    auto optimize_vertex_fetch(const MeshData &mesh) -> MeshData
+    {
+        auto remap = std::vector<std::uint32_t>(mesh.vertices.size(), no_index);
+
+        auto optimized = MeshData{};
+        optimized.indices.reserve(mesh.indices.size());
+
+        for (const auto index : mesh.indices)
+        {
+            if (remap[index] == no_index)
+            {
+                remap[index] = static_cast<std::uint32_t>(optimized.vertices.size());
+                optimized.vertices.push_back(mesh.vertices[index]);
+            }
+
+            optimized.indices.push_back(remap[index]);
+        }
+
+        return optimized;
+    }
+
+    auto optimize_mesh(const MeshData &mesh) -> MeshData
+    {
+        auto welded = weld_vertices(mesh);
+
+        welded.indices = optimize_vertex_cache(welded.indices, welded.vertices.size());
+        welded.indices = optimize_overdraw(welded.indices, welded.vertices);
+
+        return optimize_vertex_fetch(welded);
+    }
+}
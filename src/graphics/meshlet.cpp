@@ -0,0 +1,258 @@
+#include "graphics/meshlet.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <vector>
+
+#include "graphics/mesh_data.h"
+#include "math/vector3.h"
+#include "math/vector4.h"
+#include "utils/ensure.h"
+
+namespace
+{
+    constexpr auto no_index = std::numeric_limits<std::uint32_t>::max();
+
+    // slack on the cone so float error in the culling test never removes a triangle that is only just facing the camera
+    constexpr auto cone_epsilon = 1e-4f;
+
+    // triangles using each vertex are triangles[offsets[v], offsets[v + 1])
+    struct Adjacency
+    {
+        std::vector<std::uint32_t> offsets;
+        std::vector<std::uint32_t> triangles;
+
+        auto of(std::uint32_t vertex) const -> std::span<const std::uint32_t>
+        {
+            return std::span{triangles}.subspan(offsets[vertex], offsets[vertex + 1u] - offsets[vertex]);
+        }
+    };
+
+    auto build_adjacency(std::span<const std::uint32_t> indices, std::size_t vertex_count) -> Adjacency
+    {
+        auto offsets = std::vector<std::uint32_t>(vertex_count + 1zu);
+        for (const auto index : indices)
+        {
+            ++offsets[index + 1u];
+        }
+        std::inclusive_scan(offsets.begin(), offsets.end(), offsets.begin());
+
+        auto triangles = std::vector<std::uint32_t>(indices.size());
+        auto cursor = offsets;
+        for (auto i = 0zu; i < indices.size(); ++i)
+        {
+            triangles[cursor[indices[i]]++] = static_cast<std::uint32_t>(i / 3zu);
+        }
+
+        return {.offsets = std::move(offsets), .triangles = std::move(triangles)};
+    }
+
+    auto triangle(std::span<const std::uint32_t> indices, std::uint32_t t) -> std::span<const std::uint32_t, 3zu>
+    {
+        return indices.subspan(t * 3zu).first<3zu>();
+    }
+
+    // zero for degenerate triangles, which are never rasterized so can face any way
+    auto triangle_normal(const ufps::MeshData &mesh, std::uint32_t t) -> ufps::Vector3
+    {
+        const auto indices = triangle(mesh.indices, t);
+        const auto &p0 = mesh.vertices[indices[0]].position;
+        const auto &p1 = mesh.vertices[indices[1]].position;
+        const auto &p2 = mesh.vertices[indices[2]].position;
+
+        return ufps::Vector3::normalize(ufps::Vector3::cross(p1 - p0, p2 - p0));
+    }
+
+    auto triangle_centre(const ufps::MeshData &mesh, std::uint32_t t) -> ufps::Vector3
+    {
+        const auto indices = triangle(mesh.indices, t);
+
+        return (mesh.vertices[indices[0]].position + mesh.vertices[indices[1]].position + mesh.vertices[indices[2]].position) / 3.0f;
+    }
+
+    auto meshlet_bounds(
+        const ufps::MeshData &mesh,
+        std::span<const std::uint32_t> vertices,
+        std::span<const std::uint32_t> triangles,
+        std::span<const ufps::Vector3> normals) -> ufps::Meshlet
+    {
+        auto min = ufps::Vector3{std::numeric_limits<float>::max()};
+        auto max = ufps::Vector3{std::numeric_limits<float>::lowest()};
+        for (const auto v : vertices)
+        {
+            const auto &p = mesh.vertices[v].position;
+            min = {std::min(min.x, p.x), std::min(min.y, p.y), std::min(min.z, p.z)};
+            max = {std::max(max.x, p.x), std::max(max.y, p.y), std::max(max.z, p.z)};
+        }
+
+        const auto centre = (min + max) * 0.5f;
+        auto radius = 0.0f;
+        for (const auto v : vertices)
+        {
+            radius = std::max(radius, (mesh.vertices[v].position - centre).length());
+        }
+
+        auto normal_sum = ufps::Vector3{};
+        for (const auto t : triangles)
+        {
+            normal_sum += normals[t];
+        }
+        const auto axis = ufps::Vector3::normalize(normal_sum);
+
+        auto cutoff = 1.0f;
+        for (const auto t : triangles)
+        {
+            if (normals[t] != ufps::Vector3{})
+            {
+                cutoff = std::min(cutoff, ufps::Vector3::dot(axis, normals[t]));
+            }
+        }
+
+        // an axis of zero means the normals cancel out, which the cutoff check below also catches
+        cutoff = axis == ufps::Vector3{} ? 0.0f : std::max(cutoff - cone_epsilon, 0.0f);
+
+        return {
+            .sphere = {centre, radius},
+            .cone = {axis, cutoff},
+            .index_offset = 0u,
+            .index_count = static_cast<std::uint32_t>(triangles.size() * 3zu),
+            .vertex_count = static_cast<std::uint32_t>(vertices.size()),
+            .pad = 0u,
+        };
+    }
+}
+
+namespace ufps
+{
+    auto build_meshlets(const MeshData &mesh) -> MeshletData
+    {
+        const auto &[vertices, indices] = mesh;
+        ensure(indices.size() % 3zu == 0zu, "index count {} is not a triangle list", indices.size());
+
+        const auto triangle_count = static_cast<std::uint32_t>(indices.size() / 3zu);
+        const auto adjacency = build_adjacency(indices, vertices.size());
+        const auto normals = std::views::iota(0u, triangle_count) |
+                             std::views::transform([&](const auto t) { return triangle_normal(mesh, t); }) |
+                             std::ranges::to<std::vector>();
+        const auto centres = std::views::iota(0u, triangle_count) |
+                             std::views::transform([&](const auto t) { return triangle_centre(mesh, t); }) |
+                             std::ranges::to<std::vector>();
+
+        auto assigned = std::vector<bool>(triangle_count);
+
+        // the meshlet each vertex was last added to, so membership of the current one is a single compare
+        auto vertex_meshlet = std::vector<std::uint32_t>(vertices.size(), no_index);
+
+        auto result = MeshletData{.mesh = {.vertices = vertices, .indices = {}}, .meshlets = {}};
+        result.mesh.indices.reserve(indices.size());
+
+        auto meshlet_triangles = std::vector<std::uint32_t>{};
+        auto meshlet_vertices = std::vector<std::uint32_t>{};
+        auto seed = 0u;
+
+        for (;;)
+        {
+            while (seed < triangle_count && assigned[seed])
+            {
+                ++seed;
+            }
+
+            if (seed == triangle_count)
+            {
+                break;
+            }
+
+            const auto id = static_cast<std::uint32_t>(result.meshlets.size());
+            meshlet_triangles.clear();
+            meshlet_vertices.clear();
+            auto normal_sum = Vector3{};
+            auto position_sum = Vector3{};
+
+            const auto new_vertices = [&](std::uint32_t t)
+            { return static_cast<std::uint32_t>(std::ranges::count_if(triangle(indices, t), [&](const auto v) { return vertex_meshlet[v] != id; })); };
+
+            const auto add = [&](std::uint32_t t)
+            {
+                assigned[t] = true;
+                meshlet_triangles.push_back(t);
+                normal_sum += normals[t];
+
+                for (const auto v : triangle(indices, t))
+                {
+                    if (vertex_meshlet[v] != id)
+                    {
+                        vertex_meshlet[v] = id;
+                        meshlet_vertices.push_back(v);
+                        position_sum += vertices[v].position;
+                    }
+                }
+            };
+
+            add(seed);
+
+            while (meshlet_triangles.size() < meshlet_max_triangles)
+            {
+                // only triangles touching the meshlet are considered, fewest new vertices first so the vertex budget
+                // stretches as far as possible, then the closest so it grows evenly rather than in strips, weighted
+                // against ones facing away from the rest so the cone stays narrow
+                auto best = no_index;
+                auto best_new_vertices = 0u;
+                auto best_cost = 0.0f;
+
+                const auto centre = position_sum / static_cast<float>(meshlet_vertices.size());
+                const auto axis = Vector3::normalize(normal_sum);
+
+                for (const auto v : meshlet_vertices)
+                {
+                    for (const auto t : adjacency.of(v))
+                    {
+                        if (assigned[t])
+                        {
+                            continue;
+                        }
+
+                        const auto added = new_vertices(t);
+                        if (meshlet_vertices.size() + added > meshlet_max_vertices)
+                        {
+                            continue;
+                        }
+
+                        const auto cost = (centres[t] - centre).length() * (2.0f - Vector3::dot(normals[t], axis));
+                        if (best == no_index || added < best_new_vertices ||
+                            (added == best_new_vertices && (cost < best_cost || (cost == best_cost && t < best))))
+                        {
+                            best = t;
+                            best_new_vertices = added;
+                            best_cost = cost;
+                        }
+                    }
+                }
+
+                if (best == no_index)
+                {
+                    break;
+                }
+
+                add(best);
+            }
+
+            std::ranges::sort(meshlet_triangles);
+
+            auto meshlet = meshlet_bounds(mesh, meshlet_vertices, meshlet_triangles, normals);
+            meshlet.index_offset = static_cast<std::uint32_t>(result.mesh.indices.size());
+            result.meshlets.push_back(meshlet);
+
+            for (const auto t : meshlet_triangles)
+            {
+                result.mesh.indices.append_range(triangle(indices, t));
+            }
+        }
+
+        return result;
+    }
+}
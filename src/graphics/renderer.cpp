@@ -1,18 +1,26 @@
 #include "graphics/renderer.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
 #include <optional>
 #include <random>
 #include <ranges>
 #include <span>
 #include <string_view>
+#include <utility>
 
 #include "core/camera.h"
 #include "core/scene.h"
 #include "graphics/buffer_writer.h"
 #include "graphics/command_buffer.h"
+#include "graphics/culling.h"
+#include "graphics/gpu_scene.h"
+#include "graphics/hiz.h"
+#include "graphics/indirect_command.h"
+#include "graphics/instance_culling.h"
+#include "graphics/light_clusters.h"
 #include "graphics/mesh_manager.h"
-#include "graphics/object_data.h"
 #include "graphics/opengl.h"
 #include "graphics/point_light.h"
 #include "graphics/program.h"
@@ -109,6 +117,20 @@ namespace
         };
     }
 
+    auto create_hiz_texture(std::uint32_t width, std::uint32_t height, const ufps::Sampler &sampler) -> ufps::Texture
+    {
+        const auto hiz_texture_data = ufps::TextureData{
+            .width = width,
+            .height = height,
+            .format = ufps::TextureFormat::R32F,
+            .data = std::nullopt,
+            .is_compressed = false,
+            .mip_levels = ufps::hiz_mip_count(width, height),
+        };
+
+        return {hiz_texture_data, "hiz_texture", sampler};
+    }
+
     auto sprite() -> ufps::MeshData
     {
         const ufps::Vector3 positions[] = {
@@ -198,11 +220,16 @@ namespace ufps
           _post_process_sprite{create_sprite(mesh_manager, texture_manager)},
           _camera_buffer{sizeof(CameraData), "camera_buffer"},                                                                                                                                                                      //
           _light_buffer{sizeof(LightData), "light_buffer"},                                                                                                                                                                         //
-          _object_data_buffer{sizeof(ObjectData), "object_data_buffer"},                                                                                                                                                            //
-          _transparent_object_data_buffer{sizeof(ObjectData), "transparent_object_data_buffer"},                                                                                                                                    //
           _luminance_histogram_buffer{sizeof(std::uint32_t) * 256, "luminance_histogram_buffer"},                                                                                                                                   //
           _average_luminance_buffer{sizeof(float) * 1, "average_luminance_buffer"},                                                                                                                                                 //
           _ssao_samples_buffer{sizeof(Vector4) * 64, "ssao_samples_buffer"},                                                                                                                                                        //
+          _gpu_command_buffer{sizeof(IndirectCommand), "gpu_command_buffer"},                                                                                                                                                       //
+          _draw_count_buffer{sizeof(std::uint32_t), "draw_count_buffer"},                                                                                                                                                           //
+          _frustum_planes_buffer{sizeof(Vector4) * 6, "frustum_planes_buffer"},                                                                                                                                                     //
+          _visibility_buffer{sizeof(std::uint32_t), "visibility_buffer"},                                                                                                                                                           //
+          _light_grid_buffer{sizeof(ClusterRange) * cluster_count, "light_grid_buffer"},                                                                                                                                            //
+          _light_index_buffer{sizeof(std::uint32_t) * cluster_count * max_lights_per_cluster, "light_index_buffer"},                                                                                                                //
+          _gpu_scene{},                                                                                                                                                                                                             //
           _gbuffer_program{create_program(resource_loader, "gbuffer_program"sv, "shaders/gbuffer.vert"sv, "gbuffer_vertex_shader"sv, "shaders/gbuffer.frag"sv, "gbuffer_fragement_shader"sv)},                                      //
           _light_pass_program{create_program(resource_loader, "light_pass_program"sv, "shaders/light_pass.vert"sv, "light_pass_vertex_shader"sv, "shaders/light_pass.frag"sv, "light_pass_fragment_shader"sv)},                     //
           _forward_transparancy_program{create_program(resource_loader, "transparancy_program"sv, "shaders/transparancy.vert"sv, "transparancy_vertex_shader"sv, "shaders/transparancy.frag"sv, "transparancy_fragment_shader"sv)}, //
@@ -215,9 +242,15 @@ namespace ufps
           _bloom_downsample_program{create_program(resource_loader, "bloom_downsample_program"sv, "shaders/bloom_downsample.vert"sv, "bloom_downsample_vertex_shader"sv, "shaders/bloom_downsample.frag"sv, "bloom_downsample_fragement_shader"sv)},                         //
           _bloom_upsample_program{create_program(resource_loader, "bloom_upsample_program"sv, "shaders/bloom_upsample.vert"sv, "bloom_upsample_vertex_shader"sv, "shaders/bloom_upsample.frag"sv, "bloom_upsample_fragement_shader"sv)},                                     //
           _bloom_mix_program{create_program(resource_loader, "bloom_mix_program"sv, "shaders/bloom_mix.vert"sv, "bloom_mix_vertex_shader"sv, "shaders/bloom_mix.frag"sv, "bloom_mix_fragement_shader"sv)},                                                                   //
+          _frustum_cull_program{create_program(resource_loader, "frustum_cull_program"sv, "shaders/frustum_cull.comp"sv, "frustum_cull_compute")},
+          _cluster_cull_program{create_program(resource_loader, "cluster_cull_program"sv, "shaders/cluster_cull.comp"sv, "cluster_cull_compute")},
+          _hiz_build_program{create_program(resource_loader, "hiz_build_program"sv, "shaders/hiz_build.comp"sv, "hiz_build_compute")},
+          _light_cull_program{create_program(resource_loader, "light_cull_program"sv, "shaders/light_cull.comp"sv, "light_cull_compute")},
           _ssao_noise_sampler{FilterType::NEAREST, FilterType::NEAREST, WrapMode::REPEAT, WrapMode::REPEAT, "ssao_noise_sampler"},                                                                                                                                           //
           _ssao_noise_texture_bindless_handle{create_ssao_noise_texture(texture_manager, _ssao_noise_sampler)},                                                                                                                                                              //
           _fb_sampler{FilterType::LINEAR, FilterType::LINEAR, WrapMode::CLAMP_TO_EDGE, WrapMode::CLAMP_TO_EDGE, "fb_sampler"},                                                                                                                                               //
+          _hiz_sampler{FilterType::NEAREST_MIPMAP, FilterType::NEAREST, WrapMode::CLAMP_TO_EDGE, WrapMode::CLAMP_TO_EDGE, "hiz_sampler"},
+          _hiz_texture{create_hiz_texture(window.width(), window.height(), _hiz_sampler)},
           _gbuffer_rt{create_render_target(7u, window.width(), window.height(), _fb_sampler, texture_manager, "gbuffer")},                                                                                                                                                   //
           _light_pass_rt{create_render_target(1u, window.width(), window.height(), _fb_sampler, texture_manager, "light_pass")},                                                                                                                                             //
           _forward_transparancy_rt{create_render_target(1u, window.width(), window.height(), _fb_sampler, texture_manager, "forward_transparancy")},                                                                                                                         //
@@ -227,7 +260,10 @@ namespace ufps
           _chromatic_abberation_rt{create_render_target(1u, window.width(), window.height(), _fb_sampler, texture_manager, "chromatic_abberation")},
           _bloom_mips{},
           _bloom_rt{create_render_target(1u, window.width(), window.height(), _fb_sampler, texture_manager, "bloom")},
-          _final_fb{}
+          _final_fb{},
+          _opaque_culling_stats{},
+          _transparent_culling_stats{},
+          _fence_wait{}
     {
 
         ::glGenVertexArrays(1u, &_dummy_vao);
@@ -304,8 +340,12 @@ namespace ufps
     {
         _camera_buffer.write(scene.camera().data_view(), 0zu);
 
+        update_gpu_scene(scene);
+
         execute_gbuffer_pass(scene);
 
+        execute_light_culling_pass(scene);
+
         execute_lighting_pass(scene);
 
         execute_forward_transparancy_pass(scene);
@@ -327,9 +367,13 @@ namespace ufps
         post_render(scene);
 
         _command_buffer.advance();
+        _forward_transparancy_command_buffer.advance();
         _camera_buffer.advance();
         _light_buffer.advance();
-        _object_data_buffer.advance();
+        _gpu_scene.advance();
+
+        _fence_wait = _command_buffer.fence_wait() + _forward_transparancy_command_buffer.fence_wait() +
+                      _camera_buffer.fence_wait() + _light_buffer.fence_wait() + _gpu_scene.fence_wait();
     }
 
     auto Renderer::post_render(Scene &) -> void
@@ -351,11 +395,115 @@ namespace ufps
             GL_NEAREST);
     }
 
-    auto Renderer::execute_gbuffer_pass(Scene &scene) -> void
+    auto Renderer::update_gpu_scene(Scene &scene) -> void
     {
-        _gbuffer_rt.fb.bind();
-        ::glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        const auto slots_changed = _gpu_scene.update(scene);
+
+        const auto instance_count = _gpu_scene.instance_count();
+
+        // room for either culling mode so switching between them never has to wait for the buffer to grow
+        const auto command_buffer_size = std::max(instance_count, _gpu_scene.meshlet_count()) * sizeof(IndirectCommand);
+        if (_gpu_command_buffer.size() < command_buffer_size)
+        {
+            const auto new_size = std::max(command_buffer_size, _gpu_command_buffer.size() * 2zu);
+            log::info("growing {} buffer {} -> {}", _gpu_command_buffer.name(), _gpu_command_buffer.size(), new_size);
+            _gpu_command_buffer = Buffer{new_size, _gpu_command_buffer.name()};
+        }
+
+        const auto visibility_buffer_size = instance_count * sizeof(std::uint32_t);
+        const auto visibility_buffer_grown = _visibility_buffer.size() < visibility_buffer_size;
+        if (visibility_buffer_grown)
+        {
+            const auto new_size = std::max(visibility_buffer_size, _visibility_buffer.size() * 2zu);
+            log::info("growing {} buffer {} -> {}", _visibility_buffer.name(), _visibility_buffer.size(), new_size);
+            _visibility_buffer = Buffer{new_size, _visibility_buffer.name()};
+        }
+
+        // last frame's visibility is meaningless for reassigned slots, so treat everything as visible
+        if (slots_changed || visibility_buffer_grown)
+        {
+            const auto visible = 1u;
+            ::glClearNamedBufferData(_visibility_buffer.native_handle(), GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &visible);
+        }
+    }
+
+    auto Renderer::execute_gpu_culling_pass(Scene &scene, EntityFilterMode filter_mode, CullingPhase phase) -> void
+    {
+        const auto instance_count = _gpu_scene.instance_count();
+
+        const auto frustum = scene.camera().frustum();
+        const auto planes = frustum.planes |
+                            std::views::transform([](const auto &plane)
+                                                  { return Vector4{plane.normal, plane.distance}; }) |
+                            std::ranges::to<std::vector>();
+        _frustum_planes_buffer.write(std::as_bytes(std::span{planes}), 0zu);
+
+        const auto draw_count = 0u;
+        _draw_count_buffer.write(std::as_bytes(std::span{&draw_count, 1zu}), 0zu);
 
+        const auto &camera_data = scene.camera().data();
+
+        // both programs share their uniforms and first bindings, cluster culling runs a work group per instance with
+        // its threads splitting up the instance's meshlets
+        const auto cluster_culling = scene.culling_options().cluster_culling;
+        auto &program = cluster_culling ? _cluster_cull_program : _frustum_cull_program;
+
+        [[maybe_unused]] const auto auto_bind = AutoBind{program};
+
+        program.set_uniforms(
+            instance_count,
+            filter_mask(filter_mode),
+            std::to_underlying(phase),
+            camera_data.projection * camera_data.view,
+            static_cast<std::uint64_t>(_hiz_texture.bindless_handle()));
+
+        ::glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, _gpu_scene.instance_buffer().native_handle());
+        ::glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, _frustum_planes_buffer.native_handle());
+        ::glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, _gpu_command_buffer.native_handle());
+        ::glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, _draw_count_buffer.native_handle());
+        ::glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, _visibility_buffer.native_handle());
+
+        if (cluster_culling)
+        {
+            ::glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, scene.mesh_manager().meshlet_native_handle());
+            ::glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 6, _camera_buffer.native_handle(), _camera_buffer.frame_offset_bytes(), sizeof(CameraData));
+
+            ::glDispatchCompute(instance_count, 1u, 1u);
+        }
+        else
+        {
+            ::glDispatchCompute((instance_count + 63u) / 64u, 1u, 1u);
+        }
+
+        ::glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+    }
+
+    auto Renderer::execute_hiz_pass() -> void
+    {
+        [[maybe_unused]] const auto auto_bind = AutoBind{_hiz_build_program};
+
+        for (auto level = 0u; level < hiz_mip_count(_hiz_texture.width(), _hiz_texture.height()); ++level)
+        {
+            const auto width = hiz_mip_size(_hiz_texture.width(), level);
+            const auto height = hiz_mip_size(_hiz_texture.height(), level);
+
+            _hiz_build_program.set_uniforms(_gbuffer_rt.depth_texture_bindless_handle, level);
+
+            if (level != 0u)
+            {
+                ::glBindImageTexture(0, _hiz_texture.native_handle(), level - 1u, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+            }
+            ::glBindImageTexture(1, _hiz_texture.native_handle(), level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+
+            ::glDispatchCompute((width + 7u) / 8u, (height + 7u) / 8u, 1u);
+            ::glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+        }
+
+        ::glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+    }
+
+    auto Renderer::draw_gpu_culled(Scene &scene) -> void
+    {
         [[maybe_unused]] const auto auto_bind = AutoBind(_gbuffer_program);
 
         const auto [vertex_buffer_handle, index_buffer_handle] = scene.mesh_manager().native_handle();
@@ -363,39 +511,79 @@ namespace ufps
         ::glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 1, _camera_buffer.native_handle(), _camera_buffer.frame_offset_bytes(), sizeof(CameraData));
         ::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_handle);
 
-        const auto command_count = _command_buffer.build(scene, EntityFilterMode::OPAQUE);
+        // commands and draw count were written by the culling compute pass, base instance is the object data slot
+        const auto &object_data_buffer = _gpu_scene.object_data_buffer();
+        ::glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 2, object_data_buffer.native_handle(), object_data_buffer.frame_offset_bytes(), object_data_buffer.size());
+        ::glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _gpu_command_buffer.native_handle());
+        ::glBindBuffer(GL_PARAMETER_BUFFER, _draw_count_buffer.native_handle());
 
-        ::glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _command_buffer.native_handle());
+        // a command per instance or, with cluster culling, per meshlet
+        ::glMultiDrawElementsIndirectCount(
+            GL_TRIANGLES,
+            GL_UNSIGNED_INT,
+            nullptr,
+            0,
+            static_cast<::GLsizei>(_gpu_command_buffer.size() / sizeof(IndirectCommand)),
+            0);
+    }
+
+    auto Renderer::execute_gpu_driven_gbuffer_pass(Scene &scene) -> void
+    {
+        _opaque_culling_stats = {};
+
+        if (!scene.culling_options().occlusion_culling)
+        {
+            execute_gpu_culling_pass(scene, EntityFilterMode::OPAQUE, CullingPhase::FRUSTUM);
+
+            _gbuffer_rt.fb.bind();
+            ::glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            draw_gpu_culled(scene);
+
+            return;
+        }
+
+        // draw what was visible last frame, build the hi-z from that and then draw anything that turned out not to be
+        // hidden behind it
+        execute_gpu_culling_pass(scene, EntityFilterMode::OPAQUE, CullingPhase::LAST_FRAME_VISIBLE);
+
+        _gbuffer_rt.fb.bind();
+        ::glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        draw_gpu_culled(scene);
+
+        execute_hiz_pass();
+        execute_gpu_culling_pass(scene, EntityFilterMode::OPAQUE, CullingPhase::OCCLUSION);
 
-        auto object_data = std::vector<ObjectData>{};
+        _gbuffer_rt.fb.bind();
+        draw_gpu_culled(scene);
+    }
 
-        for (const auto &entity : scene.entities())
+    auto Renderer::execute_gbuffer_pass(Scene &scene) -> void
+    {
+        if (scene.culling_options().gpu_driven)
         {
-            object_data.append_range(
-                entity.render_entities() |
-                std::views::filter([](const auto &e)
-                                   { return e.opacity() > 0.9999f; }) |
-                std::views::transform(
-                    [&entity](const auto &e)
-                    { return ObjectData{
-                          .model = entity.transform(),
-                          .albedo_texture_bindless_handle = e.albedo_texture_bindless_handle(),
-                          .normal_texture_bindless_handle = e.normal_texture_bindless_handle(),
-                          .specular_texture_bindless_handle = e.specular_texture_bindless_handle(),
-                          .roughness_texture_bindless_handle = e.roughness_texture_bindless_handle(),
-                          .ao_texture_bindless_handle = e.ao_texture_bindless_handle(),
-                          .emissive_texture_bindless_handle = e.emissive_texture_bindless_handle(),
-                          .opacity = e.opacity(),
-                          .emissive_strength = e.emissive_intensity() * entity.emissive_strength(),
-                          .normal_compressed = e.normal_compressed() ? 1u : 0u,
-                          .pad{},
-                      }; }));
+            execute_gpu_driven_gbuffer_pass(scene);
+            return;
         }
 
-        resize_gpu_buffer(object_data, _object_data_buffer);
+        _gbuffer_rt.fb.bind();
+        ::glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        [[maybe_unused]] const auto auto_bind = AutoBind(_gbuffer_program);
+
+        const auto [vertex_buffer_handle, index_buffer_handle] = scene.mesh_manager().native_handle();
+        ::glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, vertex_buffer_handle);
+        ::glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 1, _camera_buffer.native_handle(), _camera_buffer.frame_offset_bytes(), sizeof(CameraData));
+        ::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_handle);
+
+        const auto culled = cull(scene.entities(), scene.camera().frustum(), EntityFilterMode::OPAQUE);
+        _opaque_culling_stats = culled.stats;
 
-        _object_data_buffer.write(std::as_bytes(std::span{object_data.data(), object_data.size()}), 0zu);
-        ::glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 2, _object_data_buffer.native_handle(), _object_data_buffer.frame_offset_bytes(), _object_data_buffer.size());
+        const auto command_count = _command_buffer.build(scene, culled.draws, _gpu_scene.table());
+
+        ::glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _command_buffer.native_handle());
+
+        const auto &object_data_buffer = _gpu_scene.object_data_buffer();
+        ::glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 2, object_data_buffer.native_handle(), object_data_buffer.frame_offset_bytes(), object_data_buffer.size());
 
         ::glMultiDrawElementsIndirect(
             GL_TRIANGLES,
@@ -405,21 +593,15 @@ namespace ufps
             0);
     }
 
-    auto Renderer::execute_lighting_pass(Scene &scene) -> void
+    auto Renderer::execute_light_culling_pass(Scene &scene) -> void
     {
-        _light_pass_rt.fb.bind();
-        ::glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        [[maybe_unused]] const auto auto_bind = AutoBind{_light_pass_program};
-
-        const auto [vertex_buffer_handle, index_buffer_handle] = scene.mesh_manager().native_handle();
-
         {
             const auto &lights = scene.lights();
             const auto buffer_size_bytes = sizeof(lights.ambient) + sizeof(std::uint32_t) + sizeof(PointLight) * lights.lights.size();
+            // gl keeps the old buffer alive until the frames still reading it are done, so there is nothing to wait for
             if (_light_buffer.size() < buffer_size_bytes)
             {
                 _light_buffer = {buffer_size_bytes, _light_buffer.name()};
-                ::glFinish();
             }
 
             auto writer = BufferWriter{_light_buffer};
@@ -428,6 +610,25 @@ namespace ufps
             writer.write(lights.lights.data());
         }
 
+        [[maybe_unused]] const auto auto_bind = AutoBind{_light_cull_program};
+
+        ::glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 1, _light_buffer.native_handle(), _light_buffer.frame_offset_bytes(), _light_buffer.size());
+        ::glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 2, _camera_buffer.native_handle(), _camera_buffer.frame_offset_bytes(), sizeof(CameraData));
+        ::glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, _light_grid_buffer.native_handle());
+        ::glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, _light_index_buffer.native_handle());
+
+        ::glDispatchCompute((cluster_count + 63u) / 64u, 1u, 1u);
+        ::glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    }
+
+    auto Renderer::execute_lighting_pass(Scene &scene) -> void
+    {
+        _light_pass_rt.fb.bind();
+        ::glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        [[maybe_unused]] const auto auto_bind = AutoBind{_light_pass_program};
+
+        const auto [vertex_buffer_handle, index_buffer_handle] = scene.mesh_manager().native_handle();
+
         _light_pass_program.set_uniforms(_gbuffer_rt.color_texture_bindless_handle_0,
                                          _gbuffer_rt.color_texture_bindless_handle_1,
                                          _gbuffer_rt.color_texture_bindless_handle_2,
@@ -439,6 +640,8 @@ namespace ufps
         ::glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, vertex_buffer_handle);
         ::glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 1, _light_buffer.native_handle(), _light_buffer.frame_offset_bytes(), _light_buffer.size());
         ::glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 2, _camera_buffer.native_handle(), _camera_buffer.frame_offset_bytes(), sizeof(CameraData));
+        ::glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, _light_grid_buffer.native_handle());
+        ::glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, _light_index_buffer.native_handle());
         ::glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _post_processing_command_buffer.native_handle());
         ::glMultiDrawElementsIndirect(
             GL_TRIANGLES,
@@ -491,47 +694,18 @@ namespace ufps
         const auto [vertex_buffer_handle, index_buffer_handle] = scene.mesh_manager().native_handle();
         ::glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, vertex_buffer_handle);
         ::glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 1, _camera_buffer.native_handle(), _camera_buffer.frame_offset_bytes(), sizeof(CameraData));
-        ::glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 2, _light_buffer.native_handle(), _light_buffer.frame_offset_bytes(), _light_buffer.size());
+        ::glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 3, _light_buffer.native_handle(), _light_buffer.frame_offset_bytes(), _light_buffer.size());
         ::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_handle);
 
-        const auto command_count = _forward_transparancy_command_buffer.build(scene, EntityFilterMode::TRANSPARENT);
-
-        ::glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _forward_transparancy_command_buffer.native_handle());
+        const auto culled = cull(scene.entities(), scene.camera().frustum(), EntityFilterMode::TRANSPARENT);
+        _transparent_culling_stats = culled.stats;
 
-        auto object_data = std::vector<ObjectData>{};
+        const auto command_count = _forward_transparancy_command_buffer.build(scene, culled.draws, _gpu_scene.table());
 
-        for (const auto &entity : scene.entities())
-        {
-            object_data.append_range(
-                entity.render_entities() |
-                std::views::filter([](const auto &e)
-                                   { return e.opacity() < 1.f; }) |
-                std::views::transform(
-                    [&entity](const auto &e)
-                    { return ObjectData{
-                          .model = entity.transform(),
-                          .albedo_texture_bindless_handle = e.albedo_texture_bindless_handle(),
-                          .normal_texture_bindless_handle = e.normal_texture_bindless_handle(),
-                          .specular_texture_bindless_handle = e.specular_texture_bindless_handle(),
-                          .roughness_texture_bindless_handle = e.roughness_texture_bindless_handle(),
-                          .ao_texture_bindless_handle = e.ao_texture_bindless_handle(),
-                          .emissive_texture_bindless_handle = e.emissive_texture_bindless_handle(),
-                          .opacity = e.opacity(),
-                          .emissive_strength = entity.emissive_strength(),
-                          .normal_compressed = e.normal_compressed() ? 1u : 0u,
-                          .pad{},
-                      }; }));
-        }
-
-        resize_gpu_buffer(object_data, _transparent_object_data_buffer);
+        ::glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _forward_transparancy_command_buffer.native_handle());
 
-        _transparent_object_data_buffer.write(std::as_bytes(std::span{object_data.data(), object_data.size()}), 0zu);
-        ::glBindBufferRange(
-            GL_SHADER_STORAGE_BUFFER,
-            2,
-            _transparent_object_data_buffer.native_handle(),
-            _transparent_object_data_buffer.frame_offset_bytes(),
-            _transparent_object_data_buffer.size());
+        const auto &object_data_buffer = _gpu_scene.object_data_buffer();
+        ::glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 2, object_data_buffer.native_handle(), object_data_buffer.frame_offset_bytes(), object_data_buffer.size());
 
         ::glMultiDrawElementsIndirect(
             GL_TRIANGLES,
@@ -0,0 +1,94 @@
+#include "graphics/ring_allocator.h"
+
+#include <cstddef>
+#include <optional>
+
+#include "utils/ensure.h"
+
+namespace
+{
+    auto align_up(std::size_t value, std::size_t alignment) -> std::size_t
+    {
+        return (value + alignment - 1zu) / alignment * alignment;
+    }
+}
+
+namespace ufps
+{
+    RingAllocator::RingAllocator(std::size_t size)
+        : _size{size},
+          _head{},
+          _used{},
+          _open{},
+          _regions{}
+    {
+    }
+
+    auto RingAllocator::allocate(std::size_t size, std::size_t alignment) -> std::optional<std::size_t>
+    {
+        expect(size <= _size, "{} bytes do not fit in a ring of {}", size, _size);
+
+        // nothing is in use so start from the beginning rather than wrapping part way through
+        if (_used == 0zu)
+        {
+            _head = 0zu;
+        }
+
+        auto offset = align_up(_head, alignment);
+        auto consumed = offset - _head + size;
+
+        // no room before the end so skip what is left of it and start again from the beginning
+        if (offset + size > _size)
+        {
+            offset = 0zu;
+            consumed = _size - _head + size;
+        }
+
+        if (_used + consumed > _size)
+        {
+            return std::nullopt;
+        }
+
+        _head = offset + size;
+        _used += consumed;
+        _open += consumed;
+
+        return offset;
+    }
+
+    auto RingAllocator::close_region() -> bool
+    {
+        if (_open == 0zu)
+        {
+            return false;
+        }
+
+        _regions.push_back(_open);
+        _open = 0zu;
+
+        return true;
+    }
+
+    auto RingAllocator::release_oldest() -> void
+    {
+        expect(!_regions.empty(), "no region to release");
+
+        _used -= _regions.front();
+        _regions.pop_front();
+    }
+
+    auto RingAllocator::size() const -> std::size_t
+    {
+        return _size;
+    }
+
+    auto RingAllocator::used() const -> std::size_t
+    {
+        return _used;
+    }
+
+    auto RingAllocator::region_count() const -> std::size_t
+    {
+        return _regions.size();
+    }
+}
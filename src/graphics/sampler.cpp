@@ -18,6 +18,8 @@ namespace
             using enum ufps::FilterType;
         case LINEAR_MIPMAP:
             return GL_LINEAR_MIPMAP_LINEAR;
+        case NEAREST_MIPMAP:
+            return GL_NEAREST_MIPMAP_NEAREST;
         case LINEAR:
             return GL_LINEAR;
         case NEAREST:
@@ -89,6 +91,8 @@ namespace ufps
             using enum ufps::FilterType;
         case LINEAR_MIPMAP:
             return "LINEAR_MIPMAP_LINEAR";
+        case NEAREST_MIPMAP:
+            return "NEAREST_MIPMAP_NEAREST";
         case LINEAR:
             return "LINEAR";
         case NEAREST:
@@ -0,0 +1,95 @@
+#include "graphics/staging_ring.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "graphics/opengl.h"
+#include "graphics/persistent_buffer.h"
+#include "graphics/ring_allocator.h"
+#include "utils/data_buffer.h"
+#include "utils/ensure.h"
+
+namespace
+{
+    constexpr auto wait_timeout = std::uint64_t{1'000'000'000u};
+}
+
+namespace ufps
+{
+    StagingRing::StagingRing(std::size_t size, std::string_view name)
+        : _buffer{size, name},
+          _allocator{size},
+          _in_flight{}
+    {
+    }
+
+    StagingRing::~StagingRing()
+    {
+        for (const auto sync : _in_flight)
+        {
+            ::glDeleteSync(sync);
+        }
+    }
+
+    auto StagingRing::write(DataBufferView data, std::size_t alignment) -> std::size_t
+    {
+        ensure(data.size() <= _allocator.size(), "{} bytes do not fit in staging ring {}", data.size(), _buffer.to_string());
+
+        auto offset = _allocator.allocate(data.size(), alignment);
+
+        while (!offset)
+        {
+            // anything not yet fenced has already had the commands reading it issued
+            if (_in_flight.empty())
+            {
+                fence();
+            }
+
+            retire_oldest();
+            offset = _allocator.allocate(data.size(), alignment);
+        }
+
+        _buffer.write(data, *offset);
+
+        return *offset;
+    }
+
+    auto StagingRing::fence() -> void
+    {
+        if (_allocator.close_region())
+        {
+            _in_flight.push_back(::glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+        }
+    }
+
+    auto StagingRing::native_handle() const -> ::GLuint
+    {
+        return _buffer.native_handle();
+    }
+
+    auto StagingRing::size() const -> std::size_t
+    {
+        return _allocator.size();
+    }
+
+    auto StagingRing::retire_oldest() -> void
+    {
+        const auto sync = _in_flight.front();
+        _in_flight.pop_front();
+
+        for (;;)
+        {
+            const auto result = ::glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, wait_timeout);
+            ensure(result != GL_WAIT_FAILED, "failed to wait for staging ring {}", _buffer.to_string());
+
+            if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED)
+            {
+                break;
+            }
+        }
+
+        ::glDeleteSync(sync);
+        _allocator.release_oldest();
+    }
+}
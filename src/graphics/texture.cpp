@@ -1,9 +1,13 @@
 #include "graphics/texture.h"
 
+#include <cstddef>
+#include <ranges>
 #include <string>
 
+#include "graphics/mip_chain.h"
 #include "graphics/opengl.h"
 #include "graphics/sampler.h"
+#include "graphics/staging_ring.h"
 #include "graphics/texture_data.h"
 #include "utils/auto_release.h"
 #include "utils/exception.h"
@@ -32,6 +36,8 @@ namespace
             return GL_RGB16F;
         case RGBA16F:
             return GL_RGBA16F;
+        case R32F:
+            return include_size ? GL_R32F : GL_RED;
         case DEPTH24:
             return GL_DEPTH_COMPONENT24;
         case BC5U:
@@ -49,6 +55,16 @@ namespace
 namespace ufps
 {
     Texture::Texture(const TextureData &texture, const std::string &name, const Sampler &sampler)
+        : Texture(texture, name, sampler, 0u, texture.data ? texture.data->data() : nullptr)
+    {
+    }
+
+    Texture::Texture(const TextureData &texture, const std::string &name, const Sampler &sampler, const StagingRing &staging, std::size_t offset)
+        : Texture(texture, name, sampler, staging.native_handle(), reinterpret_cast<const void *>(offset))
+    {
+    }
+
+    Texture::Texture(const TextureData &texture, const std::string &name, const Sampler &sampler, ::GLuint unpack_buffer, const void *pixels)
         : _handle{0u, [](auto t)
                   { ::glDeleteTextures(1u, &t); }},
           _bindless_handle{},
@@ -59,19 +75,52 @@ namespace ufps
         ::glCreateTextures(GL_TEXTURE_2D, 1, &_handle);
         ::glObjectLabel(GL_TEXTURE, _handle, name.length(), name.data());
 
-        ::glTextureStorage2D(_handle, 1, to_opengl(texture.format, true), texture.width, texture.height);
+        ::glTextureStorage2D(_handle, texture.mip_levels, to_opengl(texture.format, true), texture.width, texture.height);
 
-        if (const auto &data = texture.data; data)
+        // with an unpack buffer bound pixels is an offset into it
+        if (pixels != nullptr || unpack_buffer != 0u)
         {
-            if (texture.is_compressed)
-            {
-                const auto size = ((_width + 3u) / 4u) * ((_height + 3u) / 4u) * 16u;
-                ::glCompressedTextureSubImage2D(_handle, 0, 0, 0, texture.width, texture.height, to_opengl(texture.format, false), size, data->data());
-            }
-            else
+            ::glBindBuffer(GL_PIXEL_UNPACK_BUFFER, unpack_buffer);
+
+            // rows of small uncompressed mips are not 4 byte aligned
+            ::glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+            const auto *base = reinterpret_cast<const std::byte *>(pixels);
+
+            for (const auto &[level, mip] : std::views::enumerate(mip_chain(texture)))
             {
-                ::glTextureSubImage2D(_handle, 0, 0, 0, texture.width, texture.height, to_opengl(texture.format, false), GL_UNSIGNED_BYTE, data->data());
+                const auto *mip_pixels = reinterpret_cast<const void *>(base + mip.offset);
+
+                if (texture.is_compressed)
+                {
+                    ::glCompressedTextureSubImage2D(
+                        _handle,
+                        static_cast<::GLint>(level),
+                        0,
+                        0,
+                        mip.width,
+                        mip.height,
+                        to_opengl(texture.format, false),
+                        static_cast<::GLsizei>(mip.size),
+                        mip_pixels);
+                }
+                else
+                {
+                    ::glTextureSubImage2D(
+                        _handle,
+                        static_cast<::GLint>(level),
+                        0,
+                        0,
+                        mip.width,
+                        mip.height,
+                        to_opengl(texture.format, false),
+                        GL_UNSIGNED_BYTE,
+                        mip_pixels);
+                }
             }
+
+            ::glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            ::glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0u);
         }
 
         _bindless_handle = ::glGetTextureSamplerHandleARB(_handle, sampler.native_handle());
@@ -0,0 +1,213 @@
+#include "graphics/texture_loader.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "concurrency/mpmc_queue.h"
+#include "concurrency/thread_pool.h"
+#include "core/manifest_descriptions.h"
+#include "graphics/mip_chain.h"
+#include "graphics/sampler.h"
+#include "graphics/staging_ring.h"
+#include "graphics/texture.h"
+#include "graphics/texture_data.h"
+#include "graphics/texture_manager.h"
+#include "graphics/texture_streamer.h"
+#include "graphics/texture_streaming.h"
+#include "graphics/utils.h"
+#include "log.h"
+#include "resources/pack.h"
+#include "utils/ensure.h"
+
+namespace
+{
+    struct Decoded
+    {
+        std::optional<ufps::TextureData> texture;
+        std::exception_ptr error;
+
+        // when streaming, the texture as packed (without its data) and which of its mips texture starts from
+        std::optional<ufps::TextureData> packed;
+        std::uint32_t tail_mip;
+    };
+
+    // shared with the decode jobs, the last of which may still be signalling after load has returned
+    struct DecodeState
+    {
+        explicit DecodeState(std::size_t count)
+            : decoded(count),
+              ready{count},
+              ready_count{}
+        {
+        }
+
+        std::vector<Decoded> decoded;
+        ufps::MpmcQueue<std::uint32_t> ready;
+        std::atomic<std::size_t> ready_count;
+    };
+}
+
+namespace ufps
+{
+    TextureLoader::TextureLoader(ThreadPool &pool, std::size_t staging_size)
+        : _pool{pool},
+          _staging{staging_size, "texture_staging"}
+    {
+    }
+
+    auto TextureLoader::load(const Pack &pack, const TextureManifestDescription &manifest, TextureManager &texture_manager, const Sampler &sampler)
+        -> void
+    {
+        load(pack, manifest, texture_manager, sampler, nullptr);
+    }
+
+    auto TextureLoader::load(
+        const Pack &pack,
+        const TextureManifestDescription &manifest,
+        TextureManager &texture_manager,
+        const Sampler &sampler,
+        TextureStreamer &streamer) -> void
+    {
+        load(pack, manifest, texture_manager, sampler, &streamer);
+    }
+
+    auto TextureLoader::load(
+        const Pack &pack,
+        const TextureManifestDescription &manifest,
+        TextureManager &texture_manager,
+        const Sampler &sampler,
+        TextureStreamer *streamer) -> void
+    {
+        const auto entries = manifest.textures | std::ranges::to<std::vector>();
+        const auto state = std::make_shared<DecodeState>(entries.size());
+
+        for (const auto &[index, entry] : std::views::enumerate(entries))
+        {
+            const auto data = pack.view(entry.first);
+            const auto is_srgb = entry.second.is_srgb;
+
+            const auto streaming = streamer != nullptr;
+
+            _pool.add(
+                [state, data, is_srgb, index, streaming]
+                {
+                    auto &decoded = state->decoded[index];
+
+                    try
+                    {
+                        decoded.texture = load_texture(data, is_srgb);
+
+                        const auto &texture = *decoded.texture;
+                        decoded.tail_mip = first_mip_within(texture.width, texture.height, texture.mip_levels, texture_streaming_tail_size);
+
+                        // only the tail is uploaded now, the streamer brings in the rest when it is needed
+                        if (streaming && decoded.tail_mip != 0u)
+                        {
+                            decoded.packed = TextureData{
+                                .width = texture.width,
+                                .height = texture.height,
+                                .format = texture.format,
+                                .data = std::nullopt,
+                                .is_compressed = texture.is_compressed,
+                                .mip_levels = texture.mip_levels,
+                            };
+                            decoded.texture = drop_mips(texture, decoded.tail_mip);
+                        }
+                    }
+                    catch (...)
+                    {
+                        decoded.error = std::current_exception();
+                    }
+
+                    expect(state->ready.try_push(static_cast<std::uint32_t>(index)), "texture ready queue full");
+
+                    ++state->ready_count;
+                    state->ready_count.notify_one();
+                });
+        }
+
+        auto textures = std::vector<std::optional<Texture>>(entries.size());
+        auto error = std::exception_ptr{};
+
+        // upload in whatever order decoding finishes, every job is waited for even after an error as they read the pack
+        for (auto processed = 0zu; processed < entries.size(); ++processed)
+        {
+            state->ready_count.wait(processed);
+
+            // a job that claimed an earlier queue slot may not have finished pushing to it yet
+            auto index = state->ready.try_pop();
+            while (!index)
+            {
+                std::this_thread::yield();
+                index = state->ready.try_pop();
+            }
+
+            auto &decoded = state->decoded[*index];
+            if (decoded.error || error)
+            {
+                error = error ? error : decoded.error;
+                continue;
+            }
+
+            const auto &texture_data = *decoded.texture;
+            const auto &name = entries[*index].first;
+
+            try
+            {
+                if (!texture_data.data)
+                {
+                    // no pixels, so nothing to stage
+                    textures[*index].emplace(texture_data, name, sampler);
+                }
+                else if (texture_data.data->size() <= _staging.size())
+                {
+                    const auto offset = _staging.write(*texture_data.data);
+                    textures[*index].emplace(texture_data, name, sampler, _staging, offset);
+                    _staging.fence();
+                }
+                else
+                {
+                    log::warn("texture {} is larger than the staging ring, uploading directly", name);
+                    textures[*index].emplace(texture_data, name, sampler);
+                }
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+
+            decoded.texture.reset();
+        }
+
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+
+        // one write of every bindless handle rather than one per texture
+        const auto first_index =
+            texture_manager.add(textures | std::views::transform([](auto &texture) { return std::move(*texture); }) | std::ranges::to<std::vector>());
+
+        if (streamer == nullptr)
+        {
+            return;
+        }
+
+        for (const auto &[index, decoded] : std::views::enumerate(state->decoded))
+        {
+            if (decoded.packed)
+            {
+                const auto &[name, description] = entries[index];
+                streamer->add(name, description.is_srgb, first_index + static_cast<std::uint32_t>(index), *decoded.packed, decoded.tail_mip);
+            }
+        }
+    }
+}
@@ -1,9 +1,13 @@
 #include "graphics/texture_manager.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <optional>
 #include <ranges>
 #include <span>
 #include <string_view>
+#include <vector>
 
 #include "graphics/buffer.h"
 #include "graphics/opengl.h"
@@ -15,44 +19,62 @@ using namespace std::literals;
 
 namespace ufps
 {
-    TextureManager::TextureManager()
-        : _gpu_buffer{sizeof(::GLuint64), "bindless_textures"},
-          _cpu_buffer{},
-          _textures{}
+    TextureManager::TextureManager(std::size_t capacity)
+        : _gpu_buffer{std::max(capacity, 1zu) * sizeof(::GLuint64), "bindless_textures"},
+          _registry{},
+          _in_batch{false},
+          _revision{}
     {
+        _registry.reserve(capacity);
     }
 
     auto TextureManager::add(Texture texture) -> std::uint32_t
     {
-        const auto new_index = _textures.size();
+        const auto new_index = _registry.add(std::move(texture));
 
-        auto &new_tex = _textures.emplace_back(std::move(texture));
-
-        _cpu_buffer.push_back(new_tex.bindless_handle());
-
-        resize_gpu_buffer(_cpu_buffer, _gpu_buffer);
-
-        _gpu_buffer.write(std::as_bytes(std::span{_cpu_buffer.data(), _cpu_buffer.size()}), 0zu);
+        if (!_in_batch)
+        {
+            upload();
+        }
 
-        return static_cast<std::uint32_t>(new_index);
+        return new_index;
     }
 
     auto TextureManager::add(std::vector<Texture> textures) -> std::uint32_t
     {
-        const auto new_index = _textures.size();
+        const auto new_index = _registry.size();
+        const auto in_batch = _in_batch;
 
-        _textures.append_range(std::views::as_rvalue(textures));
+        if (!in_batch)
+        {
+            begin_batch();
+        }
 
-        _cpu_buffer = _textures |
-                      std::views::transform([](auto &e)
-                                            { return e.bindless_handle(); }) |
-                      std::ranges::to<std::vector>();
+        for (auto &texture : textures)
+        {
+            add(std::move(texture));
+        }
 
-        resize_gpu_buffer(_cpu_buffer, _gpu_buffer);
+        if (!in_batch)
+        {
+            commit();
+        }
 
-        _gpu_buffer.write(std::as_bytes(std::span{_cpu_buffer.data(), _cpu_buffer.size()}), 0zu);
+        return new_index;
+    }
 
-        return static_cast<std::uint32_t>(new_index);
+    auto TextureManager::begin_batch() -> void
+    {
+        ensure(!_in_batch, "texture batch already started");
+        _in_batch = true;
+    }
+
+    auto TextureManager::commit() -> void
+    {
+        ensure(_in_batch, "no texture batch to commit");
+        _in_batch = false;
+
+        upload();
     }
 
     auto TextureManager::native_handle() -> ::GLuint
@@ -62,38 +84,26 @@ namespace ufps
 
     auto TextureManager::texture(std::uint32_t index) const -> const Texture *
     {
-        expect(index <= _textures.size(), "index out of range");
-
-        return std::addressof(_textures[index]);
+        return _registry.texture(index);
     }
 
     auto TextureManager::texture(std::uint64_t bindless_handle) const -> const Texture *
     {
-        auto iter = std::ranges::find_if(_cpu_buffer, [bindless_handle](auto h)
-                                         { return h == bindless_handle; });
-        expect(iter != std::ranges::cend(_cpu_buffer), "bindless handle {} not found", bindless_handle);
+        const auto index = _registry.try_get_index(bindless_handle);
+        expect(index.has_value(), "bindless handle {} not found", bindless_handle);
 
-        const auto index = std::distance(std::ranges::cbegin(_cpu_buffer), iter);
-        return std::addressof(_textures[index]);
+        return _registry.texture(*index);
     }
 
     auto TextureManager::bindless_handle(std::string_view name) const -> std::uint64_t
     {
-        const auto index = texture_index(name);
-        return _cpu_buffer[index];
+        // the texture's own handle, never a redirect, only what is built for shaders holds resolved handles
+        return _registry.texture(texture_index(name))->bindless_handle();
     }
 
     auto TextureManager::try_get_texture_index(std::string_view name) const -> std::optional<std::uint32_t>
     {
-        auto iter = std::ranges::find_if(_textures, [name](const auto &t)
-                                         { return t.name() == name; });
-
-        if (iter == std::ranges::cend(_textures))
-        {
-            return std::nullopt;
-        }
-
-        return static_cast<std::uint32_t>(std::distance(std::ranges::cbegin(_textures), iter));
+        return _registry.try_get_index(name);
     }
 
     auto TextureManager::texture_index(std::string_view name) const -> std::uint32_t
@@ -106,13 +116,53 @@ namespace ufps
 
     auto TextureManager::textures(const std::vector<std::uint32_t> &indices) const -> std::vector<const Texture *>
     {
-
         return indices |
-               std::views::transform(
-                   [this](auto i)
-                   { 
-                                        expect(i <= _textures.size(), "index {} out of range", i);
-                                        return std::addressof(_textures[i]); }) |
+               std::views::transform([this](auto i) { return _registry.texture(i); }) |
                std::ranges::to<std::vector>();
     }
-}
\ No newline at end of file
+
+    auto TextureManager::redirect(std::uint32_t index, std::uint64_t bindless_handle) -> void
+    {
+        _registry.set_handle(index, bindless_handle);
+        ++_revision;
+
+        if (!_in_batch)
+        {
+            upload();
+        }
+    }
+
+    auto TextureManager::resolve(std::uint64_t bindless_handle) const -> std::uint64_t
+    {
+        return _registry.try_get_index(bindless_handle)
+            .transform([this](auto index) { return _registry.handles()[index]; })
+            .value_or(bindless_handle);
+    }
+
+    auto TextureManager::revision() const -> std::uint32_t
+    {
+        return _revision;
+    }
+
+    auto TextureManager::upload() -> void
+    {
+        const auto &handles = _registry.handles();
+
+        // a grown buffer starts out empty so everything has to go up again
+        const auto old_size = _gpu_buffer.size();
+        resize_gpu_buffer(handles, _gpu_buffer);
+        if (_gpu_buffer.size() != old_size)
+        {
+            _registry.mark_all_pending();
+        }
+
+        const auto first = _registry.pending_first();
+        if (first != handles.size())
+        {
+            const auto pending = std::span{handles}.subspan(first);
+            _gpu_buffer.write(std::as_bytes(pending), first * sizeof(::GLuint64));
+        }
+
+        _registry.clear_pending();
+    }
+}
@@ -0,0 +1,316 @@
+#include "graphics/texture_streamer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <format>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "concurrency/mpmc_queue.h"
+#include "concurrency/thread_pool.h"
+#include "core/scene.h"
+#include "graphics/mip_chain.h"
+#include "graphics/sampler.h"
+#include "graphics/texture.h"
+#include "graphics/texture_data.h"
+#include "graphics/texture_manager.h"
+#include "graphics/texture_streaming.h"
+#include "graphics/utils.h"
+#include "log.h"
+#include "math/matrix4.h"
+#include "math/utils.h"
+#include "math/vector3.h"
+#include "resources/pack.h"
+#include "utils/ensure.h"
+#include "utils/exception.h"
+
+namespace
+{
+    // a retired detail texture may still be sampled by frames the gpu has not finished yet
+    constexpr auto frames_in_flight = 3u;
+
+    struct Loaded
+    {
+        std::uint32_t streamed_index;
+        std::uint32_t first_mip;
+        std::optional<ufps::TextureData> texture;
+        std::exception_ptr error;
+    };
+}
+
+namespace ufps::impl
+{
+    // shared with the load jobs, each of which fills in its own slot and then queues the slot's index
+    struct StreamingState
+    {
+        StreamingState()
+            : slots(texture_streaming_max_loads),
+              loaded{texture_streaming_max_loads}
+        {
+        }
+
+        std::vector<Loaded> slots;
+        MpmcQueue<std::uint32_t> loaded;
+    };
+}
+
+namespace ufps
+{
+    TextureStreamer::TextureStreamer(
+        ThreadPool &pool,
+        const Pack &pack,
+        TextureManager &texture_manager,
+        const Sampler &sampler,
+        std::size_t budget)
+        : _pool{pool},
+          _pack{pack},
+          _texture_manager{texture_manager},
+          _sampler{sampler},
+          _budget{budget},
+          _staging{texture_streaming_staging_size, "texture_streaming_staging"},
+          _streamed{},
+          _handle_lookup{},
+          _retired{},
+          _state{std::make_shared<impl::StreamingState>()},
+          _free_slots{std::views::iota(0u, texture_streaming_max_loads) | std::ranges::to<std::vector>()},
+          _frame{}
+    {
+    }
+
+    TextureStreamer::~TextureStreamer()
+    {
+        // jobs read the pack, which only has to outlive the streamer
+        while (_free_slots.size() != texture_streaming_max_loads)
+        {
+            if (const auto slot = _state->loaded.try_pop(); slot)
+            {
+                _free_slots.push_back(*slot);
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    auto TextureStreamer::add(const std::string &name, bool is_srgb, std::uint32_t index, const TextureData &texture, std::uint32_t tail_mip)
+        -> void
+    {
+        const auto streamed_index = static_cast<std::uint32_t>(_streamed.size());
+        const auto handle = _texture_manager.texture(index)->bindless_handle();
+
+        _streamed.push_back({
+            .name = name,
+            .is_srgb = is_srgb,
+            .index = index,
+            .state =
+                {
+                    .format = texture.format,
+                    .width = texture.width,
+                    .height = texture.height,
+                    .mip_levels = texture.mip_levels,
+                    .tail_mip = tail_mip,
+                    .resident_mip = tail_mip,
+                    .desired_mip = tail_mip,
+                },
+            .detail = std::nullopt,
+            .loading_mip = std::nullopt,
+            .failed = false,
+        });
+
+        _handle_lookup.emplace(handle, streamed_index);
+    }
+
+    auto TextureStreamer::request(std::uint64_t bindless_handle, float extent) -> void
+    {
+        const auto iter = _handle_lookup.find(bindless_handle);
+        if (iter == std::ranges::cend(_handle_lookup))
+        {
+            return;
+        }
+
+        auto &state = _streamed[iter->second].state;
+        state.desired_mip = std::min(state.desired_mip, desired_mip(state.width, state.height, state.mip_levels, extent));
+    }
+
+    auto TextureStreamer::request(const Scene &scene) -> void
+    {
+        const auto &camera = scene.camera();
+        const auto frustum = camera.frustum();
+
+        for (const auto &entity : scene.entities())
+        {
+            const auto model = Matrix4{entity.transform()};
+
+            for (const auto &render_entity : entity.render_entities())
+            {
+                const auto aabb = transform(render_entity.aabb(), model);
+                if (!intersect(frustum, aabb))
+                {
+                    continue;
+                }
+
+                const auto centre = (aabb.min + aabb.max) / 2.f;
+                const auto radius = Vector3::distance(aabb.min, aabb.max) / 2.f;
+                const auto extent = screen_extent(radius, Vector3::distance(camera.position(), centre), camera.fov(), camera.height());
+
+                for (const auto handle : {
+                         render_entity.albedo_texture_bindless_handle(),
+                         render_entity.normal_texture_bindless_handle(),
+                         render_entity.specular_texture_bindless_handle(),
+                         render_entity.roughness_texture_bindless_handle(),
+                         render_entity.ao_texture_bindless_handle(),
+                         render_entity.emissive_texture_bindless_handle(),
+                     })
+                {
+                    request(handle, extent);
+                }
+            }
+        }
+    }
+
+    auto TextureStreamer::update() -> void
+    {
+        while (const auto slot = _state->loaded.try_pop())
+        {
+            _free_slots.push_back(*slot);
+
+            auto loaded = std::exchange(_state->slots[*slot], {});
+            auto &streamed = _streamed[loaded.streamed_index];
+            streamed.loading_mip.reset();
+
+            if (loaded.error)
+            {
+                try
+                {
+                    std::rethrow_exception(loaded.error);
+                }
+                catch (const Exception &e)
+                {
+                    log::error("failed to stream texture {}: {}", streamed.name, e.what());
+                }
+                catch (...)
+                {
+                    log::error("failed to stream texture {}", streamed.name);
+                }
+
+                streamed.failed = true;
+                continue;
+            }
+
+            install(loaded.streamed_index, loaded.first_mip, *loaded.texture);
+        }
+
+        std::erase_if(_retired, [this](const auto &retired) { return retired.frame + frames_in_flight <= _frame; });
+
+        // a texture still loading is planned as if it had arrived so its memory is already accounted for
+        const auto states = _streamed |
+                            std::views::transform(
+                                [](const auto &streamed)
+                                {
+                                    auto state = streamed.state;
+                                    state.resident_mip = streamed.loading_mip.value_or(state.resident_mip);
+                                    state.desired_mip = streamed.failed || streamed.loading_mip ? state.resident_mip : state.desired_mip;
+                                    return state;
+                                }) |
+                            std::ranges::to<std::vector>();
+
+        for (const auto &change : plan_mip_changes(states, _budget))
+        {
+            auto &streamed = _streamed[change.index];
+
+            if (change.first_mip >= streamed.state.tail_mip)
+            {
+                retire(streamed);
+                continue;
+            }
+
+            if (_free_slots.empty())
+            {
+                continue;
+            }
+
+            const auto slot = _free_slots.back();
+            _free_slots.pop_back();
+
+            streamed.loading_mip = change.first_mip;
+            _state->slots[slot] = {.streamed_index = change.index, .first_mip = change.first_mip, .texture = std::nullopt, .error = {}};
+
+            _pool.add(
+                [state = _state, data = _pack.view(streamed.name), is_srgb = streamed.is_srgb, first_mip = change.first_mip, slot]
+                {
+                    auto &loaded = state->slots[slot];
+
+                    try
+                    {
+                        loaded.texture = drop_mips(load_texture(data, is_srgb), first_mip);
+                    }
+                    catch (...)
+                    {
+                        loaded.error = std::current_exception();
+                    }
+
+                    expect(state->loaded.try_push(slot), "texture streaming queue full");
+                });
+        }
+
+        for (auto &streamed : _streamed)
+        {
+            streamed.state.desired_mip = streamed.state.tail_mip;
+        }
+
+        ++_frame;
+    }
+
+    auto TextureStreamer::resident_bytes() const -> std::size_t
+    {
+        return std::ranges::fold_left(
+            _streamed | std::views::transform([](const auto &streamed) { return detail_size(streamed.state, streamed.state.resident_mip); }),
+            0zu,
+            std::plus<>{});
+    }
+
+    auto TextureStreamer::install(std::uint32_t streamed_index, std::uint32_t first_mip, const TextureData &texture) -> void
+    {
+        auto &streamed = _streamed[streamed_index];
+        retire(streamed);
+
+        const auto name = std::format("{}_mip{}", streamed.name, first_mip);
+
+        if (texture.data && texture.data->size() <= _staging.size())
+        {
+            const auto offset = _staging.write(*texture.data);
+            streamed.detail.emplace(texture, name, _sampler, _staging, offset);
+            _staging.fence();
+        }
+        else
+        {
+            streamed.detail.emplace(texture, name, _sampler);
+        }
+
+        streamed.state.resident_mip = first_mip;
+        _texture_manager.redirect(streamed.index, streamed.detail->bindless_handle());
+    }
+
+    auto TextureStreamer::retire(Streamed &streamed) -> void
+    {
+        if (!streamed.detail)
+        {
+            return;
+        }
+
+        _texture_manager.redirect(streamed.index, _texture_manager.texture(streamed.index)->bindless_handle());
+        _retired.push_back({.texture = std::move(*streamed.detail), .frame = _frame});
+
+        streamed.detail.reset();
+        streamed.state.resident_mip = streamed.state.tail_mip;
+    }
+}
@@ -22,6 +22,7 @@
 #pragma GCC diagnostic pop
 
 #include "graphics/dds.h"
+#include "graphics/mip_chain.h"
 #include "graphics/model_data.h"
 #include "graphics/texture_data.h"
 #include "graphics/vertex_data.h"
@@ -156,10 +157,65 @@ namespace
             return ufps::TextureFormat::BC7;
         case DXGI_FORMAT_BC7_UNORM_SRGB:
             return ufps::TextureFormat::BC7_SRGB;
+        case DXGI_FORMAT_R8_UNORM:
+            return ufps::TextureFormat::R;
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+            return ufps::TextureFormat::RGBA;
+        case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+            return ufps::TextureFormat::SRGBA;
         default:
             throw ufps::Exception("unsupported DXGI format: {}", std::to_underlying(format), 1u);
         }
     }
+
+    auto to_dxgi_format(ufps::TextureFormat format) -> ::DXGI_FORMAT
+    {
+        switch (format)
+        {
+            using enum ufps::TextureFormat;
+        case BC5U:
+            return DXGI_FORMAT_BC5_UNORM;
+        case BC7:
+            return DXGI_FORMAT_BC7_UNORM;
+        case BC7_SRGB:
+            return DXGI_FORMAT_BC7_UNORM_SRGB;
+        case R:
+            return DXGI_FORMAT_R8_UNORM;
+        case RGBA:
+            return DXGI_FORMAT_R8G8B8A8_UNORM;
+        case SRGBA:
+            return DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+        default:
+            throw ufps::Exception("format cannot be written to DDS: {}", ufps::to_string(format));
+        }
+    }
+
+    // a DDS may claim more mips than it holds, keep the ones that are actually there
+    auto dds_mip_levels(const ::DDS_HEADER &header, ufps::TextureFormat format, std::size_t data_size) -> std::uint32_t
+    {
+        static constexpr auto ddsd_mipmapcount = 0x20000u;
+
+        const auto width = static_cast<std::uint32_t>(header.dwWidth);
+        const auto height = static_cast<std::uint32_t>(header.dwHeight);
+
+        auto levels = (header.dwFlags & ddsd_mipmapcount) != 0u ? static_cast<std::uint32_t>(header.dwMipMapCount) : 1u;
+        levels = std::clamp(levels, 1u, ufps::full_mip_count(width, height));
+
+        while (levels > 1u)
+        {
+            const auto chain = ufps::mip_chain(format, width, height, levels);
+            if (chain.back().offset + chain.back().size <= data_size)
+            {
+                break;
+            }
+
+            --levels;
+        }
+
+        ufps::ensure(ufps::mip_level_size(format, width, height) <= data_size, "DDS data too small for its first mip: {}", data_size);
+
+        return levels;
+    }
 }
 
 namespace ufps
@@ -199,37 +255,39 @@ namespace ufps
             std::memcpy(&dds_header, image_data.data() + sizeof(dds_magic), sizeof(dds_header));
 
             ensure(dds_header.dwSize == sizeof(dds_header), "invalid dds_header size: {}", dds_header.dwSize);
+
+            auto format = TextureFormat{};
+            auto data_offset = sizeof(dds_magic) + sizeof(dds_header);
+
             if (dds_header.ddspf.dwFourCC == 0x30315844)
             {
                 auto dx10_header = DDS_HEADER_DXT10{};
-                std::memcpy(&dx10_header, image_data.data() + sizeof(dds_magic) + sizeof(dds_header), sizeof(dx10_header));
-
-                return {
-                    .width = static_cast<std::uint32_t>(dds_header.dwWidth),
-                    .height = static_cast<std::uint32_t>(dds_header.dwHeight),
-                    .format = to_native_format(dx10_header.dxgiFormat),
-                    .data = image_data |
-                            std::views::drop(sizeof(dds_magic) + sizeof(dds_header) + sizeof(dx10_header)) |
-                            std::ranges::to<std::vector>(),
-                    .is_compressed = true,
-                };
+                std::memcpy(&dx10_header, image_data.data() + data_offset, sizeof(dx10_header));
+
+                format = to_native_format(dx10_header.dxgiFormat);
+                data_offset += sizeof(dx10_header);
             }
             else if (dds_header.ddspf.dwFourCC == 0x55354342)
             {
-                return {
-                    .width = static_cast<std::uint32_t>(dds_header.dwWidth),
-                    .height = static_cast<std::uint32_t>(dds_header.dwHeight),
-                    .format = TextureFormat::BC5U,
-                    .data = image_data |
-                            std::views::drop(sizeof(dds_magic) + sizeof(dds_header)) |
-                            std::ranges::to<std::vector>(),
-                    .is_compressed = true,
-                };
+                format = TextureFormat::BC5U;
             }
             else
             {
                 throw Exception("unsupported DDS format: {}", dds_header.ddspf.dwFourCC, 1u);
             }
+
+            const auto data = image_data.subspan(std::min(data_offset, image_data.size()));
+            const auto mip_levels = dds_mip_levels(dds_header, format, data.size());
+            const auto chain = mip_chain(format, dds_header.dwWidth, dds_header.dwHeight, mip_levels);
+
+            return {
+                .width = static_cast<std::uint32_t>(dds_header.dwWidth),
+                .height = static_cast<std::uint32_t>(dds_header.dwHeight),
+                .format = format,
+                .data = data.first(chain.back().offset + chain.back().size) | std::ranges::to<std::vector>(),
+                .is_compressed = is_block_compressed(format),
+                .mip_levels = mip_levels,
+            };
         }
         else
         {
@@ -261,6 +319,56 @@ namespace ufps
         }
     }
 
+    auto encode_dds(const TextureData &texture) -> DataBuffer
+    {
+        ensure(texture.data.has_value(), "cannot write DDS without texture data");
+
+        static constexpr auto ddsd_caps = 0x1u;
+        static constexpr auto ddsd_height = 0x2u;
+        static constexpr auto ddsd_width = 0x4u;
+        static constexpr auto ddsd_pixelformat = 0x1000u;
+        static constexpr auto ddsd_mipmapcount = 0x20000u;
+        static constexpr auto ddsd_linearsize = 0x80000u;
+        static constexpr auto ddpf_fourcc = 0x4u;
+        static constexpr auto ddscaps_complex = 0x8u;
+        static constexpr auto ddscaps_texture = 0x1000u;
+        static constexpr auto ddscaps_mipmap = 0x400000u;
+        static constexpr auto dx10_fourcc = 0x30315844u;
+
+        const auto chain = mip_chain(texture);
+        const auto data_size = chain.back().offset + chain.back().size;
+        ensure(texture.data->size() >= data_size, "texture data too small for {} mips: {}", texture.mip_levels, texture.data->size());
+
+        auto header = DDS_HEADER{};
+        header.dwSize = sizeof(DDS_HEADER);
+        header.dwFlags = ddsd_caps | ddsd_height | ddsd_width | ddsd_pixelformat | ddsd_mipmapcount | ddsd_linearsize;
+        header.dwHeight = texture.height;
+        header.dwWidth = texture.width;
+        header.dwPitchOrLinearSize = static_cast<std::uint32_t>(chain.front().size);
+        header.dwMipMapCount = texture.mip_levels;
+        header.ddspf.dwSize = sizeof(DDS_PIXELFORMAT);
+        header.ddspf.dwFlags = ddpf_fourcc;
+        header.ddspf.dwFourCC = dx10_fourcc;
+        header.dwCaps = ddscaps_texture | (texture.mip_levels > 1u ? ddscaps_complex | ddscaps_mipmap : 0u);
+
+        const auto dx10_header = DDS_HEADER_DXT10{
+            .dxgiFormat = to_dxgi_format(texture.format),
+            .resourceDimension = D3D10_RESOURCE_DIMENSION_TEXTURE2D,
+            .miscFlag = 0u,
+            .arraySize = 1u,
+            .miscFlag2 = 0u,
+        };
+
+        auto dds = DataBuffer{};
+        dds.reserve(4zu + sizeof(header) + sizeof(dx10_header) + data_size);
+        dds.append_range(std::as_bytes(std::span{"DDS ", 4zu}));
+        dds.append_range(std::as_bytes(std::span{&header, 1zu}));
+        dds.append_range(std::as_bytes(std::span{&dx10_header, 1zu}));
+        dds.append_range(DataBufferView{*texture.data}.first(data_size));
+
+        return dds;
+    }
+
     auto load_model(std::string file_name, DataBufferView model_data, std::string format) -> std::tuple<std::string, std::vector<ModelData>>
     {
         if (config::log_assimp)
@@ -390,6 +498,7 @@ namespace ufps
             auto model = ModelData{
                 .mesh_data = {.vertices = vertices(positions, normals, tangents, bitangents, uvs),
                               .indices = std::move(indices)},
+                .meshlets = {},
                 .albedo = std::nullopt,
                 .normal = std::nullopt,
                 .specular = std::nullopt,
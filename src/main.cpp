@@ -32,16 +32,18 @@
 #include "graphics/renderer.h"
 #include "graphics/sampler.h"
 #include "graphics/texture.h"
+#include "graphics/texture_loader.h"
 #include "graphics/texture_manager.h"
+#include "graphics/texture_streamer.h"
 #include "graphics/utils.h"
 #include "graphics/vertex_data.h"
 #include "log.h"
 #include "resources/embedded_resource_loader.h"
-#include "resources/file_resource_loader.h"
+#include "resources/pack.h"
 #include "resources/resource_loader.h"
+#include "resources/vfs.h"
 #include "serialization/yaml_serializer.h"
 #include "utils/data_buffer.h"
-#include "utils/decompress.h"
 #include "utils/ensure.h"
 #include "utils/exception.h"
 #include "window.h"
@@ -228,27 +230,25 @@ namespace
         return direction / factor;
     }
 
-    auto load_all_textures(ufps::ResourceLoader &resource_loader, ufps::TextureManager &texture_manager, const ufps::Sampler &sampler) -> void
+    auto load_all_textures(
+        const ufps::Pack &pack,
+        ufps::ThreadPool &pool,
+        ufps::TextureManager &texture_manager,
+        const ufps::Sampler &sampler,
+        ufps::TextureStreamer &texture_streamer) -> void
     {
-        const auto texture_manifest_str = resource_loader.load_string("configs/texture_manifest.yaml");
+        const auto texture_manifest_str = pack.load_string("configs/texture_manifest.yaml");
         const auto texture_manifest = ufps::yaml::deserialize<ufps::TextureManifestDescription>(texture_manifest_str);
 
-        const auto texture_blob = ufps::decompress(resource_loader.load_data_buffer("blobs/texture_data.bin"));
-
-        for (const auto &[name, manifest] : texture_manifest.textures)
-        {
-            const auto raw_texture_data = std::span{texture_blob.data() + manifest.offset, manifest.size};
-            const auto texture_data = ufps::load_texture(raw_texture_data, manifest.is_srgb);
-
-            texture_manager.add({texture_data, name, sampler});
-        }
+        auto texture_loader = ufps::TextureLoader{pool};
+        texture_loader.load(pack, texture_manifest, texture_manager, sampler, texture_streamer);
     }
 
-    auto build_mesh_lookup(ufps::ResourceLoader &resource_loader) -> ufps::StringUnorderedMap<std::vector<ufps::MeshView>>
+    auto build_mesh_lookup(const ufps::Pack &pack) -> ufps::StringUnorderedMap<std::vector<ufps::MeshView>>
     {
         auto mesh_lookup = ufps::StringUnorderedMap<std::vector<ufps::MeshView>>{};
 
-        const auto manifest_str = resource_loader.load_string("configs/model_manifest.yaml");
+        const auto manifest_str = pack.load_string("configs/model_manifest.yaml");
         const auto manifest = ufps::yaml::deserialize<ufps::ModelManifestDescription>(manifest_str);
 
         return manifest.models |
@@ -265,13 +265,13 @@ namespace
     }
 
     auto build_entity_cache(
-        ufps::ResourceLoader &resource_loader,
+        const ufps::Pack &pack,
         ufps::TextureManager &texture_manager,
         ufps::MeshManager &mesh_manager) -> ufps::StringUnorderedMap<ufps::Entity>
     {
         auto entity_cache = ufps::StringUnorderedMap<ufps::Entity>{};
 
-        const auto model_manifest_str = resource_loader.load_string("configs/model_manifest.yaml");
+        const auto model_manifest_str = pack.load_string("configs/model_manifest.yaml");
         const auto model_manifest = ufps::yaml::deserialize<ufps::ModelManifestDescription>(model_manifest_str);
 
         for (const auto &[name, manifests] : model_manifest.models)
@@ -407,7 +407,7 @@ auto start(int argc, char **argv) -> int
     auto running = true;
 
     const auto sampler = ufps::Sampler{
-        ufps::FilterType::LINEAR,
+        ufps::FilterType::LINEAR_MIPMAP,
         ufps::FilterType::LINEAR,
         ufps::WrapMode::REPEAT,
         ufps::WrapMode::REPEAT,
@@ -421,20 +421,31 @@ auto start(int argc, char **argv) -> int
     }
     else
     {
-        ufps::log::info("using file resource loader");
-        resource_loader = std::make_unique<ufps::FileResourceLoader>(std::vector<std::filesystem::path>{"assets", "build/build_assets"});
+        ufps::log::info("using vfs resource loader");
+
+        // source assets overlay the build outputs, so an edited config or shader is picked up without repacking
+        auto vfs = std::make_unique<ufps::Vfs>();
+        vfs->mount_directory("build/build_assets");
+        vfs->mount_directory("assets");
+        resource_loader = std::move(vfs);
     }
 
-    auto texture_manager = ufps::TextureManager{};
-    load_all_textures(*resource_loader, texture_manager, sampler);
+    // mapped for the lifetime of the game, textures and meshes are read from it in place
+    const auto pack = resource_loader->load_pack("assets.pack");
 
     auto pool = ufps::ThreadPool{};
+
+    auto texture_manager = ufps::TextureManager{};
+    auto texture_streamer = ufps::TextureStreamer{pool, pack, texture_manager, sampler};
+    load_all_textures(pack, pool, texture_manager, sampler, texture_streamer);
+
     auto awaitable_manager = ufps::AwaitableManager{pool};
 
     auto mesh_manager = ufps::MeshManager{
-        ufps::decompress(resource_loader->load_data_buffer("blobs/vertex_data.bin")),
-        ufps::decompress(resource_loader->load_data_buffer("blobs/index_data.bin")),
-        build_mesh_lookup(*resource_loader)};
+        pack.view("vertex_data"),
+        pack.view("index_data"),
+        pack.view("meshlet_data"),
+        build_mesh_lookup(pack)};
 
     mesh_manager.load("cube", std::vector{cube()});
 
@@ -469,7 +480,7 @@ auto start(int argc, char **argv) -> int
          0.01f,
          1000.f},
         ufps::yaml::deserialize<ufps::Scene::Description>(ss.str()),
-        build_entity_cache(*resource_loader, texture_manager, mesh_manager)};
+        build_entity_cache(pack, texture_manager, mesh_manager)};
 
     const auto point_light_handles = scene.lights().lights.handles();
     pulse_light(awaitable_manager, point_light_handles[0], scene);
@@ -561,6 +572,9 @@ auto start(int argc, char **argv) -> int
         scene.camera().translate(walk_direction(key_state, scene.camera()));
         scene.camera().update();
 
+        texture_streamer.request(scene);
+        texture_streamer.update();
+
         renderer.render(scene);
 
         window.swap();
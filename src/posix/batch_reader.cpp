@@ -0,0 +1,335 @@
+#ifdef _WIN32
+#error This code unit is NOT for Windows !
+#endif
+
+#include "resources/batch_reader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "log.h"
+#include "utils/auto_release.h"
+#include "utils/ensure.h"
+#include "utils/exception.h"
+
+namespace
+{
+    auto open_file(const std::filesystem::path &path) -> int
+    {
+        return ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    }
+
+    auto load_acquire(std::uint32_t *value) -> std::uint32_t
+    {
+        return std::atomic_ref{*value}.load(std::memory_order_acquire);
+    }
+
+    auto store_release(std::uint32_t *value, std::uint32_t new_value) -> void
+    {
+        std::atomic_ref{*value}.store(new_value, std::memory_order_release);
+    }
+}
+
+namespace ufps
+{
+    // the raw kernel interface, a submission and completion ring shared with the kernel through mmap
+    struct BatchReader::Ring
+    {
+        AutoRelease<int, -1> fd;
+        AutoRelease<void *, nullptr> sq_ring;
+        AutoRelease<void *, nullptr> cq_ring;
+        AutoRelease<void *, nullptr> sqes_map;
+
+        std::uint32_t *sq_tail;
+        std::uint32_t sq_mask;
+        std::uint32_t *sq_array;
+        ::io_uring_sqe *sqes;
+
+        std::uint32_t *cq_head;
+        std::uint32_t *cq_tail;
+        std::uint32_t cq_mask;
+        ::io_uring_cqe *cqes;
+
+        // submissions queued since the last enter
+        std::uint32_t to_submit;
+
+        // null if the kernel does not allow it
+        static auto create(std::uint32_t queue_depth) -> std::unique_ptr<Ring>
+        {
+            auto params = ::io_uring_params{};
+            const auto ring_fd = static_cast<int>(::syscall(__NR_io_uring_setup, queue_depth, &params));
+            if (ring_fd < 0)
+            {
+                log::warn("io_uring unavailable ({}), batch reads fall back to pread", std::strerror(errno));
+                return nullptr;
+            }
+
+            auto ring = std::make_unique<Ring>();
+            ring->fd = {ring_fd, ::close};
+
+            const auto sq_size = params.sq_off.array + params.sq_entries * sizeof(std::uint32_t);
+            const auto cq_size = params.cq_off.cqes + params.cq_entries * sizeof(::io_uring_cqe);
+            const auto single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0u;
+
+            const auto map = [ring_fd](std::size_t size, std::uint64_t offset) -> AutoRelease<void *, nullptr>
+            {
+                auto *ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, static_cast<::off_t>(offset));
+                return {ptr == MAP_FAILED ? nullptr : ptr, [size](void *ptr) { ::munmap(ptr, size); }};
+            };
+
+            ring->sq_ring = map(single_mmap ? std::max(sq_size, cq_size) : sq_size, IORING_OFF_SQ_RING);
+            ensure(ring->sq_ring, "failed to map io_uring submission ring");
+
+            if (!single_mmap)
+            {
+                ring->cq_ring = map(cq_size, IORING_OFF_CQ_RING);
+                ensure(ring->cq_ring, "failed to map io_uring completion ring");
+            }
+
+            ring->sqes_map = map(params.sq_entries * sizeof(::io_uring_sqe), IORING_OFF_SQES);
+            ensure(ring->sqes_map, "failed to map io_uring submission entries");
+
+            auto *sq = static_cast<std::byte *>(ring->sq_ring.get());
+            auto *cq = single_mmap ? sq : static_cast<std::byte *>(ring->cq_ring.get());
+
+            ring->sq_tail = reinterpret_cast<std::uint32_t *>(sq + params.sq_off.tail);
+            ring->sq_mask = *reinterpret_cast<std::uint32_t *>(sq + params.sq_off.ring_mask);
+            ring->sq_array = reinterpret_cast<std::uint32_t *>(sq + params.sq_off.array);
+            ring->sqes = static_cast<::io_uring_sqe *>(ring->sqes_map.get());
+
+            ring->cq_head = reinterpret_cast<std::uint32_t *>(cq + params.cq_off.head);
+            ring->cq_tail = reinterpret_cast<std::uint32_t *>(cq + params.cq_off.tail);
+            ring->cq_mask = *reinterpret_cast<std::uint32_t *>(cq + params.cq_off.ring_mask);
+            ring->cqes = reinterpret_cast<::io_uring_cqe *>(cq + params.cq_off.cqes);
+
+            ring->to_submit = 0u;
+
+            return ring;
+        }
+
+        // the caller keeps the number in flight within the queue depth, so there is always a free entry
+        // readv rather than read as IORING_OP_READ needs linux 5.6, vec is read by the kernel so must outlive the
+        // completion
+        auto queue_read(
+            int file,
+            ::iovec &vec,
+            std::span<std::byte> buffer,
+            std::uint64_t offset,
+            std::uint64_t user_data) -> void
+        {
+            const auto tail = *sq_tail;
+            const auto index = tail & sq_mask;
+
+            vec = {.iov_base = buffer.data(), .iov_len = buffer.size()};
+
+            auto &sqe = sqes[index];
+            sqe = {};
+            sqe.opcode = IORING_OP_READV;
+            sqe.fd = file;
+            sqe.addr = reinterpret_cast<std::uint64_t>(&vec);
+            sqe.len = 1u;
+            sqe.off = offset;
+            sqe.user_data = user_data;
+
+            sq_array[index] = index;
+            store_release(sq_tail, tail + 1u);
+            ++to_submit;
+        }
+
+        // submits everything queued and waits for at least one completion
+        auto submit_and_wait() -> void
+        {
+            for (;;)
+            {
+                const auto result = ::syscall(__NR_io_uring_enter, fd.get(), to_submit, 1u, IORING_ENTER_GETEVENTS, nullptr, 0zu);
+                if (result >= 0)
+                {
+                    to_submit -= static_cast<std::uint32_t>(result);
+                    return;
+                }
+
+                ensure(errno == EINTR || errno == EAGAIN, "io_uring_enter failed: {}", std::strerror(errno));
+            }
+        }
+
+        template <class F>
+        auto reap(F &&on_completion) -> void
+        {
+            auto head = *cq_head;
+            const auto tail = load_acquire(cq_tail);
+
+            for (; head != tail; ++head)
+            {
+                const auto &cqe = cqes[head & cq_mask];
+                on_completion(cqe.user_data, cqe.res);
+            }
+
+            store_release(cq_head, head);
+        }
+    };
+
+    BatchReader::BatchReader(std::uint32_t queue_depth, bool use_io_uring)
+        : _queue_depth{queue_depth},
+          _ring{use_io_uring ? Ring::create(queue_depth) : nullptr},
+          _ring_lock{}
+    {
+        ensure(queue_depth != 0u, "batch reader needs a queue depth of at least one");
+    }
+
+    BatchReader::~BatchReader() = default;
+
+    auto BatchReader::read(std::span<BatchRead> reads) -> void
+    {
+        if (_ring)
+        {
+            const auto lock = std::scoped_lock{_ring_lock};
+            read_io_uring(reads);
+        }
+        else
+        {
+            read_fallback(reads);
+        }
+    }
+
+    auto BatchReader::uses_io_uring() const -> bool
+    {
+        return _ring != nullptr;
+    }
+
+    auto BatchReader::read_io_uring(std::span<BatchRead> reads) -> void
+    {
+        // files are only opened once they have a slot in the ring, so a batch of thousands never holds thousands of
+        // descriptors
+        auto files = std::vector<AutoRelease<int, -1>>(reads.size());
+        auto vecs = std::vector<::iovec>(reads.size());
+        auto next = 0zu;
+        auto in_flight = 0u;
+        auto error = std::optional<std::string>{};
+
+        const auto finish = [&](std::size_t index)
+        {
+            files[index].reset(-1);
+            --in_flight;
+        };
+
+        while ((next < reads.size() && !error) || in_flight != 0u)
+        {
+            while (next < reads.size() && in_flight < _queue_depth && !error)
+            {
+                auto &read = reads[next];
+                read.bytes_read = 0zu;
+
+                files[next] = {open_file(read.path), ::close};
+                if (!files[next])
+                {
+                    error = std::format("failed to open {}: {}", read.path.string(), std::strerror(errno));
+                    break;
+                }
+
+                if (!read.buffer.empty())
+                {
+                    _ring->queue_read(files[next], vecs[next], read.buffer, 0u, next);
+                    ++in_flight;
+                }
+                else
+                {
+                    files[next].reset(-1);
+                }
+
+                ++next;
+            }
+
+            if (in_flight == 0u)
+            {
+                continue;
+            }
+
+            _ring->submit_and_wait();
+            _ring->reap(
+                [&](std::uint64_t user_data, std::int32_t result)
+                {
+                    const auto index = static_cast<std::size_t>(user_data);
+                    auto &read = reads[index];
+
+                    if (result == -EINTR || result == -EAGAIN)
+                    {
+                        _ring->queue_read(files[index], vecs[index], read.buffer.subspan(read.bytes_read), read.bytes_read, index);
+                    }
+                    else if (result < 0)
+                    {
+                        if (!error)
+                        {
+                            error = std::format("failed to read {}: {}", read.path.string(), std::strerror(-result));
+                        }
+                        finish(index);
+                    }
+                    else
+                    {
+                        read.bytes_read += static_cast<std::size_t>(result);
+
+                        // a short read that is not the end of the file, go again for the rest
+                        if (result != 0 && read.bytes_read < read.buffer.size())
+                        {
+                            _ring->queue_read(files[index], vecs[index], read.buffer.subspan(read.bytes_read), read.bytes_read, index);
+                        }
+                        else
+                        {
+                            finish(index);
+                        }
+                    }
+                });
+        }
+
+        if (error)
+        {
+            throw Exception("{}", *error);
+        }
+    }
+
+    auto BatchReader::read_fallback(std::span<BatchRead> reads) -> void
+    {
+        for (auto &read : reads)
+        {
+            auto file = AutoRelease<int, -1>{open_file(read.path), ::close};
+            ensure(file, "failed to open {}: {}", read.path.string(), std::strerror(errno));
+
+            read.bytes_read = 0zu;
+            while (read.bytes_read < read.buffer.size())
+            {
+                const auto remaining = read.buffer.subspan(read.bytes_read);
+                const auto result = ::pread(file, remaining.data(), remaining.size(), static_cast<::off_t>(read.bytes_read));
+                if (result == 0)
+                {
+                    break;
+                }
+
+                if (result < 0)
+                {
+                    ensure(errno == EINTR || errno == EAGAIN, "failed to read {}: {}", read.path.string(), std::strerror(errno));
+                    continue;
+                }
+
+                read.bytes_read += static_cast<std::size_t>(result);
+            }
+        }
+    }
+}
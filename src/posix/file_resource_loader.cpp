@@ -2,8 +2,15 @@
 
 #include <cstddef>
 #include <filesystem>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
 
+#include "log.h"
+#include "resources/batch_reader.h"
 #include "resources/file.h"
+#include "resources/pack.h"
 #include "utils/auto_release.h"
 #include "utils/data_buffer.h"
 #include "utils/ensure.h"
@@ -12,7 +19,9 @@ namespace ufps
 {
 
     FileResourceLoader::FileResourceLoader(const std::vector<std::filesystem::path> &roots)
-        : _roots{roots}
+        : _roots{roots},
+          _index{},
+          _reader{}
     {
         for (const auto &root : _roots)
         {
@@ -20,59 +29,69 @@ namespace ufps
             {
                 throw Exception("resource root does not exists: {}", root.string());
             }
+
+            for (const auto &entry : std::filesystem::recursive_directory_iterator{root})
+            {
+                if (entry.is_regular_file())
+                {
+                    _index.try_emplace(entry.path().lexically_relative(root).generic_string(), IndexEntry{.path = entry.path(), .size = entry.file_size()});
+                }
+            }
         }
+
+        log::info("indexed {} resources", _index.size());
     }
 
     auto FileResourceLoader::has_resource(std::string_view name) -> bool
     {
-        for (const auto &root : _roots)
-        {
-            auto path = root / name;
+        return _index.contains(name);
+    }
 
-            if (std::filesystem::exists(path))
-            {
-                return true;
-            }
-        }
+    auto FileResourceLoader::load_string(std::string_view name) -> std::string
+    {
+        const auto file = File{find(name).path};
+        auto str_view = file.as_string();
 
-        return false;
+        return {str_view.data(), str_view.length()};
     }
 
-    auto FileResourceLoader::load_string(std::string_view name) -> std::string
+    auto FileResourceLoader::load_data_buffer(std::string_view name) -> DataBuffer
     {
-        for (const auto &root : _roots)
-        {
-            auto path = root / name;
+        auto file = File{find(name).path};
 
-            if (std::filesystem::exists(path))
-            {
-                const auto file = File{path};
-                auto str_view = file.as_string();
+        auto span = file.as_bytes();
 
-                return {str_view.data(), str_view.length()};
-            }
-        }
+        return {span.data(), span.data() + span.size_bytes()};
+    }
 
-        throw Exception("cannot find {}", name);
+    auto FileResourceLoader::load_pack(std::string_view name) -> Pack
+    {
+        return Pack{std::make_unique<File>(find(name).path)};
     }
 
-    auto FileResourceLoader::load_data_buffer(std::string_view name) -> DataBuffer
+    auto FileResourceLoader::load_data_buffers(std::span<const std::string_view> names) -> std::vector<DataBuffer>
     {
-        for (const auto &root : _roots)
-        {
-            auto path = root / name;
+        // sized from the index rather than a stat per file, a file that has grown since is read up to its indexed size
+        auto buffers = std::vector<DataBuffer>{};
+        auto reads = std::vector<BatchRead>{};
+        buffers.reserve(names.size());
+        reads.reserve(names.size());
 
-            if (std::filesystem::exists(path))
-            {
-                auto file = File{path};
+        for (const auto name : names)
+        {
+            const auto &entry = find(name);
+            auto &buffer = buffers.emplace_back(entry.size);
+            reads.push_back({.path = entry.path, .buffer = buffer, .bytes_read = 0zu});
+        }
 
-                auto span = file.as_bytes();
+        _reader.read(reads);
 
-                return {span.data(), span.data() + span.size_bytes()};
-            }
+        for (auto i = 0zu; i < reads.size(); ++i)
+        {
+            buffers[i].resize(reads[i].bytes_read);
         }
 
-        throw Exception("cannot find {}", name);
+        return buffers;
     }
 
     auto FileResourceLoader::resources(std::string_view type) -> std::vector<std::string>
@@ -91,4 +110,15 @@ namespace ufps
                    }) |
                std::views::join | std::ranges::to<std::vector>();
     }
+
+    auto FileResourceLoader::find(std::string_view name) const -> const IndexEntry &
+    {
+        const auto entry = _index.find(name);
+        if (entry == _index.end())
+        {
+            throw Exception("cannot find {}", name);
+        }
+
+        return entry->second;
+    }
 }
\ No newline at end of file
@@ -0,0 +1,178 @@
+#include "resources/async_resource_loader.h"
+
+#include <cstdint>
+#include <exception>
+#include <format>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stop_token>
+#include <string_view>
+#include <vector>
+
+#include "concurrency/awaitable_manager.h"
+#include "concurrency/thread.h"
+#include "log.h"
+#include "resources/resource_loader.h"
+#include "utils/ensure.h"
+
+namespace ufps
+{
+    AsyncResourceLoader::AsyncResourceLoader(ResourceLoader &loader, AwaitableManager &awaitable_manager, std::uint32_t worker_count)
+        : _loader{loader},
+          _awaitable_manager{awaitable_manager},
+          _requests{},
+          _next_sequence{},
+          _lock{},
+          _cv{},
+          _workers{}
+    {
+        ensure(worker_count != 0u, "async resource loader needs at least one worker");
+
+        log::info("starting async resource loader with {} workers", worker_count);
+
+        for (auto i = 0u; i < worker_count; ++i)
+        {
+            _workers.push_back({std::format("io_worker_{}", i), [this](std::stop_token stop_token) { worker(std::move(stop_token)); }});
+        }
+    }
+
+    AsyncResourceLoader::~AsyncResourceLoader()
+    {
+        for (auto &thread : _workers)
+        {
+            thread.request_stop();
+        }
+
+        // joins, so nothing is reading any more
+        _workers.clear();
+
+        auto requests = std::map<RequestKey, Request>{};
+        {
+            const auto lock = std::scoped_lock{_lock};
+            requests.swap(_requests);
+        }
+
+        // anything never read is resumed as cancelled rather than left suspended forever, its stop callback goes first
+        // as it would otherwise outlive the loader it cancels through
+        for (auto &[key, request] : requests)
+        {
+            request.on_stop->reset();
+            *request.result = std::nullopt;
+            _awaitable_manager.resume_next_tick(request.handle);
+        }
+    }
+
+    auto AsyncResourceLoader::queued_count() const -> std::uint32_t
+    {
+        const auto lock = std::scoped_lock{_lock};
+        return static_cast<std::uint32_t>(_requests.size());
+    }
+
+    auto AsyncResourceLoader::submit(Request request, LoadPriority priority, const std::stop_token &stop_token) -> bool
+    {
+        {
+            const auto lock = std::scoped_lock{_lock};
+
+            // checked under the lock the stop callback takes, so a stop either lands before the request is queued or
+            // finds it in the queue
+            if (stop_token.stop_requested())
+            {
+                return false;
+            }
+
+            const auto key = RequestKey{.priority = priority, .sequence = _next_sequence++};
+            *request.key = key;
+            _requests.emplace(key, std::move(request));
+        }
+
+        _cv.notify_one();
+
+        return true;
+    }
+
+    auto AsyncResourceLoader::cancel(const std::optional<RequestKey> &key) -> void
+    {
+        auto lock = std::unique_lock{_lock};
+
+        // not queued yet, in which case submit() sees the stop, or already taken by a worker
+        if (!key)
+        {
+            return;
+        }
+
+        auto node = _requests.extract(*key);
+        lock.unlock();
+
+        if (node.empty())
+        {
+            return;
+        }
+
+        *node.mapped().result = std::nullopt;
+        _awaitable_manager.resume_next_tick(node.mapped().handle);
+    }
+
+    auto AsyncResourceLoader::worker(std::stop_token stop_token) -> void
+    {
+        for (;;)
+        {
+            auto lock = std::unique_lock{_lock};
+            _cv.wait(lock, stop_token, [this] { return !_requests.empty(); });
+
+            if (stop_token.stop_requested())
+            {
+                return;
+            }
+
+            auto batch = std::vector<Request>{};
+            while (!_requests.empty() && batch.size() < async_resource_loader_batch_size)
+            {
+                batch.push_back(std::move(_requests.begin()->second));
+                _requests.erase(_requests.begin());
+            }
+            lock.unlock();
+
+            load(batch);
+
+            for (const auto &request : batch)
+            {
+                _awaitable_manager.resume_next_tick(request.handle);
+            }
+        }
+    }
+
+    auto AsyncResourceLoader::load(std::span<Request> batch) -> void
+    {
+        const auto names = batch |
+                           std::views::transform([](const auto &request) -> std::string_view { return request.name; }) |
+                           std::ranges::to<std::vector>();
+
+        try
+        {
+            auto buffers = _loader.load_data_buffers(names);
+            for (auto i = 0zu; i < batch.size(); ++i)
+            {
+                *batch[i].result = std::move(buffers[i]);
+            }
+        }
+        catch (...)
+        {
+            // which resource failed is unknown, so go one at a time to give each its own result or exception
+            for (auto &request : batch)
+            {
+                try
+                {
+                    *request.result = _loader.load_data_buffer(request.name);
+                }
+                catch (...)
+                {
+                    log::error("failed to load {}", request.name);
+                    *request.exception = std::current_exception();
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,280 @@
+#include "resources/build_cache.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "graphics/meshlet.h"
+#include "graphics/model_data.h"
+#include "graphics/vertex_data.h"
+#include "resources/file.h"
+#include "utils/data_buffer.h"
+#include "utils/ensure.h"
+
+namespace
+{
+    constexpr auto imported_model_magic = std::array<char, 4zu>{'U', 'F', 'I', 'M'};
+    constexpr auto imported_model_version = 2u;
+
+    // marks a texture slot the model does not use, as opposed to an empty name
+    constexpr auto no_texture = 0xffffffffu;
+
+    class Writer
+    {
+    public:
+        template <class T>
+            requires std::is_trivially_copyable_v<T>
+        auto write(std::span<const T> values) -> void
+        {
+            const auto bytes = std::as_bytes(values);
+            _data.insert(_data.end(), bytes.begin(), bytes.end());
+        }
+
+        template <class T>
+            requires std::is_trivially_copyable_v<T>
+        auto write(const T &value) -> void
+        {
+            write(std::span{&value, 1zu});
+        }
+
+        auto write(std::string_view str) -> void
+        {
+            write(static_cast<std::uint32_t>(str.size()));
+            write(std::span{str});
+        }
+
+        auto write(const std::optional<std::string> &str) -> void
+        {
+            if (!str)
+            {
+                write(no_texture);
+                return;
+            }
+
+            write(std::string_view{*str});
+        }
+
+        auto data() && -> ufps::DataBuffer
+        {
+            return std::move(_data);
+        }
+
+    private:
+        ufps::DataBuffer _data;
+    };
+
+    class Reader
+    {
+    public:
+        explicit Reader(ufps::DataBufferView data)
+            : _data{data}
+        {
+        }
+
+        template <class T>
+            requires std::is_trivially_copyable_v<T>
+        auto read(std::span<T> values) -> void
+        {
+            const auto size = values.size_bytes();
+            ufps::ensure(size <= _data.size(), "imported model truncated, {} bytes wanted with {} left", size, _data.size());
+
+            std::memcpy(values.data(), _data.data(), size);
+            _data = _data.subspan(size);
+        }
+
+        template <class T>
+            requires std::is_trivially_copyable_v<T>
+        auto read() -> T
+        {
+            auto value = T{};
+            read(std::span{&value, 1zu});
+
+            return value;
+        }
+
+        template <class T>
+            requires std::is_trivially_copyable_v<T>
+        auto read_vector(std::size_t count) -> std::vector<T>
+        {
+            // checked before allocating so a corrupt count fails cleanly
+            ufps::ensure(count <= _data.size() / sizeof(T), "imported model truncated, {} elements wanted with {} bytes left", count, _data.size());
+
+            auto values = std::vector<T>(count);
+            read(std::span{values});
+
+            return values;
+        }
+
+        auto read_string() -> std::string
+        {
+            return read_chars(read<std::uint32_t>());
+        }
+
+        auto read_texture() -> std::optional<std::string>
+        {
+            const auto size = read<std::uint32_t>();
+            if (size == no_texture)
+            {
+                return std::nullopt;
+            }
+
+            return read_chars(size);
+        }
+
+        auto empty() const -> bool
+        {
+            return _data.empty();
+        }
+
+    private:
+        auto read_chars(std::uint32_t size) -> std::string
+        {
+            const auto chars = read_vector<char>(size);
+            return {chars.begin(), chars.end()};
+        }
+
+        ufps::DataBufferView _data;
+    };
+}
+
+namespace ufps
+{
+    BuildCache::BuildCache(std::filesystem::path directory)
+        : _directory{std::move(directory)},
+          _hits{},
+          _misses{},
+          _next_temp{}
+    {
+        std::filesystem::create_directories(_directory);
+    }
+
+    auto BuildCache::find(std::uint64_t key) -> std::optional<DataBuffer>
+    {
+        const auto entry = path(key);
+        if (!std::filesystem::exists(entry))
+        {
+            ++_misses;
+            return std::nullopt;
+        }
+
+        ++_hits;
+
+        const auto file = File{entry};
+        const auto bytes = file.as_bytes();
+
+        return DataBuffer{bytes.data(), bytes.data() + bytes.size_bytes()};
+    }
+
+    auto BuildCache::store(std::uint64_t key, DataBufferView data) -> void
+    {
+        // two identical inputs may be built at the same time so every write gets its own temporary
+        const auto final_path = path(key);
+        const auto temp_path = _directory / std::format("{:016x}.{}.tmp", key, _next_temp++);
+
+        {
+            auto file = std::ofstream{temp_path, std::ios::binary};
+            file.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+            ensure(!!file, "failed to write build cache entry {}", temp_path.string());
+        }
+
+        std::filesystem::rename(temp_path, final_path);
+    }
+
+    auto BuildCache::hits() const -> std::size_t
+    {
+        return _hits;
+    }
+
+    auto BuildCache::misses() const -> std::size_t
+    {
+        return _misses;
+    }
+
+    auto BuildCache::path(std::uint64_t key) const -> std::filesystem::path
+    {
+        return _directory / std::format("{:016x}", key);
+    }
+
+    auto encode_imported_model(const ImportedModel &model) -> DataBuffer
+    {
+        auto writer = Writer{};
+
+        writer.write(imported_model_magic);
+        writer.write(imported_model_version);
+        writer.write(std::string_view{model.name});
+        writer.write(static_cast<std::uint32_t>(model.sub_models.size()));
+
+        for (const auto &sub_model : model.sub_models)
+        {
+            const auto &[vertices, indices] = sub_model.mesh_data;
+
+            writer.write(static_cast<std::uint32_t>(vertices.size()));
+            writer.write(static_cast<std::uint32_t>(indices.size()));
+            writer.write(std::span{vertices});
+            writer.write(std::span{indices});
+            writer.write(static_cast<std::uint32_t>(sub_model.meshlets.size()));
+            writer.write(std::span{sub_model.meshlets});
+
+            writer.write(sub_model.albedo);
+            writer.write(sub_model.normal);
+            writer.write(sub_model.specular);
+            writer.write(sub_model.roughness);
+            writer.write(sub_model.ambient_occlusion);
+            writer.write(sub_model.emissive_color);
+            writer.write(sub_model.opacity);
+            writer.write(sub_model.emissive_intensity);
+        }
+
+        return std::move(writer).data();
+    }
+
+    auto decode_imported_model(DataBufferView data) -> ImportedModel
+    {
+        auto reader = Reader{data};
+
+        ensure(reader.read<std::array<char, 4zu>>() == imported_model_magic, "not an imported model");
+        const auto version = reader.read<std::uint32_t>();
+        ensure(version == imported_model_version, "unsupported imported model version: {}", version);
+
+        auto model = ImportedModel{.name = reader.read_string(), .sub_models = {}};
+
+        // every sub model takes more than a byte, so this bounds the count before allocating
+        const auto sub_model_count = reader.read<std::uint32_t>();
+        ensure(sub_model_count <= data.size(), "imported model has an invalid sub model count: {}", sub_model_count);
+        model.sub_models.resize(sub_model_count);
+
+        for (auto &sub_model : model.sub_models)
+        {
+            auto &[vertices, indices] = sub_model.mesh_data;
+
+            const auto vertex_count = reader.read<std::uint32_t>();
+            const auto index_count = reader.read<std::uint32_t>();
+            vertices = reader.read_vector<VertexData>(vertex_count);
+            indices = reader.read_vector<std::uint32_t>(index_count);
+            sub_model.meshlets = reader.read_vector<Meshlet>(reader.read<std::uint32_t>());
+
+            sub_model.albedo = reader.read_texture();
+            sub_model.normal = reader.read_texture();
+            sub_model.specular = reader.read_texture();
+            sub_model.roughness = reader.read_texture();
+            sub_model.ambient_occlusion = reader.read_texture();
+            sub_model.emissive_color = reader.read_texture();
+            sub_model.opacity = reader.read<float>();
+            sub_model.emissive_intensity = reader.read<float>();
+        }
+
+        ensure(reader.empty(), "imported model has trailing data");
+
+        return model;
+    }
+}
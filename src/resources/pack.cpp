@@ -0,0 +1,372 @@
+#include "resources/pack.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "resources/file.h"
+#include "utils/compress.h"
+#include "utils/data_buffer.h"
+#include "utils/decompress.h"
+#include "utils/ensure.h"
+
+static_assert(std::endian::native == std::endian::little, "packs are read in place and so only support little endian");
+
+namespace
+{
+    auto align_up(std::uint64_t value, std::uint64_t alignment) -> std::uint64_t
+    {
+        return (value + alignment - 1u) & ~(alignment - 1u);
+    }
+
+    template <class T>
+    auto write_bytes(std::ostream &out, std::span<const T> data) -> void
+    {
+        const auto bytes = std::as_bytes(data);
+        out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    auto write_padding(std::ostream &out, std::uint64_t position, std::uint64_t alignment) -> std::uint64_t
+    {
+        static constexpr auto zeros = std::array<char, ufps::pack_default_alignment>{};
+
+        auto padding = align_up(position, alignment) - position;
+        while (padding != 0u)
+        {
+            const auto count = std::min<std::uint64_t>(padding, zeros.size());
+            out.write(zeros.data(), static_cast<std::streamsize>(count));
+            padding -= count;
+        }
+
+        return align_up(position, alignment);
+    }
+}
+
+namespace ufps
+{
+    PackWriter::PackWriter(std::uint32_t alignment, const CompressOptions &options, const Pack *previous)
+        : _alignment{alignment},
+          _options{options},
+          _previous{previous},
+          _reused_count{},
+          _entries{},
+          _lookup{}
+    {
+        ensure(std::has_single_bit(alignment), "pack alignment must be a power of two: {}", alignment);
+    }
+
+    auto PackWriter::add(std::string_view name, DataBufferView data, PackCompression compression) -> void
+    {
+        ensure(!_lookup.contains(name), "duplicate pack chunk: {}", name);
+
+        auto entry = Entry{.name = std::string{name}, .data = {}, .size = data.size(), .compression = PackCompression::NONE};
+
+        if (reuse(name, data, compression, entry))
+        {
+            ++_reused_count;
+        }
+        else
+        {
+            if (compression == PackCompression::ZSTD)
+            {
+                auto compressed = compress(data, _options);
+                if (compressed.size() < data.size())
+                {
+                    entry.data = std::move(compressed);
+                    entry.compression = PackCompression::ZSTD;
+                }
+            }
+
+            if (entry.compression == PackCompression::NONE)
+            {
+                entry.data = {data.begin(), data.end()};
+            }
+        }
+
+        _lookup.emplace(entry.name, _entries.size());
+        _entries.push_back(std::move(entry));
+    }
+
+    auto PackWriter::write(std::ostream &out) const -> void
+    {
+        auto names = std::string{};
+        auto chunks = std::vector<PackChunk>{};
+
+        for (const auto &entry : _entries)
+        {
+            chunks.push_back({
+                .offset = 0u,
+                .stored_size = entry.data.size(),
+                .size = entry.size,
+                .name_offset = static_cast<std::uint32_t>(names.size()),
+                .name_size = static_cast<std::uint32_t>(entry.name.size()),
+                .compression = entry.compression,
+                .pad = 0u,
+            });
+
+            names += entry.name;
+        }
+
+        const auto names_offset = sizeof(PackHeader) + chunks.size() * sizeof(PackChunk);
+
+        auto offset = align_up(names_offset + names.size(), _alignment);
+        for (auto &chunk : chunks)
+        {
+            chunk.offset = offset;
+            offset = align_up(offset + chunk.stored_size, _alignment);
+        }
+
+        const auto header = PackHeader{
+            .magic = pack_magic,
+            .version = pack_version,
+            .chunk_count = static_cast<std::uint32_t>(chunks.size()),
+            .alignment = _alignment,
+            .names_offset = names_offset,
+            .names_size = names.size(),
+        };
+
+        write_bytes(out, std::span{&header, 1zu});
+        write_bytes(out, std::span<const PackChunk>{chunks});
+        write_bytes(out, std::span<const char>{names});
+
+        auto position = static_cast<std::uint64_t>(names_offset + names.size());
+
+        for (const auto &[chunk, entry] : std::views::zip(chunks, _entries))
+        {
+            position = write_padding(out, position, _alignment);
+            write_bytes(out, std::span<const std::byte>{entry.data});
+            position += chunk.stored_size;
+        }
+
+        ensure(out.good(), "failed to write pack");
+    }
+
+    auto PackWriter::stored_size() const -> std::size_t
+    {
+        auto size = 0zu;
+        for (const auto &entry : _entries)
+        {
+            size += entry.data.size();
+        }
+
+        return size;
+    }
+
+    auto PackWriter::reused_count() const -> std::size_t
+    {
+        return _reused_count;
+    }
+
+    auto PackWriter::reuse(std::string_view name, DataBufferView data, PackCompression compression, Entry &entry) const -> bool
+    {
+        if (_previous == nullptr || !_previous->has(name))
+        {
+            return false;
+        }
+
+        // a chunk asked to be compressed may have been stored as is because compression did not help, but a chunk that
+        // was compressed cannot be reused where uncompressed storage is required
+        const auto &chunk = _previous->chunk(name);
+        if (chunk.size != data.size() || (compression == PackCompression::NONE && chunk.compression != PackCompression::NONE))
+        {
+            return false;
+        }
+
+        const auto stored = _previous->stored(name);
+
+        switch (chunk.compression)
+        {
+            using enum PackCompression;
+        case NONE:
+            if (!std::ranges::equal(stored, data))
+            {
+                return false;
+            }
+            break;
+        case ZSTD:
+            // decompressing to compare is far cheaper than compressing again at a high level
+            if (!std::ranges::equal(_previous->load(name), data))
+            {
+                return false;
+            }
+            break;
+        }
+
+        entry.data = {stored.begin(), stored.end()};
+        entry.compression = chunk.compression;
+
+        return true;
+    }
+
+    Pack::Pack(DataBufferView data)
+        : _file{},
+          _owned{},
+          _data{data},
+          _chunks{},
+          _names{},
+          _lookup{}
+    {
+        open();
+    }
+
+    Pack::Pack(DataBuffer data)
+        : _file{},
+          _owned{std::move(data)},
+          _data{_owned},
+          _chunks{},
+          _names{},
+          _lookup{}
+    {
+        open();
+    }
+
+    Pack::Pack(std::unique_ptr<File> file)
+        : _file{std::move(file)},
+          _owned{},
+          _data{_file->as_bytes()},
+          _chunks{},
+          _names{},
+          _lookup{}
+    {
+        open();
+    }
+
+    auto Pack::has(std::string_view name) const -> bool
+    {
+        return _lookup.contains(name);
+    }
+
+    auto Pack::chunk(std::string_view name) const -> const PackChunk &
+    {
+        const auto chunk = _lookup.find(name);
+        ensure(chunk != std::ranges::cend(_lookup), "pack has no chunk: {}", name);
+
+        return _chunks[chunk->second];
+    }
+
+    auto Pack::chunks() const -> std::span<const PackChunk>
+    {
+        return _chunks;
+    }
+
+    auto Pack::name(const PackChunk &chunk) const -> std::string_view
+    {
+        return _names.substr(chunk.name_offset, chunk.name_size);
+    }
+
+    auto Pack::view(std::string_view name) const -> DataBufferView
+    {
+        const auto &chunk = this->chunk(name);
+        ensure(chunk.compression == PackCompression::NONE, "pack chunk {} is compressed and cannot be viewed in place", name);
+
+        return stored(chunk);
+    }
+
+    auto Pack::stored(std::string_view name) const -> DataBufferView
+    {
+        return stored(chunk(name));
+    }
+
+    auto Pack::load(std::string_view name) const -> DataBuffer
+    {
+        const auto &chunk = this->chunk(name);
+
+        auto data = DataBuffer(chunk.size);
+        load(name, data);
+
+        return data;
+    }
+
+    auto Pack::load(std::string_view name, std::span<std::byte> destination) const -> void
+    {
+        const auto &chunk = this->chunk(name);
+        ensure(destination.size() == chunk.size, "pack chunk {} is {} bytes, destination is {}", name, chunk.size, destination.size());
+
+        const auto data = stored(chunk);
+
+        switch (chunk.compression)
+        {
+            using enum PackCompression;
+        case NONE:
+            std::ranges::copy(data, destination.begin());
+            break;
+        case ZSTD:
+            decompress(data, destination);
+            break;
+        }
+    }
+
+    auto Pack::load_string(std::string_view name) const -> std::string
+    {
+        const auto data = load(name);
+        return {reinterpret_cast<const char *>(data.data()), data.size()};
+    }
+
+    auto Pack::stream(std::string_view name, const DataConsumer &consumer, std::size_t chunk_size) const -> void
+    {
+        ensure(chunk_size != 0zu, "pack chunk {} streamed with a chunk size of zero", name);
+
+        const auto &chunk = this->chunk(name);
+        const auto data = stored(chunk);
+
+        switch (chunk.compression)
+        {
+            using enum PackCompression;
+        case NONE:
+            for (auto offset = 0zu; offset < data.size(); offset += chunk_size)
+            {
+                consumer(data.subspan(offset, std::min(chunk_size, data.size() - offset)));
+            }
+            break;
+        case ZSTD:
+            decompress(data, chunk_size, consumer);
+            break;
+        }
+    }
+
+    auto Pack::open() -> void
+    {
+        ensure(_data.size() >= sizeof(PackHeader), "pack too small for its header: {}", _data.size());
+
+        const auto *header = reinterpret_cast<const PackHeader *>(_data.data());
+        ensure(header->magic == pack_magic, "not a pack");
+        ensure(header->version == pack_version, "unsupported pack version: {}", header->version);
+        ensure(std::has_single_bit(header->alignment), "invalid pack alignment: {}", header->alignment);
+
+        const auto chunks_size = static_cast<std::uint64_t>(header->chunk_count) * sizeof(PackChunk);
+        ensure(sizeof(PackHeader) + chunks_size <= _data.size(), "pack table of contents out of bounds");
+        ensure(header->names_offset >= sizeof(PackHeader) + chunks_size, "pack names overlap table of contents");
+        ensure(header->names_size <= _data.size() - std::min<std::uint64_t>(header->names_offset, _data.size()), "pack names out of bounds");
+
+        _chunks = {reinterpret_cast<const PackChunk *>(_data.data() + sizeof(PackHeader)), header->chunk_count};
+        _names = {reinterpret_cast<const char *>(_data.data() + header->names_offset), header->names_size};
+
+        for (const auto &[index, chunk] : std::views::enumerate(_chunks))
+        {
+            ensure(static_cast<std::uint64_t>(chunk.name_offset) + chunk.name_size <= _names.size(), "pack chunk {} name out of bounds", index);
+            ensure(chunk.offset % header->alignment == 0u, "pack chunk {} is not aligned", name(chunk));
+            ensure(chunk.offset <= _data.size() && chunk.stored_size <= _data.size() - chunk.offset, "pack chunk {} out of bounds", name(chunk));
+            ensure(
+                chunk.compression == PackCompression::ZSTD || (chunk.compression == PackCompression::NONE && chunk.size == chunk.stored_size),
+                "pack chunk {} has invalid compression",
+                name(chunk));
+
+            const auto [_, inserted] = _lookup.emplace(name(chunk), static_cast<std::uint32_t>(index));
+            ensure(inserted, "duplicate pack chunk: {}", name(chunk));
+        }
+    }
+
+    auto Pack::stored(const PackChunk &chunk) const -> DataBufferView
+    {
+        return _data.subspan(chunk.offset, chunk.stored_size);
+    }
+}
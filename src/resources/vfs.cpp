@@ -0,0 +1,365 @@
+#include "resources/vfs.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "log.h"
+#include "resources/batch_reader.h"
+#include "resources/file.h"
+#include "resources/pack.h"
+#include "utils/data_buffer.h"
+#include "utils/ensure.h"
+#include "utils/exception.h"
+
+namespace
+{
+    constexpr auto empty_slot = std::numeric_limits<std::uint32_t>::max();
+
+    // only has to be consistent within a run, std::hash is much quicker than FNV on long paths
+    auto hash_name(std::string_view name) -> std::uint64_t
+    {
+        return std::hash<std::string_view>{}(name);
+    }
+
+    // the top half of the hash, the bottom half already picked the slot
+    auto tag(std::uint64_t hash) -> std::uint32_t
+    {
+        return static_cast<std::uint32_t>(hash >> 32u);
+    }
+
+    // keeps the table at most half full so probes stay short, and never tiny
+    constexpr auto min_table_size = 16zu;
+}
+
+namespace ufps
+{
+    Vfs::Vfs()
+        : _candidates{},
+          _mount_count{},
+          _packs{},
+          _entries{},
+          _table{},
+          _mapped_lock{},
+          _mapped{},
+          _reader{}
+    {
+    }
+
+    auto Vfs::mount_directory(const std::filesystem::path &root, std::int32_t priority) -> void
+    {
+        if (!std::filesystem::exists(root))
+        {
+            throw Exception("resource root does not exists: {}", root.string());
+        }
+
+        for (const auto &dir_entry : std::filesystem::recursive_directory_iterator{root})
+        {
+            if (dir_entry.is_regular_file())
+            {
+                add({.name = dir_entry.path().lexically_relative(root).generic_string(),
+                     .hash = 0u,
+                     .size = dir_entry.file_size(),
+                     .backing = VfsBacking::FILE,
+                     .path = dir_entry.path(),
+                     .pack = nullptr,
+                     .data = {}},
+                    priority);
+            }
+        }
+
+        rebuild();
+    }
+
+    auto Vfs::mount_pack(Pack pack, std::int32_t priority) -> void
+    {
+        const auto &owned = *_packs.emplace_back(std::make_unique<Pack>(std::move(pack)));
+
+        for (const auto &chunk : owned.chunks())
+        {
+            const auto name = owned.name(chunk);
+            add({.name = std::string{name},
+                 .hash = 0u,
+                 .size = chunk.size,
+                 .backing = VfsBacking::PACK,
+                 .path = {},
+                 .pack = &owned,
+                 .data = chunk.compression == PackCompression::NONE ? owned.view(name) : DataBufferView{}},
+                priority);
+        }
+
+        rebuild();
+    }
+
+    auto Vfs::mount_memory(std::string_view name, DataBufferView data, std::int32_t priority) -> void
+    {
+        const auto resource = VfsMemory{.name = name, .data = data};
+        mount_memory(std::span{&resource, 1zu}, priority);
+    }
+
+    auto Vfs::mount_memory(std::span<const VfsMemory> resources, std::int32_t priority) -> void
+    {
+        for (const auto &[name, data] : resources)
+        {
+            add({.name = std::string{name},
+                 .hash = 0u,
+                 .size = data.size(),
+                 .backing = VfsBacking::MEMORY,
+                 .path = {},
+                 .pack = nullptr,
+                 .data = data},
+                priority);
+        }
+
+        rebuild();
+    }
+
+    auto Vfs::find(std::string_view name) const -> const VfsEntry *
+    {
+        if (_table.empty())
+        {
+            return nullptr;
+        }
+
+        const auto hash = hash_name(name);
+        const auto mask = _table.size() - 1zu;
+
+        for (auto slot = hash & mask;; slot = (slot + 1zu) & mask)
+        {
+            const auto [slot_tag, index] = _table[slot];
+            if (index == empty_slot)
+            {
+                return nullptr;
+            }
+
+            // the tag rules out almost every other name without touching its entry
+            if (slot_tag == tag(hash) && _entries[index].name == name)
+            {
+                return &_entries[index];
+            }
+        }
+    }
+
+    auto Vfs::view(std::string_view name) const -> DataBufferView
+    {
+        const auto &entry = this->entry(name);
+
+        if (entry.backing != VfsBacking::FILE)
+        {
+            ensure(entry.size == 0u || !entry.data.empty(), "{} is compressed in its pack and cannot be viewed in place", name);
+            return entry.data;
+        }
+
+        // File cannot map an empty file
+        if (entry.size == 0u)
+        {
+            return {};
+        }
+
+        const auto lock = std::scoped_lock{_mapped_lock};
+
+        auto [mapped, inserted] = _mapped.try_emplace(entry.path.string());
+        if (inserted)
+        {
+            mapped->second = std::make_unique<File>(entry.path);
+        }
+
+        return mapped->second->as_bytes();
+    }
+
+    auto Vfs::has_resource(std::string_view name) -> bool
+    {
+        return find(name) != nullptr;
+    }
+
+    auto Vfs::load_string(std::string_view name) -> std::string
+    {
+        const auto buffer = load_data_buffer(name);
+        return {reinterpret_cast<const char *>(buffer.data()), buffer.size()};
+    }
+
+    auto Vfs::load_data_buffer(std::string_view name) -> DataBuffer
+    {
+        const auto &entry = this->entry(name);
+
+        switch (entry.backing)
+        {
+            using enum VfsBacking;
+        case FILE:
+        {
+            if (entry.size == 0u)
+            {
+                return {};
+            }
+
+            // a one off read, so not kept mapped like a view
+            const auto file = File{entry.path};
+            const auto bytes = file.as_bytes();
+            return {bytes.begin(), bytes.end()};
+        }
+        case PACK:
+            return entry.pack->load(entry.name);
+        case MEMORY:
+            return {entry.data.begin(), entry.data.end()};
+        }
+
+        throw Exception("unknown vfs backing for {}", name);
+    }
+
+    auto Vfs::load_data_buffers(std::span<const std::string_view> names) -> std::vector<DataBuffer>
+    {
+        auto buffers = std::vector<DataBuffer>(names.size());
+        auto reads = std::vector<BatchRead>{};
+        auto read_indices = std::vector<std::size_t>{};
+
+        for (auto i = 0zu; i < names.size(); ++i)
+        {
+            const auto &entry = this->entry(names[i]);
+
+            if (entry.backing != VfsBacking::FILE)
+            {
+                buffers[i] = load_data_buffer(names[i]);
+            }
+            else if (entry.size != 0u)
+            {
+                // a file that has grown since it was mounted is read up to its indexed size
+                buffers[i].resize(entry.size);
+                reads.push_back({.path = entry.path, .buffer = buffers[i], .bytes_read = 0zu});
+                read_indices.push_back(i);
+            }
+        }
+
+        if (reads.empty())
+        {
+            return buffers;
+        }
+
+        _reader.read(reads);
+
+        for (auto i = 0zu; i < reads.size(); ++i)
+        {
+            buffers[read_indices[i]].resize(reads[i].bytes_read);
+        }
+
+        return buffers;
+    }
+
+    auto Vfs::resources(std::string_view type) -> std::vector<std::string>
+    {
+        const auto prefix = std::string{type} + "/";
+
+        auto first = std::ranges::lower_bound(_entries, prefix, {}, &VfsEntry::name);
+
+        auto result = std::vector<std::string>{};
+        for (; first != _entries.end() && first->name.starts_with(prefix); ++first)
+        {
+            // only what is directly in the directory, like a directory listing
+            if (first->name.find('/', prefix.size()) == std::string::npos)
+            {
+                result.push_back(first->name);
+            }
+        }
+
+        return result;
+    }
+
+    auto Vfs::load_pack(std::string_view name) -> Pack
+    {
+        const auto &entry = this->entry(name);
+
+        switch (entry.backing)
+        {
+            using enum VfsBacking;
+        case FILE:
+            return Pack{std::make_unique<File>(entry.path)};
+        case PACK:
+            return entry.data.empty() ? Pack{entry.pack->load(entry.name)} : Pack{entry.data};
+        case MEMORY:
+            return Pack{entry.data};
+        }
+
+        throw Exception("unknown vfs backing for {}", name);
+    }
+
+    auto Vfs::entries() const -> std::span<const VfsEntry>
+    {
+        return _entries;
+    }
+
+    auto Vfs::add(VfsEntry entry, std::int32_t priority) -> void
+    {
+        entry.hash = hash_name(entry.name);
+        _candidates.push_back({.entry = std::move(entry), .priority = priority, .mount = _mount_count});
+    }
+
+    auto Vfs::rebuild() -> void
+    {
+        ++_mount_count;
+
+        // by name, then the winner first: highest priority, then most recently mounted
+        auto order = std::vector<std::size_t>(_candidates.size());
+        std::iota(order.begin(), order.end(), 0zu);
+        std::ranges::sort(
+            order,
+            [this](const auto a, const auto b)
+            {
+                const auto &ca = _candidates[a];
+                const auto &cb = _candidates[b];
+
+                if (ca.entry.name != cb.entry.name)
+                {
+                    return ca.entry.name < cb.entry.name;
+                }
+
+                return ca.priority != cb.priority ? ca.priority > cb.priority : ca.mount > cb.mount;
+            });
+
+        _entries.clear();
+        for (const auto index : order)
+        {
+            const auto &candidate = _candidates[index];
+            if (_entries.empty() || _entries.back().name != candidate.entry.name)
+            {
+                _entries.push_back(candidate.entry);
+            }
+        }
+
+        _table.assign(std::bit_ceil(std::max(_entries.size() * 2zu, min_table_size)), {.tag = 0u, .index = empty_slot});
+        const auto mask = _table.size() - 1zu;
+
+        for (auto i = 0u; i < _entries.size(); ++i)
+        {
+            auto slot = _entries[i].hash & mask;
+            while (_table[slot].index != empty_slot)
+            {
+                slot = (slot + 1zu) & mask;
+            }
+
+            _table[slot] = {.tag = tag(_entries[i].hash), .index = i};
+        }
+
+        log::debug("vfs indexed {} resources from {} mounts", _entries.size(), _mount_count);
+    }
+
+    auto Vfs::entry(std::string_view name) const -> const VfsEntry &
+    {
+        const auto *entry = find(name);
+        if (entry == nullptr)
+        {
+            throw Exception("cannot find {}", name);
+        }
+
+        return *entry;
+    }
+}
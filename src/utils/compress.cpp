@@ -1,10 +1,41 @@
 #include "utils/compress.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
 #include <zstd.h>
 
 #include "utils/data_buffer.h"
+#include "utils/ensure.h"
 #include "utils/exception.h"
 
+namespace
+{
+    auto check(std::size_t result) -> std::size_t
+    {
+        if (::ZSTD_isError(result) == 1)
+        {
+            throw ufps::Exception("failed to compress data: {}", ::ZSTD_getErrorName(result));
+        }
+
+        return result;
+    }
+
+    auto create_context(const ufps::CompressOptions &options) -> ::ZSTD_CCtx *
+    {
+        auto *context = ::ZSTD_createCCtx();
+        ufps::ensure(context != nullptr, "failed to create compression context");
+
+        check(::ZSTD_CCtx_setParameter(context, ZSTD_c_compressionLevel, options.level));
+        check(::ZSTD_CCtx_setParameter(context, ZSTD_c_enableLongDistanceMatching, options.long_distance_matching ? 1 : 0));
+        check(::ZSTD_CCtx_setParameter(context, ZSTD_c_windowLog, static_cast<int>(options.window_log)));
+
+        return context;
+    }
+}
+
 namespace ufps
 {
     auto compress(DataBufferView data) -> DataBuffer
@@ -24,4 +55,67 @@ namespace ufps
 
         return compressed_buffer;
     }
+
+    auto compress(DataBufferView data, const CompressOptions &options) -> DataBuffer
+    {
+        const auto context = std::unique_ptr<::ZSTD_CCtx, decltype(&::ZSTD_freeCCtx)>{create_context(options), ::ZSTD_freeCCtx};
+
+        auto compressed_buffer = DataBuffer(::ZSTD_compressBound(data.size_bytes()));
+
+        const auto compressed_size =
+            check(::ZSTD_compress2(context.get(), compressed_buffer.data(), compressed_buffer.size(), data.data(), data.size_bytes()));
+
+        compressed_buffer.resize(compressed_size);
+
+        return compressed_buffer;
+    }
+
+    Compressor::Compressor(const CompressOptions &options, std::size_t chunk_size)
+        : _context{create_context(options)},
+          _buffer(std::max(chunk_size, 1zu))
+    {
+    }
+
+    auto Compressor::set_content_size(std::size_t size) -> void
+    {
+        check(::ZSTD_CCtx_setPledgedSrcSize(_context.get(), size));
+    }
+
+    auto Compressor::compress(DataBufferView data, const DataConsumer &consumer) -> void
+    {
+        stream(data, false, consumer);
+    }
+
+    auto Compressor::finish(const DataConsumer &consumer) -> void
+    {
+        stream({}, true, consumer);
+    }
+
+    auto Compressor::stream(DataBufferView data, bool end, const DataConsumer &consumer) -> void
+    {
+        auto input = ::ZSTD_inBuffer{.src = data.data(), .size = data.size(), .pos = 0zu};
+
+        for (;;)
+        {
+            auto output = ::ZSTD_outBuffer{.dst = _buffer.data(), .size = _buffer.size(), .pos = 0zu};
+            const auto remaining = check(::ZSTD_compressStream2(_context.get(), &output, &input, end ? ZSTD_e_end : ZSTD_e_continue));
+
+            if (output.pos != 0zu)
+            {
+                consumer(DataBufferView{_buffer}.first(output.pos));
+            }
+
+            // when continuing zstd holds on to what it has not flushed until there is more input or the frame ends
+            const auto done = end ? remaining == 0zu : input.pos == input.size;
+            if (done)
+            {
+                break;
+            }
+        }
+    }
+
+    auto Compressor::ContextDeleter::operator()(::ZSTD_CCtx *context) const -> void
+    {
+        ::ZSTD_freeCCtx(context);
+    }
 }
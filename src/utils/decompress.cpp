@@ -1,18 +1,45 @@
 #include "utils/decompress.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+
 #include <zstd.h>
 
 #include "utils/data_buffer.h"
 #include "utils/ensure.h"
 #include "utils/exception.h"
 
+namespace
+{
+    auto check(std::size_t result) -> std::size_t
+    {
+        if (::ZSTD_isError(result) == 1)
+        {
+            throw ufps::Exception("failed to decompress data: {}", ::ZSTD_getErrorName(result));
+        }
+
+        return result;
+    }
+}
+
 namespace ufps
 {
     auto decompress(DataBufferView data) -> DataBuffer
     {
         const auto decompressed_buffer_size = ::ZSTD_getFrameContentSize(data.data(), data.size_bytes());
-        expect(decompressed_buffer_size != ZSTD_CONTENTSIZE_ERROR, "not compressed by zstd");
-        expect(decompressed_buffer_size != ZSTD_CONTENTSIZE_UNKNOWN, "could not get original size");
+        ensure(decompressed_buffer_size != ZSTD_CONTENTSIZE_ERROR, "not compressed by zstd");
+
+        // frames written by a Compressor without a content size have to be grown as they are decompressed
+        if (decompressed_buffer_size == ZSTD_CONTENTSIZE_UNKNOWN)
+        {
+            auto decompressed_buffer = DataBuffer{};
+            decompress(data, decompress_chunk_size, [&](DataBufferView chunk) { decompressed_buffer.append_range(chunk); });
+
+            return decompressed_buffer;
+        }
 
         auto decompressed_buffer = DataBuffer(decompressed_buffer_size);
 
@@ -25,4 +52,109 @@ namespace ufps
 
         return decompressed_buffer;
     }
+
+    auto decompress(DataBufferView data, std::span<std::byte> destination) -> void
+    {
+        const auto decompressed_size = ::ZSTD_decompress(destination.data(), destination.size(), data.data(), data.size_bytes());
+
+        if (::ZSTD_isError(decompressed_size) == 1)
+        {
+            throw Exception("failed to decompress data: {}", ::ZSTD_getErrorName(decompressed_size));
+        }
+
+        ensure(decompressed_size == destination.size(), "decompressed {} bytes, expected {}", decompressed_size, destination.size());
+    }
+
+    auto decompress(DataBufferView data, std::size_t chunk_size, const DataConsumer &consumer) -> void
+    {
+        auto decompressor = Decompressor{chunk_size};
+        decompressor.decompress(data, consumer);
+
+        ensure(decompressor.finished(), "truncated zstd frame");
+    }
+
+    Decompressor::Decompressor(std::size_t chunk_size, std::uint32_t window_log_max)
+        : _context{::ZSTD_createDCtx()},
+          _buffer(std::max(chunk_size, 1zu)),
+          _buffered{},
+          _written{},
+          _finished{}
+    {
+        ensure(_context != nullptr, "failed to create decompression context");
+        check(::ZSTD_DCtx_setParameter(_context.get(), ZSTD_d_windowLogMax, static_cast<int>(window_log_max)));
+    }
+
+    auto Decompressor::decompress(DataBufferView data, const DataConsumer &consumer) -> void
+    {
+        auto input = ::ZSTD_inBuffer{.src = data.data(), .size = data.size(), .pos = 0zu};
+
+        // keep going while there is input or zstd may still be holding output that did not fit
+        auto output_full = false;
+        while ((input.pos < input.size || output_full) && !_finished)
+        {
+            auto output = ::ZSTD_outBuffer{.dst = _buffer.data(), .size = _buffer.size(), .pos = _buffered};
+            _finished = check(::ZSTD_decompressStream(_context.get(), &output, &input)) == 0zu;
+
+            _buffered = output.pos;
+            output_full = _buffered == _buffer.size();
+
+            if (output_full || (_finished && _buffered != 0zu))
+            {
+                consumer(DataBufferView{_buffer}.first(_buffered));
+                _buffered = 0zu;
+            }
+        }
+
+        ensure(input.pos == input.size, "trailing data after zstd frame");
+    }
+
+    auto Decompressor::decompress(DataBufferView data, std::span<std::byte> destination) -> std::size_t
+    {
+        ensure(_written <= destination.size(), "destination shrank from {} to {} bytes", _written, destination.size());
+
+        auto input = ::ZSTD_inBuffer{.src = data.data(), .size = data.size(), .pos = 0zu};
+        auto output = ::ZSTD_outBuffer{.dst = destination.data(), .size = destination.size(), .pos = _written};
+
+        while (input.pos < input.size && !_finished)
+        {
+            const auto input_pos = input.pos;
+            const auto output_pos = output.pos;
+
+            _finished = check(::ZSTD_decompressStream(_context.get(), &output, &input)) == 0zu;
+
+            // zstd stops making progress once it has filled its own buffers and has nowhere to write
+            ensure(_finished || input.pos != input_pos || output.pos != output_pos, "destination too small: {} bytes", destination.size());
+        }
+
+        ensure(input.pos == input.size, "trailing data after zstd frame");
+
+        const auto written = output.pos - _written;
+        _written = output.pos;
+
+        return written;
+    }
+
+    auto Decompressor::finished() const -> bool
+    {
+        return _finished;
+    }
+
+    auto Decompressor::reset() -> void
+    {
+        check(::ZSTD_DCtx_reset(_context.get(), ZSTD_reset_session_only));
+
+        _buffered = 0zu;
+        _written = 0zu;
+        _finished = false;
+    }
+
+    auto Decompressor::memory_usage() const -> std::size_t
+    {
+        return ::ZSTD_sizeof_DCtx(_context.get()) + _buffer.size();
+    }
+
+    auto Decompressor::ContextDeleter::operator()(::ZSTD_DCtx *context) const -> void
+    {
+        ::ZSTD_freeDCtx(context);
+    }
 }
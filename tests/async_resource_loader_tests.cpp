@@ -0,0 +1,272 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "concurrency/awaitable_manager.h"
+#include "concurrency/task.h"
+#include "concurrency/thread_pool.h"
+#include "resources/async_resource_loader.h"
+#include "resources/file_resource_loader.h"
+#include "utils/data_buffer.h"
+#include "utils/exception.h"
+
+namespace
+{
+    auto temp_resource_dir(const std::string &name) -> std::filesystem::path
+    {
+        const auto dir = std::filesystem::temp_directory_path() / name;
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+
+        for (const auto file : {"a", "b", "c", "d", "gate"})
+        {
+            auto stream = std::ofstream{dir / file, std::ios::binary};
+            stream << "contents of " << file;
+        }
+
+        return dir;
+    }
+
+    auto to_string(const ufps::DataBuffer &buffer) -> std::string
+    {
+        return {reinterpret_cast<const char *>(buffer.data()), buffer.size()};
+    }
+
+    // holds the (only) worker on a batch with the gate file until released, and records the batches everything was
+    // read in
+    class GatedLoader : public ufps::FileResourceLoader
+    {
+    public:
+        using ufps::FileResourceLoader::FileResourceLoader;
+
+        auto load_data_buffers(std::span<const std::string_view> names) -> std::vector<ufps::DataBuffer> override
+        {
+            if (std::ranges::contains(names, std::string_view{"gate"}))
+            {
+                gate_reached = true;
+                gate_reached.notify_all();
+                released.wait(false);
+            }
+
+            {
+                const auto lock = std::scoped_lock{batches_lock};
+                batches.push_back(names | std::ranges::to<std::vector<std::string>>());
+            }
+
+            return ufps::FileResourceLoader::load_data_buffers(names);
+        }
+
+        auto release() -> void
+        {
+            released = true;
+            released.notify_all();
+        }
+
+        std::atomic<bool> gate_reached = false;
+        std::atomic<bool> released = false;
+        std::mutex batches_lock;
+        std::vector<std::vector<std::string>> batches;
+    };
+
+    auto load(
+        ufps::AsyncResourceLoader &loader,
+        std::string name,
+        ufps::LoadPriority priority,
+        std::optional<ufps::DataBuffer> &result,
+        std::atomic<int> &done,
+        std::stop_token stop_token = {}) -> ufps::Task
+    {
+        result = co_await loader.load_async(name, priority, stop_token);
+        ++done;
+    }
+
+    auto wait_for(ufps::AwaitableManager &am, ufps::ThreadPool &pool, const std::atomic<int> &done, int count) -> void
+    {
+        while (done != count)
+        {
+            am.pump();
+            pool.drain();
+        }
+    }
+}
+
+TEST(async_resource_loader, load)
+{
+    auto pool = ufps::ThreadPool{2u};
+    auto am = ufps::AwaitableManager{pool};
+    auto file_loader = ufps::FileResourceLoader{{temp_resource_dir("ufps_async_load")}};
+    auto loader = ufps::AsyncResourceLoader{file_loader, am};
+
+    auto result = std::optional<ufps::DataBuffer>{};
+    auto done = std::atomic<int>{0};
+    load(loader, "a", ufps::LoadPriority::NORMAL, result, done);
+
+    wait_for(am, pool, done, 1);
+
+    ASSERT_TRUE(result.has_value());
+    ASSERT_EQ(to_string(*result), "contents of a");
+}
+
+TEST(async_resource_loader, missing_resource_throws_in_coroutine)
+{
+    auto pool = ufps::ThreadPool{2u};
+    auto am = ufps::AwaitableManager{pool};
+    auto file_loader = ufps::FileResourceLoader{{temp_resource_dir("ufps_async_missing")}};
+    auto loader = ufps::AsyncResourceLoader{file_loader, am};
+
+    auto threw = false;
+    auto done = std::atomic<int>{0};
+
+    [[maybe_unused]] const auto coro = [](ufps::AsyncResourceLoader &loader, bool &threw, std::atomic<int> &done) -> ufps::Task
+    {
+        try
+        {
+            co_await loader.load_async("missing");
+        }
+        catch (const ufps::Exception &)
+        {
+            threw = true;
+        }
+
+        ++done;
+    }(loader, threw, done);
+
+    wait_for(am, pool, done, 1);
+
+    ASSERT_TRUE(threw);
+}
+
+TEST(async_resource_loader, cancelled)
+{
+    auto pool = ufps::ThreadPool{2u};
+    auto am = ufps::AwaitableManager{pool};
+    auto file_loader = ufps::FileResourceLoader{{temp_resource_dir("ufps_async_cancelled")}};
+    auto loader = ufps::AsyncResourceLoader{file_loader, am};
+
+    auto stop_source = std::stop_source{};
+    stop_source.request_stop();
+
+    auto result = std::optional<ufps::DataBuffer>{ufps::DataBuffer{}};
+    auto done = std::atomic<int>{0};
+
+    [[maybe_unused]] const auto coro =
+        [](ufps::AsyncResourceLoader &loader, std::stop_token stop_token, std::optional<ufps::DataBuffer> &result, std::atomic<int> &done) -> ufps::Task
+    {
+        result = co_await loader.load_async("a", ufps::LoadPriority::NORMAL, stop_token);
+        ++done;
+    }(loader, stop_source.get_token(), result, done);
+
+    wait_for(am, pool, done, 1);
+
+    ASSERT_FALSE(result.has_value());
+}
+
+TEST(async_resource_loader, priority_order)
+{
+    auto pool = ufps::ThreadPool{2u};
+    auto am = ufps::AwaitableManager{pool};
+    auto file_loader = GatedLoader{{temp_resource_dir("ufps_async_priority")}};
+    auto loader = ufps::AsyncResourceLoader{file_loader, am, 1u};
+
+    auto results = std::vector<std::optional<ufps::DataBuffer>>(5zu);
+    auto done = std::atomic<int>{0};
+
+    load(loader, "gate", ufps::LoadPriority::LOW, results[0], done);
+    file_loader.gate_reached.wait(false);
+
+    load(loader, "a", ufps::LoadPriority::LOW, results[1], done);
+    load(loader, "b", ufps::LoadPriority::NORMAL, results[2], done);
+    load(loader, "c", ufps::LoadPriority::HIGH, results[3], done);
+    load(loader, "d", ufps::LoadPriority::NORMAL, results[4], done);
+
+    ASSERT_EQ(loader.queued_count(), 4u);
+
+    file_loader.release();
+
+    wait_for(am, pool, done, 5);
+
+    // everything queued behind the gate is read as one batch, most urgent first
+    ASSERT_EQ(file_loader.batches, (std::vector<std::vector<std::string>>{{"gate"}, {"c", "b", "d", "a"}}));
+    ASSERT_EQ(to_string(*results[3]), "contents of c");
+}
+
+TEST(async_resource_loader, missing_resource_in_batch)
+{
+    auto pool = ufps::ThreadPool{2u};
+    auto am = ufps::AwaitableManager{pool};
+    auto file_loader = GatedLoader{{temp_resource_dir("ufps_async_missing_batch")}};
+    auto loader = ufps::AsyncResourceLoader{file_loader, am, 1u};
+
+    auto gate = std::optional<ufps::DataBuffer>{};
+    auto done = std::atomic<int>{0};
+    load(loader, "gate", ufps::LoadPriority::NORMAL, gate, done);
+    file_loader.gate_reached.wait(false);
+
+    auto result = std::optional<ufps::DataBuffer>{};
+    auto threw = false;
+    load(loader, "a", ufps::LoadPriority::NORMAL, result, done);
+
+    [[maybe_unused]] const auto coro = [](ufps::AsyncResourceLoader &loader, bool &threw, std::atomic<int> &done) -> ufps::Task
+    {
+        try
+        {
+            co_await loader.load_async("missing");
+        }
+        catch (const ufps::Exception &)
+        {
+            threw = true;
+        }
+
+        ++done;
+    }(loader, threw, done);
+
+    file_loader.release();
+
+    wait_for(am, pool, done, 3);
+
+    // the failed batch is retried one at a time, so only the missing resource throws
+    ASSERT_TRUE(threw);
+    ASSERT_EQ(to_string(*result), "contents of a");
+}
+
+TEST(async_resource_loader, cancelled_while_queued)
+{
+    auto pool = ufps::ThreadPool{2u};
+    auto am = ufps::AwaitableManager{pool};
+    auto file_loader = GatedLoader{{temp_resource_dir("ufps_async_cancel_queued")}};
+    auto loader = ufps::AsyncResourceLoader{file_loader, am, 1u};
+
+    auto gate = std::optional<ufps::DataBuffer>{};
+    auto done = std::atomic<int>{0};
+    load(loader, "gate", ufps::LoadPriority::NORMAL, gate, done);
+    file_loader.gate_reached.wait(false);
+
+    auto stop_source = std::stop_source{};
+    auto result = std::optional<ufps::DataBuffer>{ufps::DataBuffer{}};
+    load(loader, "a", ufps::LoadPriority::NORMAL, result, done, stop_source.get_token());
+    ASSERT_EQ(loader.queued_count(), 1u);
+
+    // resumed without waiting for the worker, which is still held on the gate
+    stop_source.request_stop();
+    ASSERT_EQ(loader.queued_count(), 0u);
+
+    wait_for(am, pool, done, 1);
+    ASSERT_FALSE(result.has_value());
+
+    file_loader.release();
+    wait_for(am, pool, done, 2);
+
+    ASSERT_EQ(file_loader.batches, (std::vector<std::vector<std::string>>{{"gate"}}));
+}
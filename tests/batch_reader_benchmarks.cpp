@@ -0,0 +1,217 @@
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <benchmark/benchmark.h>
+
+#include "resources/batch_reader.h"
+#include "resources/file_resource_loader.h"
+#include "utils/data_buffer.h"
+
+namespace
+{
+    // lots of small resources, shaders, configs and the like, 1 to 16KiB each
+    constexpr auto file_count = 4096zu;
+    constexpr auto max_file_size = 16zu * 1024zu;
+
+    struct Content
+    {
+        Content()
+            : root{std::filesystem::temp_directory_path() / "ufps_batch_reader_benchmarks"}
+        {
+            std::filesystem::remove_all(root);
+            std::filesystem::create_directories(root / "small");
+
+            auto rng = std::mt19937{1u};
+            auto size_dist = std::uniform_int_distribution<std::size_t>{1024zu, max_file_size};
+
+            for (auto i = 0zu; i < file_count; ++i)
+            {
+                const auto name = std::format("small/{}.bin", i);
+                const auto data = std::string(size_dist(rng), static_cast<char>(i));
+
+                auto file = std::ofstream{root / name, std::ios::binary};
+                file.write(data.data(), static_cast<std::streamsize>(data.size()));
+
+                names.push_back(name);
+            }
+        }
+
+        ~Content()
+        {
+            std::filesystem::remove_all(root);
+        }
+
+        // drop the files from the page cache so the next load has to go to disk
+        auto evict() const -> void
+        {
+            for (const auto &entry : std::filesystem::recursive_directory_iterator{root})
+            {
+                if (entry.is_regular_file())
+                {
+                    const auto fd = ::open(entry.path().c_str(), O_RDONLY);
+                    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+                    ::close(fd);
+                }
+            }
+        }
+
+        std::filesystem::path root;
+        std::vector<std::string> names;
+    };
+
+    auto content() -> const Content &
+    {
+        static const auto content = Content{};
+        return content;
+    }
+
+    auto consume(ufps::DataBufferView data) -> std::uint64_t
+    {
+        return data.empty() ? 0u : data.size() + std::to_underlying(data.front());
+    }
+
+    template <class F>
+    auto load_all(benchmark::State &state, F &&load) -> void
+    {
+        const auto &c = content();
+        const auto cold = state.range(0) != 0;
+        const auto names = std::vector<std::string_view>{c.names.begin(), c.names.end()};
+
+        for (auto _ : state)
+        {
+            if (cold)
+            {
+                state.PauseTiming();
+                c.evict();
+                state.ResumeTiming();
+            }
+
+            benchmark::DoNotOptimize(load(names));
+        }
+
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(names.size()));
+    }
+
+    auto read_batch(const std::vector<std::string_view> &names, bool use_io_uring) -> std::uint64_t
+    {
+        const auto &c = content();
+        auto reader = ufps::BatchReader{ufps::batch_reader_queue_depth, use_io_uring};
+
+        auto buffers = std::vector<ufps::DataBuffer>(names.size(), ufps::DataBuffer(max_file_size));
+        auto reads = std::vector<ufps::BatchRead>{};
+        reads.reserve(names.size());
+
+        for (auto i = 0zu; i < names.size(); ++i)
+        {
+            reads.push_back({.path = c.root / names[i], .buffer = buffers[i], .bytes_read = 0zu});
+        }
+
+        reader.read(reads);
+
+        auto sum = std::uint64_t{};
+        for (const auto &read : reads)
+        {
+            sum += consume(read.buffer.first(read.bytes_read));
+        }
+
+        return sum;
+    }
+}
+
+// one File (open, fstat, mmap, copy, munmap, close) per resource
+static void file_resource_loader_load_one_at_a_time(benchmark::State &state)
+{
+    auto loader = ufps::FileResourceLoader{{content().root}};
+
+    load_all(
+        state,
+        [&](const auto &names)
+        {
+            auto sum = std::uint64_t{};
+            for (const auto name : names)
+            {
+                sum += consume(loader.load_data_buffer(name));
+            }
+
+            return sum;
+        });
+}
+
+static void file_resource_loader_load_batched(benchmark::State &state)
+{
+    auto loader = ufps::FileResourceLoader{{content().root}};
+
+    load_all(
+        state,
+        [&](const auto &names)
+        {
+            auto sum = std::uint64_t{};
+            for (const auto &buffer : loader.load_data_buffers(names))
+            {
+                sum += consume(buffer);
+            }
+
+            return sum;
+        });
+}
+
+static void batch_reader_io_uring(benchmark::State &state)
+{
+    load_all(state, [](const auto &names) { return read_batch(names, true); });
+}
+
+static void batch_reader_pread(benchmark::State &state)
+{
+    load_all(state, [](const auto &names) { return read_batch(names, false); });
+}
+
+// what every lookup cost before the index, a stat per root
+static void file_resource_loader_exists(benchmark::State &state)
+{
+    const auto &c = content();
+
+    for (auto _ : state)
+    {
+        for (const auto &name : c.names)
+        {
+            benchmark::DoNotOptimize(std::filesystem::exists(c.root / name));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(c.names.size()));
+}
+
+static void file_resource_loader_has_resource(benchmark::State &state)
+{
+    const auto &c = content();
+    auto loader = ufps::FileResourceLoader{{c.root}};
+
+    for (auto _ : state)
+    {
+        for (const auto &name : c.names)
+        {
+            benchmark::DoNotOptimize(loader.has_resource(name));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(c.names.size()));
+}
+
+BENCHMARK(file_resource_loader_load_one_at_a_time)->ArgName("cold")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(file_resource_loader_load_batched)->ArgName("cold")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(batch_reader_io_uring)->ArgName("cold")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(batch_reader_pread)->ArgName("cold")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(file_resource_loader_exists)->Unit(benchmark::kMicrosecond);
+BENCHMARK(file_resource_loader_has_resource)->Unit(benchmark::kMicrosecond);
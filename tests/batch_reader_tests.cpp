@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "resources/batch_reader.h"
+#include "resources/file_resource_loader.h"
+#include "utils/data_buffer.h"
+#include "utils/exception.h"
+
+namespace
+{
+    constexpr auto file_count = 300zu;
+
+    auto contents(std::size_t index) -> std::string
+    {
+        // varied sizes, including empty and larger than a page
+        return std::string(index % 7zu == 0zu ? 0zu : index * 37zu % 5000zu, static_cast<char>('a' + index % 26zu));
+    }
+
+    auto temp_resource_dir(const std::string &name) -> std::filesystem::path
+    {
+        const auto dir = std::filesystem::temp_directory_path() / name;
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir / "blobs");
+
+        for (auto i = 0zu; i < file_count; ++i)
+        {
+            auto stream = std::ofstream{dir / std::format("blobs/{}.bin", i), std::ios::binary};
+            stream << contents(i);
+        }
+
+        return dir;
+    }
+
+    auto to_string(std::span<const std::byte> buffer) -> std::string
+    {
+        return {reinterpret_cast<const char *>(buffer.data()), buffer.size()};
+    }
+
+    // each test reads its own directory so they can run in parallel
+    auto read_all(const std::string &dir_name, bool use_io_uring) -> void
+    {
+        const auto dir = temp_resource_dir(dir_name);
+
+        // a small queue so the ring wraps many times
+        auto reader = ufps::BatchReader{8u, use_io_uring};
+        auto buffers = std::vector<ufps::DataBuffer>{};
+        auto reads = std::vector<ufps::BatchRead>{};
+        buffers.reserve(file_count);
+
+        for (auto i = 0zu; i < file_count; ++i)
+        {
+            // one byte spare to check short files report what they actually read
+            auto &buffer = buffers.emplace_back(contents(i).size() + 1zu);
+            reads.push_back({.path = dir / std::format("blobs/{}.bin", i), .buffer = buffer, .bytes_read = 0zu});
+        }
+
+        reader.read(reads);
+
+        for (auto i = 0zu; i < file_count; ++i)
+        {
+            ASSERT_EQ(reads[i].bytes_read, contents(i).size());
+            ASSERT_EQ(to_string(reads[i].buffer.first(reads[i].bytes_read)), contents(i));
+        }
+    }
+}
+
+TEST(batch_reader, read_io_uring)
+{
+    read_all("ufps_batch_reader_io_uring", true);
+}
+
+TEST(batch_reader, read_fallback)
+{
+    auto reader = ufps::BatchReader{8u, false};
+    ASSERT_FALSE(reader.uses_io_uring());
+
+    read_all("ufps_batch_reader_fallback", false);
+}
+
+TEST(batch_reader, missing_file_throws)
+{
+    const auto dir = temp_resource_dir("ufps_batch_reader_missing");
+
+    for (const auto use_io_uring : {true, false})
+    {
+        auto reader = ufps::BatchReader{4u, use_io_uring};
+        auto buffers = std::vector<ufps::DataBuffer>(10zu, ufps::DataBuffer(64zu));
+        auto reads = std::vector<ufps::BatchRead>{};
+
+        for (auto i = 0zu; i < buffers.size(); ++i)
+        {
+            const auto name = i == 6zu ? std::string{"blobs/missing.bin"} : std::format("blobs/{}.bin", i);
+            reads.push_back({.path = dir / name, .buffer = buffers[i], .bytes_read = 0zu});
+        }
+
+        ASSERT_THROW(reader.read(reads), ufps::Exception);
+    }
+}
+
+TEST(batch_reader, file_resource_loader_index)
+{
+    const auto dir = temp_resource_dir("ufps_batch_reader_index");
+    auto loader = ufps::FileResourceLoader{{dir}};
+
+    ASSERT_TRUE(loader.has_resource("blobs/1.bin"));
+    ASSERT_FALSE(loader.has_resource("blobs/missing.bin"));
+    ASSERT_FALSE(loader.has_resource("blobs"));
+
+    // the index is built up front, files added later are not seen
+    {
+        auto stream = std::ofstream{dir / "late.bin"};
+        stream << "late";
+    }
+    ASSERT_FALSE(loader.has_resource("late.bin"));
+
+    const auto names = std::vector<std::string_view>{"blobs/5.bin", "blobs/0.bin", "blobs/299.bin", "blobs/5.bin"};
+    const auto buffers = loader.load_data_buffers(names);
+
+    ASSERT_EQ(buffers.size(), names.size());
+    ASSERT_EQ(to_string(buffers[0]), contents(5zu));
+    ASSERT_TRUE(buffers[1].empty());
+    ASSERT_EQ(to_string(buffers[2]), contents(299zu));
+    ASSERT_EQ(buffers[3], buffers[0]);
+
+    ASSERT_THROW(loader.load_data_buffers(std::vector<std::string_view>{"blobs/missing.bin"}), ufps::Exception);
+}
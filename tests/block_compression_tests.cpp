@@ -0,0 +1,227 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <span>
+
+#include "concurrency/thread_pool.h"
+#include "graphics/block_compression.h"
+#include "graphics/mip_chain.h"
+#include "graphics/texture_data.h"
+#include "utils/data_buffer.h"
+#include "utils/exception.h"
+
+namespace
+{
+    using Pixels = std::array<std::uint8_t, 64zu>;
+
+    auto read_bits(const ufps::CompressedBlock &block, std::uint32_t &position, std::uint32_t bits) -> std::uint32_t
+    {
+        auto value = 0u;
+        for (auto i = 0u; i < bits; ++i, ++position)
+        {
+            value |= ((std::to_integer<std::uint32_t>(block[position / 8u]) >> (position % 8u)) & 1u) << i;
+        }
+
+        return value;
+    }
+
+    // just enough of a BC7 decoder to read back what the encoder writes
+    auto decode_bc7_mode6(const ufps::CompressedBlock &block) -> Pixels
+    {
+        static constexpr auto weights = std::array<std::uint32_t, 16zu>{0u, 4u, 9u, 13u, 17u, 21u, 26u, 30u, 34u, 38u, 43u, 47u, 51u, 55u, 60u, 64u};
+
+        auto position = 0u;
+        EXPECT_EQ(read_bits(block, position, 7u), 1u << 6u);
+
+        auto endpoints = std::array<std::array<std::uint32_t, 4zu>, 2zu>{};
+        for (auto c = 0zu; c < 4zu; ++c)
+        {
+            endpoints[0][c] = read_bits(block, position, 7u) << 1u;
+            endpoints[1][c] = read_bits(block, position, 7u) << 1u;
+        }
+
+        const auto p0 = read_bits(block, position, 1u);
+        const auto p1 = read_bits(block, position, 1u);
+
+        auto pixels = Pixels{};
+        for (auto p = 0zu; p < 16zu; ++p)
+        {
+            const auto index = read_bits(block, position, p == 0zu ? 3u : 4u);
+            for (auto c = 0zu; c < 4zu; ++c)
+            {
+                const auto e0 = endpoints[0][c] | p0;
+                const auto e1 = endpoints[1][c] | p1;
+                pixels[p * 4zu + c] = static_cast<std::uint8_t>(((64u - weights[index]) * e0 + weights[index] * e1 + 32u) >> 6u);
+            }
+        }
+
+        return pixels;
+    }
+
+    auto decode_bc4(const ufps::CompressedBlock &block, std::uint32_t offset) -> std::array<std::uint8_t, 16zu>
+    {
+        auto position = offset;
+        const auto red0 = read_bits(block, position, 8u);
+        const auto red1 = read_bits(block, position, 8u);
+
+        auto palette = std::array<std::uint32_t, 8zu>{red0, red1};
+        for (auto i = 2u; i < 8u; ++i)
+        {
+            palette[i] = red0 > red1 ? ((8u - i) * red0 + (i - 1u) * red1 + 3u) / 7u : red0;
+        }
+
+        auto values = std::array<std::uint8_t, 16zu>{};
+        for (auto &value : values)
+        {
+            value = static_cast<std::uint8_t>(palette[read_bits(block, position, 3u)]);
+        }
+
+        return values;
+    }
+
+    auto max_error(const Pixels &a, const Pixels &b, std::size_t channels) -> int
+    {
+        auto error = 0;
+        for (auto p = 0zu; p < 16zu; ++p)
+        {
+            for (auto c = 0zu; c < channels; ++c)
+            {
+                error = std::max(error, std::abs(static_cast<int>(a[p * 4zu + c]) - static_cast<int>(b[p * 4zu + c])));
+            }
+        }
+
+        return error;
+    }
+
+    auto gradient() -> Pixels
+    {
+        auto pixels = Pixels{};
+        for (auto p = 0zu; p < 16zu; ++p)
+        {
+            pixels[p * 4zu + 0zu] = static_cast<std::uint8_t>(p * 16zu);
+            pixels[p * 4zu + 1zu] = static_cast<std::uint8_t>(255zu - p * 12zu);
+            pixels[p * 4zu + 2zu] = static_cast<std::uint8_t>(64zu + p * 4zu);
+            pixels[p * 4zu + 3zu] = 255u;
+        }
+
+        return pixels;
+    }
+}
+
+TEST(block_compression, bc7_solid_colour)
+{
+    auto pixels = Pixels{};
+    for (auto p = 0zu; p < 16zu; ++p)
+    {
+        std::ranges::copy(std::array<std::uint8_t, 4zu>{201u, 34u, 128u, 255u}, pixels.begin() + p * 4zu);
+    }
+
+    // mode 6 shares the lsb of an endpoint across channels so mixed odd and even values can be one off
+    ASSERT_LE(max_error(decode_bc7_mode6(ufps::encode_bc7_block(pixels)), pixels, 4zu), 1);
+}
+
+TEST(block_compression, bc7_gradient)
+{
+    const auto pixels = gradient();
+
+    ASSERT_LE(max_error(decode_bc7_mode6(ufps::encode_bc7_block(pixels)), pixels, 4zu), 6);
+}
+
+TEST(block_compression, bc7_two_colours_with_alpha)
+{
+    auto pixels = Pixels{};
+    for (auto p = 0zu; p < 16zu; ++p)
+    {
+        const auto colour = p % 3zu == 0zu ? std::array<std::uint8_t, 4zu>{250u, 10u, 10u, 0u} : std::array<std::uint8_t, 4zu>{10u, 10u, 250u, 255u};
+        std::ranges::copy(colour, pixels.begin() + p * 4zu);
+    }
+
+    ASSERT_LE(max_error(decode_bc7_mode6(ufps::encode_bc7_block(pixels)), pixels, 4zu), 2);
+}
+
+TEST(block_compression, bc5_encodes_red_and_green)
+{
+    const auto pixels = gradient();
+    const auto block = ufps::encode_bc5_block(pixels);
+
+    const auto red = decode_bc4(block, 0u);
+    const auto green = decode_bc4(block, 64u);
+
+    for (auto p = 0zu; p < 16zu; ++p)
+    {
+        ASSERT_LE(std::abs(static_cast<int>(red[p]) - static_cast<int>(pixels[p * 4zu])), 18);
+        ASSERT_LE(std::abs(static_cast<int>(green[p]) - static_cast<int>(pixels[p * 4zu + 1zu])), 14);
+    }
+}
+
+TEST(block_compression, bc5_flat_block)
+{
+    auto pixels = Pixels{};
+    for (auto p = 0zu; p < 16zu; ++p)
+    {
+        pixels[p * 4zu] = 77u;
+        pixels[p * 4zu + 1zu] = 128u;
+    }
+
+    const auto block = ufps::encode_bc5_block(pixels);
+
+    ASSERT_TRUE(std::ranges::all_of(decode_bc4(block, 0u), [](auto v) { return v == 77u; }));
+    ASSERT_TRUE(std::ranges::all_of(decode_bc4(block, 64u), [](auto v) { return v == 128u; }));
+}
+
+TEST(block_compression, block_compress_every_mip)
+{
+    auto pool = ufps::ThreadPool{2u};
+
+    const auto texture = ufps::generate_mips({
+        .width = 34u,
+        .height = 17u,
+        .format = ufps::TextureFormat::SRGBA,
+        .data = ufps::DataBuffer(34zu * 17zu * 4zu, std::byte{90}),
+        .is_compressed = false,
+    });
+
+    const auto compressed = ufps::block_compress(texture, ufps::TextureFormat::BC7_SRGB, pool);
+    const auto chain = ufps::mip_chain(compressed);
+
+    ASSERT_EQ(compressed.format, ufps::TextureFormat::BC7_SRGB);
+    ASSERT_TRUE(compressed.is_compressed);
+    ASSERT_EQ(compressed.mip_levels, texture.mip_levels);
+    ASSERT_EQ(compressed.data->size(), chain.back().offset + chain.back().size);
+
+    for (const auto &mip : chain)
+    {
+        auto block = ufps::CompressedBlock{};
+        std::ranges::copy(std::span{*compressed.data}.subspan(mip.offset, block.size()), block.begin());
+
+        const auto decoded = decode_bc7_mode6(block);
+        ASSERT_TRUE(std::ranges::all_of(decoded, [](auto v) { return v == 90u; }));
+    }
+}
+
+TEST(block_compression, block_compress_rejects_unsupported)
+{
+    auto pool = ufps::ThreadPool{1u};
+
+    const auto rgb = ufps::TextureData{
+        .width = 4u,
+        .height = 4u,
+        .format = ufps::TextureFormat::RGB,
+        .data = ufps::DataBuffer(48zu),
+        .is_compressed = false,
+    };
+    ASSERT_THROW(ufps::block_compress(rgb, ufps::TextureFormat::BC7, pool), ufps::Exception);
+
+    const auto rgba = ufps::TextureData{
+        .width = 4u,
+        .height = 4u,
+        .format = ufps::TextureFormat::RGBA,
+        .data = ufps::DataBuffer(64zu),
+        .is_compressed = false,
+    };
+    ASSERT_THROW(ufps::block_compress(rgba, ufps::TextureFormat::RGBA16F, pool), ufps::Exception);
+}
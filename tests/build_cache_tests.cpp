@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <ranges>
+#include <string>
+
+#include "graphics/model_data.h"
+#include "graphics/vertex_data.h"
+#include "resources/build_cache.h"
+#include "utils/data_buffer.h"
+#include "utils/exception.h"
+
+namespace
+{
+    auto temp_cache_dir(const std::string &name) -> std::filesystem::path
+    {
+        const auto dir = std::filesystem::temp_directory_path() / name;
+        std::filesystem::remove_all(dir);
+
+        return dir;
+    }
+
+    auto imported_model() -> ufps::ImportedModel
+    {
+        return {
+            .name = "crate.fbx",
+            .sub_models = {
+                {
+                    .mesh_data = {
+                        .vertices = {
+                            {.position = {1.0f, 2.0f, 3.0f}, .normal = {0.0f, 1.0f, 0.0f}, .tangent = {1.0f, 0.0f, 0.0f}, .bitangent = {0.0f, 0.0f, 1.0f}, .uv = {0.25f, 0.75f}},
+                            {.position = {-1.0f, 0.0f, 4.0f}, .normal = {0.0f, 0.0f, 1.0f}, .tangent = {0.0f, 1.0f, 0.0f}, .bitangent = {1.0f, 0.0f, 0.0f}, .uv = {1.0f, 0.0f}},
+                        },
+                        .indices = {0u, 1u, 1u},
+                    },
+                    .meshlets = {
+                        {.sphere = {{0.0f, 1.0f, 3.5f}, 1.5f}, .cone = {{0.0f, 0.0f, 1.0f}, 0.5f}, .index_offset = 0u, .index_count = 3u, .vertex_count = 2u, .pad = 0u},
+                    },
+                    .albedo = "textures/crate_BaseColor.png",
+                    .normal = "textures/crate_Normal.png",
+                    .specular = std::nullopt,
+                    .roughness = "",
+                    .ambient_occlusion = std::nullopt,
+                    .emissive_color = std::nullopt,
+                    .opacity = 0.5f,
+                    .emissive_intensity = 2.0f,
+                },
+                {
+                    .mesh_data = {},
+                    .meshlets = {},
+                    .albedo = std::nullopt,
+                    .normal = std::nullopt,
+                    .specular = std::nullopt,
+                    .roughness = std::nullopt,
+                    .ambient_occlusion = std::nullopt,
+                    .emissive_color = "textures/glow.png",
+                    .opacity = 1.0f,
+                    .emissive_intensity = 0.0f,
+                },
+            },
+        };
+    }
+}
+
+TEST(build_cache, miss_then_hit)
+{
+    const auto dir = temp_cache_dir("ufps_build_cache_miss_then_hit");
+    auto cache = ufps::BuildCache{dir};
+
+    ASSERT_FALSE(cache.find(42u).has_value());
+
+    const auto data = ufps::DataBuffer{std::byte{1}, std::byte{2}, std::byte{3}};
+    cache.store(42u, data);
+
+    ASSERT_EQ(cache.find(42u), data);
+    ASSERT_FALSE(cache.find(43u).has_value());
+
+    ASSERT_EQ(cache.hits(), 1zu);
+    ASSERT_EQ(cache.misses(), 2zu);
+
+    // no temporaries are left behind
+    ASSERT_EQ(std::ranges::distance(std::filesystem::directory_iterator{dir}), 1);
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST(build_cache, store_replaces)
+{
+    const auto dir = temp_cache_dir("ufps_build_cache_store_replaces");
+    auto cache = ufps::BuildCache{dir};
+
+    cache.store(7u, ufps::DataBuffer{std::byte{1}});
+    cache.store(7u, ufps::DataBuffer{std::byte{2}, std::byte{3}});
+
+    ASSERT_EQ(cache.find(7u), (ufps::DataBuffer{std::byte{2}, std::byte{3}}));
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST(build_cache, imported_model_round_trip)
+{
+    const auto model = imported_model();
+    const auto decoded = ufps::decode_imported_model(ufps::encode_imported_model(model));
+
+    ASSERT_EQ(decoded.name, model.name);
+    ASSERT_EQ(decoded.sub_models.size(), model.sub_models.size());
+
+    for (const auto &[a, b] : std::views::zip(decoded.sub_models, model.sub_models))
+    {
+        ASSERT_EQ(a.mesh_data.indices, b.mesh_data.indices);
+        ASSERT_EQ(a.meshlets, b.meshlets);
+        ASSERT_EQ(a.mesh_data.vertices.size(), b.mesh_data.vertices.size());
+        for (const auto &[va, vb] : std::views::zip(a.mesh_data.vertices, b.mesh_data.vertices))
+        {
+            ASSERT_EQ(va.position, vb.position);
+            ASSERT_EQ(va.normal, vb.normal);
+            ASSERT_EQ(va.uv.s, vb.uv.s);
+            ASSERT_EQ(va.uv.t, vb.uv.t);
+        }
+
+        ASSERT_EQ(a.albedo, b.albedo);
+        ASSERT_EQ(a.normal, b.normal);
+        ASSERT_EQ(a.specular, b.specular);
+        ASSERT_EQ(a.roughness, b.roughness);
+        ASSERT_EQ(a.ambient_occlusion, b.ambient_occlusion);
+        ASSERT_EQ(a.emissive_color, b.emissive_color);
+        ASSERT_EQ(a.opacity, b.opacity);
+        ASSERT_EQ(a.emissive_intensity, b.emissive_intensity);
+    }
+}
+
+TEST(build_cache, imported_model_rejects_corrupt)
+{
+    auto data = ufps::encode_imported_model(imported_model());
+
+    auto truncated = data;
+    truncated.resize(truncated.size() - 3zu);
+    ASSERT_THROW(ufps::decode_imported_model(truncated), ufps::Exception);
+
+    auto trailing = data;
+    trailing.push_back(std::byte{0});
+    ASSERT_THROW(ufps::decode_imported_model(trailing), ufps::Exception);
+
+    auto bad_magic = data;
+    bad_magic[0] = std::byte{'X'};
+    ASSERT_THROW(ufps::decode_imported_model(bad_magic), ufps::Exception);
+}
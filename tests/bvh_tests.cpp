@@ -0,0 +1,394 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "core/scene_bvh.h"
+#include "graphics/mesh_view.h"
+#include "graphics/vertex_data.h"
+#include "math/aabb.h"
+#include "math/bvh.h"
+#include "math/ray.h"
+#include "math/transform.h"
+#include "math/utils.h"
+#include "math/vector3.h"
+
+namespace
+{
+    class FakeMeshManager
+    {
+    public:
+        FakeMeshManager()
+            : _vertices{},
+              _indices{}
+        {
+            for (auto i = 0u; i < 8u; ++i)
+            {
+                _vertices.push_back({
+                    .position = {(i & 1u) ? 1.f : -1.f, (i & 2u) ? 1.f : -1.f, (i & 4u) ? 1.f : -1.f},
+                    .normal = {},
+                    .tangent = {},
+                    .bitangent = {},
+                    .uv = {},
+                });
+            }
+
+            _indices = {0, 2, 1, 1, 2, 3, 4, 5, 6, 5, 7, 6, 0, 1, 4, 1, 5, 4, 2, 6, 3, 3, 6, 7, 0, 4, 2, 2, 4, 6, 1, 3, 5, 3, 7, 5};
+        }
+
+        auto cube() const -> ufps::MeshView
+        {
+            return {.vertex_offset = 0u, .vertex_count = 8u, .index_offset = 0u, .index_count = 36u, .meshlet_offset = 0u, .meshlet_count = 1u};
+        }
+
+        auto vertex_data(ufps::MeshView view) const -> std::span<const ufps::VertexData>
+        {
+            return std::span{_vertices}.subspan(view.vertex_offset, view.vertex_count);
+        }
+
+        auto index_data(ufps::MeshView view) const -> std::span<const std::uint32_t>
+        {
+            return std::span{_indices}.subspan(view.index_offset, view.index_count);
+        }
+
+    private:
+        std::vector<ufps::VertexData> _vertices;
+        std::vector<std::uint32_t> _indices;
+    };
+
+    class FakeRenderEntity
+    {
+    public:
+        FakeRenderEntity(ufps::MeshView mesh_view)
+            : _mesh_view{mesh_view}
+        {
+        }
+
+        auto mesh_view() const -> ufps::MeshView
+        {
+            return _mesh_view;
+        }
+
+    private:
+        ufps::MeshView _mesh_view;
+    };
+
+    class FakeEntity
+    {
+    public:
+        FakeEntity(ufps::MeshView mesh_view, const ufps::Vector3 &position, float scale)
+            : _render_entities{mesh_view},
+              _transform{position, {scale}, {}},
+              _version{}
+        {
+        }
+
+        auto render_entities() const -> std::span<const FakeRenderEntity>
+        {
+            return _render_entities;
+        }
+
+        auto transform() const -> const ufps::Transform &
+        {
+            return _transform;
+        }
+
+        auto version() const -> std::uint32_t
+        {
+            return _version;
+        }
+
+        auto set_position(const ufps::Vector3 &position) -> void
+        {
+            _transform.position = position;
+            ++_version;
+        }
+
+        // world space bounds of the cube mesh, only valid as there is no rotation
+        auto aabb() const -> ufps::AABB
+        {
+            return {.min = _transform.position - _transform.scale, .max = _transform.position + _transform.scale};
+        }
+
+    private:
+        std::vector<FakeRenderEntity> _render_entities;
+        ufps::Transform _transform;
+        std::uint32_t _version;
+    };
+
+    auto create_entities(const FakeMeshManager &mesh_manager) -> std::vector<FakeEntity>
+    {
+        auto entities = std::vector<FakeEntity>{};
+
+        for (auto y = 0u; y < 10u; ++y)
+        {
+            for (auto x = 0u; x < 10u; ++x)
+            {
+                const auto position = ufps::Vector3{static_cast<float>(x) * 4.f, static_cast<float>(y) * 4.f, -static_cast<float>((x + y) % 4u)};
+                entities.emplace_back(mesh_manager.cube(), position, 1.f + static_cast<float>((x * y) % 3u) * .4f);
+            }
+        }
+
+        return entities;
+    }
+
+    auto create_rays() -> std::vector<ufps::Ray>
+    {
+        auto rays = std::vector<ufps::Ray>{};
+
+        for (auto i = 0u; i < 20u; ++i)
+        {
+            for (auto j = 0u; j < 20u; ++j)
+            {
+                const auto x = static_cast<float>(i) * 2.1f - 2.f;
+                const auto y = static_cast<float>(j) * 2.1f - 2.f;
+                rays.emplace_back(ufps::Vector3{x, y, 20.f}, ufps::Vector3{.05f, -.03f, -1.f});
+                rays.emplace_back(ufps::Vector3{-20.f, y, x * .1f}, ufps::Vector3{1.f, .01f * static_cast<float>(i), -.02f});
+            }
+        }
+
+        return rays;
+    }
+
+    auto closest_entity(std::span<const FakeEntity> entities, const ufps::Ray &ray) -> std::optional<std::pair<std::uint32_t, float>>
+    {
+        auto result = std::optional<std::pair<std::uint32_t, float>>{};
+
+        for (const auto &[index, entity] : std::views::enumerate(entities))
+        {
+            if (const auto distance = ufps::intersect(ray, entity.aabb()); distance && (!result || *distance < result->second))
+            {
+                result = std::pair{static_cast<std::uint32_t>(index), *distance};
+            }
+        }
+
+        return result;
+    }
+
+    auto boxes_along_x(std::uint32_t count) -> std::vector<ufps::AABB>
+    {
+        return std::views::iota(0u, count) |
+               std::views::transform(
+                   [](const auto index)
+                   {
+                       const auto x = static_cast<float>(index) * 3.f;
+                       return ufps::AABB{.min = {x - .5f, -.5f, -.5f}, .max = {x + .5f, .5f, .5f}};
+                   }) |
+               std::ranges::to<std::vector>();
+    }
+
+    auto intersect_boxes(const ufps::Bvh &bvh, std::span<const ufps::AABB> boxes, const ufps::Ray &ray, std::uint32_t &hit_index)
+        -> std::optional<float>
+    {
+        return bvh.intersect(
+            ray,
+            std::numeric_limits<float>::infinity(),
+            [&](const auto index, const auto max_distance) -> std::optional<float>
+            {
+                const auto distance = ufps::intersect(ray, boxes[index]);
+                if (distance && *distance < max_distance)
+                {
+                    hit_index = index;
+                }
+
+                return distance;
+            });
+    }
+}
+
+TEST(bvh, empty_has_no_hits)
+{
+    const auto bvh = ufps::Bvh{};
+
+    ASSERT_FALSE(bvh.intersect(ufps::Ray{{0.f}, {1.f, 0.f, 0.f}}, 100.f, [](auto, auto) { return std::optional{0.f}; }));
+}
+
+TEST(bvh, leaves_cover_every_primitive_once)
+{
+    const auto boxes = boxes_along_x(100u);
+    const auto bvh = ufps::Bvh{boxes};
+
+    auto primitives = bvh.primitives() | std::ranges::to<std::vector>();
+    std::ranges::sort(primitives);
+    ASSERT_EQ(primitives, std::views::iota(0u, 100u) | std::ranges::to<std::vector>());
+
+    auto leaf_primitives = 0u;
+    for (const auto &node : bvh.nodes())
+    {
+        ASSERT_LE(node.count, ufps::Bvh::max_leaf_size);
+        leaf_primitives += node.count;
+    }
+
+    ASSERT_EQ(leaf_primitives, 100u);
+}
+
+TEST(bvh, closest_primitive_is_hit)
+{
+    const auto boxes = boxes_along_x(100u);
+    const auto bvh = ufps::Bvh{boxes};
+
+    auto hit_index = 0u;
+
+    const auto forward = intersect_boxes(bvh, boxes, ufps::Ray{{-10.f, 0.f, 0.f}, {1.f, 0.f, 0.f}}, hit_index);
+    ASSERT_TRUE(forward.has_value());
+    ASSERT_NEAR(*forward, 9.5f, 0.0001f);
+    ASSERT_EQ(hit_index, 0u);
+
+    const auto backward = intersect_boxes(bvh, boxes, ufps::Ray{{1000.f, 0.f, 0.f}, {-1.f, 0.f, 0.f}}, hit_index);
+    ASSERT_TRUE(backward.has_value());
+    ASSERT_EQ(hit_index, 99u);
+
+    ASSERT_FALSE(intersect_boxes(bvh, boxes, ufps::Ray{{-10.f, 5.f, 0.f}, {1.f, 0.f, 0.f}}, hit_index).has_value());
+}
+
+TEST(bvh, refit_follows_moved_primitives)
+{
+    auto boxes = boxes_along_x(100u);
+    auto bvh = ufps::Bvh{boxes};
+
+    boxes[0] = {.min = {-.5f, 9.5f, -.5f}, .max = {.5f, 10.5f, .5f}};
+    bvh.refit(boxes);
+
+    auto hit_index = 0u;
+
+    ASSERT_TRUE(intersect_boxes(bvh, boxes, ufps::Ray{{-10.f, 0.f, 0.f}, {1.f, 0.f, 0.f}}, hit_index).has_value());
+    ASSERT_EQ(hit_index, 1u);
+
+    ASSERT_TRUE(intersect_boxes(bvh, boxes, ufps::Ray{{-10.f, 10.f, 0.f}, {1.f, 0.f, 0.f}}, hit_index).has_value());
+    ASSERT_EQ(hit_index, 0u);
+}
+
+TEST(bvh, blas_matches_brute_force)
+{
+    // bumpy 32x32 grid of quads in the xy plane
+    const auto height = [](float x, float y) { return std::sin(x) * std::cos(y); };
+
+    auto triangles = std::vector<ufps::Triangle>{};
+    for (auto y = 0u; y < 32u; ++y)
+    {
+        for (auto x = 0u; x < 32u; ++x)
+        {
+            const auto corner = [&](std::uint32_t cx, std::uint32_t cy)
+            {
+                const auto fx = static_cast<float>(cx) * .5f;
+                const auto fy = static_cast<float>(cy) * .5f;
+                return ufps::Vector3{fx, fy, height(fx, fy)};
+            };
+
+            triangles.push_back({corner(x, y), corner(x + 1u, y), corner(x + 1u, y + 1u)});
+            triangles.push_back({corner(x, y), corner(x + 1u, y + 1u), corner(x, y + 1u)});
+        }
+    }
+
+    const auto blas = ufps::Blas{triangles};
+    ASSERT_EQ(blas.triangle_count(), triangles.size());
+
+    for (const auto &ray : create_rays())
+    {
+        auto expected = std::optional<float>{};
+        for (const auto &triangle : triangles)
+        {
+            if (const auto distance = ufps::intersect(ray, triangle.v0, triangle.v1, triangle.v2); distance && (!expected || *distance < *expected))
+            {
+                expected = distance;
+            }
+        }
+
+        const auto actual = blas.intersect(ray);
+
+        ASSERT_EQ(actual.has_value(), expected.has_value());
+        if (expected)
+        {
+            ASSERT_FLOAT_EQ(*actual, *expected);
+        }
+    }
+}
+
+TEST(scene_bvh, blas_shared_between_entities)
+{
+    const auto mesh_manager = FakeMeshManager{};
+    const auto entities = create_entities(mesh_manager);
+
+    auto bvh = ufps::SceneBvh{};
+    bvh.update(entities, 0u, mesh_manager);
+
+    ASSERT_EQ(bvh.blas_count(), 1u);
+    ASSERT_EQ(bvh.instance_count(), entities.size());
+}
+
+TEST(scene_bvh, matches_linear_search)
+{
+    const auto mesh_manager = FakeMeshManager{};
+    const auto entities = create_entities(mesh_manager);
+
+    auto bvh = ufps::SceneBvh{};
+    bvh.update(entities, 0u, mesh_manager);
+
+    auto hits = 0u;
+
+    for (const auto &ray : create_rays())
+    {
+        const auto expected = closest_entity(entities, ray);
+        const auto actual = bvh.intersect_ray(ray);
+
+        ASSERT_EQ(actual.has_value(), expected.has_value());
+        if (expected)
+        {
+            ASSERT_EQ(actual->entity_index, expected->first);
+            ASSERT_NEAR(actual->distance, expected->second, 0.001f);
+
+            const auto position = ray.origin + ray.direction * expected->second;
+            ASSERT_NEAR(actual->position.x, position.x, 0.001f);
+            ASSERT_NEAR(actual->position.y, position.y, 0.001f);
+            ASSERT_NEAR(actual->position.z, position.z, 0.001f);
+            ++hits;
+        }
+    }
+
+    ASSERT_GT(hits, 0u);
+}
+
+TEST(scene_bvh, refit_after_move)
+{
+    const auto mesh_manager = FakeMeshManager{};
+    auto entities = create_entities(mesh_manager);
+
+    auto bvh = ufps::SceneBvh{};
+    bvh.update(entities, 0u, mesh_manager);
+
+    const auto ray = ufps::Ray{{100.f, 100.f, 20.f}, {0.f, 0.f, -1.f}};
+    ASSERT_FALSE(bvh.intersect_ray(ray).has_value());
+
+    entities[42].set_position({100.f, 100.f, 0.f});
+    bvh.update(entities, 0u, mesh_manager);
+
+    const auto hit = bvh.intersect_ray(ray);
+    ASSERT_TRUE(hit.has_value());
+    ASSERT_EQ(hit->entity_index, 42u);
+    ASSERT_NEAR(hit->distance, 20.f - entities[42].transform().scale.z, 0.001f);
+}
+
+TEST(scene_bvh, rebuild_on_revision_change)
+{
+    const auto mesh_manager = FakeMeshManager{};
+    auto entities = create_entities(mesh_manager);
+
+    auto bvh = ufps::SceneBvh{};
+    bvh.update(entities, 0u, mesh_manager);
+
+    entities.emplace_back(mesh_manager.cube(), ufps::Vector3{-100.f, 0.f, 0.f}, 1.f);
+    bvh.update(entities, 1u, mesh_manager);
+
+    ASSERT_EQ(bvh.instance_count(), entities.size());
+    ASSERT_EQ(bvh.blas_count(), 1u);
+
+    const auto hit = bvh.intersect_ray(ufps::Ray{{-100.f, 0.f, 20.f}, {0.f, 0.f, -1.f}});
+    ASSERT_TRUE(hit.has_value());
+    ASSERT_EQ(hit->entity_index, entities.size() - 1u);
+}
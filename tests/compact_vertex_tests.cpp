@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <ranges>
+#include <vector>
+
+#include "graphics/compact_vertex.h"
+#include "graphics/vertex_data.h"
+#include "math/vector3.h"
+
+namespace
+{
+    // largest angle between an encoded direction and its decoded one, in radians, snorm16 octahedral measures at about
+    // 6.5e-5 and the snorm15 tangent at about 1e-4
+    constexpr auto max_normal_error = 1e-4f;
+    constexpr auto max_tangent_error = 1.5e-4f;
+
+    // atan2 rather than acos of the dot product, which has no precision left for angles this small
+    auto angle(const ufps::Vector3 &a, const ufps::Vector3 &b) -> float
+    {
+        return std::atan2(ufps::Vector3::cross(a, b).length(), ufps::Vector3::dot(a, b));
+    }
+
+    // includes the axes and the octahedron's folds, which are where encoding goes wrong
+    auto directions() -> std::vector<ufps::Vector3>
+    {
+        auto result = std::vector<ufps::Vector3>{
+            {1.0f, 0.0f, 0.0f},
+            {-1.0f, 0.0f, 0.0f},
+            {0.0f, 1.0f, 0.0f},
+            {0.0f, -1.0f, 0.0f},
+            {0.0f, 0.0f, 1.0f},
+            {0.0f, 0.0f, -1.0f},
+            {1.0f, 1.0f, 0.0f},
+            {-1.0f, 1.0f, -1.0f},
+            {0.5f, -1.0f, -0.001f},
+        };
+
+        auto rng = std::mt19937{3u};
+        auto dist = std::normal_distribution<float>{};
+        for (auto i = 0; i < 2000; ++i)
+        {
+            result.push_back({dist(rng), dist(rng), dist(rng)});
+        }
+
+        return result | std::views::transform([](const auto &v) { return ufps::Vector3::normalize(v); }) | std::ranges::to<std::vector>();
+    }
+
+    // any vector perpendicular to v
+    auto perpendicular(const ufps::Vector3 &v) -> ufps::Vector3
+    {
+        const auto other = std::abs(v.x) < 0.9f ? ufps::Vector3{1.0f, 0.0f, 0.0f} : ufps::Vector3{0.0f, 1.0f, 0.0f};
+        return ufps::Vector3::normalize(ufps::Vector3::cross(v, other));
+    }
+}
+
+TEST(compact_vertex, less_than_half_the_size)
+{
+    ASSERT_LT(sizeof(ufps::CompactVertex) * 2zu, sizeof(ufps::VertexData));
+}
+
+TEST(compact_vertex, octahedral_round_trip)
+{
+    for (const auto &direction : directions())
+    {
+        const auto [x, y] = ufps::impl::octahedral_encode(direction);
+
+        ASSERT_LE(std::abs(x), 1.0f);
+        ASSERT_LE(std::abs(y), 1.0f);
+        ASSERT_LT(angle(ufps::impl::octahedral_decode(x, y), direction), 1e-5f);
+    }
+}
+
+TEST(compact_vertex, snorm_round_trip)
+{
+    for (const auto bits : {15u, 16u})
+    {
+        const auto step = 1.0f / static_cast<float>((1u << (bits - 1u)) - 1u);
+
+        ASSERT_EQ(ufps::impl::from_snorm(ufps::impl::to_snorm(1.0f, bits), bits), 1.0f);
+        ASSERT_EQ(ufps::impl::from_snorm(ufps::impl::to_snorm(-1.0f, bits), bits), -1.0f);
+        ASSERT_EQ(ufps::impl::from_snorm(ufps::impl::to_snorm(0.0f, bits), bits), 0.0f);
+        ASSERT_EQ(ufps::impl::from_snorm(ufps::impl::to_snorm(5.0f, bits), bits), 1.0f);
+
+        for (auto v = -1.0f; v <= 1.0f; v += 0.0137f)
+        {
+            ASSERT_NEAR(ufps::impl::from_snorm(ufps::impl::to_snorm(v, bits), bits), v, step * 0.5f + 1e-7f);
+        }
+    }
+}
+
+TEST(compact_vertex, vertex_round_trip)
+{
+    auto rng = std::mt19937{11u};
+    auto uv_dist = std::uniform_real_distribution<float>{-4.0f, 4.0f};
+
+    for (const auto &[index, normal] : std::views::enumerate(directions()))
+    {
+        const auto tangent = perpendicular(normal);
+        const auto handedness = index % 2 == 0 ? 1.0f : -1.0f;
+
+        const auto vertex = ufps::VertexData{
+            .position = {static_cast<float>(index) * 0.37f, -12.5f, 1e6f},
+            .normal = normal,
+            .tangent = tangent,
+            .bitangent = ufps::Vector3::cross(normal, tangent) * handedness,
+            .uv = {uv_dist(rng), uv_dist(rng)},
+        };
+
+        const auto decoded = ufps::decode_vertex(ufps::encode_vertex(vertex));
+
+        ASSERT_EQ(decoded.position, vertex.position);
+        ASSERT_LT(angle(decoded.normal, vertex.normal), max_normal_error);
+        ASSERT_LT(angle(decoded.tangent, vertex.tangent), max_tangent_error);
+        ASSERT_LT(angle(decoded.bitangent, vertex.bitangent), max_normal_error + max_tangent_error);
+
+        // half precision keeps 11 significant bits
+        ASSERT_NEAR(decoded.uv.s, vertex.uv.s, std::abs(vertex.uv.s) / 2048.0f + 1e-7f);
+        ASSERT_NEAR(decoded.uv.t, vertex.uv.t, std::abs(vertex.uv.t) / 2048.0f + 1e-7f);
+    }
+}
+
+TEST(compact_vertex, exact_uvs)
+{
+    for (const auto uv : {0.0f, 0.25f, 0.5f, 1.0f, 2.0f, -3.0f})
+    {
+        const auto vertex = ufps::VertexData{
+            .position = {},
+            .normal = {0.0f, 0.0f, 1.0f},
+            .tangent = {1.0f, 0.0f, 0.0f},
+            .bitangent = {0.0f, 1.0f, 0.0f},
+            .uv = {uv, 1.0f - uv},
+        };
+
+        const auto decoded = ufps::decode_vertex(ufps::encode_vertex(vertex));
+
+        ASSERT_EQ(decoded.uv.s, uv);
+        ASSERT_EQ(decoded.uv.t, 1.0f - uv);
+    }
+}
+
+TEST(compact_vertex, degenerate_frame)
+{
+    // the full screen sprite has no meaningful normal or tangent, decoding must still give finite unit vectors
+    const auto vertex = ufps::VertexData{
+        .position = {1.0f, -1.0f, 0.0f},
+        .normal = {},
+        .tangent = {},
+        .bitangent = {},
+        .uv = {1.0f, 0.0f},
+    };
+
+    const auto decoded = ufps::decode_vertex(ufps::encode_vertex(vertex));
+
+    ASSERT_EQ(decoded.position, vertex.position);
+    ASSERT_NEAR(decoded.normal.length(), 1.0f, 1e-6f);
+    ASSERT_NEAR(decoded.tangent.length(), 1.0f, 1e-6f);
+    ASSERT_FALSE(std::isnan(decoded.bitangent.x));
+}
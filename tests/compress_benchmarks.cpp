@@ -0,0 +1,111 @@
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "utils/compress.h"
+#include "utils/data_buffer.h"
+#include "utils/decompress.h"
+
+namespace
+{
+    // smooth floats, like a vertex blob
+    auto blob(std::size_t size) -> ufps::DataBuffer
+    {
+        auto data = std::vector<float>(size / sizeof(float));
+        for (auto i = 0zu; i < data.size(); ++i)
+        {
+            data[i] = std::sin(static_cast<float>(i) * .001f);
+        }
+
+        const auto bytes = std::as_bytes(std::span{data});
+        return {bytes.begin(), bytes.end()};
+    }
+
+    // stand in for the upload, every byte gets read once
+    auto consume(ufps::DataBufferView data) -> std::uint64_t
+    {
+        auto sum = std::uint64_t{};
+        for (const auto b : data)
+        {
+            sum += std::to_underlying(b);
+        }
+
+        return sum;
+    }
+
+    auto compressed_blob(std::size_t size) -> const ufps::DataBuffer &
+    {
+        static auto cache = std::vector<std::pair<std::size_t, ufps::DataBuffer>>{};
+
+        for (const auto &[cached_size, data] : cache)
+        {
+            if (cached_size == size)
+            {
+                return data;
+            }
+        }
+
+        return cache.emplace_back(size, ufps::compress(blob(size))).second;
+    }
+}
+
+static void decompress_whole(benchmark::State &state)
+{
+    const auto size = static_cast<std::size_t>(state.range(0)) * 1024zu * 1024zu;
+    const auto &compressed = compressed_blob(size);
+
+    for (auto _ : state)
+    {
+        const auto data = ufps::decompress(compressed);
+        benchmark::DoNotOptimize(consume(data));
+    }
+
+    // the whole output is live at once on top of the compressed input
+    state.counters["peak_bytes"] = static_cast<double>(size);
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * size));
+}
+
+static void decompress_streaming(benchmark::State &state)
+{
+    const auto size = static_cast<std::size_t>(state.range(0)) * 1024zu * 1024zu;
+    const auto &compressed = compressed_blob(size);
+
+    auto decompressor = ufps::Decompressor{};
+
+    for (auto _ : state)
+    {
+        auto sum = std::uint64_t{};
+        decompressor.reset();
+        decompressor.decompress(compressed, [&](ufps::DataBufferView chunk) { sum += consume(chunk); });
+        benchmark::DoNotOptimize(sum);
+    }
+
+    // only the zstd window and one chunk are ever live, whatever the size
+    state.counters["peak_bytes"] = static_cast<double>(decompressor.memory_usage());
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * size));
+}
+
+static void compress_level(benchmark::State &state)
+{
+    const auto data = blob(16zu * 1024zu * 1024zu);
+    const auto options = ufps::CompressOptions{.level = static_cast<std::int32_t>(state.range(0)), .long_distance_matching = state.range(1) != 0};
+
+    auto compressed_size = 0zu;
+
+    for (auto _ : state)
+    {
+        compressed_size = ufps::compress(data, options).size();
+    }
+
+    state.counters["ratio"] = static_cast<double>(data.size()) / static_cast<double>(compressed_size);
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * data.size()));
+}
+
+BENCHMARK(decompress_whole)->ArgName("MiB")->Arg(16)->Arg(128)->Unit(benchmark::kMillisecond);
+BENCHMARK(decompress_streaming)->ArgName("MiB")->Arg(16)->Arg(128)->Unit(benchmark::kMillisecond);
+BENCHMARK(compress_level)->ArgNames({"level", "ldm"})->ArgsProduct({{1, 9, 19}, {0, 1}})->Unit(benchmark::kMillisecond);
@@ -0,0 +1,262 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <ranges>
+#include <span>
+#include <vector>
+
+#include "utils/compress.h"
+#include "utils/data_buffer.h"
+#include "utils/decompress.h"
+#include "utils/exception.h"
+
+namespace
+{
+    auto compressible(std::size_t size) -> ufps::DataBuffer
+    {
+        return std::views::iota(0zu, size) |
+               std::views::transform([](const auto i) { return static_cast<std::byte>((i / 3zu) % 11zu); }) |
+               std::ranges::to<ufps::DataBuffer>();
+    }
+
+    auto incompressible(std::size_t size) -> ufps::DataBuffer
+    {
+        auto rng = std::mt19937{42u};
+        return std::views::iota(0zu, size) |
+               std::views::transform([&rng](const auto) { return static_cast<std::byte>(rng()); }) |
+               std::ranges::to<ufps::DataBuffer>();
+    }
+
+    // a frame with no content size in its header, as written by a Compressor that was never told the size
+    auto compress_streamed(ufps::DataBufferView data, const ufps::CompressOptions &options = {}) -> ufps::DataBuffer
+    {
+        auto compressed = ufps::DataBuffer{};
+        const auto append = [&](ufps::DataBufferView chunk) { compressed.insert(compressed.end(), chunk.begin(), chunk.end()); };
+
+        auto compressor = ufps::Compressor{options, 1'000zu};
+        compressor.compress(data, append);
+        compressor.finish(append);
+
+        return compressed;
+    }
+
+    auto decompress_chunks(ufps::DataBufferView data, std::size_t chunk_size) -> std::vector<ufps::DataBuffer>
+    {
+        auto chunks = std::vector<ufps::DataBuffer>{};
+        ufps::decompress(data, chunk_size, [&](ufps::DataBufferView chunk) { chunks.emplace_back(chunk.begin(), chunk.end()); });
+
+        return chunks;
+    }
+
+    auto join(const std::vector<ufps::DataBuffer> &chunks) -> ufps::DataBuffer
+    {
+        return chunks | std::views::join | std::ranges::to<ufps::DataBuffer>();
+    }
+}
+
+TEST(compress, round_trip)
+{
+    const auto data = compressible(100'000zu);
+    const auto compressed = ufps::compress(data);
+
+    ASSERT_LT(compressed.size(), data.size());
+    ASSERT_EQ(ufps::decompress(compressed), data);
+}
+
+TEST(compress, options_round_trip)
+{
+    // the same incompressible block twice, far enough apart that only long distance matching finds the repeat
+    const auto block = incompressible(1024zu * 1024zu);
+    auto data = block;
+    data.insert(data.end(), block.begin(), block.end());
+
+    const auto compressed = ufps::compress(data, {.level = 3, .long_distance_matching = true, .window_log = 0u});
+    ASSERT_LT(compressed.size(), data.size() * 3zu / 4zu);
+    ASSERT_EQ(ufps::decompress(compressed), data);
+
+    const auto streamed = compress_streamed(data, {.level = 3, .long_distance_matching = true, .window_log = 0u});
+    ASSERT_LT(streamed.size(), data.size() * 3zu / 4zu);
+    ASSERT_EQ(ufps::decompress(streamed), data);
+}
+
+TEST(compress, compressor_content_size)
+{
+    const auto data = compressible(10'000zu);
+
+    auto compressed = ufps::DataBuffer{};
+    const auto append = [&](ufps::DataBufferView chunk) { compressed.insert(compressed.end(), chunk.begin(), chunk.end()); };
+
+    auto compressor = ufps::Compressor{};
+    compressor.set_content_size(data.size());
+    compressor.compress(data, append);
+    compressor.finish(append);
+
+    auto destination = ufps::DataBuffer(data.size());
+    ufps::decompress(compressed, destination);
+
+    ASSERT_EQ(destination, data);
+}
+
+TEST(compress, compressor_chunks_bounded)
+{
+    const auto data = incompressible(10'000zu);
+
+    auto chunk_sizes = std::vector<std::size_t>{};
+    const auto record = [&](ufps::DataBufferView chunk) { chunk_sizes.push_back(chunk.size()); };
+
+    auto compressor = ufps::Compressor{{}, 100zu};
+    compressor.compress(data, record);
+    compressor.finish(record);
+
+    ASSERT_GT(chunk_sizes.size(), 1zu);
+    ASSERT_TRUE(std::ranges::all_of(chunk_sizes, [](const auto size) { return size != 0zu && size <= 100zu; }));
+}
+
+TEST(compress, compressor_reuse)
+{
+    const auto first = compressible(5'000zu);
+    const auto second = incompressible(5'000zu);
+
+    auto compressor = ufps::Compressor{};
+
+    for (const auto &data : {first, second})
+    {
+        auto compressed = ufps::DataBuffer{};
+        const auto append = [&](ufps::DataBufferView chunk) { compressed.insert(compressed.end(), chunk.begin(), chunk.end()); };
+
+        compressor.compress(data, append);
+        compressor.finish(append);
+
+        ASSERT_EQ(ufps::decompress(compressed), data);
+    }
+}
+
+TEST(compress, decompress_unknown_content_size)
+{
+    const auto data = compressible(300'000zu);
+    const auto compressed = compress_streamed(data);
+
+    ASSERT_EQ(ufps::decompress(compressed), data);
+}
+
+TEST(compress, chunk_boundaries)
+{
+    const auto chunk_size = 4'096zu;
+
+    for (const auto size : {0zu, 1zu, chunk_size - 1zu, chunk_size, chunk_size + 1zu, chunk_size * 10zu, chunk_size * 10zu + 1zu})
+    {
+        const auto data = compressible(size);
+        const auto chunks = decompress_chunks(ufps::compress(data), chunk_size);
+
+        ASSERT_EQ(chunks.size(), (size + chunk_size - 1zu) / chunk_size) << size;
+        for (const auto &chunk : chunks | std::views::take(chunks.size() - std::min(chunks.size(), 1zu)))
+        {
+            ASSERT_EQ(chunk.size(), chunk_size) << size;
+        }
+
+        ASSERT_EQ(join(chunks), data) << size;
+    }
+}
+
+TEST(compress, single_byte_chunks)
+{
+    const auto data = compressible(1'000zu);
+    const auto chunks = decompress_chunks(ufps::compress(data), 1zu);
+
+    ASSERT_EQ(chunks.size(), data.size());
+    ASSERT_EQ(join(chunks), data);
+}
+
+TEST(compress, decompressor_fed_byte_by_byte)
+{
+    const auto data = compressible(50'000zu);
+    const auto compressed = compress_streamed(data);
+
+    auto chunks = std::vector<ufps::DataBuffer>{};
+    auto decompressor = ufps::Decompressor{1'000zu};
+
+    for (auto i = 0zu; i < compressed.size(); ++i)
+    {
+        ASSERT_FALSE(decompressor.finished());
+        decompressor.decompress(
+            ufps::DataBufferView{compressed}.subspan(i, 1zu),
+            [&](ufps::DataBufferView chunk) { chunks.emplace_back(chunk.begin(), chunk.end()); });
+    }
+
+    ASSERT_TRUE(decompressor.finished());
+    ASSERT_EQ(chunks.size(), 50zu);
+    ASSERT_EQ(join(chunks), data);
+}
+
+TEST(compress, decompressor_into_destination)
+{
+    const auto data = compressible(50'000zu);
+    const auto compressed = compress_streamed(data);
+
+    auto destination = ufps::DataBuffer(data.size());
+    auto decompressor = ufps::Decompressor{};
+    auto written = 0zu;
+
+    for (auto offset = 0zu; offset < compressed.size(); offset += 333zu)
+    {
+        const auto piece = ufps::DataBufferView{compressed}.subspan(offset, std::min(333zu, compressed.size() - offset));
+        written += decompressor.decompress(piece, destination);
+    }
+
+    ASSERT_TRUE(decompressor.finished());
+    ASSERT_EQ(written, data.size());
+    ASSERT_EQ(destination, data);
+}
+
+TEST(compress, decompressor_reset)
+{
+    const auto data = compressible(10'000zu);
+    const auto compressed = ufps::compress(data);
+
+    auto decompressor = ufps::Decompressor{};
+    auto destination = ufps::DataBuffer(data.size());
+
+    decompressor.decompress(ufps::DataBufferView{compressed}.first(compressed.size() / 2zu), destination);
+    ASSERT_FALSE(decompressor.finished());
+
+    decompressor.reset();
+
+    ASSERT_EQ(decompressor.decompress(compressed, destination), data.size());
+    ASSERT_TRUE(decompressor.finished());
+    ASSERT_EQ(destination, data);
+}
+
+TEST(compress, memory_usage_bounded)
+{
+    const auto data = compressible(4zu * 1024zu * 1024zu);
+    const auto compressed = compress_streamed(data);
+
+    auto decompressor = ufps::Decompressor{ufps::decompress_chunk_size};
+    decompressor.decompress(compressed, [](ufps::DataBufferView) {});
+
+    ASSERT_TRUE(decompressor.finished());
+    ASSERT_LT(decompressor.memory_usage(), data.size() / 2zu);
+}
+
+TEST(compress, errors)
+{
+    const auto data = compressible(10'000zu);
+    const auto compressed = ufps::compress(data);
+
+    auto too_small = ufps::DataBuffer(data.size() - 1zu);
+    ASSERT_THROW(ufps::decompress(compressed, too_small), ufps::Exception);
+    ASSERT_THROW(ufps::Decompressor{}.decompress(compressed, too_small), ufps::Exception);
+
+    const auto truncated = ufps::DataBufferView{compressed}.first(compressed.size() - 1zu);
+    ASSERT_THROW(ufps::decompress(truncated, 100zu, [](ufps::DataBufferView) {}), ufps::Exception);
+
+    auto trailing = compressed;
+    trailing.push_back(std::byte{0});
+    ASSERT_THROW(ufps::decompress(trailing, 100zu, [](ufps::DataBufferView) {}), ufps::Exception);
+
+    const auto garbage = incompressible(100zu);
+    ASSERT_THROW(ufps::decompress(garbage), ufps::Exception);
+    ASSERT_THROW(ufps::decompress(garbage, 100zu, [](ufps::DataBufferView) {}), ufps::Exception);
+}
@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <limits>
+#include <numbers>
+#include <span>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "core/camera.h"
+#include "graphics/culling.h"
+#include "math/aabb.h"
+#include "math/transform.h"
+
+namespace
+{
+    class FakeRenderEntity
+    {
+    public:
+        FakeRenderEntity(const ufps::AABB &aabb, float opacity = 1.f)
+            : _aabb{aabb},
+              _opacity{opacity}
+        {
+        }
+
+        auto aabb() const -> const ufps::AABB &
+        {
+            return _aabb;
+        }
+
+        auto opacity() const -> float
+        {
+            return _opacity;
+        }
+
+    private:
+        ufps::AABB _aabb;
+        float _opacity;
+    };
+
+    class FakeEntity
+    {
+    public:
+        FakeEntity(std::vector<FakeRenderEntity> render_entities, const ufps::Vector3 &position)
+            : _render_entities{std::move(render_entities)},
+              _transform{position, {1.f}, {}},
+              _aabb{.min = {std::numeric_limits<float>::max()}, .max = {std::numeric_limits<float>::lowest()}}
+        {
+            for (const auto &e : _render_entities)
+            {
+                _aabb.min = {std::min(_aabb.min.x, e.aabb().min.x), std::min(_aabb.min.y, e.aabb().min.y), std::min(_aabb.min.z, e.aabb().min.z)};
+                _aabb.max = {std::max(_aabb.max.x, e.aabb().max.x), std::max(_aabb.max.y, e.aabb().max.y), std::max(_aabb.max.z, e.aabb().max.z)};
+            }
+        }
+
+        auto render_entities() const -> std::span<const FakeRenderEntity>
+        {
+            return _render_entities;
+        }
+
+        auto transform() const -> const ufps::Transform &
+        {
+            return _transform;
+        }
+
+        auto aabb() const -> const ufps::AABB &
+        {
+            return _aabb;
+        }
+
+    private:
+        std::vector<FakeRenderEntity> _render_entities;
+        ufps::Transform _transform;
+        ufps::AABB _aabb;
+    };
+
+    auto create_frustum() -> ufps::Frustum
+    {
+        return ufps::Camera{
+            {0.f, 0.f, 0.f},
+            {0.f, 0.f, -1.f},
+            {0.f, 1.f, 0.f},
+            std::numbers::pi_v<float> / 4.f,
+            1920.f,
+            1080.f,
+            0.1f,
+            100.f}
+            .frustum();
+    }
+
+    const auto unit_box = ufps::AABB{.min = {-1.f}, .max = {1.f}};
+}
+
+TEST(culling, empty_scene)
+{
+    const auto result = ufps::cull(std::vector<FakeEntity>{}, create_frustum(), ufps::EntityFilterMode::ALL);
+
+    ASSERT_TRUE(result.draws.empty());
+    ASSERT_EQ(result.stats.visible_draws, 0u);
+    ASSERT_EQ(result.stats.culled_draws, 0u);
+}
+
+TEST(culling, entity_behind_camera_is_culled)
+{
+    const auto entities = std::vector<FakeEntity>{
+        {{{unit_box}, {unit_box}}, {0.f, 0.f, -10.f}},
+        {{{unit_box}, {unit_box}, {unit_box}}, {0.f, 0.f, 10.f}},
+    };
+
+    const auto result = ufps::cull(entities, create_frustum(), ufps::EntityFilterMode::ALL);
+
+    ASSERT_EQ(result.draws.size(), 2zu);
+    ASSERT_EQ(result.draws[0].entity_index, 0u);
+    ASSERT_EQ(result.draws[0].render_entity_index, 0u);
+    ASSERT_EQ(result.draws[1].entity_index, 0u);
+    ASSERT_EQ(result.draws[1].render_entity_index, 1u);
+
+    ASSERT_EQ(result.stats.visible_entities, 1u);
+    ASSERT_EQ(result.stats.culled_entities, 1u);
+    ASSERT_EQ(result.stats.visible_draws, 2u);
+    ASSERT_EQ(result.stats.culled_draws, 3u);
+}
+
+TEST(culling, render_entities_culled_individually)
+{
+    // entity bounds straddle the left plane but only one of its render entities is inside
+    const auto entities = std::vector<FakeEntity>{
+        {{{{.min = {-1.f}, .max = {1.f}}}, {{.min = {-80.f, -1.f, -1.f}, .max = {-78.f, 1.f, 1.f}}}}, {0.f, 0.f, -10.f}},
+    };
+
+    const auto result = ufps::cull(entities, create_frustum(), ufps::EntityFilterMode::ALL);
+
+    ASSERT_EQ(result.draws.size(), 1zu);
+    ASSERT_EQ(result.draws[0].render_entity_index, 0u);
+    ASSERT_EQ(result.stats.visible_entities, 1u);
+    ASSERT_EQ(result.stats.visible_draws, 1u);
+    ASSERT_EQ(result.stats.culled_draws, 1u);
+}
+
+TEST(culling, filter_mode)
+{
+    const auto entities = std::vector<FakeEntity>{
+        {{{unit_box, 1.f}, {unit_box, .5f}, {unit_box, 1.f}}, {0.f, 0.f, -10.f}},
+        {{{unit_box, .5f}}, {0.f, 0.f, -20.f}},
+    };
+
+    const auto opaque = ufps::cull(entities, create_frustum(), ufps::EntityFilterMode::OPAQUE);
+    ASSERT_EQ(opaque.draws.size(), 2zu);
+    ASSERT_EQ(opaque.draws[0].render_entity_index, 0u);
+    ASSERT_EQ(opaque.draws[1].render_entity_index, 2u);
+    ASSERT_EQ(opaque.stats.visible_entities, 1u);
+
+    const auto transparent = ufps::cull(entities, create_frustum(), ufps::EntityFilterMode::TRANSPARENT);
+    ASSERT_EQ(transparent.draws.size(), 2zu);
+    ASSERT_EQ(transparent.draws[0].entity_index, 0u);
+    ASSERT_EQ(transparent.draws[0].render_entity_index, 1u);
+    ASSERT_EQ(transparent.draws[1].entity_index, 1u);
+    ASSERT_EQ(transparent.draws[1].render_entity_index, 0u);
+    ASSERT_EQ(transparent.stats.visible_entities, 2u);
+}
+
+TEST(culling, entities_without_matching_render_entities_are_not_counted)
+{
+    const auto entities = std::vector<FakeEntity>{
+        {{{unit_box, 1.f}}, {0.f, 0.f, 10.f}},
+    };
+
+    const auto result = ufps::cull(entities, create_frustum(), ufps::EntityFilterMode::TRANSPARENT);
+
+    ASSERT_TRUE(result.draws.empty());
+    ASSERT_EQ(result.stats.visible_entities, 0u);
+    ASSERT_EQ(result.stats.culled_entities, 0u);
+    ASSERT_EQ(result.stats.culled_draws, 0u);
+}
@@ -0,0 +1,150 @@
+#include <numbers>
+
+#include <gtest/gtest.h>
+
+#include "core/camera.h"
+#include "math/aabb.h"
+#include "math/frustum.h"
+#include "math/matrix4.h"
+#include "math/quaternion.h"
+#include "math/transform.h"
+#include "math/utils.h"
+#include "math/vector3.h"
+
+namespace
+{
+    auto create_camera() -> ufps::Camera
+    {
+        // default yaw looks down -z regardless of the look at point
+        return {
+            {0.f, 0.f, 0.f},
+            {0.f, 0.f, -1.f},
+            {0.f, 1.f, 0.f},
+            std::numbers::pi_v<float> / 4.f,
+            1920.f,
+            1080.f,
+            0.1f,
+            100.f};
+    }
+
+    auto inside(const ufps::Frustum &frustum, const ufps::Vector3 &point) -> bool
+    {
+        for (const auto &plane : frustum.planes)
+        {
+            if (plane.distance_to(point) < 0.f)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+TEST(frustum, plane_from_points)
+{
+    const auto plane = ufps::Plane::from_points({0.f, 1.f, 0.f}, {0.f, 1.f, 1.f}, {1.f, 1.f, 0.f});
+
+    ASSERT_EQ(plane.normal, (ufps::Vector3{0.f, 1.f, 0.f}));
+    ASSERT_FLOAT_EQ(plane.distance, -1.f);
+    ASSERT_FLOAT_EQ(plane.distance_to({5.f, 3.f, -2.f}), 2.f);
+}
+
+TEST(frustum, planes_face_inwards)
+{
+    const auto frustum = create_camera().frustum();
+
+    ASSERT_TRUE(inside(frustum, {0.f, 0.f, -10.f}));
+    ASSERT_TRUE(inside(frustum, {0.f, 0.f, -99.f}));
+    ASSERT_FALSE(inside(frustum, {0.f, 0.f, 10.f}));
+    ASSERT_FALSE(inside(frustum, {0.f, 0.f, -0.05f}));
+    ASSERT_FALSE(inside(frustum, {0.f, 0.f, -101.f}));
+    ASSERT_FALSE(inside(frustum, {100.f, 0.f, -10.f}));
+    ASSERT_FALSE(inside(frustum, {-100.f, 0.f, -10.f}));
+    ASSERT_FALSE(inside(frustum, {0.f, 100.f, -10.f}));
+    ASSERT_FALSE(inside(frustum, {0.f, -100.f, -10.f}));
+}
+
+TEST(frustum, corners_lie_on_planes)
+{
+    const auto camera = create_camera();
+    const auto frustum = camera.frustum();
+
+    for (const auto &corner : camera.frustum_corners())
+    {
+        for (const auto &plane : frustum.planes)
+        {
+            ASSERT_GE(plane.distance_to(corner), -0.001f);
+        }
+    }
+}
+
+TEST(frustum, aabb_in_front_is_visible)
+{
+    const auto frustum = create_camera().frustum();
+
+    ASSERT_TRUE(ufps::intersect(frustum, ufps::AABB{.min = {-1.f, -1.f, -11.f}, .max = {1.f, 1.f, -9.f}}));
+}
+
+TEST(frustum, aabb_behind_is_culled)
+{
+    const auto frustum = create_camera().frustum();
+
+    ASSERT_FALSE(ufps::intersect(frustum, ufps::AABB{.min = {-1.f, -1.f, 9.f}, .max = {1.f, 1.f, 11.f}}));
+}
+
+TEST(frustum, aabb_outside_side_plane_is_culled)
+{
+    const auto frustum = create_camera().frustum();
+
+    ASSERT_FALSE(ufps::intersect(frustum, ufps::AABB{.min = {50.f, -1.f, -11.f}, .max = {52.f, 1.f, -9.f}}));
+}
+
+TEST(frustum, aabb_straddling_plane_is_visible)
+{
+    const auto frustum = create_camera().frustum();
+
+    ASSERT_TRUE(ufps::intersect(frustum, ufps::AABB{.min = {-1.f, -1.f, -1.f}, .max = {1.f, 1.f, 1.f}}));
+    ASSERT_TRUE(ufps::intersect(frustum, ufps::AABB{.min = {-1.f, -1.f, -150.f}, .max = {1.f, 1.f, -90.f}}));
+}
+
+TEST(frustum, aabb_containing_frustum_is_visible)
+{
+    const auto frustum = create_camera().frustum();
+
+    ASSERT_TRUE(ufps::intersect(frustum, ufps::AABB{.min = {-500.f}, .max = {500.f}}));
+}
+
+TEST(frustum, transform_aabb_translate)
+{
+    const auto aabb = ufps::AABB{.min = {-1.f}, .max = {1.f}};
+    const auto result = ufps::transform(aabb, ufps::Matrix4{ufps::Vector3{1.f, 2.f, 3.f}});
+
+    ASSERT_EQ(result.min, (ufps::Vector3{0.f, 1.f, 2.f}));
+    ASSERT_EQ(result.max, (ufps::Vector3{2.f, 3.f, 4.f}));
+}
+
+TEST(frustum, transform_aabb_scale)
+{
+    const auto aabb = ufps::AABB{.min = {-1.f, 0.f, 1.f}, .max = {1.f, 2.f, 3.f}};
+    const auto result = ufps::transform(aabb, ufps::Matrix4{ufps::Vector3{2.f, 3.f, -1.f}, ufps::Matrix4::Scale{}});
+
+    ASSERT_EQ(result.min, (ufps::Vector3{-2.f, 0.f, -3.f}));
+    ASSERT_EQ(result.max, (ufps::Vector3{2.f, 6.f, -1.f}));
+}
+
+TEST(frustum, transform_aabb_rotate)
+{
+    const auto half_angle = std::numbers::pi_v<float> / 4.f;
+    const auto rotation = ufps::Transform{{}, {1.f}, {{0.f, std::sin(half_angle), 0.f}, std::cos(half_angle)}};
+
+    const auto aabb = ufps::AABB{.min = {-1.f, -2.f, -3.f}, .max = {1.f, 2.f, 3.f}};
+    const auto result = ufps::transform(aabb, rotation);
+
+    ASSERT_NEAR(result.min.x, -3.f, 0.0001f);
+    ASSERT_NEAR(result.min.y, -2.f, 0.0001f);
+    ASSERT_NEAR(result.min.z, -1.f, 0.0001f);
+    ASSERT_NEAR(result.max.x, 3.f, 0.0001f);
+    ASSERT_NEAR(result.max.y, 2.f, 0.0001f);
+    ASSERT_NEAR(result.max.z, 1.f, 0.0001f);
+}
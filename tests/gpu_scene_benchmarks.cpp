@@ -0,0 +1,332 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ranges>
+#include <span>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "concurrency/parallel_for.h"
+#include "concurrency/thread_pool.h"
+#include "graphics/instance_table.h"
+#include "graphics/mesh_view.h"
+#include "graphics/object_data.h"
+#include "math/aabb.h"
+#include "math/transform.h"
+
+namespace
+{
+    constexpr auto frames = 3zu;
+    constexpr auto render_entities_per_entity = 4u;
+
+    class FakeRenderEntity
+    {
+    public:
+        auto mesh_view() const -> ufps::MeshView
+        {
+            return {};
+        }
+
+        auto aabb() const -> ufps::AABB
+        {
+            return {.min = {-1.f}, .max = {1.f}};
+        }
+
+        auto albedo_texture_bindless_handle() const -> std::uint64_t
+        {
+            return 1u;
+        }
+
+        auto normal_texture_bindless_handle() const -> std::uint64_t
+        {
+            return 2u;
+        }
+
+        auto specular_texture_bindless_handle() const -> std::uint64_t
+        {
+            return 3u;
+        }
+
+        auto roughness_texture_bindless_handle() const -> std::uint64_t
+        {
+            return 4u;
+        }
+
+        auto ao_texture_bindless_handle() const -> std::uint64_t
+        {
+            return 5u;
+        }
+
+        auto emissive_texture_bindless_handle() const -> std::uint64_t
+        {
+            return 6u;
+        }
+
+        auto normal_compressed() const -> bool
+        {
+            return false;
+        }
+
+        auto opacity() const -> float
+        {
+            return 1.f;
+        }
+
+        auto emissive_intensity() const -> float
+        {
+            return 1.f;
+        }
+    };
+
+    class FakeEntity
+    {
+    public:
+        FakeEntity(float x)
+            : _render_entities(render_entities_per_entity),
+              _transform{{x, 0.f, 0.f}, {1.f}, {}},
+              _version{}
+        {
+        }
+
+        auto render_entities() const -> std::span<const FakeRenderEntity>
+        {
+            return _render_entities;
+        }
+
+        auto transform() const -> const ufps::Transform &
+        {
+            return _transform;
+        }
+
+        auto emissive_strength() const -> float
+        {
+            return 1.f;
+        }
+
+        auto version() const -> std::uint32_t
+        {
+            return _version;
+        }
+
+        auto translate(float x) -> void
+        {
+            _transform.position.x += x;
+            ++_version;
+        }
+
+    private:
+        std::vector<FakeRenderEntity> _render_entities;
+        ufps::Transform _transform;
+        std::uint32_t _version;
+    };
+
+    auto create_entities(std::int64_t render_entity_count) -> std::vector<FakeEntity>
+    {
+        return std::views::iota(0u, static_cast<std::uint32_t>(render_entity_count) / render_entities_per_entity) |
+               std::views::transform([](const auto index) { return FakeEntity{static_cast<float>(index)}; }) |
+               std::ranges::to<std::vector>();
+    }
+
+    // stand in for the persistently mapped, triple buffered object data buffer
+    struct MappedBuffer
+    {
+        MappedBuffer(std::size_t frame_size)
+            : data(frame_size * frames),
+              frame_size{frame_size},
+              frame_offset{}
+        {
+        }
+
+        auto write(std::span<const std::byte> src, std::size_t offset) -> void
+        {
+            std::memcpy(data.data() + frame_offset + offset, src.data(), src.size());
+        }
+
+        auto advance() -> void
+        {
+            frame_offset = (frame_offset + frame_size) % data.size();
+        }
+
+        std::vector<std::byte> data;
+        std::size_t frame_size;
+        std::size_t frame_offset;
+    };
+
+    // what the renderer used to do every frame: rebuild and copy the object data of every render entity
+    auto rebuild(const std::vector<FakeEntity> &entities, MappedBuffer &buffer) -> void
+    {
+        const auto object_data = entities |
+                                 std::views::transform(
+                                     [](const auto &entity)
+                                     {
+                                         return entity.render_entities() |
+                                                std::views::transform([&entity](const auto &e) { return ufps::create_object_data(entity, e); });
+                                     }) |
+                                 std::views::join |
+                                 std::ranges::to<std::vector>();
+
+        buffer.write(std::as_bytes(std::span{object_data}), 0zu);
+        buffer.advance();
+    }
+
+    // the same rebuild split across a pool, every entity writes its render entities straight to their slots
+    auto rebuild_parallel(
+        ufps::ThreadPool &pool,
+        const std::vector<FakeEntity> &entities,
+        const ufps::InstanceTable &table,
+        MappedBuffer &buffer) -> void
+    {
+        ufps::parallel_for(
+            pool,
+            0zu,
+            entities.size(),
+            256zu,
+            [&](const auto first, const auto last)
+            {
+                for (auto i = first; i < last; ++i)
+                {
+                    const auto &entity = entities[i];
+                    const auto slots = table.entity_slots(static_cast<std::uint32_t>(i));
+
+                    for (const auto &[index, render_entity] : std::views::enumerate(entity.render_entities()))
+                    {
+                        const auto object_data = ufps::create_object_data(entity, render_entity);
+                        buffer.write(
+                            std::as_bytes(std::span{&object_data, 1zu}),
+                            (slots.first + static_cast<std::size_t>(index)) * sizeof(ufps::ObjectData));
+                    }
+                }
+            });
+
+        buffer.advance();
+    }
+
+    // mirrors GpuScene::update, only slots that changed are rebuilt and copied into the current frame region
+    auto incremental(
+        const std::vector<FakeEntity> &entities,
+        ufps::InstanceTable &table,
+        ufps::FrameDirtySlots<frames> &dirty,
+        MappedBuffer &buffer) -> void
+    {
+        table.sync(entities, 0u);
+        dirty.mark(table.dirty());
+
+        for (const auto &range : dirty.current().ranges())
+        {
+            const auto object_data = std::views::iota(range.first, range.first + range.count) |
+                                     std::views::transform(
+                                         [&](const auto slot)
+                                         {
+                                             const auto owner = table.owner(slot);
+                                             const auto &entity = entities[owner.entity_index];
+                                             return ufps::create_object_data(entity, entity.render_entities()[owner.render_entity_index]);
+                                         }) |
+                                     std::ranges::to<std::vector>();
+
+            buffer.write(std::as_bytes(std::span{object_data}), range.first * sizeof(ufps::ObjectData));
+        }
+
+        table.clear_dirty();
+        dirty.clear_current();
+        dirty.advance();
+        buffer.advance();
+    }
+
+    auto moving_entities(benchmark::State &state, std::vector<FakeEntity> &entities, std::size_t frame) -> void
+    {
+        // one percent of entities move every frame
+        const auto stride = 100zu;
+        for (auto i = frame % stride; i < entities.size(); i += stride)
+        {
+            entities[i].translate(.1f);
+        }
+
+        benchmark::DoNotOptimize(entities.data());
+        state.counters["moving"] = static_cast<double>(entities.size() / stride);
+    }
+}
+
+static void object_data_rebuild(benchmark::State &state)
+{
+    const auto entities = create_entities(state.range(0));
+    auto buffer = MappedBuffer{state.range(0) * sizeof(ufps::ObjectData)};
+
+    for (auto _ : state)
+    {
+        rebuild(entities, buffer);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void object_data_rebuild_parallel(benchmark::State &state)
+{
+    auto pool = ufps::ThreadPool{static_cast<std::uint32_t>(state.range(1))};
+    const auto entities = create_entities(state.range(0));
+    auto buffer = MappedBuffer{state.range(0) * sizeof(ufps::ObjectData)};
+    auto table = ufps::InstanceTable{};
+    table.sync(entities, 0u);
+
+    for (auto _ : state)
+    {
+        rebuild_parallel(pool, entities, table, buffer);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void object_data_incremental_static(benchmark::State &state)
+{
+    const auto entities = create_entities(state.range(0));
+    auto buffer = MappedBuffer{state.range(0) * sizeof(ufps::ObjectData)};
+    auto table = ufps::InstanceTable{};
+    auto dirty = ufps::FrameDirtySlots<frames>{};
+
+    // get the initial upload into every frame region out of the way
+    for (auto i = 0zu; i < frames; ++i)
+    {
+        incremental(entities, table, dirty, buffer);
+    }
+
+    for (auto _ : state)
+    {
+        incremental(entities, table, dirty, buffer);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void object_data_incremental_moving(benchmark::State &state)
+{
+    auto entities = create_entities(state.range(0));
+    auto buffer = MappedBuffer{state.range(0) * sizeof(ufps::ObjectData)};
+    auto table = ufps::InstanceTable{};
+    auto dirty = ufps::FrameDirtySlots<frames>{};
+
+    for (auto i = 0zu; i < frames; ++i)
+    {
+        incremental(entities, table, dirty, buffer);
+    }
+
+    auto frame = 0zu;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        moving_entities(state, entities, frame++);
+        state.ResumeTiming();
+
+        incremental(entities, table, dirty, buffer);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(object_data_rebuild)->Arg(10'000)->Arg(100'000);
+BENCHMARK(object_data_rebuild_parallel)->ArgsProduct({{10'000, 100'000}, {1, 2, 4, 8}})->UseRealTime();
+BENCHMARK(object_data_incremental_static)->Arg(10'000)->Arg(100'000);
+BENCHMARK(object_data_incremental_moving)->Arg(10'000)->Arg(100'000);
@@ -0,0 +1,32 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <span>
+#include <string_view>
+
+#include "utils/hash.h"
+
+using namespace std::literals;
+
+TEST(hash, fnv1a_reference_values)
+{
+    static_assert(ufps::hash_string("") == 0xcbf29ce484222325ull);
+    static_assert(ufps::hash_string("a") == 0xaf63dc4c8601ec8cull);
+    static_assert(ufps::hash_string("foobar") == 0x85944171f73967e8ull);
+}
+
+TEST(hash, bytes_and_strings_agree)
+{
+    const auto str = "textures/wall_BaseColor.png"sv;
+
+    ASSERT_EQ(ufps::hash_bytes(std::as_bytes(std::span{str})), ufps::hash_string(str));
+}
+
+TEST(hash, combine_is_order_dependent)
+{
+    const auto a = ufps::hash_string("a");
+    const auto b = ufps::hash_string("b");
+
+    ASSERT_NE(ufps::hash_combine(a, b), ufps::hash_combine(b, a));
+    ASSERT_NE(ufps::hash_combine(a, b), a);
+}
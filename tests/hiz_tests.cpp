@@ -0,0 +1,168 @@
+#include <cstdint>
+#include <numbers>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "core/camera.h"
+#include "graphics/hiz.h"
+#include "math/aabb.h"
+#include "math/matrix4.h"
+#include "math/vector4.h"
+
+namespace
+{
+    auto create_camera() -> ufps::Camera
+    {
+        return {
+            {0.f, 0.f, 0.f},
+            {0.f, 0.f, -1.f},
+            {0.f, 1.f, 0.f},
+            std::numbers::pi_v<float> / 2.f,
+            64.f,
+            64.f,
+            0.1f,
+            100.f};
+    }
+
+    auto view_projection(const ufps::Camera &camera) -> ufps::Matrix4
+    {
+        return camera.data().projection * camera.data().view;
+    }
+
+    // depth buffer with a wall covering the left half of the screen at the given depth
+    auto create_depth(std::uint32_t width, std::uint32_t height, float wall_depth) -> std::vector<float>
+    {
+        auto depth = std::vector<float>(width * height, 1.f);
+        for (auto y = 0u; y < height; ++y)
+        {
+            for (auto x = 0u; x < width / 2u; ++x)
+            {
+                depth[y * width + x] = wall_depth;
+            }
+        }
+
+        return depth;
+    }
+
+    // depth of a point straight ahead of the camera
+    auto depth_at(const ufps::Camera &camera, float distance) -> float
+    {
+        const auto clip = view_projection(camera) * ufps::Vector4{0.f, 0.f, -distance, 1.f};
+        return (clip.z / clip.w) * .5f + .5f;
+    }
+}
+
+TEST(hiz, mip_count)
+{
+    ASSERT_EQ(ufps::hiz_mip_count(1u, 1u), 1u);
+    ASSERT_EQ(ufps::hiz_mip_count(64u, 64u), 7u);
+    ASSERT_EQ(ufps::hiz_mip_count(1920u, 1080u), 11u);
+    ASSERT_EQ(ufps::hiz_mip_size(1080u, 10u), 1u);
+}
+
+TEST(hiz, downsample_takes_max)
+{
+    const auto depth = std::vector<float>{
+        .1f, .2f, .3f, .4f,
+        .5f, .6f, .7f, .8f};
+
+    const auto result = ufps::downsample_depth(depth, 4u, 2u);
+
+    ASSERT_EQ(result, (std::vector<float>{.6f, .8f}));
+}
+
+TEST(hiz, downsample_odd_size_folds_into_last_texel)
+{
+    const auto depth = std::vector<float>{
+        .1f, .2f, .9f,
+        .1f, .2f, .3f,
+        .1f, .8f, .3f};
+
+    const auto result = ufps::downsample_depth(depth, 3u, 3u);
+
+    ASSERT_EQ(result, (std::vector<float>{.9f}));
+}
+
+TEST(hiz, pyramid_levels)
+{
+    const auto depth = create_depth(5u, 3u, .5f);
+    const auto pyramid = ufps::HiZPyramid{depth, 5u, 3u};
+
+    ASSERT_EQ(pyramid.mip_count(), 3u);
+    ASSERT_EQ(pyramid.width(1u), 2u);
+    ASSERT_EQ(pyramid.height(1u), 1u);
+    ASSERT_FLOAT_EQ(pyramid.depth(1u, 0u, 0u), .5f);
+    ASSERT_FLOAT_EQ(pyramid.depth(1u, 1u, 0u), 1.f);
+    ASSERT_FLOAT_EQ(pyramid.depth(2u, 0u, 0u), 1.f);
+}
+
+TEST(hiz, project_aabb_in_front)
+{
+    const auto camera = create_camera();
+    const auto bounds = ufps::project_aabb({.min = {-1.f, -1.f, -11.f}, .max = {1.f, 1.f, -9.f}}, view_projection(camera));
+
+    ASSERT_TRUE(bounds.has_value());
+    ASSERT_NEAR(bounds->min_x + bounds->max_x, 1.f, 0.0001f);
+    ASSERT_NEAR(bounds->min_y + bounds->max_y, 1.f, 0.0001f);
+    ASSERT_LT(bounds->min_x, .5f);
+    ASSERT_GT(bounds->max_x, .5f);
+    ASSERT_NEAR(bounds->min_depth, depth_at(camera, 9.f), 0.0001f);
+}
+
+TEST(hiz, project_aabb_crossing_near_plane)
+{
+    const auto camera = create_camera();
+
+    ASSERT_FALSE(ufps::project_aabb({.min = {-1.f}, .max = {1.f}}, view_projection(camera)).has_value());
+}
+
+TEST(hiz, mip_level_covers_bounds_with_two_texels)
+{
+    const auto full_screen = ufps::ScreenBounds{.min_x = 0.f, .min_y = 0.f, .max_x = 1.f, .max_y = 1.f, .min_depth = 0.f};
+    ASSERT_EQ(ufps::hiz_mip_level(full_screen, 64u, 64u), 6u);
+
+    const auto small = ufps::ScreenBounds{.min_x = 0.f, .min_y = 0.f, .max_x = 3.5f / 64.f, .max_y = 1.f / 64.f, .min_depth = 0.f};
+    ASSERT_EQ(ufps::hiz_mip_level(small, 64u, 64u), 2u);
+
+    const auto point = ufps::ScreenBounds{.min_x = .5f, .min_y = .5f, .max_x = .5f, .max_y = .5f, .min_depth = 0.f};
+    ASSERT_EQ(ufps::hiz_mip_level(point, 64u, 64u), 0u);
+}
+
+TEST(hiz, box_behind_wall_is_occluded)
+{
+    const auto camera = create_camera();
+    const auto depth = create_depth(64u, 64u, depth_at(camera, 5.f));
+    const auto pyramid = ufps::HiZPyramid{depth, 64u, 64u};
+
+    // left half of the screen, well behind the wall
+    const auto bounds = ufps::project_aabb({.min = {-12.f, -1.f, -21.f}, .max = {-10.f, 1.f, -19.f}}, view_projection(camera));
+
+    ASSERT_TRUE(bounds.has_value());
+    ASSERT_TRUE(ufps::is_occluded(pyramid, *bounds));
+}
+
+TEST(hiz, box_in_front_of_wall_is_visible)
+{
+    const auto camera = create_camera();
+    const auto depth = create_depth(64u, 64u, depth_at(camera, 5.f));
+    const auto pyramid = ufps::HiZPyramid{depth, 64u, 64u};
+
+    const auto bounds = ufps::project_aabb({.min = {-2.f, -.5f, -3.f}, .max = {-1.f, .5f, -2.f}}, view_projection(camera));
+
+    ASSERT_TRUE(bounds.has_value());
+    ASSERT_FALSE(ufps::is_occluded(pyramid, *bounds));
+}
+
+TEST(hiz, box_partially_past_wall_is_visible)
+{
+    const auto camera = create_camera();
+    const auto depth = create_depth(64u, 64u, depth_at(camera, 5.f));
+    const auto pyramid = ufps::HiZPyramid{depth, 64u, 64u};
+
+    // straddles the edge of the wall so part of it is seen against the far plane
+    const auto bounds = ufps::project_aabb({.min = {-2.f, -1.f, -21.f}, .max = {2.f, 1.f, -19.f}}, view_projection(camera));
+
+    ASSERT_TRUE(bounds.has_value());
+    ASSERT_FALSE(ufps::is_occluded(pyramid, *bounds));
+}
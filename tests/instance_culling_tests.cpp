@@ -0,0 +1,266 @@
+#include <algorithm>
+#include <limits>
+#include <numbers>
+#include <ranges>
+#include <span>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "core/camera.h"
+#include "graphics/culling.h"
+#include "graphics/instance_culling.h"
+#include "graphics/instance_data.h"
+#include "graphics/instance_table.h"
+#include "graphics/mesh_view.h"
+#include "graphics/meshlet.h"
+#include "math/aabb.h"
+#include "math/quaternion.h"
+#include "math/transform.h"
+
+namespace
+{
+    class FakeRenderEntity
+    {
+    public:
+        FakeRenderEntity(const ufps::AABB &aabb, float opacity = 1.f)
+            : _aabb{aabb},
+              _opacity{opacity}
+        {
+        }
+
+        auto aabb() const -> const ufps::AABB &
+        {
+            return _aabb;
+        }
+
+        auto opacity() const -> float
+        {
+            return _opacity;
+        }
+
+        auto mesh_view() const -> ufps::MeshView
+        {
+            return {.vertex_offset = 10u, .vertex_count = 24u, .index_offset = 30u, .index_count = 36u, .meshlet_offset = 5u, .meshlet_count = 1u};
+        }
+
+    private:
+        ufps::AABB _aabb;
+        float _opacity;
+    };
+
+    class FakeEntity
+    {
+    public:
+        FakeEntity(std::vector<FakeRenderEntity> render_entities, const ufps::Vector3 &position)
+            : _render_entities{std::move(render_entities)},
+              _transform{position, {1.f}, {}},
+              _aabb{.min = {std::numeric_limits<float>::max()}, .max = {std::numeric_limits<float>::lowest()}}
+        {
+            for (const auto &e : _render_entities)
+            {
+                _aabb.min = {std::min(_aabb.min.x, e.aabb().min.x), std::min(_aabb.min.y, e.aabb().min.y), std::min(_aabb.min.z, e.aabb().min.z)};
+                _aabb.max = {std::max(_aabb.max.x, e.aabb().max.x), std::max(_aabb.max.y, e.aabb().max.y), std::max(_aabb.max.z, e.aabb().max.z)};
+            }
+        }
+
+        auto render_entities() const -> std::span<const FakeRenderEntity>
+        {
+            return _render_entities;
+        }
+
+        auto transform() const -> const ufps::Transform &
+        {
+            return _transform;
+        }
+
+        auto aabb() const -> const ufps::AABB &
+        {
+            return _aabb;
+        }
+
+        auto version() const -> std::uint32_t
+        {
+            return 0u;
+        }
+
+    private:
+        std::vector<FakeRenderEntity> _render_entities;
+        ufps::Transform _transform;
+        ufps::AABB _aabb;
+    };
+
+    auto create_frustum() -> ufps::Frustum
+    {
+        return ufps::Camera{
+            {0.f, 0.f, 0.f},
+            {0.f, 0.f, -1.f},
+            {0.f, 1.f, 0.f},
+            std::numbers::pi_v<float> / 4.f,
+            1920.f,
+            1080.f,
+            0.1f,
+            100.f}
+            .frustum();
+    }
+
+    auto create_instances(const std::vector<FakeEntity> &entities, const ufps::InstanceTable &table)
+        -> std::vector<ufps::InstanceData>
+    {
+        return std::views::iota(0u, table.slot_count()) |
+               std::views::transform(
+                   [&](const auto slot)
+                   {
+                       const auto owner = table.owner(slot);
+                       const auto &entity = entities[owner.entity_index];
+                       return ufps::create_instance_data(entity, entity.render_entities()[owner.render_entity_index]);
+                   }) |
+               std::ranges::to<std::vector>();
+    }
+
+    const auto unit_box = ufps::AABB{.min = {-1.f}, .max = {1.f}};
+}
+
+TEST(instance_culling, filter_flags)
+{
+    ASSERT_EQ(ufps::filter_flags(1.f), ufps::opaque_filter_flag);
+    ASSERT_EQ(ufps::filter_flags(.5f), ufps::transparent_filter_flag);
+    ASSERT_EQ(ufps::filter_mask(ufps::EntityFilterMode::ALL), ufps::opaque_filter_flag | ufps::transparent_filter_flag);
+}
+
+TEST(instance_culling, create_instance_data)
+{
+    const auto entity = FakeEntity{{{unit_box, .5f}}, {1.f, 2.f, 3.f}};
+    const auto instance = ufps::create_instance_data(entity, entity.render_entities()[0]);
+
+    ASSERT_EQ(instance.index_count, 36u);
+    ASSERT_EQ(instance.first_index, 30u);
+    ASSERT_EQ(instance.base_vertex, 10);
+    ASSERT_EQ(instance.filter_flags, ufps::transparent_filter_flag);
+    ASSERT_EQ(instance.meshlet_offset, 5u);
+    ASSERT_EQ(instance.meshlet_count, 1u);
+    ASSERT_EQ(instance.model, ufps::Matrix4{entity.transform()});
+}
+
+TEST(instance_culling, matches_cpu_culling)
+{
+    const auto entities = std::vector<FakeEntity>{
+        {{{unit_box}, {unit_box, .5f}}, {0.f, 0.f, -10.f}},
+        {{{unit_box}, {unit_box}, {unit_box}}, {0.f, 0.f, 10.f}},
+        {{{{.min = {-1.f}, .max = {1.f}}}, {{.min = {-80.f, -1.f, -1.f}, .max = {-78.f, 1.f, 1.f}}}}, {0.f, 0.f, -10.f}},
+        {{{unit_box}}, {0.f, 0.f, -50.f}},
+    };
+
+    auto table = ufps::InstanceTable{};
+    table.sync(entities, 0u);
+    const auto instances = create_instances(entities, table);
+    const auto frustum = create_frustum();
+
+    for (const auto mode : {ufps::EntityFilterMode::ALL, ufps::EntityFilterMode::OPAQUE, ufps::EntityFilterMode::TRANSPARENT})
+    {
+        const auto expected = ufps::cull(entities, frustum, mode).draws |
+                              std::views::transform([&](const auto &draw) { return table.slot(draw); }) |
+                              std::ranges::to<std::vector>();
+
+        const auto actual = ufps::cull_instances(instances, frustum, ufps::filter_mask(mode)) |
+                            std::views::transform([](const auto &command) { return command.baseInstance; }) |
+                            std::ranges::to<std::vector>();
+
+        ASSERT_EQ(actual, expected);
+    }
+}
+
+TEST(instance_culling, commands_reference_slot)
+{
+    const auto entities = std::vector<FakeEntity>{
+        {{{unit_box}}, {0.f, 0.f, 10.f}},
+        {{{unit_box}}, {0.f, 0.f, -10.f}},
+    };
+
+    auto table = ufps::InstanceTable{};
+    table.sync(entities, 0u);
+
+    const auto commands = ufps::cull_instances(create_instances(entities, table), create_frustum(), ufps::opaque_filter_flag);
+
+    ASSERT_EQ(commands.size(), 1zu);
+    ASSERT_EQ(commands[0].count, 36u);
+    ASSERT_EQ(commands[0].instanceCount, 1u);
+    ASSERT_EQ(commands[0].first_index, 30u);
+    ASSERT_EQ(commands[0].base_vertex, 10);
+    ASSERT_EQ(commands[0].baseInstance, 1u);
+}
+
+TEST(instance_culling, meshlet_backfacing)
+{
+    const auto meshlet = ufps::Meshlet{
+        .sphere = {{0.f, 0.f, 0.f}, 1.f},
+        .cone = {{0.f, 0.f, 1.f}, .9f},
+        .index_offset = 0u,
+        .index_count = 3u,
+        .vertex_count = 3u,
+        .pad = 0u,
+    };
+
+    ASSERT_FALSE(ufps::is_backfacing(meshlet, {0.f, 0.f, 5.f}));
+    ASSERT_TRUE(ufps::is_backfacing(meshlet, {0.f, 0.f, -5.f}));
+
+    // behind the centre's plane but some of the sphere is not
+    ASSERT_FALSE(ufps::is_backfacing(meshlet, {5.f, 0.f, -.5f}));
+
+    // inside the sphere
+    ASSERT_FALSE(ufps::is_backfacing(meshlet, {0.f, 0.f, -.5f}));
+
+    auto no_cone = meshlet;
+    no_cone.cone.w = 0.f;
+    ASSERT_FALSE(ufps::is_backfacing(no_cone, {0.f, 0.f, -5.f}));
+}
+
+TEST(instance_culling, cull_meshlets)
+{
+    const auto meshlet = [](const ufps::Vector3 &centre, const ufps::Vector3 &axis, float cutoff, std::uint32_t index_offset)
+    {
+        return ufps::Meshlet{
+            .sphere = {centre, .5f},
+            .cone = {axis, cutoff},
+            .index_offset = index_offset,
+            .index_count = 6u,
+            .vertex_count = 4u,
+            .pad = 0u,
+        };
+    };
+
+    const auto meshlets = std::vector<ufps::Meshlet>{
+        meshlet({0.f, 0.f, 0.f}, {0.f, 0.f, 1.f}, .9f, 0u),
+        meshlet({0.f, 0.f, 0.f}, {0.f, 0.f, -1.f}, .9f, 6u),
+        meshlet({0.f, 0.f, 0.f}, {}, 0.f, 12u),
+        meshlet({-80.f, 0.f, 0.f}, {}, 0.f, 18u),
+    };
+
+    const auto wide_box = ufps::AABB{.min = {-81.f, -1.f, -1.f}, .max = {1.f, 1.f, 1.f}};
+    const auto entities = std::vector<FakeEntity>{{{{wide_box}}, {0.f, 0.f, -10.f}}};
+
+    auto table = ufps::InstanceTable{};
+    table.sync(entities, 0u);
+    auto instances = create_instances(entities, table);
+    instances[0].meshlet_offset = 0u;
+    instances[0].meshlet_count = static_cast<std::uint32_t>(meshlets.size());
+
+    const auto first_indices = [&]
+    {
+        return ufps::cull_meshlets(instances, meshlets, create_frustum(), {0.f, 0.f, 0.f}, ufps::opaque_filter_flag) |
+               std::views::transform([](const auto &command) { return command.first_index; }) |
+               std::ranges::to<std::vector>();
+    };
+
+    // the meshlet facing the camera and the one without a cone, the back facing and off screen ones are culled
+    ASSERT_EQ(first_indices(), (std::vector<std::uint32_t>{30u, 42u}));
+
+    // turned around the back facing one is the one drawn, the off screen one is now on the other side
+    instances[0].model = ufps::Matrix4{ufps::Transform{{0.f, 0.f, -10.f}, {1.f}, ufps::Quaternion{0.f, 1.f, 0.f, 0.f}}};
+    ASSERT_EQ(first_indices(), (std::vector<std::uint32_t>{36u, 42u}));
+
+    const auto commands = ufps::cull_meshlets(instances, meshlets, create_frustum(), {0.f, 0.f, 0.f}, ufps::opaque_filter_flag);
+    ASSERT_EQ(commands[0].count, 6u);
+    ASSERT_EQ(commands[0].base_vertex, 10);
+    ASSERT_EQ(commands[0].baseInstance, 0u);
+}
@@ -0,0 +1,165 @@
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "graphics/instance_table.h"
+
+namespace
+{
+    struct FakeRenderEntity
+    {
+    };
+
+    class FakeEntity
+    {
+    public:
+        FakeEntity(std::uint32_t render_entity_count)
+            : _render_entities(render_entity_count),
+              _version{}
+        {
+        }
+
+        auto render_entities() const -> const std::vector<FakeRenderEntity> &
+        {
+            return _render_entities;
+        }
+
+        auto version() const -> std::uint32_t
+        {
+            return _version;
+        }
+
+        auto touch() -> void
+        {
+            ++_version;
+        }
+
+    private:
+        std::vector<FakeRenderEntity> _render_entities;
+        std::uint32_t _version;
+    };
+}
+
+TEST(instance_table, dirty_slots_merge_overlapping_and_adjacent)
+{
+    auto dirty = ufps::DirtySlots{};
+    dirty.mark(10u, 2u);
+    dirty.mark(0u, 3u);
+    dirty.mark(3u);
+    dirty.mark(11u, 4u);
+    dirty.mark(20u);
+
+    const auto expected = std::vector<ufps::SlotRange>{{0u, 4u}, {10u, 5u}, {20u, 1u}};
+    ASSERT_EQ(dirty.ranges(), expected);
+}
+
+TEST(instance_table, dirty_slots_ignore_empty_marks)
+{
+    auto dirty = ufps::DirtySlots{};
+    dirty.mark(5u, 0u);
+
+    ASSERT_TRUE(dirty.empty());
+}
+
+TEST(instance_table, sync_assigns_contiguous_slots)
+{
+    const auto entities = std::vector<FakeEntity>{2u, 0u, 3u};
+
+    auto table = ufps::InstanceTable{};
+    table.sync(entities, 0u);
+
+    ASSERT_EQ(table.slot_count(), 5u);
+    ASSERT_EQ(table.entity_slots(0u), (ufps::SlotRange{0u, 2u}));
+    ASSERT_EQ(table.entity_slots(1u), (ufps::SlotRange{2u, 0u}));
+    ASSERT_EQ(table.entity_slots(2u), (ufps::SlotRange{2u, 3u}));
+    ASSERT_EQ(table.slot({2u, 1u}), 3u);
+    ASSERT_EQ(table.owner(4u).entity_index, 2u);
+    ASSERT_EQ(table.owner(4u).render_entity_index, 2u);
+
+    const auto expected = std::vector<ufps::SlotRange>{{0u, 5u}};
+    ASSERT_EQ(table.dirty().ranges(), expected);
+}
+
+TEST(instance_table, unchanged_scene_is_clean)
+{
+    const auto entities = std::vector<FakeEntity>{2u, 3u};
+
+    auto table = ufps::InstanceTable{};
+    ASSERT_TRUE(table.sync(entities, 0u));
+    table.clear_dirty();
+    ASSERT_FALSE(table.sync(entities, 0u));
+
+    ASSERT_TRUE(table.dirty().empty());
+}
+
+TEST(instance_table, version_change_dirties_entity_slots)
+{
+    auto entities = std::vector<FakeEntity>{2u, 3u, 1u};
+
+    auto table = ufps::InstanceTable{};
+    table.sync(entities, 0u);
+    table.clear_dirty();
+
+    entities[1].touch();
+    table.sync(entities, 0u);
+
+    const auto expected = std::vector<ufps::SlotRange>{{2u, 3u}};
+    ASSERT_EQ(table.dirty().ranges(), expected);
+}
+
+TEST(instance_table, revision_change_rebuilds)
+{
+    auto entities = std::vector<FakeEntity>{2u};
+
+    auto table = ufps::InstanceTable{};
+    table.sync(entities, 0u);
+    table.clear_dirty();
+
+    entities.emplace_back(4u);
+    ASSERT_TRUE(table.sync(entities, 1u));
+
+    ASSERT_EQ(table.slot_count(), 6u);
+    const auto expected = std::vector<ufps::SlotRange>{{0u, 6u}};
+    ASSERT_EQ(table.dirty().ranges(), expected);
+}
+
+TEST(instance_table, frame_dirty_slots_written_once_per_frame)
+{
+    auto dirty = ufps::FrameDirtySlots<3zu>{};
+    dirty.mark(4u, 2u);
+
+    for (auto i = 0u; i < 3u; ++i)
+    {
+        const auto expected = std::vector<ufps::SlotRange>{{4u, 2u}};
+        ASSERT_EQ(dirty.current().ranges(), expected);
+
+        dirty.clear_current();
+        dirty.advance();
+    }
+
+    ASSERT_TRUE(dirty.current().empty());
+}
+
+TEST(instance_table, frame_dirty_slots_late_mark_only_pending_frames)
+{
+    auto dirty = ufps::FrameDirtySlots<3zu>{};
+    dirty.mark(0u);
+    dirty.clear_current();
+    dirty.advance();
+
+    auto table_dirty = ufps::DirtySlots{};
+    table_dirty.mark(7u);
+    dirty.mark(table_dirty);
+
+    const auto both = std::vector<ufps::SlotRange>{{0u, 1u}, {7u, 1u}};
+    const auto late = std::vector<ufps::SlotRange>{{7u, 1u}};
+
+    ASSERT_EQ(dirty.current().ranges(), both);
+    dirty.clear_current();
+    dirty.advance();
+    ASSERT_EQ(dirty.current().ranges(), both);
+    dirty.clear_current();
+    dirty.advance();
+    ASSERT_EQ(dirty.current().ranges(), late);
+}
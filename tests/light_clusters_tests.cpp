@@ -0,0 +1,197 @@
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+#include <ranges>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "core/camera.h"
+#include "graphics/color.h"
+#include "graphics/light_clusters.h"
+#include "graphics/point_light.h"
+#include "math/vector3.h"
+
+namespace
+{
+    auto create_camera() -> ufps::Camera
+    {
+        return {
+            {0.f, 0.f, 0.f},
+            {0.f, 0.f, -1.f},
+            {0.f, 1.f, 0.f},
+            std::numbers::pi_v<float> / 2.f,
+            64.f,
+            64.f,
+            0.1f,
+            100.f};
+    }
+
+    auto create_light(const ufps::Vector3 &position, float constant, float linear, float quadratic) -> ufps::PointLight
+    {
+        return {
+            .position = position,
+            .color = ufps::Color::white(),
+            .constant_attenuation = constant,
+            .linear_attenuation = linear,
+            .quadratic_attenuation = quadratic,
+            .specular_power = 32.f,
+            .intensity = 1.f};
+    }
+
+    auto cluster_lights(const ufps::LightClusters &clusters, std::uint32_t index) -> std::vector<std::uint32_t>
+    {
+        const auto range = clusters.clusters[index];
+        return clusters.light_indices | std::views::drop(range.offset) | std::views::take(range.count) | std::ranges::to<std::vector>();
+    }
+}
+
+TEST(light_clusters, light_range_quadratic)
+{
+    ASSERT_NEAR(ufps::light_range(create_light({}, 1.f, 0.f, 1.f)), std::sqrt(255.f), 0.0001f);
+}
+
+TEST(light_clusters, light_range_linear)
+{
+    ASSERT_NEAR(ufps::light_range(create_light({}, 1.f, 1.f, 0.f)), 255.f, 0.0001f);
+}
+
+TEST(light_clusters, light_range_constant_only_is_infinite)
+{
+    ASSERT_TRUE(std::isinf(ufps::light_range(create_light({}, 1.f, 0.f, 0.f))));
+}
+
+TEST(light_clusters, light_range_too_dim_is_zero)
+{
+    ASSERT_EQ(ufps::light_range(create_light({}, 512.f, 1.f, 1.f)), 0.f);
+}
+
+TEST(light_clusters, projection_planes)
+{
+    const auto camera = create_camera();
+
+    ASSERT_NEAR(ufps::projection_near_plane(camera.data().projection), .1f, 0.0001f);
+    ASSERT_NEAR(ufps::projection_far_plane(camera.data().projection), 100.f, 0.1f);
+}
+
+TEST(light_clusters, cluster_slice)
+{
+    ASSERT_EQ(ufps::cluster_slice(.05f, .1f, 100.f), 0u);
+    ASSERT_EQ(ufps::cluster_slice(std::sqrt(10.f) * 1.01f, .1f, 100.f), ufps::cluster_count_z / 2u);
+    ASSERT_EQ(ufps::cluster_slice(200.f, .1f, 100.f), ufps::cluster_count_z - 1u);
+}
+
+TEST(light_clusters, cluster_index_straight_ahead)
+{
+    const auto camera = create_camera();
+
+    ASSERT_EQ(ufps::cluster_index({0.f, 0.f, -10.5f}, camera.data()), ufps::cluster_index(8u, 4u, 16u));
+}
+
+TEST(light_clusters, cluster_bounds_contain_position)
+{
+    const auto camera = create_camera();
+    const auto position = ufps::Vector3{1.3f, -.7f, -10.5f};
+
+    const auto index = ufps::cluster_index(position, camera.data());
+    const auto x = index % ufps::cluster_count_x;
+    const auto y = (index / ufps::cluster_count_x) % ufps::cluster_count_y;
+    const auto z = index / (ufps::cluster_count_x * ufps::cluster_count_y);
+
+    const auto bounds = ufps::cluster_bounds(x, y, z, camera.data().projection);
+
+    ASSERT_TRUE(ufps::sphere_intersects(bounds, position, 0.f));
+}
+
+TEST(light_clusters, light_assigned_to_every_cluster_it_reaches)
+{
+    const auto camera = create_camera();
+    const auto light = create_light({1.f, .5f, -10.5f}, 1.f, 0.f, 100.f);
+    const auto range = ufps::light_range(light);
+    const auto lights = std::vector<ufps::PointLight>{light};
+
+    const auto clusters = ufps::assign_lights(lights, camera.data());
+
+    for (const auto i : std::views::iota(-4, 5))
+    {
+        for (const auto j : std::views::iota(-4, 5))
+        {
+            for (const auto k : std::views::iota(-4, 5))
+            {
+                const auto offset = ufps::Vector3{static_cast<float>(i), static_cast<float>(j), static_cast<float>(k)} * (range * .2f);
+                if (offset.length() > range * .9f)
+                {
+                    continue;
+                }
+
+                const auto index = ufps::cluster_index(light.position + offset, camera.data());
+                ASSERT_EQ(cluster_lights(clusters, index), std::vector<std::uint32_t>{0u});
+            }
+        }
+    }
+
+    ASSERT_TRUE(cluster_lights(clusters, ufps::cluster_index(0u, 0u, 0u)).empty());
+}
+
+TEST(light_clusters, light_behind_camera_is_not_assigned)
+{
+    const auto camera = create_camera();
+    const auto lights = std::vector<ufps::PointLight>{create_light({0.f, 0.f, 10.f}, 1.f, 0.f, 100.f)};
+
+    const auto clusters = ufps::assign_lights(lights, camera.data());
+
+    ASSERT_TRUE(clusters.light_indices.empty());
+}
+
+TEST(light_clusters, too_dim_light_is_not_assigned)
+{
+    const auto camera = create_camera();
+    const auto lights = std::vector<ufps::PointLight>{create_light({0.f, 0.f, -10.f}, 512.f, 0.f, 0.f)};
+
+    const auto clusters = ufps::assign_lights(lights, camera.data());
+
+    ASSERT_TRUE(clusters.light_indices.empty());
+}
+
+TEST(light_clusters, ranges_are_packed)
+{
+    const auto camera = create_camera();
+    const auto lights = std::views::iota(0, 32) |
+                        std::views::transform(
+                            [](const auto index)
+                            {
+                                const auto x = static_cast<float>(index % 8) - 4.f;
+                                const auto z = -2.f - static_cast<float>(index);
+                                return create_light({x, 0.f, z}, 1.f, 0.f, 10.f);
+                            }) |
+                        std::ranges::to<std::vector>();
+
+    const auto clusters = ufps::assign_lights(lights, camera.data());
+
+    ASSERT_EQ(clusters.clusters.size(), ufps::cluster_count);
+
+    auto offset = 0u;
+    for (const auto &range : clusters.clusters)
+    {
+        ASSERT_EQ(range.offset, offset);
+        offset += range.count;
+    }
+
+    ASSERT_EQ(offset, clusters.light_indices.size());
+}
+
+TEST(light_clusters, clusters_are_capped)
+{
+    const auto camera = create_camera();
+    const auto lights = std::vector<ufps::PointLight>(ufps::max_lights_per_cluster + 10u, create_light({0.f, 0.f, -10.f}, 1.f, 0.f, 0.f));
+
+    const auto clusters = ufps::assign_lights(lights, camera.data());
+
+    for (const auto &range : clusters.clusters)
+    {
+        ASSERT_EQ(range.count, ufps::max_lights_per_cluster);
+    }
+
+    const auto expected = std::views::iota(0u, ufps::max_lights_per_cluster) | std::ranges::to<std::vector>();
+    ASSERT_EQ(cluster_lights(clusters, 0u), expected);
+}
@@ -0,0 +1,223 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <ranges>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "math/matrix4.h"
+#include "math/vector4.h"
+
+namespace
+{
+    constexpr auto count = 1024zu;
+
+    auto create_matrices(std::uint32_t seed) -> std::vector<ufps::Matrix4>
+    {
+        auto rng = std::mt19937{seed};
+        auto dist = std::uniform_real_distribution<float>{-2.f, 2.f};
+
+        auto matrices = std::vector<ufps::Matrix4>{};
+        for (auto i = 0zu; i < count; ++i)
+        {
+            auto elements = std::array<float, 16u>{};
+            for (auto &element : elements)
+            {
+                element = dist(rng);
+            }
+
+            // keep them comfortably invertible
+            elements[0] += 8.f;
+            elements[5] += 8.f;
+            elements[10] += 8.f;
+            elements[15] += 8.f;
+
+            matrices.push_back(ufps::Matrix4{elements});
+        }
+
+        return matrices;
+    }
+
+    auto create_vectors() -> std::vector<ufps::Vector4>
+    {
+        auto rng = std::mt19937{3u};
+        auto dist = std::uniform_real_distribution<float>{-10.f, 10.f};
+
+        auto vectors = std::vector<ufps::Vector4>{};
+        for (auto i = 0zu; i < count; ++i)
+        {
+            const auto x = dist(rng);
+            const auto y = dist(rng);
+            const auto z = dist(rng);
+            vectors.push_back({x, y, z, 1.f});
+        }
+
+        return vectors;
+    }
+
+    auto elements(const ufps::Matrix4 &matrix) -> std::array<float, 16u>
+    {
+        auto result = std::array<float, 16u>{};
+        std::ranges::copy(matrix.data(), std::ranges::begin(result));
+        return result;
+    }
+
+    // google benchmark times whole iterations of count operations, this reports the time of one (printed as e.g. 12.3n)
+    auto set_time_per_op(benchmark::State &state) -> void
+    {
+        state.counters["per_op"] = benchmark::Counter(
+            static_cast<double>(state.iterations() * count), benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+    }
+}
+
+static void matrix4_multiply_scalar(benchmark::State &state)
+{
+    const auto lhs = create_matrices(1u) | std::views::transform(elements) | std::ranges::to<std::vector>();
+    const auto rhs = create_matrices(2u) | std::views::transform(elements) | std::ranges::to<std::vector>();
+
+    for (auto _ : state)
+    {
+        for (auto i = 0zu; i < count; ++i)
+        {
+            benchmark::DoNotOptimize(ufps::impl::multiply_scalar(lhs[i], rhs[i]));
+        }
+    }
+
+    set_time_per_op(state);
+}
+
+static void matrix4_multiply(benchmark::State &state)
+{
+    const auto lhs = create_matrices(1u);
+    const auto rhs = create_matrices(2u);
+
+    for (auto _ : state)
+    {
+        for (auto i = 0zu; i < count; ++i)
+        {
+            benchmark::DoNotOptimize(lhs[i] * rhs[i]);
+        }
+    }
+
+    set_time_per_op(state);
+}
+
+static void matrix4_multiply_batched(benchmark::State &state)
+{
+    const auto lhs = create_matrices(1u);
+    const auto rhs = create_matrices(2u);
+    auto out = std::vector<ufps::Matrix4>(count);
+
+    for (auto _ : state)
+    {
+        ufps::Matrix4::multiply(lhs, rhs, out);
+        benchmark::ClobberMemory();
+    }
+
+    set_time_per_op(state);
+}
+
+static void matrix4_transform_scalar(benchmark::State &state)
+{
+    const auto matrix = elements(create_matrices(1u).front());
+    const auto vectors = create_vectors();
+
+    for (auto _ : state)
+    {
+        for (const auto &vector : vectors)
+        {
+            benchmark::DoNotOptimize(ufps::impl::transform_scalar(matrix, vector));
+        }
+    }
+
+    set_time_per_op(state);
+}
+
+static void matrix4_transform(benchmark::State &state)
+{
+    const auto matrix = create_matrices(1u).front();
+    const auto vectors = create_vectors();
+
+    for (auto _ : state)
+    {
+        for (const auto &vector : vectors)
+        {
+            benchmark::DoNotOptimize(matrix * vector);
+        }
+    }
+
+    set_time_per_op(state);
+}
+
+static void matrix4_transform_batched(benchmark::State &state)
+{
+    const auto matrix = create_matrices(1u).front();
+    const auto vectors = create_vectors();
+    auto out = std::vector<ufps::Vector4>(count);
+
+    for (auto _ : state)
+    {
+        ufps::Matrix4::transform(matrix, vectors, out);
+        benchmark::ClobberMemory();
+    }
+
+    set_time_per_op(state);
+}
+
+static void matrix4_cofactors_scalar(benchmark::State &state)
+{
+    const auto matrices = create_matrices(1u) | std::views::transform(elements) | std::ranges::to<std::vector>();
+
+    for (auto _ : state)
+    {
+        for (const auto &matrix : matrices)
+        {
+            benchmark::DoNotOptimize(ufps::impl::cofactors_scalar(matrix));
+        }
+    }
+
+    set_time_per_op(state);
+}
+
+static void matrix4_cofactors(benchmark::State &state)
+{
+    const auto matrices = create_matrices(1u) | std::views::transform(elements) | std::ranges::to<std::vector>();
+
+    for (auto _ : state)
+    {
+        for (const auto &matrix : matrices)
+        {
+            benchmark::DoNotOptimize(ufps::impl::cofactors_simd(matrix));
+        }
+    }
+
+    set_time_per_op(state);
+}
+
+static void matrix4_invert(benchmark::State &state)
+{
+    const auto matrices = create_matrices(1u);
+
+    for (auto _ : state)
+    {
+        for (const auto &matrix : matrices)
+        {
+            benchmark::DoNotOptimize(ufps::Matrix4::invert(matrix));
+        }
+    }
+
+    set_time_per_op(state);
+}
+
+BENCHMARK(matrix4_multiply_scalar);
+BENCHMARK(matrix4_multiply);
+BENCHMARK(matrix4_multiply_batched);
+BENCHMARK(matrix4_transform_scalar);
+BENCHMARK(matrix4_transform);
+BENCHMARK(matrix4_transform_batched);
+BENCHMARK(matrix4_cofactors_scalar);
+BENCHMARK(matrix4_cofactors);
+BENCHMARK(matrix4_invert);
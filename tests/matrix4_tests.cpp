@@ -1,8 +1,10 @@
 #include <gtest/gtest.h>
 
+#include <array>
 #include <cstring>
 #include <numbers>
 #include <print>
+#include <vector>
 
 #include "math/matrix4.h"
 #include "math/vector3.h"
@@ -227,3 +229,77 @@ TEST(matrix4, mul_vector4)
 
     ASSERT_EQ(result, expected);
 }
+
+TEST(matrix4, runtime_matches_compile_time)
+{
+    static constexpr auto m1 = ufps::Matrix4{
+        {0.6f, 2.4f, 1.1f, 0.0f, 2.4f, 0.6f, -0.4f, 1.0f, 1.1f, -0.4f, 0.6f, 0.0f, 0.3f, -7.2f, 0.1f, 1.0f}};
+    static constexpr auto m2 = ufps::Matrix4{
+        {1.5f, -2.5f, 3.5f, 0.1f, 5.5f, 6.5f, -7.5f, 0.2f, 9.5f, 0.3f, 11.5f, 12.5f, -13.5f, 14.5f, 0.7f, 1.f}};
+    static constexpr auto v = ufps::Vector4{0.3f, -1.7f, 2.2f, 1.f};
+
+    static constexpr auto product = m1 * m2;
+    static constexpr auto inverse = ufps::Matrix4::invert(m1);
+    static constexpr auto transformed = m1 * v;
+
+    // runtime copies so the simd paths are taken
+    auto runtime_m1 = m1;
+    auto runtime_m2 = m2;
+    auto runtime_v = v;
+
+    const auto runtime_product = runtime_m1 * runtime_m2;
+    const auto runtime_inverse = ufps::Matrix4::invert(runtime_m1);
+    const auto runtime_transformed = runtime_m1 * runtime_v;
+
+    EXPECT_EQ(std::memcmp(runtime_product.data().data(), product.data().data(), product.data().size_bytes()), 0);
+    EXPECT_EQ(std::memcmp(runtime_inverse.data().data(), inverse.data().data(), inverse.data().size_bytes()), 0);
+    EXPECT_EQ(std::memcmp(&runtime_transformed, &transformed, sizeof(ufps::Vector4)), 0);
+
+    // sparse matrices have mostly zero cofactors, where the sign of each zero has to match too
+    static constexpr auto identity = ufps::Matrix4{};
+    static constexpr auto translation = ufps::Matrix4{ufps::Vector3{1.5f, -2.f, 3.f}};
+    static constexpr auto scale = ufps::Matrix4{ufps::Vector3{2.f, 0.5f, -4.f}, ufps::Matrix4::Scale{}};
+
+    static constexpr auto inverses = std::array{
+        ufps::Matrix4::invert(identity), ufps::Matrix4::invert(translation), ufps::Matrix4::invert(scale)};
+
+    auto runtime_matrices = std::array{identity, translation, scale};
+
+    for (auto i = 0zu; i < runtime_matrices.size(); ++i)
+    {
+        const auto sparse_inverse = ufps::Matrix4::invert(runtime_matrices[i]);
+        EXPECT_EQ(std::memcmp(sparse_inverse.data().data(), inverses[i].data().data(), inverses[i].data().size_bytes()), 0) << i;
+    }
+}
+
+TEST(matrix4, multiply_batched)
+{
+    const auto m1 = ufps::Matrix4{{1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f, 10.f, 11.f, 12.f, 13.f, 14.f, 15.f, 16.f}};
+    const auto m2 = ufps::Matrix4{
+        {1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f, 8.5f, 9.5f, 10.5f, 11.5f, 12.5f, 13.5f, 14.5f, 15.5f, 16.5f}};
+
+    auto lhs = std::vector<ufps::Matrix4>{m1, m2, ufps::Matrix4{}, m1};
+    const auto rhs = std::vector<ufps::Matrix4>{m2, m1, m2, ufps::Matrix4{}};
+    const auto expected = std::vector<ufps::Matrix4>{m1 * m2, m2 * m1, m2, m1};
+
+    // writing over one of the inputs is allowed
+    ufps::Matrix4::multiply(lhs, rhs, lhs);
+
+    ASSERT_EQ(lhs, expected);
+}
+
+TEST(matrix4, transform_batched)
+{
+    const auto m = ufps::Matrix4{{1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f, 10.f, 11.f, 12.f, 13.f, 14.f, 15.f, 16.f}};
+    const auto vectors = std::vector<ufps::Vector4>{{.5f, 1.5f, 2.5f, 3.5f}, {1.f, 0.f, 0.f, 1.f}, {-2.f, 4.f, .25f, 0.f}};
+
+    auto out = std::vector<ufps::Vector4>(vectors.size());
+    ufps::Matrix4::transform(m, vectors, out);
+
+    ASSERT_EQ(out[0], (ufps::Vector4{76.f, 84.f, 92.f, 100.f}));
+
+    for (auto i = 0zu; i < vectors.size(); ++i)
+    {
+        ASSERT_EQ(out[i], m * vectors[i]);
+    }
+}
@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <ranges>
+#include <tuple>
+#include <vector>
+
+#include "graphics/mesh_data.h"
+#include "graphics/mesh_optimizer.h"
+#include "graphics/vertex_data.h"
+#include "math/vector3.h"
+
+namespace
+{
+    // a size x size grid of quads on a slightly curved surface, every triangle has its own copy of its vertices and the
+    // triangles are shuffled, which is about the worst an importer can hand over
+    auto unwelded_grid(std::uint32_t size) -> ufps::MeshData
+    {
+        const auto vertex = [size](std::uint32_t x, std::uint32_t y)
+        {
+            const auto fx = static_cast<float>(x) / static_cast<float>(size);
+            const auto fy = static_cast<float>(y) / static_cast<float>(size);
+
+            return ufps::VertexData{
+                .position = {fx, fy, fx * fx},
+                .normal = {0.0f, 0.0f, 1.0f},
+                .tangent = {1.0f, 0.0f, 0.0f},
+                .bitangent = {0.0f, 1.0f, 0.0f},
+                .uv = {fx, fy},
+            };
+        };
+
+        auto triangles = std::vector<std::array<ufps::VertexData, 3zu>>{};
+        for (auto y = 0u; y < size; ++y)
+        {
+            for (auto x = 0u; x < size; ++x)
+            {
+                triangles.push_back({vertex(x, y), vertex(x + 1u, y), vertex(x + 1u, y + 1u)});
+                triangles.push_back({vertex(x, y), vertex(x + 1u, y + 1u), vertex(x, y + 1u)});
+            }
+        }
+
+        std::ranges::shuffle(triangles, std::mt19937{7u});
+
+        auto mesh = ufps::MeshData{};
+        for (const auto &triangle : triangles)
+        {
+            for (const auto &v : triangle)
+            {
+                mesh.indices.push_back(static_cast<std::uint32_t>(mesh.vertices.size()));
+                mesh.vertices.push_back(v);
+            }
+        }
+
+        return mesh;
+    }
+
+    using Triangle = std::array<ufps::Vector3, 3zu>;
+
+    // the triangles by position, rotated to start at their smallest vertex so winding is kept but order is not
+    auto triangle_set(const ufps::MeshData &mesh) -> std::vector<Triangle>
+    {
+        const auto less = [](const ufps::Vector3 &a, const ufps::Vector3 &b)
+        { return std::tie(a.x, a.y, a.z) < std::tie(b.x, b.y, b.z); };
+
+        auto triangles = std::vector<Triangle>{};
+        for (auto i = 0zu; i < mesh.indices.size(); i += 3zu)
+        {
+            auto triangle = Triangle{
+                mesh.vertices[mesh.indices[i]].position,
+                mesh.vertices[mesh.indices[i + 1zu]].position,
+                mesh.vertices[mesh.indices[i + 2zu]].position,
+            };
+            std::ranges::rotate(triangle, std::ranges::min_element(triangle, less));
+            triangles.push_back(triangle);
+        }
+
+        std::ranges::sort(triangles, [&](const Triangle &a, const Triangle &b) { return std::ranges::lexicographical_compare(a, b, less); });
+
+        return triangles;
+    }
+}
+
+TEST(mesh_optimizer, analyze_vertex_cache)
+{
+    const auto single = std::vector<std::uint32_t>{0u, 1u, 2u};
+    const auto single_stats = ufps::analyze_vertex_cache(single, 3zu);
+    ASSERT_FLOAT_EQ(single_stats.acmr, 3.0f);
+    ASSERT_FLOAT_EQ(single_stats.atvr, 1.0f);
+
+    const auto quad = std::vector<std::uint32_t>{0u, 1u, 2u, 0u, 2u, 3u};
+    const auto quad_stats = ufps::analyze_vertex_cache(quad, 4zu);
+    ASSERT_FLOAT_EQ(quad_stats.acmr, 2.0f);
+    ASSERT_FLOAT_EQ(quad_stats.atvr, 1.0f);
+
+    // a cache of three evicts vertex 0 before the second triangle reuses it
+    const auto tiny_cache_stats = ufps::analyze_vertex_cache(std::vector<std::uint32_t>{0u, 1u, 2u, 3u, 4u, 0u}, 5zu, 3u);
+    ASSERT_FLOAT_EQ(tiny_cache_stats.acmr, 3.0f);
+    ASSERT_FLOAT_EQ(tiny_cache_stats.atvr, 6.0f / 5.0f);
+}
+
+TEST(mesh_optimizer, weld_vertices)
+{
+    const auto mesh = unwelded_grid(8u);
+    const auto welded = ufps::weld_vertices(mesh);
+
+    ASSERT_EQ(welded.vertices.size(), 9zu * 9zu);
+    ASSERT_EQ(welded.indices.size(), mesh.indices.size());
+    ASSERT_EQ(triangle_set(welded), triangle_set(mesh));
+}
+
+TEST(mesh_optimizer, weld_keeps_distinct_attributes)
+{
+    auto mesh = ufps::MeshData{
+        .vertices = {{.position = {}, .normal = {}, .tangent = {}, .bitangent = {}, .uv = {0.0f, 0.0f}},
+                     {.position = {}, .normal = {}, .tangent = {}, .bitangent = {}, .uv = {1.0f, 0.0f}},
+                     {.position = {}, .normal = {}, .tangent = {}, .bitangent = {}, .uv = {0.0f, 0.0f}}},
+        .indices = {0u, 1u, 2u},
+    };
+
+    const auto welded = ufps::weld_vertices(mesh);
+
+    ASSERT_EQ(welded.vertices.size(), 2zu);
+    ASSERT_EQ(welded.indices, (std::vector<std::uint32_t>{0u, 1u, 0u}));
+}
+
+TEST(mesh_optimizer, vertex_cache_improves_acmr)
+{
+    const auto welded = ufps::weld_vertices(unwelded_grid(32u));
+    const auto before = ufps::analyze_vertex_cache(welded.indices, welded.vertices.size());
+
+    const auto indices = ufps::optimize_vertex_cache(welded.indices, welded.vertices.size());
+    const auto after = ufps::analyze_vertex_cache(indices, welded.vertices.size());
+
+    ASSERT_GT(before.acmr, 2.0f);
+    ASSERT_LT(after.acmr, 0.85f);
+    ASSERT_LT(after.atvr, before.atvr);
+
+    ASSERT_EQ(triangle_set({welded.vertices, indices}), triangle_set(welded));
+}
+
+TEST(mesh_optimizer, vertex_cache_degenerate_and_empty)
+{
+    ASSERT_TRUE(ufps::optimize_vertex_cache({}, 0zu).empty());
+
+    const auto indices = std::vector<std::uint32_t>{0u, 0u, 1u, 1u, 2u, 3u, 0u, 1u, 2u};
+    auto optimized = ufps::optimize_vertex_cache(indices, 4zu);
+
+    ASSERT_EQ(optimized.size(), indices.size());
+}
+
+TEST(mesh_optimizer, overdraw_keeps_cache_efficiency)
+{
+    const auto welded = ufps::weld_vertices(unwelded_grid(32u));
+    const auto cache_optimized = ufps::optimize_vertex_cache(welded.indices, welded.vertices.size());
+    const auto before = ufps::analyze_vertex_cache(cache_optimized, welded.vertices.size());
+
+    const auto indices = ufps::optimize_overdraw(cache_optimized, welded.vertices);
+    const auto after = ufps::analyze_vertex_cache(indices, welded.vertices.size());
+
+    // clusters start with a cold cache once reordered so allow a little over the threshold
+    ASSERT_LT(after.acmr, before.acmr * 1.1f);
+    ASSERT_EQ(triangle_set({welded.vertices, indices}), triangle_set(welded));
+}
+
+TEST(mesh_optimizer, vertex_fetch_first_use_order)
+{
+    const auto mesh = ufps::MeshData{
+        .vertices = unwelded_grid(1u).vertices,
+        .indices = {5u, 3u, 4u, 3u, 5u, 0u},
+    };
+
+    const auto optimized = ufps::optimize_vertex_fetch(mesh);
+
+    ASSERT_EQ(optimized.vertices.size(), 4zu);
+    ASSERT_EQ(optimized.indices, (std::vector<std::uint32_t>{0u, 1u, 2u, 1u, 0u, 3u}));
+    ASSERT_EQ(triangle_set(optimized), triangle_set(mesh));
+}
+
+TEST(mesh_optimizer, optimize_mesh)
+{
+    const auto mesh = unwelded_grid(24u);
+    const auto optimized = ufps::optimize_mesh(mesh);
+
+    ASSERT_EQ(optimized.vertices.size(), 25zu * 25zu);
+    ASSERT_EQ(triangle_set(optimized), triangle_set(mesh));
+    ASSERT_LT(ufps::analyze_vertex_cache(optimized.indices, optimized.vertices.size()).acmr, 1.0f);
+
+    // every index is at most one past the largest seen so far
+    auto next = 0u;
+    for (const auto index : optimized.indices)
+    {
+        ASSERT_LE(index, next);
+        next = std::max(next, index + 1u);
+    }
+
+    const auto again = ufps::optimize_mesh(mesh);
+    ASSERT_EQ(again.indices, optimized.indices);
+}
@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <set>
+#include <span>
+#include <vector>
+
+#include "graphics/mesh_data.h"
+#include "graphics/mesh_optimizer.h"
+#include "graphics/meshlet.h"
+#include "graphics/vertex_data.h"
+#include "math/vector3.h"
+
+namespace
+{
+    // a size x size grid of quads bent into a half cylinder, so meshlets on different parts of it face different ways
+    auto curved_grid(std::uint32_t size) -> ufps::MeshData
+    {
+        auto mesh = ufps::MeshData{};
+
+        for (auto y = 0u; y <= size; ++y)
+        {
+            for (auto x = 0u; x <= size; ++x)
+            {
+                const auto angle = 3.14159f * static_cast<float>(x) / static_cast<float>(size);
+                mesh.vertices.push_back({
+                    .position = {std::cos(angle), static_cast<float>(y) / static_cast<float>(size), std::sin(angle)},
+                    .normal = {std::cos(angle), 0.0f, std::sin(angle)},
+                    .tangent = {0.0f, 1.0f, 0.0f},
+                    .bitangent = {-std::sin(angle), 0.0f, std::cos(angle)},
+                    .uv = {static_cast<float>(x), static_cast<float>(y)},
+                });
+            }
+        }
+
+        const auto index = [size](std::uint32_t x, std::uint32_t y) { return y * (size + 1u) + x; };
+        for (auto y = 0u; y < size; ++y)
+        {
+            for (auto x = 0u; x < size; ++x)
+            {
+                mesh.indices.append_range(std::array{index(x, y), index(x, y + 1u), index(x + 1u, y + 1u)});
+                mesh.indices.append_range(std::array{index(x, y), index(x + 1u, y + 1u), index(x + 1u, y)});
+            }
+        }
+
+        return mesh;
+    }
+
+    auto triangles(std::span<const std::uint32_t> indices) -> std::multiset<std::array<std::uint32_t, 3zu>>
+    {
+        auto result = std::multiset<std::array<std::uint32_t, 3zu>>{};
+        for (auto i = 0zu; i < indices.size(); i += 3zu)
+        {
+            result.insert({indices[i], indices[i + 1zu], indices[i + 2zu]});
+        }
+
+        return result;
+    }
+
+    auto normal(const ufps::MeshData &mesh, std::span<const std::uint32_t> triangle) -> ufps::Vector3
+    {
+        const auto &p0 = mesh.vertices[triangle[0]].position;
+        const auto &p1 = mesh.vertices[triangle[1]].position;
+        const auto &p2 = mesh.vertices[triangle[2]].position;
+
+        return ufps::Vector3::normalize(ufps::Vector3::cross(p1 - p0, p2 - p0));
+    }
+}
+
+TEST(meshlet, limits_and_coverage)
+{
+    const auto mesh = ufps::optimize_mesh(curved_grid(40u));
+    const auto [meshlet_mesh, meshlets] = ufps::build_meshlets(mesh);
+
+    ASSERT_EQ(meshlet_mesh.vertices.size(), mesh.vertices.size());
+    ASSERT_EQ(triangles(meshlet_mesh.indices), triangles(mesh.indices));
+
+    // 3200 triangles need at least 26 meshlets, the grid should pack them well enough to stay close to that
+    ASSERT_GE(meshlets.size(), 26zu);
+    ASSERT_LT(meshlets.size(), 50zu);
+
+    auto next_index = 0u;
+    for (const auto &meshlet : meshlets)
+    {
+        ASSERT_EQ(meshlet.index_offset, next_index);
+        ASSERT_GT(meshlet.index_count, 0u);
+        ASSERT_LE(meshlet.index_count, ufps::meshlet_max_triangles * 3u);
+        next_index += meshlet.index_count;
+
+        const auto indices = std::span{meshlet_mesh.indices}.subspan(meshlet.index_offset, meshlet.index_count);
+        const auto unique = std::set<std::uint32_t>{indices.begin(), indices.end()};
+        ASSERT_EQ(unique.size(), meshlet.vertex_count);
+        ASSERT_LE(meshlet.vertex_count, ufps::meshlet_max_vertices);
+    }
+
+    ASSERT_EQ(next_index, meshlet_mesh.indices.size());
+}
+
+TEST(meshlet, bounds_contain_meshlet)
+{
+    const auto [mesh, meshlets] = ufps::build_meshlets(curved_grid(40u));
+
+    auto cullable = 0zu;
+    for (const auto &meshlet : meshlets)
+    {
+        const auto centre = ufps::Vector3{meshlet.sphere};
+        const auto axis = ufps::Vector3{meshlet.cone};
+        const auto indices = std::span{mesh.indices}.subspan(meshlet.index_offset, meshlet.index_count);
+
+        for (const auto index : indices)
+        {
+            ASSERT_LE((mesh.vertices[index].position - centre).length(), meshlet.sphere.w * 1.0001f);
+        }
+
+        if (meshlet.cone.w > 0.0f)
+        {
+            ++cullable;
+            for (auto i = 0zu; i < indices.size(); i += 3zu)
+            {
+                ASSERT_GE(ufps::Vector3::dot(axis, normal(mesh, indices.subspan(i, 3zu))), meshlet.cone.w);
+            }
+        }
+    }
+
+    // the half cylinder only turns 180 degrees, so most meshlets have a usable cone
+    ASSERT_GT(cullable * 2zu, meshlets.size());
+}
+
+TEST(meshlet, deterministic)
+{
+    const auto mesh = ufps::optimize_mesh(curved_grid(32u));
+
+    const auto a = ufps::build_meshlets(mesh);
+    const auto b = ufps::build_meshlets(mesh);
+
+    ASSERT_EQ(a.mesh.indices, b.mesh.indices);
+    ASSERT_EQ(a.meshlets, b.meshlets);
+}
+
+TEST(meshlet, closed_and_empty_meshes)
+{
+    ASSERT_TRUE(ufps::build_meshlets({}).meshlets.empty());
+
+    // a tetrahedron fits in one meshlet whose triangles face every way, so it can never be backface culled
+    const auto tetrahedron = ufps::MeshData{
+        .vertices = {
+            {.position = {1.0f, 1.0f, 1.0f}, .normal = {}, .tangent = {}, .bitangent = {}, .uv = {}},
+            {.position = {1.0f, -1.0f, -1.0f}, .normal = {}, .tangent = {}, .bitangent = {}, .uv = {}},
+            {.position = {-1.0f, 1.0f, -1.0f}, .normal = {}, .tangent = {}, .bitangent = {}, .uv = {}},
+            {.position = {-1.0f, -1.0f, 1.0f}, .normal = {}, .tangent = {}, .bitangent = {}, .uv = {}},
+        },
+        .indices = {0u, 1u, 2u, 0u, 3u, 1u, 0u, 2u, 3u, 1u, 3u, 2u},
+    };
+
+    const auto [mesh, meshlets] = ufps::build_meshlets(tetrahedron);
+
+    ASSERT_EQ(meshlets.size(), 1zu);
+    ASSERT_EQ(meshlets[0].index_count, 12u);
+    ASSERT_EQ(meshlets[0].vertex_count, 4u);
+    ASSERT_EQ(meshlets[0].cone.w, 0.0f);
+    ASSERT_NEAR(meshlets[0].sphere.w, std::sqrt(3.0f), 1e-5f);
+}
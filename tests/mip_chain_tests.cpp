@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "graphics/mip_chain.h"
+#include "graphics/texture_data.h"
+#include "utils/data_buffer.h"
+#include "utils/exception.h"
+
+namespace
+{
+    auto solid(ufps::TextureFormat format, std::uint32_t width, std::uint32_t height, std::vector<std::uint8_t> pixel) -> ufps::TextureData
+    {
+        auto data = ufps::DataBuffer{};
+        for (auto i = 0u; i < width * height; ++i)
+        {
+            for (const auto c : pixel)
+            {
+                data.push_back(static_cast<std::byte>(c));
+            }
+        }
+
+        return {.width = width, .height = height, .format = format, .data = std::move(data), .is_compressed = false};
+    }
+}
+
+TEST(mip_chain, full_mip_count)
+{
+    ASSERT_EQ(ufps::full_mip_count(1u, 1u), 1u);
+    ASSERT_EQ(ufps::full_mip_count(256u, 256u), 9u);
+    ASSERT_EQ(ufps::full_mip_count(256u, 16u), 9u);
+    ASSERT_EQ(ufps::full_mip_count(300u, 20u), 9u);
+}
+
+TEST(mip_chain, uncompressed_levels)
+{
+    const auto chain = ufps::mip_chain(ufps::TextureFormat::RGBA, 4u, 2u, 3u);
+
+    const auto expected = std::vector<ufps::MipLevel>{
+        {.width = 4u, .height = 2u, .offset = 0zu, .size = 32zu},
+        {.width = 2u, .height = 1u, .offset = 32zu, .size = 8zu},
+        {.width = 1u, .height = 1u, .offset = 40zu, .size = 4zu},
+    };
+
+    ASSERT_EQ(chain, expected);
+}
+
+TEST(mip_chain, compressed_levels_round_up_to_blocks)
+{
+    const auto chain = ufps::mip_chain(ufps::TextureFormat::BC7, 8u, 8u, 4u);
+
+    ASSERT_EQ(chain[0].size, 64zu);
+    ASSERT_EQ(chain[1].size, 16zu);
+    ASSERT_EQ(chain[2].size, 16zu);
+    ASSERT_EQ(chain[3].size, 16zu);
+    ASSERT_EQ(chain[3].offset, 96zu);
+}
+
+TEST(mip_chain, bytes_per_pixel_of_compressed_throws)
+{
+    ASSERT_THROW(ufps::bytes_per_pixel(ufps::TextureFormat::BC5U), ufps::Exception);
+}
+
+TEST(mip_chain, generate_mips_box_filters)
+{
+    auto texture = solid(ufps::TextureFormat::R, 2u, 2u, {0u});
+    (*texture.data)[1] = std::byte{100};
+    (*texture.data)[2] = std::byte{200};
+    (*texture.data)[3] = std::byte{100};
+
+    const auto mipped = ufps::generate_mips(texture);
+
+    ASSERT_EQ(mipped.mip_levels, 2u);
+    ASSERT_EQ(mipped.data->size(), 5zu);
+    ASSERT_EQ((*mipped.data)[4], std::byte{100});
+}
+
+TEST(mip_chain, generate_mips_keeps_solid_colour)
+{
+    const auto texture = solid(ufps::TextureFormat::SRGBA, 13u, 7u, {10u, 128u, 250u, 255u});
+
+    const auto mipped = ufps::generate_mips(texture);
+    const auto chain = ufps::mip_chain(mipped);
+
+    ASSERT_EQ(mipped.mip_levels, 4u);
+    ASSERT_EQ(mipped.data->size(), chain.back().offset + chain.back().size);
+
+    for (const auto &mip : chain)
+    {
+        const auto *pixel = mipped.data->data() + mip.offset;
+        ASSERT_EQ(pixel[0], std::byte{10});
+        ASSERT_EQ(pixel[1], std::byte{128});
+        ASSERT_EQ(pixel[2], std::byte{250});
+        ASSERT_EQ(pixel[3], std::byte{255});
+    }
+}
+
+TEST(mip_chain, generate_mips_averages_srgb_in_linear_space)
+{
+    auto texture = solid(ufps::TextureFormat::SRGBA, 2u, 1u, {0u, 0u, 0u, 0u});
+    (*texture.data)[4] = std::byte{255};
+    (*texture.data)[7] = std::byte{255};
+
+    const auto mipped = ufps::generate_mips(texture);
+
+    // half of full intensity is ~188 in srgb rather than 128, alpha is linear
+    ASSERT_EQ((*mipped.data)[8], std::byte{188});
+    ASSERT_EQ((*mipped.data)[11], std::byte{128});
+}
+
+TEST(mip_chain, generate_mips_of_compressed_throws)
+{
+    const auto texture = ufps::TextureData{
+        .width = 4u,
+        .height = 4u,
+        .format = ufps::TextureFormat::BC7,
+        .data = ufps::DataBuffer(16zu),
+        .is_compressed = true,
+    };
+
+    ASSERT_THROW(ufps::generate_mips(texture), ufps::Exception);
+}
+
+TEST(mip_chain, drop_mips)
+{
+    const auto mipped = ufps::generate_mips(solid(ufps::TextureFormat::RGBA, 8u, 4u, {1u, 2u, 3u, 4u}));
+    const auto dropped = ufps::drop_mips(mipped, 2u);
+
+    ASSERT_EQ(dropped.width, 2u);
+    ASSERT_EQ(dropped.height, 1u);
+    ASSERT_EQ(dropped.mip_levels, mipped.mip_levels - 2u);
+    ASSERT_EQ(dropped.data->size(), (2zu + 1zu) * 4zu);
+    ASSERT_EQ((*dropped.data)[0], std::byte{1});
+}
+
+TEST(mip_chain, drop_all_mips_throws)
+{
+    const auto texture = solid(ufps::TextureFormat::R, 2u, 2u, {0u});
+
+    ASSERT_THROW(ufps::drop_mips(texture, 1u), ufps::Exception);
+}
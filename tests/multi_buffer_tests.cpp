@@ -1,3 +1,4 @@
+#include <chrono>
 #include <cstddef>
 #include <iterator>
 #include <string_view>
@@ -141,3 +142,59 @@ TEST(multi_buffer, multi_write_offset)
     ASSERT_EQ(buffer.size(), data_view.size_bytes() * 3zu);
     ASSERT_EQ(buffer.write_calls, expected);
 }
+
+class FakeFence
+{
+public:
+    auto signal() -> void
+    {
+        ++signal_count;
+        _signalled = true;
+    }
+
+    auto wait() -> std::chrono::nanoseconds
+    {
+        ++wait_count;
+
+        // pretend the gpu took 1ms to catch up with anything fenced
+        const auto waited = _signalled ? std::chrono::nanoseconds{1'000'000} : std::chrono::nanoseconds{};
+        _signalled = false;
+
+        return waited;
+    }
+
+    static inline auto signal_count = 0zu;
+    static inline auto wait_count = 0zu;
+
+private:
+    bool _signalled = false;
+};
+
+TEST(multi_buffer, fences_each_region)
+{
+    auto data = ufps::DataBuffer{std::byte{0x0}, std::byte{0x1}, std::byte{0x2}};
+    auto data_view = ufps::DataBufferView{data};
+
+    FakeFence::signal_count = 0zu;
+    FakeFence::wait_count = 0zu;
+
+    auto mb = ufps::MultiBuffer<FakeBuffer, 3zu, FakeFence>{data_view.size_bytes(), "testbuffer"};
+    ASSERT_EQ(mb.fence_wait(), std::chrono::nanoseconds{});
+
+    // the first time round no region has been used by the gpu yet
+    mb.advance();
+    ASSERT_EQ(mb.fence_wait(), std::chrono::nanoseconds{});
+    mb.advance();
+    ASSERT_EQ(mb.fence_wait(), std::chrono::nanoseconds{});
+
+    // back to the first region, which was fenced two advances ago
+    mb.advance();
+    ASSERT_EQ(mb.frame_offset_bytes(), 0zu);
+    ASSERT_EQ(mb.fence_wait(), std::chrono::milliseconds{1});
+
+    mb.advance();
+    ASSERT_EQ(mb.fence_wait(), std::chrono::milliseconds{1});
+
+    ASSERT_EQ(FakeFence::signal_count, 4zu);
+    ASSERT_EQ(FakeFence::wait_count, 4zu);
+}
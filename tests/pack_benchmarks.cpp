@@ -0,0 +1,253 @@
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <random>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <benchmark/benchmark.h>
+
+#include "core/manifest_descriptions.h"
+#include "resources/file_resource_loader.h"
+#include "resources/pack.h"
+#include "serialization/yaml_serializer.h"
+#include "utils/compress.h"
+#include "utils/data_buffer.h"
+#include "utils/decompress.h"
+#include "utils/string_unordered_map.h"
+
+namespace
+{
+    // roughly a level: 512k vertices of 56 bytes, 3M indices and 512 textures of 128KiB
+    constexpr auto vertex_data_size = 512zu * 1024zu * 56zu;
+    constexpr auto index_count = 3zu * 1024zu * 1024zu;
+    constexpr auto texture_count = 512zu;
+    constexpr auto texture_size = 128zu * 1024zu;
+
+    // the texture manifest as it was before packs, pointing into one big texture blob
+    struct LegacyTextureManifest
+    {
+        std::uint32_t offset;
+        std::uint32_t size;
+        bool is_srgb;
+    };
+
+    struct LegacyTextureManifestDescription
+    {
+        ufps::StringUnorderedMap<LegacyTextureManifest> textures;
+    };
+
+    auto write_file(const std::filesystem::path &path, ufps::DataBufferView data) -> void
+    {
+        auto file = std::ofstream{path, std::ios::binary};
+        file.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+
+    auto write_file(const std::filesystem::path &path, const std::string &str) -> void
+    {
+        write_file(path, std::as_bytes(std::span{str}));
+    }
+
+    // the same synthetic content written in both formats, once per run
+    struct Content
+    {
+        Content()
+            : root{std::filesystem::temp_directory_path() / "ufps_pack_benchmarks"}
+        {
+            std::filesystem::create_directories(root / "blobs");
+            std::filesystem::create_directories(root / "configs");
+
+            // smooth floats compress a bit, like real vertex data
+            auto vertex_data = std::vector<float>(vertex_data_size / sizeof(float));
+            for (auto i = 0zu; i < vertex_data.size(); ++i)
+            {
+                vertex_data[i] = std::sin(static_cast<float>(i) * .001f);
+            }
+
+            auto index_data = std::vector<std::uint32_t>(index_count);
+            for (auto i = 0zu; i < index_data.size(); ++i)
+            {
+                index_data[i] = static_cast<std::uint32_t>(i / 3zu + i % 3zu);
+            }
+
+            // block compressed texture data is close to incompressible
+            auto rng = std::mt19937{1u};
+            auto texture_blob = ufps::DataBuffer(texture_count * texture_size);
+            for (auto &b : texture_blob)
+            {
+                b = static_cast<std::byte>(rng());
+            }
+
+            auto legacy_manifest = LegacyTextureManifestDescription{};
+            auto manifest = ufps::TextureManifestDescription{};
+            auto pack = ufps::PackWriter{};
+
+            for (auto i = 0zu; i < texture_count; ++i)
+            {
+                const auto name = std::format("textures/texture_{}.dds", i);
+                legacy_manifest.textures[name] = {
+                    .offset = static_cast<std::uint32_t>(i * texture_size),
+                    .size = static_cast<std::uint32_t>(texture_size),
+                    .is_srgb = false};
+                manifest.textures[name] = {.is_srgb = false};
+
+                pack.add(name, ufps::DataBufferView{texture_blob}.subspan(i * texture_size, texture_size), ufps::PackCompression::NONE);
+            }
+
+            const auto vertex_bytes = std::as_bytes(std::span{vertex_data});
+            const auto index_bytes = std::as_bytes(std::span{index_data});
+
+            write_file(root / "blobs/vertex_data.bin", ufps::compress(vertex_bytes));
+            write_file(root / "blobs/index_data.bin", ufps::compress(index_bytes));
+            write_file(root / "blobs/texture_data.bin", ufps::compress(texture_blob));
+            write_file(root / "configs/texture_manifest.yaml", ufps::yaml::serialize(legacy_manifest));
+
+            const auto manifest_str = ufps::yaml::serialize(manifest);
+            pack.add("configs/texture_manifest.yaml", std::as_bytes(std::span{manifest_str}), ufps::PackCompression::ZSTD);
+            pack.add("vertex_data", vertex_bytes, ufps::PackCompression::NONE);
+            pack.add("index_data", index_bytes, ufps::PackCompression::NONE);
+
+            auto pack_file = std::ofstream{root / "assets.pack", std::ios::binary};
+            pack.write(pack_file);
+        }
+
+        ~Content()
+        {
+            std::filesystem::remove_all(root);
+        }
+
+        // drop the files from the page cache so the next load has to go to disk
+        auto evict() const -> void
+        {
+#ifndef _WIN32
+            for (const auto &entry : std::filesystem::recursive_directory_iterator{root})
+            {
+                if (entry.is_regular_file())
+                {
+                    const auto fd = ::open(entry.path().c_str(), O_RDONLY);
+                    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+                    ::close(fd);
+                }
+            }
+#endif
+        }
+
+        std::filesystem::path root;
+    };
+
+    auto content() -> const Content &
+    {
+        static const auto content = Content{};
+        return content;
+    }
+
+    // stand in for the upload, every byte gets read once
+    auto consume(ufps::DataBufferView data) -> std::uint64_t
+    {
+        auto sum = std::uint64_t{};
+        for (const auto b : data)
+        {
+            sum += std::to_underlying(b);
+        }
+
+        return sum;
+    }
+
+    // main.cpp before packs: copy each blob out of the mapped file then decompress it whole
+    auto load_legacy(ufps::FileResourceLoader &loader, std::size_t &heap_bytes) -> std::uint64_t
+    {
+        const auto manifest_str = loader.load_string("configs/texture_manifest.yaml");
+        const auto manifest = ufps::yaml::deserialize<LegacyTextureManifestDescription>(manifest_str);
+
+        const auto compressed_texture_blob = loader.load_data_buffer("blobs/texture_data.bin");
+        const auto texture_blob = ufps::decompress(compressed_texture_blob);
+
+        auto sum = std::uint64_t{};
+        for (const auto &[name, texture] : manifest.textures)
+        {
+            sum += consume(ufps::DataBufferView{texture_blob}.subspan(texture.offset, texture.size));
+        }
+
+        const auto compressed_vertex_data = loader.load_data_buffer("blobs/vertex_data.bin");
+        const auto vertex_data = ufps::decompress(compressed_vertex_data);
+        const auto compressed_index_data = loader.load_data_buffer("blobs/index_data.bin");
+        const auto index_data = ufps::decompress(compressed_index_data);
+
+        sum += consume(vertex_data);
+        sum += consume(index_data);
+
+        heap_bytes = compressed_texture_blob.size() + texture_blob.size() + compressed_vertex_data.size() + vertex_data.size() +
+                     compressed_index_data.size() + index_data.size();
+
+        return sum;
+    }
+
+    auto load_pack(ufps::FileResourceLoader &loader, std::size_t &heap_bytes) -> std::uint64_t
+    {
+        const auto pack = loader.load_pack("assets.pack");
+
+        const auto manifest_str = pack.load_string("configs/texture_manifest.yaml");
+        const auto manifest = ufps::yaml::deserialize<ufps::TextureManifestDescription>(manifest_str);
+
+        auto sum = std::uint64_t{};
+        for (const auto &[name, texture] : manifest.textures)
+        {
+            sum += consume(pack.view(name));
+        }
+
+        sum += consume(pack.view("vertex_data"));
+        sum += consume(pack.view("index_data"));
+
+        heap_bytes = manifest_str.size();
+
+        return sum;
+    }
+
+    template <class F>
+    auto startup(benchmark::State &state, F &&load) -> void
+    {
+        const auto &c = content();
+        auto loader = ufps::FileResourceLoader{{c.root}};
+        const auto cold = state.range(0) != 0;
+        auto heap_bytes = 0zu;
+
+        for (auto _ : state)
+        {
+            if (cold)
+            {
+                state.PauseTiming();
+                c.evict();
+                state.ResumeTiming();
+            }
+
+            benchmark::DoNotOptimize(load(loader, heap_bytes));
+        }
+
+        // bytes copied or decompressed to the heap, on top of the page cache
+        state.counters["heap_bytes"] = static_cast<double>(heap_bytes);
+    }
+}
+
+static void pack_startup_legacy(benchmark::State &state)
+{
+    startup(state, load_legacy);
+}
+
+static void pack_startup(benchmark::State &state)
+{
+    startup(state, load_pack);
+}
+
+BENCHMARK(pack_startup_legacy)->ArgName("cold")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(pack_startup)->ArgName("cold")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,308 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <ranges>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "resources/file.h"
+#include "resources/pack.h"
+#include "utils/data_buffer.h"
+#include "utils/exception.h"
+
+namespace
+{
+    auto compressible(std::size_t size) -> ufps::DataBuffer
+    {
+        return std::views::iota(0zu, size) |
+               std::views::transform([](const auto i) { return static_cast<std::byte>(i % 7zu); }) |
+               std::ranges::to<ufps::DataBuffer>();
+    }
+
+    auto incompressible(std::size_t size) -> ufps::DataBuffer
+    {
+        auto rng = std::mt19937{42u};
+        return std::views::iota(0zu, size) |
+               std::views::transform([&rng](const auto) { return static_cast<std::byte>(rng()); }) |
+               std::ranges::to<ufps::DataBuffer>();
+    }
+
+    auto serialize(const ufps::PackWriter &writer) -> ufps::DataBuffer
+    {
+        auto out = std::stringstream{};
+        writer.write(out);
+
+        const auto str = out.str();
+        return std::as_bytes(std::span{str}) | std::ranges::to<ufps::DataBuffer>();
+    }
+
+    auto equal(ufps::DataBufferView a, ufps::DataBufferView b) -> bool
+    {
+        return std::ranges::equal(a, b);
+    }
+}
+
+TEST(pack, empty)
+{
+    const auto data = serialize(ufps::PackWriter{});
+    const auto pack = ufps::Pack{ufps::DataBufferView{data}};
+
+    ASSERT_TRUE(pack.chunks().empty());
+    ASSERT_FALSE(pack.has("anything"));
+}
+
+TEST(pack, round_trip)
+{
+    const auto raw = incompressible(10'000zu);
+    const auto text = compressible(50'000zu);
+
+    auto writer = ufps::PackWriter{};
+    writer.add("raw", raw, ufps::PackCompression::NONE);
+    writer.add("configs/text.yaml", text, ufps::PackCompression::ZSTD);
+
+    const auto data = serialize(writer);
+    const auto pack = ufps::Pack{ufps::DataBufferView{data}};
+
+    ASSERT_EQ(pack.chunks().size(), 2zu);
+    ASSERT_TRUE(pack.has("raw"));
+    ASSERT_TRUE(pack.has("configs/text.yaml"));
+    ASSERT_EQ(pack.name(pack.chunk("configs/text.yaml")), "configs/text.yaml");
+
+    ASSERT_EQ(pack.chunk("raw").compression, ufps::PackCompression::NONE);
+    ASSERT_EQ(pack.chunk("configs/text.yaml").compression, ufps::PackCompression::ZSTD);
+    ASSERT_LT(pack.chunk("configs/text.yaml").stored_size, text.size());
+
+    ASSERT_TRUE(equal(pack.load("raw"), raw));
+    ASSERT_TRUE(equal(pack.load("configs/text.yaml"), text));
+}
+
+TEST(pack, uncompressed_in_place)
+{
+    const auto raw = incompressible(1'000zu);
+
+    auto writer = ufps::PackWriter{};
+    writer.add("a", compressible(3zu), ufps::PackCompression::NONE);
+    writer.add("b", raw, ufps::PackCompression::NONE);
+
+    const auto data = serialize(writer);
+    const auto pack = ufps::Pack{ufps::DataBufferView{data}};
+
+    const auto view = pack.view("b");
+
+    ASSERT_TRUE(equal(view, raw));
+    ASSERT_GE(view.data(), data.data());
+    ASSERT_LE(view.data() + view.size(), data.data() + data.size());
+    ASSERT_EQ((view.data() - data.data()) % ufps::pack_default_alignment, 0);
+}
+
+TEST(pack, custom_alignment)
+{
+    auto writer = ufps::PackWriter{64u};
+    writer.add("a", compressible(3zu), ufps::PackCompression::NONE);
+    writer.add("b", compressible(100zu), ufps::PackCompression::NONE);
+
+    const auto data = serialize(writer);
+    const auto pack = ufps::Pack{ufps::DataBufferView{data}};
+
+    for (const auto &chunk : pack.chunks())
+    {
+        ASSERT_EQ(chunk.offset % 64u, 0u);
+    }
+
+    // nothing is padded out to a page
+    ASSERT_LT(data.size(), 512zu);
+}
+
+TEST(pack, incompressible_stored_as_is)
+{
+    const auto raw = incompressible(4'096zu);
+
+    auto writer = ufps::PackWriter{};
+    writer.add("raw", raw, ufps::PackCompression::ZSTD);
+
+    const auto data = serialize(writer);
+    const auto pack = ufps::Pack{ufps::DataBufferView{data}};
+
+    ASSERT_EQ(pack.chunk("raw").compression, ufps::PackCompression::NONE);
+    ASSERT_TRUE(equal(pack.view("raw"), raw));
+}
+
+TEST(pack, load_into_destination)
+{
+    const auto text = compressible(20'000zu);
+
+    auto writer = ufps::PackWriter{};
+    writer.add("text", text, ufps::PackCompression::ZSTD);
+
+    const auto pack = ufps::Pack{serialize(writer)};
+
+    auto destination = ufps::DataBuffer(text.size());
+    pack.load("text", destination);
+
+    ASSERT_TRUE(equal(destination, text));
+
+    auto too_small = ufps::DataBuffer(text.size() - 1zu);
+    ASSERT_THROW(pack.load("text", too_small), ufps::Exception);
+}
+
+TEST(pack, load_string)
+{
+    const auto str = std::string{"models: {}"};
+
+    auto writer = ufps::PackWriter{};
+    writer.add("configs/model_manifest.yaml", std::as_bytes(std::span{str}), ufps::PackCompression::ZSTD);
+
+    const auto pack = ufps::Pack{serialize(writer)};
+
+    ASSERT_EQ(pack.load_string("configs/model_manifest.yaml"), str);
+}
+
+TEST(pack, errors)
+{
+    auto writer = ufps::PackWriter{};
+    writer.add("text", compressible(1'000zu), ufps::PackCompression::ZSTD);
+
+    ASSERT_THROW(writer.add("text", compressible(1zu), ufps::PackCompression::NONE), ufps::Exception);
+    ASSERT_THROW(ufps::PackWriter{100u}, ufps::Exception);
+
+    const auto data = serialize(writer);
+    const auto pack = ufps::Pack{ufps::DataBufferView{data}};
+
+    ASSERT_THROW(pack.chunk("missing"), ufps::Exception);
+    ASSERT_THROW(pack.view("text"), ufps::Exception);
+}
+
+TEST(pack, corrupt)
+{
+    auto writer = ufps::PackWriter{};
+    writer.add("raw", incompressible(100zu), ufps::PackCompression::NONE);
+
+    const auto data = serialize(writer);
+
+    auto bad_magic = data;
+    bad_magic[0] = std::byte{'X'};
+    ASSERT_THROW(ufps::Pack{ufps::DataBufferView{bad_magic}}, ufps::Exception);
+
+    const auto truncated = ufps::DataBufferView{data}.first(data.size() - 1zu);
+    ASSERT_THROW(ufps::Pack{truncated}, ufps::Exception);
+
+    const auto too_small = ufps::DataBufferView{data}.first(4zu);
+    ASSERT_THROW(ufps::Pack{too_small}, ufps::Exception);
+}
+
+TEST(pack, mapped_file)
+{
+    const auto raw = incompressible(10'000zu);
+    const auto text = compressible(10'000zu);
+
+    auto writer = ufps::PackWriter{};
+    writer.add("raw", raw, ufps::PackCompression::NONE);
+    writer.add("text", text, ufps::PackCompression::ZSTD);
+
+    const auto path = std::filesystem::temp_directory_path() / "ufps_pack_tests.pack";
+
+    {
+        auto out = std::ofstream{path, std::ios::binary};
+        writer.write(out);
+    }
+
+    {
+        const auto pack = ufps::Pack{std::make_unique<ufps::File>(path)};
+
+        ASSERT_TRUE(equal(pack.view("raw"), raw));
+        ASSERT_TRUE(equal(pack.load("text"), text));
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST(pack, stream)
+{
+    const auto raw = incompressible(10'000zu);
+    const auto text = compressible(10'000zu);
+
+    auto writer = ufps::PackWriter{ufps::pack_default_alignment, {.level = 19, .long_distance_matching = true}};
+    writer.add("raw", raw, ufps::PackCompression::NONE);
+    writer.add("text", text, ufps::PackCompression::ZSTD);
+
+    const auto pack = ufps::Pack{serialize(writer)};
+
+    for (const auto *name : {"raw", "text"})
+    {
+        auto streamed = ufps::DataBuffer{};
+        auto chunk_count = 0zu;
+
+        pack.stream(
+            name,
+            [&](ufps::DataBufferView chunk)
+            {
+                ASSERT_LE(chunk.size(), 3'000zu);
+                streamed.insert(streamed.end(), chunk.begin(), chunk.end());
+                ++chunk_count;
+            },
+            3'000zu);
+
+        ASSERT_EQ(chunk_count, 4zu);
+        ASSERT_TRUE(equal(streamed, pack.load(name)));
+    }
+}
+
+TEST(pack, reuse_unchanged_chunks)
+{
+    const auto raw = incompressible(5'000zu);
+    const auto text = compressible(20'000zu);
+
+    auto first = ufps::PackWriter{};
+    first.add("raw", raw, ufps::PackCompression::NONE);
+    first.add("text", text, ufps::PackCompression::ZSTD);
+    first.add("changed", compressible(1'000zu), ufps::PackCompression::ZSTD);
+
+    const auto previous = ufps::Pack{serialize(first)};
+
+    auto changed = compressible(1'000zu);
+    changed[10] = std::byte{0xff};
+
+    auto second = ufps::PackWriter{ufps::pack_default_alignment, {}, &previous};
+    second.add("raw", raw, ufps::PackCompression::NONE);
+    second.add("text", text, ufps::PackCompression::ZSTD);
+    second.add("changed", changed, ufps::PackCompression::ZSTD);
+    second.add("new", raw, ufps::PackCompression::NONE);
+
+    ASSERT_EQ(second.reused_count(), 2zu);
+
+    const auto pack = ufps::Pack{serialize(second)};
+
+    ASSERT_EQ(pack.chunk("text").compression, ufps::PackCompression::ZSTD);
+    ASSERT_TRUE(equal(pack.stored("text"), previous.stored("text")));
+    ASSERT_TRUE(equal(pack.load("raw"), raw));
+    ASSERT_TRUE(equal(pack.load("text"), text));
+    ASSERT_TRUE(equal(pack.load("changed"), changed));
+    ASSERT_TRUE(equal(pack.load("new"), raw));
+}
+
+TEST(pack, compressed_chunk_not_reused_uncompressed)
+{
+    const auto text = compressible(20'000zu);
+
+    auto first = ufps::PackWriter{};
+    first.add("text", text, ufps::PackCompression::ZSTD);
+
+    const auto previous = ufps::Pack{serialize(first)};
+
+    auto second = ufps::PackWriter{ufps::pack_default_alignment, {}, &previous};
+    second.add("text", text, ufps::PackCompression::NONE);
+
+    ASSERT_EQ(second.reused_count(), 0zu);
+
+    const auto pack = ufps::Pack{serialize(second)};
+
+    ASSERT_TRUE(equal(pack.view("text"), text));
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "concurrency/parallel_for.h"
+#include "concurrency/thread_pool.h"
+
+TEST(parallel_for, every_index_once)
+{
+    auto pool = ufps::ThreadPool{4u};
+    auto counts = std::vector<std::atomic<std::uint32_t>>(10'000zu);
+
+    ufps::parallel_for(
+        pool,
+        0zu,
+        counts.size(),
+        64zu,
+        [&](const auto first, const auto last)
+        {
+            ASSERT_LE(last - first, 64zu);
+            for (auto i = first; i < last; ++i)
+            {
+                ++counts[i];
+            }
+        });
+
+    ASSERT_TRUE(std::ranges::all_of(counts, [](const auto &count) { return count.load() == 1u; }));
+}
+
+TEST(parallel_for, offset_range)
+{
+    auto pool = ufps::ThreadPool{4u};
+    auto sum = std::atomic<std::size_t>{};
+
+    ufps::parallel_for(
+        pool,
+        100zu,
+        200zu,
+        7zu,
+        [&](const auto first, const auto last)
+        {
+            for (auto i = first; i < last; ++i)
+            {
+                sum += i;
+            }
+        });
+
+    ASSERT_EQ(sum.load(), 14'950zu);
+}
+
+TEST(parallel_for, empty_range)
+{
+    auto pool = ufps::ThreadPool{2u};
+    auto called = false;
+
+    ufps::parallel_for(pool, 10zu, 10zu, 1zu, [&](auto, auto) { called = true; });
+
+    ASSERT_FALSE(called);
+}
+
+TEST(parallel_for, single_chunk_runs_on_caller)
+{
+    auto pool = ufps::ThreadPool{2u};
+    auto thread_id = std::thread::id{};
+
+    ufps::parallel_for(pool, 0zu, 10zu, 100zu, [&](auto, auto) { thread_id = std::this_thread::get_id(); });
+
+    ASSERT_EQ(thread_id, std::this_thread::get_id());
+}
+
+TEST(parallel_for, elements)
+{
+    auto pool = ufps::ThreadPool{4u};
+    auto values = std::vector<std::uint32_t>(1'000u);
+    std::ranges::iota(values, 0u);
+
+    ufps::parallel_for(pool, values, 16zu, [](auto &value) { value *= 2u; });
+
+    for (auto i = 0u; i < values.size(); ++i)
+    {
+        ASSERT_EQ(values[i], i * 2u);
+    }
+}
+
+TEST(parallel_for, nested_inside_jobs)
+{
+    // every worker is busy in an outer loop, the inner loops only finish because the callers take chunks themselves
+    auto pool = ufps::ThreadPool{2u};
+    auto count = std::atomic<std::uint32_t>{};
+
+    ufps::parallel_for(
+        pool,
+        0zu,
+        8zu,
+        1zu,
+        [&](auto, auto)
+        {
+            ufps::parallel_for(
+                pool,
+                0zu,
+                100zu,
+                10zu,
+                [&](const auto first, const auto last) { count += static_cast<std::uint32_t>(last - first); });
+        });
+
+    ASSERT_EQ(count.load(), 800u);
+}
@@ -0,0 +1,153 @@
+#include <cstddef>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "math/aabb.h"
+#include "math/ray.h"
+#include "math/ray_packet.h"
+#include "math/triangle.h"
+#include "math/utils.h"
+#include "math/vector3.h"
+
+namespace
+{
+    constexpr auto triangle_count = 1024zu;
+    constexpr auto ray_count = 1024zu;
+
+    auto random_vector(std::mt19937 &rng, float extent) -> ufps::Vector3
+    {
+        auto dist = std::uniform_real_distribution<float>{-extent, extent};
+        const auto x = dist(rng);
+        const auto y = dist(rng);
+        const auto z = dist(rng);
+        return {x, y, z};
+    }
+
+    auto create_triangles() -> std::vector<ufps::Triangle>
+    {
+        auto rng = std::mt19937{1u};
+        auto triangles = std::vector<ufps::Triangle>{};
+
+        for (auto i = 0zu; i < triangle_count; ++i)
+        {
+            const auto v0 = random_vector(rng, 2.f);
+            const auto v1 = random_vector(rng, 2.f);
+            const auto v2 = random_vector(rng, 2.f);
+            triangles.push_back({v0, v1, v2});
+        }
+
+        return triangles;
+    }
+
+    auto create_rays() -> std::vector<ufps::Ray>
+    {
+        auto rng = std::mt19937{2u};
+        auto rays = std::vector<ufps::Ray>{};
+
+        for (auto i = 0zu; i < ray_count; ++i)
+        {
+            const auto origin = random_vector(rng, 5.f);
+            rays.push_back({origin, random_vector(rng, 1.f) - origin});
+        }
+
+        return rays;
+    }
+
+    template <std::size_t N>
+    auto create_triangle_packets(const std::vector<ufps::Triangle> &triangles) -> std::vector<ufps::TrianglePacket<N>>
+    {
+        auto packets = std::vector<ufps::TrianglePacket<N>>{};
+        for (auto i = 0zu; i < triangles.size(); i += N)
+        {
+            packets.push_back(ufps::create_triangle_packet<N>(std::span{triangles}.subspan(i, N)));
+        }
+        return packets;
+    }
+
+    template <std::size_t N>
+    auto create_ray_packets(const std::vector<ufps::Ray> &rays) -> std::vector<ufps::RayPacket<N>>
+    {
+        auto packets = std::vector<ufps::RayPacket<N>>{};
+        for (auto i = 0zu; i < rays.size(); i += N)
+        {
+            packets.push_back(ufps::create_ray_packet<N>(std::span{rays}.subspan(i, N)));
+        }
+        return packets;
+    }
+}
+
+static void ray_triangles_scalar(benchmark::State &state)
+{
+    const auto triangles = create_triangles();
+    const auto ray = create_rays().front();
+
+    for (auto _ : state)
+    {
+        for (const auto &triangle : triangles)
+        {
+            benchmark::DoNotOptimize(ufps::intersect(ray, triangle.v0, triangle.v1, triangle.v2));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * triangles.size());
+}
+
+template <std::size_t N>
+static void ray_triangles_packet(benchmark::State &state)
+{
+    const auto packets = create_triangle_packets<N>(create_triangles());
+    const auto ray = create_rays().front();
+
+    for (auto _ : state)
+    {
+        for (const auto &packet : packets)
+        {
+            benchmark::DoNotOptimize(ufps::intersect(ray, packet));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * packets.size() * N);
+}
+
+static void rays_aabb_scalar(benchmark::State &state)
+{
+    const auto rays = create_rays();
+    const auto aabb = ufps::AABB{.min = {-1.f}, .max = {1.f}};
+
+    for (auto _ : state)
+    {
+        for (const auto &ray : rays)
+        {
+            benchmark::DoNotOptimize(ufps::intersect(ray, aabb));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * rays.size());
+}
+
+template <std::size_t N>
+static void rays_aabb_packet(benchmark::State &state)
+{
+    const auto packets = create_ray_packets<N>(create_rays());
+    const auto aabb = ufps::AABB{.min = {-1.f}, .max = {1.f}};
+
+    for (auto _ : state)
+    {
+        for (const auto &packet : packets)
+        {
+            benchmark::DoNotOptimize(ufps::intersect(packet, aabb));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * packets.size() * N);
+}
+
+BENCHMARK(ray_triangles_scalar);
+BENCHMARK(ray_triangles_packet<4zu>);
+BENCHMARK(ray_triangles_packet<8zu>);
+BENCHMARK(rays_aabb_scalar);
+BENCHMARK(rays_aabb_packet<4zu>);
+BENCHMARK(rays_aabb_packet<8zu>);
@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "math/aabb.h"
+#include "math/ray.h"
+#include "math/ray_packet.h"
+#include "math/triangle.h"
+#include "math/utils.h"
+#include "math/vector3.h"
+
+namespace
+{
+    auto random_vector(std::mt19937 &rng, float extent) -> ufps::Vector3
+    {
+        auto dist = std::uniform_real_distribution<float>{-extent, extent};
+        const auto x = dist(rng);
+        const auto y = dist(rng);
+        const auto z = dist(rng);
+        return {x, y, z};
+    }
+
+    auto random_triangles(std::mt19937 &rng, std::size_t count) -> std::vector<ufps::Triangle>
+    {
+        auto triangles = std::vector<ufps::Triangle>{};
+        for (auto i = 0zu; i < count; ++i)
+        {
+            const auto v0 = random_vector(rng, 2.f);
+            const auto v1 = random_vector(rng, 2.f);
+            const auto v2 = random_vector(rng, 2.f);
+            triangles.push_back({v0, v1, v2});
+        }
+        return triangles;
+    }
+
+    auto random_rays(std::mt19937 &rng, std::size_t count) -> std::vector<ufps::Ray>
+    {
+        auto rays = std::vector<ufps::Ray>{};
+        for (auto i = 0zu; i < count; ++i)
+        {
+            const auto origin = random_vector(rng, 5.f);
+            // aim roughly at the middle so about half of them hit
+            const auto direction = random_vector(rng, 1.f) - origin;
+            rays.push_back({origin, direction});
+        }
+        return rays;
+    }
+
+    template <std::size_t N>
+    auto check_triangles(const ufps::Ray &ray, const std::vector<ufps::Triangle> &triangles) -> std::size_t
+    {
+        const auto hits = ufps::intersect(ray, ufps::create_triangle_packet<N>(triangles));
+        auto hit_count = 0zu;
+
+        for (auto i = 0zu; i < N; ++i)
+        {
+            const auto actual = hits.hit(i);
+
+            if (i >= triangles.size())
+            {
+                EXPECT_FALSE(actual.has_value()) << "padding lane " << i << " hit";
+                continue;
+            }
+
+            const auto &triangle = triangles[i];
+            const auto expected = ufps::intersect(ray, triangle.v0, triangle.v1, triangle.v2);
+
+            EXPECT_EQ(actual.has_value(), expected.has_value()) << "lane " << i;
+            if (actual && expected)
+            {
+                EXPECT_EQ(std::bit_cast<std::uint32_t>(*actual), std::bit_cast<std::uint32_t>(*expected)) << "lane " << i;
+                ++hit_count;
+            }
+        }
+
+        return hit_count;
+    }
+
+    template <std::size_t N>
+    auto check_aabb(const std::vector<ufps::Ray> &rays, const ufps::AABB &aabb) -> std::size_t
+    {
+        const auto hits = ufps::intersect(ufps::create_ray_packet<N>(rays), aabb);
+        auto hit_count = 0zu;
+
+        for (auto i = 0zu; i < N; ++i)
+        {
+            // padding lanes repeat the first ray
+            const auto &ray = i < rays.size() ? rays[i] : rays.front();
+            const auto actual = hits.hit(i);
+            const auto expected = ufps::intersect(ray, aabb);
+
+            EXPECT_EQ(actual.has_value(), expected.has_value()) << "lane " << i;
+            if (actual && expected)
+            {
+                EXPECT_EQ(std::bit_cast<std::uint32_t>(*actual), std::bit_cast<std::uint32_t>(*expected)) << "lane " << i;
+                ++hit_count;
+            }
+        }
+
+        return hit_count;
+    }
+}
+
+TEST(ray_packet, triangles_match_scalar_4)
+{
+    auto rng = std::mt19937{42u};
+    auto hit_count = 0zu;
+
+    for (auto i = 0u; i < 1000u; ++i)
+    {
+        hit_count += check_triangles<4zu>(random_rays(rng, 1zu).front(), random_triangles(rng, 4zu));
+    }
+
+    ASSERT_GT(hit_count, 0zu);
+}
+
+TEST(ray_packet, triangles_match_scalar_8)
+{
+    auto rng = std::mt19937{43u};
+    auto hit_count = 0zu;
+
+    for (auto i = 0u; i < 1000u; ++i)
+    {
+        hit_count += check_triangles<8zu>(random_rays(rng, 1zu).front(), random_triangles(rng, 8zu));
+    }
+
+    ASSERT_GT(hit_count, 0zu);
+}
+
+TEST(ray_packet, triangles_padding_never_hits)
+{
+    auto rng = std::mt19937{44u};
+
+    for (auto count = 0zu; count < 8zu; ++count)
+    {
+        check_triangles<8zu>(ufps::Ray{{0.f, 0.f, 10.f}, {0.f, 0.f, -1.f}}, random_triangles(rng, count));
+    }
+}
+
+TEST(ray_packet, triangles_edge_cases)
+{
+    const auto triangles = std::vector<ufps::Triangle>{
+        // parallel to the ray
+        {{-1.f, 0.f, -1.f}, {1.f, 0.f, -1.f}, {0.f, 0.f, 1.f}},
+        // straight ahead
+        {{-1.f, -1.f, -5.f}, {1.f, -1.f, -5.f}, {0.f, 1.f, -5.f}},
+        // behind the origin
+        {{-1.f, -1.f, 5.f}, {1.f, -1.f, 5.f}, {0.f, 1.f, 5.f}},
+        // ray passes through a vertex
+        {{0.f, 0.f, -3.f}, {1.f, 0.f, -3.f}, {0.f, 1.f, -3.f}},
+    };
+
+    const auto ray = ufps::Ray{{0.f, 0.f, 0.f}, {0.f, 0.f, -1.f}};
+
+    ASSERT_EQ(check_triangles<4zu>(ray, triangles), 2zu);
+    check_triangles<8zu>(ray, triangles);
+}
+
+TEST(ray_packet, aabb_matches_scalar_4)
+{
+    auto rng = std::mt19937{45u};
+    auto hit_count = 0zu;
+
+    for (auto i = 0u; i < 1000u; ++i)
+    {
+        const auto a = random_vector(rng, 2.f);
+        const auto b = random_vector(rng, 2.f);
+        const auto aabb = ufps::AABB{
+            .min = {std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z)},
+            .max = {std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z)}};
+
+        hit_count += check_aabb<4zu>(random_rays(rng, 4zu), aabb);
+    }
+
+    ASSERT_GT(hit_count, 0zu);
+}
+
+TEST(ray_packet, aabb_matches_scalar_8)
+{
+    auto rng = std::mt19937{46u};
+    auto hit_count = 0zu;
+
+    for (auto i = 0u; i < 1000u; ++i)
+    {
+        const auto a = random_vector(rng, 2.f);
+        const auto b = random_vector(rng, 2.f);
+        const auto aabb = ufps::AABB{
+            .min = {std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z)},
+            .max = {std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z)}};
+
+        hit_count += check_aabb<8zu>(random_rays(rng, 1zu + i % 8u), aabb);
+    }
+
+    ASSERT_GT(hit_count, 0zu);
+}
+
+TEST(ray_packet, aabb_axis_aligned_rays)
+{
+    // zero direction components divide to infinities (and nan on the slab planes), which both paths must agree on
+    const auto rays = std::vector<ufps::Ray>{
+        {{0.f, 0.f, 5.f}, {0.f, 0.f, -1.f}},
+        {{5.f, 0.f, 0.f}, {-1.f, 0.f, 0.f}},
+        {{0.f, 5.f, 0.f}, {0.f, 1.f, 0.f}},
+        {{0.f, 0.f, 0.f}, {1.f, 0.f, 0.f}},
+        {{1.f, 0.f, 5.f}, {0.f, 0.f, -1.f}},
+        {{2.f, 0.f, 5.f}, {0.f, 0.f, -1.f}},
+        {{-1.f, -1.f, 5.f}, {0.f, 0.f, -1.f}},
+        {{0.f, 0.f, -5.f}, {0.f, 0.f, -1.f}},
+    };
+
+    const auto aabb = ufps::AABB{.min = {-1.f}, .max = {1.f}};
+
+    check_aabb<4zu>(std::vector<ufps::Ray>{rays.begin(), rays.begin() + 4}, aabb);
+    check_aabb<4zu>(std::vector<ufps::Ray>{rays.begin() + 4, rays.end()}, aabb);
+    ASSERT_GE(check_aabb<8zu>(rays, aabb), 4zu);
+}
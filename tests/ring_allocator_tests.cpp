@@ -0,0 +1,107 @@
+#include <cstddef>
+#include <optional>
+
+#include <gtest/gtest.h>
+
+#include "graphics/ring_allocator.h"
+
+TEST(ring_allocator, allocate_aligned)
+{
+    auto ring = ufps::RingAllocator{256zu};
+
+    ASSERT_EQ(ring.allocate(10zu, 16zu), 0zu);
+    ASSERT_EQ(ring.allocate(10zu, 16zu), 16zu);
+    ASSERT_EQ(ring.allocate(4zu, 4zu), 28zu);
+
+    // padding for alignment counts as used
+    ASSERT_EQ(ring.used(), 32zu);
+    ASSERT_EQ(ring.region_count(), 0zu);
+}
+
+TEST(ring_allocator, close_region)
+{
+    auto ring = ufps::RingAllocator{256zu};
+
+    ASSERT_FALSE(ring.close_region());
+
+    ring.allocate(64zu, 16zu);
+    ring.allocate(64zu, 16zu);
+    ASSERT_TRUE(ring.close_region());
+    ASSERT_FALSE(ring.close_region());
+
+    ring.allocate(32zu, 16zu);
+    ASSERT_TRUE(ring.close_region());
+
+    ASSERT_EQ(ring.region_count(), 2zu);
+    ASSERT_EQ(ring.used(), 160zu);
+
+    ring.release_oldest();
+    ASSERT_EQ(ring.region_count(), 1zu);
+    ASSERT_EQ(ring.used(), 32zu);
+
+    ring.release_oldest();
+    ASSERT_EQ(ring.used(), 0zu);
+}
+
+TEST(ring_allocator, full_until_released)
+{
+    auto ring = ufps::RingAllocator{256zu};
+
+    ASSERT_EQ(ring.allocate(128zu, 16zu), 0zu);
+    ring.close_region();
+    ASSERT_EQ(ring.allocate(128zu, 16zu), 128zu);
+    ring.close_region();
+
+    ASSERT_EQ(ring.allocate(16zu, 16zu), std::nullopt);
+
+    // the oldest region is free again so the ring wraps into it
+    ring.release_oldest();
+    ASSERT_EQ(ring.allocate(16zu, 16zu), 0zu);
+}
+
+TEST(ring_allocator, wrap_skips_tail)
+{
+    auto ring = ufps::RingAllocator{256zu};
+
+    ring.allocate(96zu, 16zu);
+    ring.close_region();
+    ring.allocate(96zu, 16zu);
+    ring.close_region();
+    ring.release_oldest();
+
+    // 64 bytes are left before the end, too few, so they are skipped and held until the allocation is released
+    ASSERT_EQ(ring.allocate(80zu, 16zu), 0zu);
+    ASSERT_EQ(ring.used(), 96zu + 64zu + 80zu);
+    ring.close_region();
+
+    ASSERT_EQ(ring.allocate(32zu, 16zu), std::nullopt);
+
+    ring.release_oldest();
+    ASSERT_EQ(ring.allocate(32zu, 16zu), 80zu);
+
+    ring.close_region();
+    ring.release_oldest();
+    ring.release_oldest();
+    ASSERT_EQ(ring.used(), 0zu);
+}
+
+TEST(ring_allocator, empty_restarts_at_beginning)
+{
+    auto ring = ufps::RingAllocator{256zu};
+
+    ring.allocate(200zu, 16zu);
+    ring.close_region();
+    ring.release_oldest();
+
+    // nothing is in use so the whole ring is available, not just what is after the head
+    ASSERT_EQ(ring.allocate(256zu, 16zu), 0zu);
+}
+
+TEST(ring_allocator, grown_capacity)
+{
+    ASSERT_EQ(ufps::grown_capacity(64zu, 32zu), 64zu);
+    ASSERT_EQ(ufps::grown_capacity(64zu, 64zu), 64zu);
+    ASSERT_EQ(ufps::grown_capacity(64zu, 65zu), 128zu);
+    ASSERT_EQ(ufps::grown_capacity(64zu, 1000zu), 1024zu);
+    ASSERT_EQ(ufps::grown_capacity(0zu, 3zu), 4zu);
+}
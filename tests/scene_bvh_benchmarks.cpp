@@ -0,0 +1,309 @@
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "core/scene_bvh.h"
+#include "graphics/mesh_view.h"
+#include "graphics/vertex_data.h"
+#include "math/matrix4.h"
+#include "math/ray.h"
+#include "math/transform.h"
+#include "math/utils.h"
+#include "math/vector3.h"
+#include "math/vector4.h"
+
+namespace
+{
+    constexpr auto grid_size = 16u;
+
+    // single bumpy grid mesh of grid_size x grid_size quads, about what a prop looks like
+    class FakeMeshManager
+    {
+    public:
+        FakeMeshManager()
+            : _vertices{},
+              _indices{}
+        {
+            for (auto y = 0u; y <= grid_size; ++y)
+            {
+                for (auto x = 0u; x <= grid_size; ++x)
+                {
+                    const auto fx = static_cast<float>(x) / static_cast<float>(grid_size) * 2.f - 1.f;
+                    const auto fy = static_cast<float>(y) / static_cast<float>(grid_size) * 2.f - 1.f;
+                    _vertices.push_back({.position = {fx, fy, std::sin(fx * 3.f) * std::cos(fy * 3.f)}, .normal = {}, .tangent = {}, .bitangent = {}, .uv = {}});
+                }
+            }
+
+            for (auto y = 0u; y < grid_size; ++y)
+            {
+                for (auto x = 0u; x < grid_size; ++x)
+                {
+                    const auto i = y * (grid_size + 1u) + x;
+                    _indices.insert(_indices.end(), {i, i + 1u, i + grid_size + 2u, i, i + grid_size + 2u, i + grid_size + 1u});
+                }
+            }
+        }
+
+        auto mesh() const -> ufps::MeshView
+        {
+            return {
+                .vertex_offset = 0u,
+                .vertex_count = static_cast<std::uint32_t>(_vertices.size()),
+                .index_offset = 0u,
+                .index_count = static_cast<std::uint32_t>(_indices.size()),
+                .meshlet_offset = 0u,
+                .meshlet_count = 0u};
+        }
+
+        auto vertex_data(ufps::MeshView view) const -> std::span<const ufps::VertexData>
+        {
+            return std::span{_vertices}.subspan(view.vertex_offset, view.vertex_count);
+        }
+
+        auto index_data(ufps::MeshView view) const -> std::span<const std::uint32_t>
+        {
+            return std::span{_indices}.subspan(view.index_offset, view.index_count);
+        }
+
+    private:
+        std::vector<ufps::VertexData> _vertices;
+        std::vector<std::uint32_t> _indices;
+    };
+
+    class FakeRenderEntity
+    {
+    public:
+        FakeRenderEntity(ufps::MeshView mesh_view)
+            : _mesh_view{mesh_view},
+              _aabb{.min = {-1.f}, .max = {1.f}}
+        {
+        }
+
+        auto mesh_view() const -> ufps::MeshView
+        {
+            return _mesh_view;
+        }
+
+        auto aabb() const -> const ufps::AABB &
+        {
+            return _aabb;
+        }
+
+    private:
+        ufps::MeshView _mesh_view;
+        ufps::AABB _aabb;
+    };
+
+    class FakeEntity
+    {
+    public:
+        FakeEntity(ufps::MeshView mesh_view, const ufps::Vector3 &position)
+            : _render_entities{mesh_view},
+              _transform{position, {1.f}, {}},
+              _version{}
+        {
+        }
+
+        auto render_entities() const -> std::span<const FakeRenderEntity>
+        {
+            return _render_entities;
+        }
+
+        auto transform() const -> const ufps::Transform &
+        {
+            return _transform;
+        }
+
+        auto aabb() const -> const ufps::AABB &
+        {
+            return _render_entities.front().aabb();
+        }
+
+        auto version() const -> std::uint32_t
+        {
+            return _version;
+        }
+
+        auto translate(float z) -> void
+        {
+            _transform.position.z += z;
+            ++_version;
+        }
+
+    private:
+        std::vector<FakeRenderEntity> _render_entities;
+        ufps::Transform _transform;
+        std::uint32_t _version;
+    };
+
+    // square grid of entities in the xy plane, staggered in z so rays pass through several before hitting
+    auto create_entities(const FakeMeshManager &mesh_manager, std::int64_t count) -> std::vector<FakeEntity>
+    {
+        const auto side = static_cast<std::uint32_t>(std::sqrt(static_cast<double>(count)));
+
+        return std::views::iota(0u, side * side) |
+               std::views::transform(
+                   [&](const auto index)
+                   {
+                       const auto x = static_cast<float>(index % side) * 3.f;
+                       const auto y = static_cast<float>(index / side) * 3.f;
+                       return FakeEntity{mesh_manager.mesh(), {x, y, -static_cast<float>(index % 7u)}};
+                   }) |
+               std::ranges::to<std::vector>();
+    }
+
+    auto create_rays(std::int64_t count) -> std::vector<ufps::Ray>
+    {
+        const auto extent = std::sqrt(static_cast<float>(count)) * 3.f;
+
+        return std::views::iota(0u, 256u) |
+               std::views::transform(
+                   [extent](const auto index)
+                   {
+                       const auto x = static_cast<float>(index % 16u) / 16.f * extent;
+                       const auto y = static_cast<float>(index / 16u) / 16.f * extent;
+                       return ufps::Ray{{x, y, 20.f}, {.1f, .05f, -1.f}};
+                   }) |
+               std::ranges::to<std::vector>();
+    }
+
+    // what Scene::intersect_ray used to do, invert every transform and walk every entity
+    auto intersect_linear(const std::vector<FakeEntity> &entities, const FakeMeshManager &mesh_manager, const ufps::Ray &ray)
+        -> std::optional<float>
+    {
+        auto result = std::optional<float>{};
+        auto min_distance = std::numeric_limits<float>::max();
+
+        for (const auto &entity : entities)
+        {
+            const auto inv_transform = ufps::Matrix4::invert(entity.transform());
+            const auto transformed_ray =
+                ufps::Ray{inv_transform * ufps::Vector4{ray.origin, 1.0f}, inv_transform * ufps::Vector4{ray.direction, 0.0f}};
+
+            if (!ufps::intersect(transformed_ray, entity.aabb()))
+            {
+                continue;
+            }
+
+            for (const auto &render_entity : entity.render_entities())
+            {
+                if (!ufps::intersect(transformed_ray, render_entity.aabb()))
+                {
+                    continue;
+                }
+
+                const auto mesh_view = render_entity.mesh_view();
+                const auto index_data = mesh_manager.index_data(mesh_view);
+                const auto vertex_data = mesh_manager.vertex_data(mesh_view);
+
+                for (const auto &indices : std::views::chunk(index_data, 3))
+                {
+                    const auto distance = ufps::intersect(
+                        transformed_ray,
+                        vertex_data[indices[0]].position,
+                        vertex_data[indices[1]].position,
+                        vertex_data[indices[2]].position);
+
+                    if (distance && *distance < min_distance)
+                    {
+                        result = distance;
+                        min_distance = *distance;
+                    }
+                }
+            }
+        }
+
+        return result;
+    }
+}
+
+static void intersect_ray_linear(benchmark::State &state)
+{
+    const auto mesh_manager = FakeMeshManager{};
+    const auto entities = create_entities(mesh_manager, state.range(0));
+    const auto rays = create_rays(state.range(0));
+
+    for (auto _ : state)
+    {
+        for (const auto &ray : rays)
+        {
+            benchmark::DoNotOptimize(intersect_linear(entities, mesh_manager, ray));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * rays.size());
+}
+
+static void intersect_ray_bvh(benchmark::State &state)
+{
+    const auto mesh_manager = FakeMeshManager{};
+    const auto entities = create_entities(mesh_manager, state.range(0));
+    const auto rays = create_rays(state.range(0));
+
+    auto bvh = ufps::SceneBvh{};
+    bvh.update(entities, 0u, mesh_manager);
+
+    for (auto _ : state)
+    {
+        for (const auto &ray : rays)
+        {
+            benchmark::DoNotOptimize(bvh.intersect_ray(ray));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * rays.size());
+}
+
+static void scene_bvh_build(benchmark::State &state)
+{
+    const auto mesh_manager = FakeMeshManager{};
+    const auto entities = create_entities(mesh_manager, state.range(0));
+
+    auto revision = 0u;
+    auto bvh = ufps::SceneBvh{};
+
+    for (auto _ : state)
+    {
+        bvh.update(entities, revision++, mesh_manager);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void scene_bvh_refit(benchmark::State &state)
+{
+    const auto mesh_manager = FakeMeshManager{};
+    auto entities = create_entities(mesh_manager, state.range(0));
+
+    auto bvh = ufps::SceneBvh{};
+    bvh.update(entities, 0u, mesh_manager);
+
+    auto frame = 0zu;
+    for (auto _ : state)
+    {
+        // one percent of entities move every frame
+        state.PauseTiming();
+        for (auto i = frame++ % 100zu; i < entities.size(); i += 100zu)
+        {
+            entities[i].translate(.01f);
+        }
+        state.ResumeTiming();
+
+        bvh.update(entities, 0u, mesh_manager);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(intersect_ray_linear)->Arg(1'000)->Arg(10'000);
+BENCHMARK(intersect_ray_bvh)->Arg(1'000)->Arg(10'000);
+BENCHMARK(scene_bvh_build)->Arg(1'000)->Arg(10'000);
+BENCHMARK(scene_bvh_refit)->Arg(1'000)->Arg(10'000);
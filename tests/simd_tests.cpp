@@ -0,0 +1,40 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+
+#include <gtest/gtest.h>
+
+#include "math/simd.h"
+
+namespace
+{
+    // whatever FloatN<N> is specialised to, store() gets the lanes back out
+    template <std::size_t N>
+    auto gather_lanes(const std::array<std::uint32_t, N> &indices) -> std::array<float, N>
+    {
+        auto src = std::array<float, 64zu>{};
+        std::iota(src.begin(), src.end(), 100.f);
+
+        auto result = std::array<float, N>{};
+        ufps::simd::store(ufps::simd::gather<N>(src.data(), indices), result.data());
+
+        return result;
+    }
+}
+
+TEST(simd, gather_4)
+{
+    ASSERT_EQ(gather_lanes<4zu>({3u, 0u, 63u, 3u}), (std::array<float, 4zu>{103.f, 100.f, 163.f, 103.f}));
+}
+
+TEST(simd, gather_8)
+{
+    const auto expected = std::array<float, 8zu>{163.f, 101.f, 102.f, 100.f, 150.f, 117.f, 117.f, 140.f};
+    ASSERT_EQ(gather_lanes<8zu>({63u, 1u, 2u, 0u, 50u, 17u, 17u, 40u}), expected);
+}
+
+TEST(simd, gather_any_width)
+{
+    ASSERT_EQ(gather_lanes<3zu>({5u, 4u, 3u}), (std::array<float, 3zu>{105.f, 104.f, 103.f}));
+}
@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ranges>
+#include <thread>
+#include <vector>
+
+#include "concurrency/task_graph.h"
+#include "concurrency/thread_pool.h"
+#include "utils/exception.h"
+
+using namespace std::literals;
+
+namespace
+{
+    // records the order tasks ran in
+    struct Order
+    {
+        auto record(std::uint32_t id) -> void
+        {
+            const auto lock = std::scoped_lock{mutex};
+            ids.push_back(id);
+        }
+
+        auto position(std::uint32_t id) const -> std::ptrdiff_t
+        {
+            return std::ranges::distance(ids.begin(), std::ranges::find(ids, id));
+        }
+
+        std::mutex mutex;
+        std::vector<std::uint32_t> ids;
+    };
+}
+
+TEST(task_graph, ctor)
+{
+    auto pool = ufps::ThreadPool{2u};
+    auto graph = ufps::TaskGraph{pool};
+
+    ASSERT_EQ(graph.task_count(), 0u);
+    ASSERT_TRUE(graph.done());
+
+    graph.run();
+    graph.wait();
+}
+
+TEST(task_graph, runs_every_task)
+{
+    auto pool = ufps::ThreadPool{4u};
+    auto graph = ufps::TaskGraph{pool};
+    auto count = std::atomic<std::uint32_t>{};
+
+    for (auto i = 0u; i < 100u; ++i)
+    {
+        graph.add([&count] { ++count; });
+    }
+
+    graph.run();
+    graph.wait();
+
+    ASSERT_EQ(count.load(), 100u);
+    ASSERT_TRUE(graph.done());
+}
+
+TEST(task_graph, respects_dependencies)
+{
+    auto pool = ufps::ThreadPool{4u};
+    auto graph = ufps::TaskGraph{pool};
+    auto order = Order{};
+
+    // diamond: a -> (b, c) -> d
+    const auto a = graph.add([&] { order.record(0u); });
+    const auto b = graph.add(
+        [&]
+        {
+            std::this_thread::sleep_for(10ms);
+            order.record(1u);
+        },
+        {a});
+    const auto c = graph.add([&] { order.record(2u); }, {a});
+    graph.add([&] { order.record(3u); }, {b, c});
+
+    graph.run();
+    graph.wait();
+
+    ASSERT_EQ(order.ids.size(), 4u);
+    ASSERT_EQ(order.position(0u), 0);
+    ASSERT_EQ(order.position(3u), 3);
+}
+
+TEST(task_graph, run_again)
+{
+    auto pool = ufps::ThreadPool{2u};
+    auto graph = ufps::TaskGraph{pool};
+    auto count = std::atomic<std::uint32_t>{};
+
+    const auto first = graph.add([&count] { ++count; });
+    graph.add([&count] { ++count; }, {first});
+
+    for (auto frame = 0u; frame < 20u; ++frame)
+    {
+        graph.run();
+        graph.wait();
+
+        ASSERT_EQ(count.load(), (frame + 1u) * 2u);
+    }
+}
+
+TEST(task_graph, graphs_wait_independently)
+{
+    auto pool = ufps::ThreadPool{2u};
+    auto slow_graph = ufps::TaskGraph{pool};
+    auto fast_graph = ufps::TaskGraph{pool};
+    auto release = std::atomic<bool>{};
+    auto fast_ran = false;
+
+    slow_graph.add([&release] { release.wait(false); });
+    fast_graph.add([&fast_ran] { fast_ran = true; });
+
+    slow_graph.run();
+    fast_graph.run();
+
+    // the pool still has a job in flight but the fast graph is finished
+    fast_graph.wait();
+    ASSERT_TRUE(fast_ran);
+    ASSERT_FALSE(slow_graph.done());
+
+    release = true;
+    release.notify_all();
+
+    slow_graph.wait();
+    ASSERT_TRUE(slow_graph.done());
+}
+
+TEST(task_graph, unknown_dependency)
+{
+    auto pool = ufps::ThreadPool{1u};
+    auto graph = ufps::TaskGraph{pool};
+
+    ASSERT_THROW(graph.add([] {}, {0u}), ufps::Exception);
+
+    const auto id = graph.add([] {});
+    ASSERT_THROW(graph.add([] {}, {id + 1u}), ufps::Exception);
+}
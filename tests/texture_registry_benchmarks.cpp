@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <format>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "graphics/texture_registry.h"
+
+namespace
+{
+    class FakeTexture
+    {
+    public:
+        FakeTexture(std::string name, std::uint64_t bindless_handle)
+            : _name{std::move(name)},
+              _bindless_handle{bindless_handle}
+        {
+        }
+
+        auto name() const -> std::string
+        {
+            return _name;
+        }
+
+        auto bindless_handle() const -> std::uint64_t
+        {
+            return _bindless_handle;
+        }
+
+    private:
+        std::string _name;
+        std::uint64_t _bindless_handle;
+    };
+
+    // stands in for the gpu buffer, grows the same way resize_gpu_buffer does
+    struct FakeGpuBuffer
+    {
+        auto write(std::span<const std::uint64_t> handles, std::size_t first, std::size_t count) -> void
+        {
+            if (data.size() <= handles.size())
+            {
+                data.resize(std::max(data.size() * 2zu, handles.size() + 1zu));
+                first = 0zu;
+                count = handles.size();
+            }
+
+            std::memcpy(data.data() + first, handles.data() + first, count * sizeof(std::uint64_t));
+            bytes_written += count * sizeof(std::uint64_t);
+        }
+
+        std::vector<std::uint64_t> data = std::vector<std::uint64_t>(1zu);
+        std::size_t bytes_written = 0zu;
+    };
+
+    // TextureManager before the registry: every add uploads every handle and lookups scan
+    class LegacyTextureManager
+    {
+    public:
+        auto add(FakeTexture texture) -> std::uint32_t
+        {
+            const auto index = static_cast<std::uint32_t>(_textures.size());
+
+            _cpu_buffer.push_back(_textures.emplace_back(std::move(texture)).bindless_handle());
+            gpu_buffer.write(_cpu_buffer, 0zu, _cpu_buffer.size());
+
+            return index;
+        }
+
+        auto try_get_texture_index(std::string_view name) const -> std::optional<std::uint32_t>
+        {
+            const auto iter = std::ranges::find_if(_textures, [name](const auto &t) { return t.name() == name; });
+            if (iter == std::ranges::cend(_textures))
+            {
+                return std::nullopt;
+            }
+
+            return static_cast<std::uint32_t>(std::distance(std::ranges::cbegin(_textures), iter));
+        }
+
+        FakeGpuBuffer gpu_buffer;
+
+    private:
+        std::vector<std::uint64_t> _cpu_buffer;
+        std::deque<FakeTexture> _textures;
+    };
+
+    class RegistryTextureManager
+    {
+    public:
+        auto add(FakeTexture texture) -> std::uint32_t
+        {
+            return _registry.add(std::move(texture));
+        }
+
+        auto commit() -> void
+        {
+            const auto first = _registry.pending_first();
+            gpu_buffer.write(_registry.handles(), first, _registry.size() - first);
+            _registry.clear_pending();
+        }
+
+        auto try_get_texture_index(std::string_view name) const -> std::optional<std::uint32_t>
+        {
+            return _registry.try_get_index(name);
+        }
+
+        FakeGpuBuffer gpu_buffer;
+
+    private:
+        ufps::TextureRegistry<FakeTexture> _registry;
+    };
+
+    auto names(std::size_t count) -> const std::vector<std::string> &
+    {
+        static auto names = std::vector<std::string>{};
+
+        while (names.size() < count)
+        {
+            names.push_back(std::format("textures/material_{}_BaseColor.dds", names.size()));
+        }
+
+        return names;
+    }
+
+    // the lookups build_entity_cache does, a handful per submesh
+    constexpr auto lookups_per_texture = 3zu;
+}
+
+static void texture_registration_legacy(benchmark::State &state)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const auto &texture_names = names(count);
+
+    auto bytes_written = 0zu;
+
+    for (auto _ : state)
+    {
+        auto manager = LegacyTextureManager{};
+
+        for (auto i = 0zu; i < count; ++i)
+        {
+            manager.add({texture_names[i], i + 1zu});
+        }
+
+        for (auto i = 0zu; i < count * lookups_per_texture; ++i)
+        {
+            benchmark::DoNotOptimize(manager.try_get_texture_index(texture_names[(i * 7919zu) % count]));
+        }
+
+        bytes_written = manager.gpu_buffer.bytes_written;
+    }
+
+    state.counters["bytes_uploaded"] = static_cast<double>(bytes_written);
+}
+
+static void texture_registration(benchmark::State &state)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const auto &texture_names = names(count);
+
+    auto bytes_written = 0zu;
+
+    for (auto _ : state)
+    {
+        auto manager = RegistryTextureManager{};
+
+        for (auto i = 0zu; i < count; ++i)
+        {
+            manager.add({texture_names[i], i + 1zu});
+        }
+
+        manager.commit();
+
+        for (auto i = 0zu; i < count * lookups_per_texture; ++i)
+        {
+            benchmark::DoNotOptimize(manager.try_get_texture_index(texture_names[(i * 7919zu) % count]));
+        }
+
+        bytes_written = manager.gpu_buffer.bytes_written;
+    }
+
+    state.counters["bytes_uploaded"] = static_cast<double>(bytes_written);
+}
+
+BENCHMARK(texture_registration_legacy)->Arg(1'000)->Arg(10'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(texture_registration)->Arg(1'000)->Arg(10'000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <format>
+#include <string>
+#include <utility>
+
+#include "graphics/texture_registry.h"
+
+namespace
+{
+    class FakeTexture
+    {
+    public:
+        FakeTexture(std::string name, std::uint64_t bindless_handle)
+            : _name{std::move(name)},
+              _bindless_handle{bindless_handle}
+        {
+        }
+
+        FakeTexture(FakeTexture &&) = default;
+        auto operator=(FakeTexture &&) -> FakeTexture & = default;
+
+        auto name() const -> std::string
+        {
+            return _name;
+        }
+
+        auto bindless_handle() const -> std::uint64_t
+        {
+            return _bindless_handle;
+        }
+
+    private:
+        std::string _name;
+        std::uint64_t _bindless_handle;
+    };
+}
+
+TEST(texture_registry, empty)
+{
+    const auto registry = ufps::TextureRegistry<FakeTexture>{};
+
+    ASSERT_EQ(registry.size(), 0u);
+    ASSERT_TRUE(registry.handles().empty());
+    ASSERT_EQ(registry.pending_first(), 0u);
+    ASSERT_FALSE(registry.try_get_index("missing").has_value());
+    ASSERT_FALSE(registry.try_get_index(std::uint64_t{1u}).has_value());
+}
+
+TEST(texture_registry, lookups)
+{
+    auto registry = ufps::TextureRegistry<FakeTexture>{};
+
+    for (auto i = 0u; i < 100u; ++i)
+    {
+        ASSERT_EQ(registry.add({std::format("texture_{}", i), 1000u + i}), i);
+    }
+
+    ASSERT_EQ(registry.size(), 100u);
+
+    for (auto i = 0u; i < 100u; ++i)
+    {
+        ASSERT_EQ(registry.try_get_index(std::format("texture_{}", i)), i);
+        ASSERT_EQ(registry.try_get_index(std::uint64_t{1000u + i}), i);
+        ASSERT_EQ(registry.handles()[i], 1000u + i);
+        ASSERT_EQ(registry.texture(i)->name(), std::format("texture_{}", i));
+    }
+}
+
+TEST(texture_registry, stable_addresses)
+{
+    auto registry = ufps::TextureRegistry<FakeTexture>{};
+    registry.add({"first", 1u});
+
+    const auto *first = registry.texture(0u);
+
+    for (auto i = 0u; i < 1'000u; ++i)
+    {
+        registry.add({std::format("texture_{}", i), 2u + i});
+    }
+
+    ASSERT_EQ(registry.texture(0u), first);
+}
+
+TEST(texture_registry, duplicate_name_keeps_first)
+{
+    auto registry = ufps::TextureRegistry<FakeTexture>{};
+    registry.add({"texture", 1u});
+    registry.add({"texture", 2u});
+
+    ASSERT_EQ(registry.size(), 2u);
+    ASSERT_EQ(registry.try_get_index("texture"), 0u);
+    ASSERT_EQ(registry.try_get_index(std::uint64_t{2u}), 1u);
+}
+
+TEST(texture_registry, pending_range)
+{
+    auto registry = ufps::TextureRegistry<FakeTexture>{};
+    registry.add({"a", 1u});
+    registry.add({"b", 2u});
+
+    ASSERT_EQ(registry.pending_first(), 0u);
+
+    registry.clear_pending();
+    ASSERT_EQ(registry.pending_first(), 2u);
+
+    registry.add({"c", 3u});
+    registry.add({"d", 4u});
+    ASSERT_EQ(registry.pending_first(), 2u);
+
+    registry.clear_pending();
+    ASSERT_EQ(registry.pending_first(), registry.size());
+
+    registry.mark_all_pending();
+    ASSERT_EQ(registry.pending_first(), 0u);
+}
+
+TEST(texture_registry, set_handle)
+{
+    auto registry = ufps::TextureRegistry<FakeTexture>{};
+    registry.add({"a", 1u});
+    registry.add({"b", 2u});
+    registry.add({"c", 3u});
+    registry.clear_pending();
+
+    registry.set_handle(1u, 20u);
+
+    ASSERT_EQ(registry.handles()[1], 20u);
+    ASSERT_EQ(registry.pending_first(), 1u);
+
+    // lookups are by the texture's own handle
+    ASSERT_EQ(registry.try_get_index(std::uint64_t{2u}), 1u);
+    ASSERT_FALSE(registry.try_get_index(std::uint64_t{20u}).has_value());
+}
+
+TEST(texture_registry, name_lookup_after_set_handle)
+{
+    auto registry = ufps::TextureRegistry<FakeTexture>{};
+    registry.add({"a", 1u});
+    registry.add({"b", 2u});
+
+    registry.set_handle(1u, 20u);
+
+    // a name still finds the texture and its own handle, which resolves back to the same index
+    const auto index = registry.try_get_index("b");
+    ASSERT_EQ(index, 1u);
+    ASSERT_EQ(registry.texture(*index)->bindless_handle(), 2u);
+    ASSERT_EQ(registry.try_get_index(registry.texture(*index)->bindless_handle()), index);
+}
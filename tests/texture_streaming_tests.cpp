@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+#include <vector>
+
+#include "graphics/texture_data.h"
+#include "graphics/texture_streaming.h"
+
+namespace
+{
+    // 1024x1024 BC7 with a tail from mip 2 (256x256)
+    auto streamed(std::uint32_t resident_mip, std::uint32_t desired_mip) -> ufps::StreamedTexture
+    {
+        return {
+            .format = ufps::TextureFormat::BC7,
+            .width = 1024u,
+            .height = 1024u,
+            .mip_levels = 11u,
+            .tail_mip = 2u,
+            .resident_mip = resident_mip,
+            .desired_mip = desired_mip,
+        };
+    }
+}
+
+TEST(texture_streaming, first_mip_within)
+{
+    ASSERT_EQ(ufps::first_mip_within(1024u, 1024u, 11u, 256u), 2u);
+    ASSERT_EQ(ufps::first_mip_within(1024u, 64u, 11u, 256u), 2u);
+    ASSERT_EQ(ufps::first_mip_within(128u, 128u, 8u, 256u), 0u);
+
+    // a texture without enough mips keeps its last one
+    ASSERT_EQ(ufps::first_mip_within(1024u, 1024u, 1u, 256u), 0u);
+}
+
+TEST(texture_streaming, screen_extent)
+{
+    const auto fov = std::numbers::pi_v<float> / 2.f;
+
+    ASSERT_FLOAT_EQ(ufps::screen_extent(1.f, 2.f, fov, 1000.f), 500.f);
+    ASSERT_FLOAT_EQ(ufps::screen_extent(1.f, 0.5f, fov, 1000.f), 1000.f);
+}
+
+TEST(texture_streaming, desired_mip)
+{
+    ASSERT_EQ(ufps::desired_mip(1024u, 1024u, 11u, 1024.f), 0u);
+    ASSERT_EQ(ufps::desired_mip(1024u, 1024u, 11u, 2000.f), 0u);
+    ASSERT_EQ(ufps::desired_mip(1024u, 1024u, 11u, 512.f), 1u);
+    ASSERT_EQ(ufps::desired_mip(1024u, 1024u, 11u, 300.f), 1u);
+    ASSERT_EQ(ufps::desired_mip(1024u, 1024u, 11u, 0.f), 10u);
+}
+
+TEST(texture_streaming, detail_size)
+{
+    const auto texture = streamed(2u, 2u);
+
+    ASSERT_EQ(ufps::detail_size(texture, 2u), 0zu);
+    ASSERT_EQ(ufps::detail_size(texture, 1u), ufps::detail_size(texture, 0u) - 1024zu * 1024zu);
+}
+
+TEST(texture_streaming, nothing_to_do)
+{
+    const auto textures = std::vector{streamed(2u, 2u), streamed(0u, 0u)};
+
+    ASSERT_TRUE(ufps::plan_mip_changes(textures, 1zu << 30zu).empty());
+}
+
+TEST(texture_streaming, loads_what_is_needed)
+{
+    const auto textures = std::vector{streamed(2u, 0u), streamed(2u, 1u), streamed(2u, 5u)};
+
+    const auto expected = std::vector<ufps::MipChange>{{.index = 0u, .first_mip = 0u}, {.index = 1u, .first_mip = 1u}};
+    ASSERT_EQ(ufps::plan_mip_changes(textures, 1zu << 30zu), expected);
+}
+
+TEST(texture_streaming, drops_before_loads)
+{
+    const auto textures = std::vector{streamed(2u, 0u), streamed(0u, 2u)};
+
+    const auto expected = std::vector<ufps::MipChange>{{.index = 1u, .first_mip = 2u}, {.index = 0u, .first_mip = 0u}};
+    ASSERT_EQ(ufps::plan_mip_changes(textures, 1zu << 30zu), expected);
+}
+
+TEST(texture_streaming, one_mip_too_fine_is_kept)
+{
+    const auto textures = std::vector{streamed(0u, 1u)};
+
+    ASSERT_TRUE(ufps::plan_mip_changes(textures, 1zu << 30zu).empty());
+}
+
+TEST(texture_streaming, budget_serves_most_missing_first)
+{
+    const auto full = ufps::detail_size(streamed(2u, 0u), 0u);
+    const auto half = ufps::detail_size(streamed(2u, 1u), 1u);
+    const auto textures = std::vector{streamed(2u, 1u), streamed(2u, 0u)};
+
+    // room for one full chain and one from mip 1 at most, the texture missing two mips goes first
+    const auto expected = std::vector<ufps::MipChange>{{.index = 1u, .first_mip = 0u}, {.index = 0u, .first_mip = 1u}};
+    ASSERT_EQ(ufps::plan_mip_changes(textures, full + half), expected);
+
+    // with only room for a full chain the other one has to stay at its tail
+    const auto starved = std::vector<ufps::MipChange>{{.index = 1u, .first_mip = 0u}};
+    ASSERT_EQ(ufps::plan_mip_changes(textures, full + half - 1zu), starved);
+}
+
+TEST(texture_streaming, over_budget_drops)
+{
+    const auto textures = std::vector{streamed(0u, 0u)};
+
+    const auto expected = std::vector<ufps::MipChange>{{.index = 0u, .first_mip = 1u}};
+    ASSERT_EQ(ufps::plan_mip_changes(textures, ufps::detail_size(textures[0], 1u)), expected);
+}
@@ -0,0 +1,205 @@
+#include <atomic>
+#include <cstdint>
+#include <format>
+#include <mutex>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "concurrency/concurrent_queue.h"
+#include "concurrency/cond_var.h"
+#include "concurrency/lock.h"
+#include "concurrency/thread.h"
+#include "concurrency/thread_pool.h"
+
+namespace
+{
+    constexpr auto worker_count = 4u;
+
+    // the previous ThreadPool, one mutex protected queue and a condition variable, kept as the baseline
+    class MutexThreadPool
+    {
+    public:
+        MutexThreadPool(std::uint32_t worker_count)
+            : _job_queue{},
+              _worker_lock{},
+              _worker_cv{},
+              _job_count{},
+              _workers{}
+        {
+            for (auto i = 0u; i < worker_count; ++i)
+            {
+                _workers.push_back({std::format("worker_{}", i), [this](std::stop_token stop_token) { worker(std::move(stop_token)); }});
+            }
+        }
+
+        ~MutexThreadPool()
+        {
+            for (auto &thread : _workers)
+            {
+                thread.request_stop();
+            }
+
+            _workers.clear();
+        }
+
+        auto add(ufps::Job job) -> void
+        {
+            ++_job_count;
+            _job_queue.push(std::move(job));
+            _worker_cv.notify_one();
+        }
+
+        auto drain() const -> void
+        {
+            auto count = _job_count.load();
+            while (count != 0u)
+            {
+                _job_count.wait(count);
+                count = _job_count.load();
+            }
+        }
+
+    private:
+        auto worker(std::stop_token stop_token) -> void
+        {
+            while (!stop_token.stop_requested())
+            {
+                auto job = ufps::Job{};
+
+                {
+                    auto lock = std::unique_lock{_worker_lock};
+                    _worker_cv.wait(lock, stop_token, [&] { return !_job_queue.empty(); });
+
+                    if (stop_token.stop_requested())
+                    {
+                        break;
+                    }
+
+                    job = _job_queue.pop();
+                }
+
+                job();
+
+                if (--_job_count == 0u)
+                {
+                    _job_count.notify_all();
+                }
+            }
+        }
+
+        ufps::ConcurrentQueue<ufps::Job> _job_queue;
+        ufps::Lock<> _worker_lock;
+        ufps::CondVar _worker_cv;
+        std::atomic<std::uint32_t> _job_count;
+        std::vector<ufps::Thread> _workers;
+    };
+
+    // lots of tiny jobs from one thread, what AwaitableManager::pump does with coroutine resumes
+    template <class Pool>
+    auto throughput(benchmark::State &state) -> void
+    {
+        auto pool = Pool{worker_count};
+        auto count = std::atomic<std::uint32_t>{};
+        const auto job_count = static_cast<std::uint32_t>(state.range(0));
+
+        for (auto _ : state)
+        {
+            for (auto i = 0u; i < job_count; ++i)
+            {
+                pool.add([&count] { count.fetch_add(1u, std::memory_order_relaxed); });
+            }
+
+            pool.drain();
+        }
+
+        state.SetItemsProcessed(state.iterations() * job_count);
+    }
+
+    // jobs that fan out more jobs from inside the pool
+    template <class Pool>
+    auto nested(benchmark::State &state) -> void
+    {
+        auto pool = Pool{worker_count};
+        auto count = std::atomic<std::uint32_t>{};
+        const auto job_count = static_cast<std::uint32_t>(state.range(0));
+
+        for (auto _ : state)
+        {
+            for (auto i = 0u; i < worker_count; ++i)
+            {
+                pool.add(
+                    [&pool, &count, job_count]
+                    {
+                        for (auto j = 0u; j < job_count / worker_count; ++j)
+                        {
+                            pool.add([&count] { count.fetch_add(1u, std::memory_order_relaxed); });
+                        }
+                    });
+            }
+
+            pool.drain();
+        }
+
+        state.SetItemsProcessed(state.iterations() * job_count);
+    }
+
+    // time from add until the job has run, with the workers idle in between
+    template <class Pool>
+    auto latency(benchmark::State &state) -> void
+    {
+        auto pool = Pool{worker_count};
+
+        for (auto _ : state)
+        {
+            auto done = std::atomic<bool>{};
+            pool.add(
+                [&done]
+                {
+                    done = true;
+                    done.notify_one();
+                });
+
+            done.wait(false);
+        }
+
+        pool.drain();
+    }
+}
+
+static void thread_pool_throughput_mutex(benchmark::State &state)
+{
+    throughput<MutexThreadPool>(state);
+}
+
+static void thread_pool_throughput(benchmark::State &state)
+{
+    throughput<ufps::ThreadPool>(state);
+}
+
+static void thread_pool_nested_mutex(benchmark::State &state)
+{
+    nested<MutexThreadPool>(state);
+}
+
+static void thread_pool_nested(benchmark::State &state)
+{
+    nested<ufps::ThreadPool>(state);
+}
+
+static void thread_pool_latency_mutex(benchmark::State &state)
+{
+    latency<MutexThreadPool>(state);
+}
+
+static void thread_pool_latency(benchmark::State &state)
+{
+    latency<ufps::ThreadPool>(state);
+}
+
+BENCHMARK(thread_pool_throughput_mutex)->Arg(1'000)->Arg(10'000)->UseRealTime();
+BENCHMARK(thread_pool_throughput)->Arg(1'000)->Arg(10'000)->UseRealTime();
+BENCHMARK(thread_pool_nested_mutex)->Arg(10'000)->UseRealTime();
+BENCHMARK(thread_pool_nested)->Arg(10'000)->UseRealTime();
+BENCHMARK(thread_pool_latency_mutex)->UseRealTime();
+BENCHMARK(thread_pool_latency)->UseRealTime();
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <ranges>
@@ -42,4 +43,74 @@ TEST(thread_pool, simple)
     ASSERT_EQ(thread_ids.size(), thread_ids_set.size());
     ASSERT_FALSE(std::ranges::any_of(thread_ids_set, [](const auto e)
                                      { return e == std::this_thread::get_id(); }));
-}
\ No newline at end of file
+}
+
+TEST(thread_pool, many_small_jobs)
+{
+    auto pool = ufps::ThreadPool{4u};
+    auto count = std::atomic<std::uint32_t>{};
+
+    for (auto i = 0u; i < 100'000u; ++i)
+    {
+        pool.add([&count] { ++count; });
+    }
+
+    pool.drain();
+
+    ASSERT_EQ(count.load(), 100'000u);
+}
+
+TEST(thread_pool, jobs_adding_jobs)
+{
+    auto pool = ufps::ThreadPool{4u};
+    auto count = std::atomic<std::uint32_t>{};
+
+    // children go to the adding worker's own deque and get stolen by the others
+    for (auto i = 0u; i < 100u; ++i)
+    {
+        pool.add(
+            [&pool, &count]
+            {
+                for (auto j = 0u; j < 100u; ++j)
+                {
+                    pool.add([&count] { ++count; });
+                }
+            });
+    }
+
+    // drain waits for the children too, they are counted before their parent finishes
+    pool.drain();
+
+    ASSERT_EQ(count.load(), 10'000u);
+}
+
+TEST(thread_pool, drain_repeatedly)
+{
+    auto pool = ufps::ThreadPool{2u};
+    auto count = std::atomic<std::uint32_t>{};
+
+    for (auto frame = 0u; frame < 50u; ++frame)
+    {
+        for (auto i = 0u; i < 10u; ++i)
+        {
+            pool.add([&count] { ++count; });
+        }
+
+        pool.drain();
+        ASSERT_EQ(count.load(), (frame + 1u) * 10u);
+    }
+}
+
+TEST(thread_pool, wakes_after_parking)
+{
+    auto pool = ufps::ThreadPool{2u};
+    auto ran = std::atomic<bool>{};
+
+    // long enough for every worker to give up spinning and park
+    std::this_thread::sleep_for(50ms);
+
+    pool.add([&ran] { ran = true; });
+    pool.drain();
+
+    ASSERT_TRUE(ran.load());
+}
@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <random>
+#include <ranges>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "resources/pack.h"
+#include "resources/vfs.h"
+#include "utils/data_buffer.h"
+#include "utils/string_unordered_map.h"
+
+namespace
+{
+    // about what a shipped game has, every texture, mesh, shader and config
+    constexpr auto resource_count = 16384zu;
+
+    struct Content
+    {
+        Content()
+        {
+            auto writer = ufps::PackWriter{16u};
+            for (auto i = 0zu; i < resource_count; ++i)
+            {
+                names.push_back(std::format("textures/level_{}/texture_{}_BaseColor.dds", i % 32zu, i));
+                misses.push_back(std::format("textures/level_{}/texture_{}_Normal.dds", i % 32zu, i));
+                writer.add(names.back(), std::as_bytes(std::span{names.back()}), ufps::PackCompression::NONE);
+            }
+
+            auto out = std::stringstream{};
+            writer.write(out);
+            const auto str = out.str();
+
+            vfs.mount_pack(ufps::Pack{std::as_bytes(std::span{str}) | std::ranges::to<ufps::DataBuffer>()});
+
+            for (const auto &entry : vfs.entries())
+            {
+                map[entry.name] = entry.data;
+            }
+
+            // so lookups are not walking the table in order
+            auto rng = std::mt19937{7u};
+            std::ranges::shuffle(names, rng);
+            std::ranges::shuffle(misses, rng);
+        }
+
+        ufps::Vfs vfs;
+
+        // what EmbeddedResourceLoader and Pack look names up with
+        ufps::StringUnorderedMap<ufps::DataBufferView> map;
+
+        std::vector<std::string> names;
+        std::vector<std::string> misses;
+    };
+
+    auto content() -> const Content &
+    {
+        static const auto content = Content{};
+        return content;
+    }
+
+    template <class F>
+    auto lookup(benchmark::State &state, const std::vector<std::string> &names, F &&find) -> void
+    {
+        for (auto _ : state)
+        {
+            for (const auto &name : names)
+            {
+                benchmark::DoNotOptimize(find(name));
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(names.size()));
+    }
+}
+
+static void vfs_find_hit(benchmark::State &state)
+{
+    const auto &c = content();
+    lookup(state, c.names, [&](const auto &name) { return c.vfs.find(name); });
+}
+
+static void vfs_find_miss(benchmark::State &state)
+{
+    const auto &c = content();
+    lookup(state, c.misses, [&](const auto &name) { return c.vfs.find(name); });
+}
+
+static void vfs_view(benchmark::State &state)
+{
+    const auto &c = content();
+    lookup(state, c.names, [&](const auto &name) { return c.vfs.view(name).data(); });
+}
+
+static void string_unordered_map_find_hit(benchmark::State &state)
+{
+    const auto &c = content();
+    lookup(state, c.names, [&](const auto &name) { return c.map.find(name) != c.map.end(); });
+}
+
+static void string_unordered_map_find_miss(benchmark::State &state)
+{
+    const auto &c = content();
+    lookup(state, c.misses, [&](const auto &name) { return c.map.find(name) != c.map.end(); });
+}
+
+BENCHMARK(vfs_find_hit)->Unit(benchmark::kMicrosecond);
+BENCHMARK(vfs_find_miss)->Unit(benchmark::kMicrosecond);
+BENCHMARK(vfs_view)->Unit(benchmark::kMicrosecond);
+BENCHMARK(string_unordered_map_find_hit)->Unit(benchmark::kMicrosecond);
+BENCHMARK(string_unordered_map_find_miss)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,248 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <ranges>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "resources/pack.h"
+#include "resources/vfs.h"
+#include "utils/data_buffer.h"
+#include "utils/exception.h"
+
+namespace
+{
+    auto bytes(std::string_view str) -> ufps::DataBufferView
+    {
+        return std::as_bytes(std::span{str});
+    }
+
+    auto to_string(ufps::DataBufferView data) -> std::string
+    {
+        return {reinterpret_cast<const char *>(data.data()), data.size()};
+    }
+
+    auto write_file(const std::filesystem::path &path, std::string_view contents) -> void
+    {
+        std::filesystem::create_directories(path.parent_path());
+        auto file = std::ofstream{path, std::ios::binary};
+        file << contents;
+    }
+
+    auto temp_resource_dir(const std::string &name) -> std::filesystem::path
+    {
+        const auto dir = std::filesystem::temp_directory_path() / name;
+        std::filesystem::remove_all(dir);
+
+        write_file(dir / "shaders/simple.vert", "file simple.vert");
+        write_file(dir / "shaders/nested/deep.vert", "file deep.vert");
+        write_file(dir / "configs/scene.yaml", "file scene.yaml");
+
+        return dir;
+    }
+
+    auto make_pack() -> ufps::Pack
+    {
+        auto writer = ufps::PackWriter{};
+        writer.add("shaders/simple.vert", bytes("pack simple.vert"), ufps::PackCompression::NONE);
+        writer.add("vertex_data", bytes("pack vertex_data"), ufps::PackCompression::NONE);
+
+        // long and repetitive enough to stay compressed
+        const auto manifest = std::string(4096zu, 'm');
+        writer.add("configs/texture_manifest.yaml", bytes(manifest), ufps::PackCompression::ZSTD);
+
+        auto out = std::stringstream{};
+        writer.write(out);
+
+        const auto str = out.str();
+        return ufps::Pack{bytes(str) | std::ranges::to<ufps::DataBuffer>()};
+    }
+}
+
+TEST(vfs, empty)
+{
+    auto vfs = ufps::Vfs{};
+
+    ASSERT_FALSE(vfs.has_resource("anything"));
+    ASSERT_EQ(vfs.find("anything"), nullptr);
+    ASSERT_TRUE(vfs.resources("shaders").empty());
+    ASSERT_THROW(vfs.load_data_buffer("anything"), ufps::Exception);
+}
+
+TEST(vfs, mounts_every_backing)
+{
+    static constexpr auto embedded = std::string_view{"memory font"};
+
+    auto vfs = ufps::Vfs{};
+    vfs.mount_directory(temp_resource_dir("ufps_vfs_backings"));
+    vfs.mount_pack(make_pack());
+    vfs.mount_memory("fonts/font.ttf", bytes(embedded));
+
+    ASSERT_EQ(vfs.entries().size(), 6zu);
+    ASSERT_TRUE(std::ranges::is_sorted(vfs.entries(), {}, &ufps::VfsEntry::name));
+
+    ASSERT_EQ(vfs.find("shaders/nested/deep.vert")->backing, ufps::VfsBacking::FILE);
+    ASSERT_EQ(vfs.find("vertex_data")->backing, ufps::VfsBacking::PACK);
+    ASSERT_EQ(vfs.find("fonts/font.ttf")->backing, ufps::VfsBacking::MEMORY);
+
+    ASSERT_EQ(vfs.load_string("configs/scene.yaml"), "file scene.yaml");
+    ASSERT_EQ(vfs.load_string("vertex_data"), "pack vertex_data");
+    ASSERT_EQ(vfs.load_string("configs/texture_manifest.yaml"), std::string(4096zu, 'm'));
+    ASSERT_EQ(vfs.load_string("fonts/font.ttf"), embedded);
+}
+
+TEST(vfs, views_are_zero_copy)
+{
+    static constexpr auto embedded = std::string_view{"memory font"};
+
+    auto vfs = ufps::Vfs{};
+    vfs.mount_directory(temp_resource_dir("ufps_vfs_views"));
+    vfs.mount_pack(make_pack());
+    vfs.mount_memory("fonts/font.ttf", bytes(embedded));
+
+    ASSERT_EQ(vfs.view("fonts/font.ttf").data(), bytes(embedded).data());
+    ASSERT_EQ(vfs.view("vertex_data").data(), vfs.find("vertex_data")->pack->view("vertex_data").data());
+    ASSERT_EQ(to_string(vfs.view("vertex_data")), "pack vertex_data");
+
+    // files are mapped once and the same mapping handed out after
+    const auto file_view = vfs.view("configs/scene.yaml");
+    ASSERT_EQ(to_string(file_view), "file scene.yaml");
+    ASSERT_EQ(vfs.view("configs/scene.yaml").data(), file_view.data());
+
+    ASSERT_THROW(vfs.view("configs/texture_manifest.yaml"), ufps::Exception);
+}
+
+TEST(vfs, overlay_priority)
+{
+    const auto dir = temp_resource_dir("ufps_vfs_overlay");
+
+    // a later mount of the same priority overlays an earlier one
+    {
+        auto vfs = ufps::Vfs{};
+        vfs.mount_pack(make_pack());
+        vfs.mount_directory(dir);
+
+        ASSERT_EQ(vfs.load_string("shaders/simple.vert"), "file simple.vert");
+        ASSERT_EQ(vfs.load_string("vertex_data"), "pack vertex_data");
+    }
+
+    {
+        auto vfs = ufps::Vfs{};
+        vfs.mount_directory(dir);
+        vfs.mount_pack(make_pack());
+
+        ASSERT_EQ(vfs.load_string("shaders/simple.vert"), "pack simple.vert");
+    }
+
+    // but never one with a higher priority
+    {
+        auto vfs = ufps::Vfs{};
+        vfs.mount_directory(dir, 1);
+        vfs.mount_pack(make_pack());
+        vfs.mount_memory("shaders/simple.vert", bytes("memory simple.vert"));
+
+        ASSERT_EQ(vfs.load_string("shaders/simple.vert"), "file simple.vert");
+        ASSERT_EQ(vfs.entries().size(), 5zu);
+
+        vfs.mount_memory("shaders/simple.vert", bytes("memory simple.vert"), 2);
+        ASSERT_EQ(vfs.load_string("shaders/simple.vert"), "memory simple.vert");
+    }
+}
+
+TEST(vfs, resources)
+{
+    auto vfs = ufps::Vfs{};
+    vfs.mount_directory(temp_resource_dir("ufps_vfs_resources"));
+    vfs.mount_pack(make_pack());
+    vfs.mount_memory("shaders_extra/a.vert", bytes("a"));
+
+    // only direct children, with no duplicates for overlaid names
+    ASSERT_EQ(vfs.resources("shaders"), (std::vector<std::string>{"shaders/simple.vert"}));
+    ASSERT_EQ(vfs.resources("shaders/nested"), (std::vector<std::string>{"shaders/nested/deep.vert"}));
+    ASSERT_EQ(vfs.resources("configs"), (std::vector<std::string>{"configs/scene.yaml", "configs/texture_manifest.yaml"}));
+    ASSERT_TRUE(vfs.resources("models").empty());
+}
+
+TEST(vfs, many_entries)
+{
+    auto names = std::vector<std::string>{};
+    auto writer = ufps::PackWriter{16u};
+    for (auto i = 0; i < 5000; ++i)
+    {
+        names.push_back(std::format("textures/texture_{}.dds", i));
+        writer.add(names.back(), bytes(names.back()), ufps::PackCompression::NONE);
+    }
+
+    auto out = std::stringstream{};
+    writer.write(out);
+    const auto str = out.str();
+
+    auto vfs = ufps::Vfs{};
+    vfs.mount_pack(ufps::Pack{bytes(str) | std::ranges::to<ufps::DataBuffer>()});
+
+    for (const auto &name : names)
+    {
+        const auto *entry = vfs.find(name);
+        ASSERT_NE(entry, nullptr);
+        ASSERT_EQ(entry->name, name);
+        ASSERT_EQ(to_string(vfs.view(name)), name);
+    }
+
+    ASSERT_EQ(vfs.find("textures/texture_5000.dds"), nullptr);
+    ASSERT_EQ(vfs.resources("textures").size(), names.size());
+}
+
+TEST(vfs, load_data_buffers)
+{
+    static constexpr auto embedded = std::string_view{"memory font"};
+
+    auto vfs = ufps::Vfs{};
+    vfs.mount_directory(temp_resource_dir("ufps_vfs_load_data_buffers"));
+    vfs.mount_pack(make_pack());
+    vfs.mount_memory("fonts/font.ttf", bytes(embedded));
+
+    const auto names = std::vector<std::string_view>{
+        "shaders/nested/deep.vert", "vertex_data", "fonts/font.ttf", "configs/texture_manifest.yaml", "configs/scene.yaml"};
+
+    const auto buffers = vfs.load_data_buffers(names);
+
+    ASSERT_EQ(buffers.size(), names.size());
+    for (auto i = 0zu; i < names.size(); ++i)
+    {
+        ASSERT_EQ(to_string(buffers[i]), vfs.load_string(names[i]));
+    }
+
+    ASSERT_EQ(to_string(buffers[0]), "file deep.vert");
+    ASSERT_THROW(vfs.load_data_buffers(std::vector<std::string_view>{"shaders/simple.vert", "missing"}), ufps::Exception);
+}
+
+TEST(vfs, mount_memory_bulk)
+{
+    auto names = std::vector<std::string>{};
+    for (auto i = 0; i < 5000; ++i)
+    {
+        names.push_back(std::format("embedded/blob_{}.bin", i));
+    }
+
+    auto resources = std::vector<ufps::VfsMemory>{};
+    for (const auto &name : names)
+    {
+        resources.push_back({.name = name, .data = bytes(name)});
+    }
+
+    auto vfs = ufps::Vfs{};
+    vfs.mount_memory(resources);
+
+    ASSERT_EQ(vfs.entries().size(), names.size());
+    for (const auto &name : names)
+    {
+        ASSERT_EQ(vfs.find(name)->backing, ufps::VfsBacking::MEMORY);
+        ASSERT_EQ(vfs.view(name).data(), bytes(name).data());
+    }
+}
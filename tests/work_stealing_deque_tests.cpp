@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "concurrency/mpmc_queue.h"
+#include "concurrency/work_stealing_deque.h"
+
+TEST(work_stealing_deque, ctor)
+{
+    auto deque = ufps::WorkStealingDeque<int>{};
+
+    ASSERT_TRUE(deque.empty());
+    ASSERT_FALSE(deque.pop().has_value());
+    ASSERT_FALSE(deque.steal().has_value());
+}
+
+TEST(work_stealing_deque, pop_is_lifo_steal_is_fifo)
+{
+    auto deque = ufps::WorkStealingDeque<int>{};
+
+    deque.push(1);
+    deque.push(2);
+    deque.push(3);
+
+    ASSERT_EQ(deque.size(), 3u);
+    ASSERT_EQ(deque.pop(), 3);
+    ASSERT_EQ(deque.steal(), 1);
+    ASSERT_EQ(deque.pop(), 2);
+    ASSERT_TRUE(deque.empty());
+}
+
+TEST(work_stealing_deque, grows)
+{
+    auto deque = ufps::WorkStealingDeque<int>{4u};
+
+    for (auto i = 0; i < 1000; ++i)
+    {
+        deque.push(i);
+    }
+
+    ASSERT_EQ(deque.steal(), 0);
+
+    for (auto i = 999; i > 0; --i)
+    {
+        ASSERT_EQ(deque.pop(), i);
+    }
+
+    ASSERT_TRUE(deque.empty());
+}
+
+TEST(work_stealing_deque, every_value_taken_once)
+{
+    constexpr auto count = 200'000;
+
+    auto deque = ufps::WorkStealingDeque<int>{16u};
+    auto taken = std::vector<std::atomic<std::uint32_t>>(count);
+    auto done = std::atomic<bool>{};
+
+    auto thieves = std::vector<std::jthread>{};
+    for (auto i = 0u; i < 3u; ++i)
+    {
+        thieves.emplace_back(
+            [&]
+            {
+                while (!done || !deque.empty())
+                {
+                    if (const auto value = deque.steal())
+                    {
+                        ++taken[*value];
+                    }
+                }
+            });
+    }
+
+    for (auto i = 0; i < count; ++i)
+    {
+        deque.push(i);
+
+        // the owner takes some back so pop races the thieves for the last element
+        if (i % 3 == 0)
+        {
+            if (const auto value = deque.pop())
+            {
+                ++taken[*value];
+            }
+        }
+    }
+
+    done = true;
+    thieves.clear();
+
+    while (const auto value = deque.pop())
+    {
+        ++taken[*value];
+    }
+
+    ASSERT_TRUE(std::ranges::all_of(taken, [](const auto &t) { return t.load() == 1u; }));
+}
+
+TEST(mpmc_queue, push_pop)
+{
+    auto queue = ufps::MpmcQueue<int>{4u};
+
+    ASSERT_TRUE(queue.empty());
+    ASSERT_EQ(queue.capacity(), 4u);
+
+    ASSERT_TRUE(queue.try_push(1));
+    ASSERT_TRUE(queue.try_push(2));
+    ASSERT_TRUE(queue.try_push(3));
+    ASSERT_TRUE(queue.try_push(4));
+    ASSERT_FALSE(queue.try_push(5));
+
+    ASSERT_EQ(queue.try_pop(), 1);
+    ASSERT_TRUE(queue.try_push(5));
+
+    ASSERT_EQ(queue.try_pop(), 2);
+    ASSERT_EQ(queue.try_pop(), 3);
+    ASSERT_EQ(queue.try_pop(), 4);
+    ASSERT_EQ(queue.try_pop(), 5);
+    ASSERT_FALSE(queue.try_pop().has_value());
+}
+
+TEST(mpmc_queue, every_value_taken_once)
+{
+    constexpr auto producers = 3;
+    constexpr auto per_producer = 50'000;
+
+    auto queue = ufps::MpmcQueue<int>{64u};
+    auto taken = std::vector<std::atomic<std::uint32_t>>(producers * per_producer);
+    auto popped = std::atomic<int>{};
+
+    {
+        auto threads = std::vector<std::jthread>{};
+
+        for (auto p = 0; p < producers; ++p)
+        {
+            threads.emplace_back(
+                [&, p]
+                {
+                    for (auto i = 0; i < per_producer; ++i)
+                    {
+                        while (!queue.try_push(p * per_producer + i))
+                        {
+                            std::this_thread::yield();
+                        }
+                    }
+                });
+        }
+
+        for (auto c = 0; c < 3; ++c)
+        {
+            threads.emplace_back(
+                [&]
+                {
+                    while (popped < producers * per_producer)
+                    {
+                        if (const auto value = queue.try_pop())
+                        {
+                            ++taken[*value];
+                            ++popped;
+                        }
+                    }
+                });
+        }
+    }
+
+    ASSERT_TRUE(std::ranges::all_of(taken, [](const auto &t) { return t.load() == 1u; }));
+}
@@ -1,17 +1,41 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <exception>
 #include <filesystem>
+#include <format>
 #include <fstream>
+#include <memory>
+#include <optional>
 #include <ranges>
+#include <string>
+#include <string_view>
+#include <tuple>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <yaml-cpp/yaml.h>
 
+#include "concurrency/parallel_for.h"
+#include "concurrency/thread_pool.h"
 #include "core/manifest_descriptions.h"
+#include "graphics/block_compression.h"
+#include "graphics/compact_vertex.h"
+#include "graphics/mesh_optimizer.h"
+#include "graphics/meshlet.h"
+#include "graphics/mip_chain.h"
+#include "graphics/texture_data.h"
 #include "graphics/utils.h"
 #include "log.h"
+#include "resources/build_cache.h"
+#include "resources/file.h"
 #include "resources/file_resource_loader.h"
+#include "resources/pack.h"
 #include "serialization/yaml_serializer.h"
-#include "utils/compress.h"
+#include "utils/data_buffer.h"
 #include "utils/ensure.h"
+#include "utils/hash.h"
 
 namespace
 {
@@ -70,6 +94,193 @@ namespace
         return t;
     }
 
+    auto is_srgb_texture(std::string_view name) -> bool
+    {
+        return name.contains("BaseColor") || name.contains("_BC");
+    }
+
+    // DDS has no 24 bit formats so RGB sources gain an opaque alpha channel
+    auto expand_to_rgba(ufps::TextureData texture) -> ufps::TextureData
+    {
+        using enum ufps::TextureFormat;
+
+        if (texture.format != RGB && texture.format != SRGB)
+        {
+            return texture;
+        }
+
+        const auto &rgb = *texture.data;
+        auto rgba = ufps::DataBuffer(rgb.size() / 3zu * 4zu, std::byte{0xff});
+
+        for (auto i = 0zu; i < rgb.size() / 3zu; ++i)
+        {
+            std::ranges::copy_n(rgb.begin() + i * 3zu, 3zu, rgba.begin() + i * 4zu);
+        }
+
+        texture.format = texture.format == SRGB ? SRGBA : RGBA;
+        texture.data = std::move(rgba);
+
+        return texture;
+    }
+
+    // bump whenever load_model's import settings or output, the mesh optimization or meshlet building change so stale
+    // cache entries are never used
+    constexpr auto model_importer_version = 3u;
+
+    // bump whenever encoded output changes so stale cache entries are never used
+    constexpr auto texture_encoder_version = 1u;
+
+    auto import_model(ufps::ResourceLoader &resource_loader, const std::string &resource, ufps::BuildCache &cache) -> ufps::ImportedModel
+    {
+        const auto file_name = std::filesystem::path{resource}.filename().string();
+        const auto source = resource_loader.load_data_buffer(resource);
+
+        const auto key = ufps::hash_combine(
+            ufps::hash_combine(ufps::hash_bytes(source), ufps::hash_string(file_name)), model_importer_version);
+
+        if (const auto cached = cache.find(key); cached)
+        {
+            // a bad entry is just a miss, the fresh import below overwrites it
+            try
+            {
+                return ufps::decode_imported_model(*cached);
+            }
+            catch (const ufps::Exception &e)
+            {
+                ufps::log::warn("ignoring build cache entry for {}: {}", resource, e.what());
+            }
+        }
+
+        auto [name, sub_models] = ufps::load_model(file_name, source, "fbx");
+        auto model = ufps::ImportedModel{.name = std::move(name), .sub_models = std::move(sub_models)};
+
+        for (auto &&[index, sub_model] : std::views::enumerate(model.sub_models))
+        {
+            auto &mesh = sub_model.mesh_data;
+            const auto before = ufps::analyze_vertex_cache(mesh.indices, mesh.vertices.size());
+            const auto vertex_count = mesh.vertices.size();
+
+            // meshlets reorder triangles, so vertices are put back in first use order afterwards
+            auto [meshlet_mesh, meshlets] = ufps::build_meshlets(ufps::optimize_mesh(mesh));
+            mesh = ufps::optimize_vertex_fetch(meshlet_mesh);
+            sub_model.meshlets = std::move(meshlets);
+
+            const auto after = ufps::analyze_vertex_cache(mesh.indices, mesh.vertices.size());
+            ufps::log::info(
+                "optimized {}[{}]: {} -> {} vertices, {} meshlets, acmr {:.3f} -> {:.3f}, atvr {:.3f} -> {:.3f}",
+                model.name,
+                index,
+                vertex_count,
+                mesh.vertices.size(),
+                sub_model.meshlets.size(),
+                before.acmr,
+                after.acmr,
+                before.atvr,
+                after.atvr);
+        }
+
+        cache.store(key, ufps::encode_imported_model(model));
+
+        return model;
+    }
+
+    // DDS sources are packed as authored, anything else is mipped and block compressed here so the game never decodes
+    // or uploads raw pixels, BC5 for normal maps and BC7 for everything else
+    auto prepare_texture(const ufps::DataBuffer &source, bool is_srgb, bool is_normal, ufps::ThreadPool &pool, ufps::BuildCache &cache)
+        -> ufps::DataBuffer
+    {
+        const auto key = ufps::hash_combine(
+            ufps::hash_combine(ufps::hash_bytes(source), texture_encoder_version), (is_srgb ? 1u : 0u) | (is_normal ? 2u : 0u));
+
+        if (auto cached = cache.find(key); cached)
+        {
+            return std::move(*cached);
+        }
+
+        const auto texture = ufps::load_texture(source, is_srgb);
+        if (texture.is_compressed)
+        {
+            return source;
+        }
+
+        const auto format = is_normal ? ufps::TextureFormat::BC5U : is_srgb ? ufps::TextureFormat::BC7_SRGB : ufps::TextureFormat::BC7;
+        const auto encoded = ufps::encode_dds(ufps::block_compress(ufps::generate_mips(expand_to_rgba(texture)), format, pool));
+
+        cache.store(key, encoded);
+
+        return encoded;
+    }
+
+    // calls func(index) for every index in [0, count) across the pool, an exception from any of them is rethrown here
+    // once all have run
+    template <class F>
+    auto build_all(ufps::ThreadPool &pool, std::size_t count, F &&func) -> void
+    {
+        auto errors = std::vector<std::exception_ptr>(count);
+
+        ufps::parallel_for(
+            pool,
+            0zu,
+            count,
+            1zu,
+            [&](std::size_t first, std::size_t last)
+            {
+                for (auto i = first; i < last; ++i)
+                {
+                    try
+                    {
+                        func(i);
+                    }
+                    catch (...)
+                    {
+                        errors[i] = std::current_exception();
+                    }
+                }
+            });
+
+        for (const auto &error : errors)
+        {
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    class StageTimer
+    {
+    public:
+        StageTimer()
+            : _start{std::chrono::steady_clock::now()},
+              _stages{}
+        {
+        }
+
+        // ends the current stage and starts the next
+        auto end(std::string name) -> void
+        {
+            const auto now = std::chrono::steady_clock::now();
+            _stages.push_back({std::move(name), std::chrono::duration_cast<std::chrono::milliseconds>(now - _start)});
+            _start = now;
+        }
+
+        auto log() const -> void
+        {
+            auto total = std::chrono::milliseconds{};
+            for (const auto &[name, duration] : _stages)
+            {
+                ufps::log::info("  {:<16} {:>8}ms", name, duration.count());
+                total += duration;
+            }
+
+            ufps::log::info("  {:<16} {:>8}ms", "total", total.count());
+        }
+
+    private:
+        std::chrono::steady_clock::time_point _start;
+        std::vector<std::tuple<std::string, std::chrono::milliseconds>> _stages;
+    };
+
     auto insert_name_if_not_emtpy(std::unordered_set<std::string> &texture_names, std::string texture) -> void
     {
         if (texture.empty())
@@ -92,42 +303,81 @@ auto main(int argc, char **argv) -> int
                                                    { return std::filesystem::path{argv[i]}; }) |
                              std::ranges::to<std::vector>();
 
+        auto timer = StageTimer{};
+
         const auto output_asset_dir = std::filesystem::path{argv[1]} / "build_assets";
         std::filesystem::create_directories(output_asset_dir);
 
-        const auto output_blobs_dir = output_asset_dir / "blobs";
-        std::filesystem::create_directories(output_blobs_dir);
+        const auto pack_path = output_asset_dir / "assets.pack";
+        const auto cache_dir = std::filesystem::path{argv[1]} / "build_cache";
+
+        auto model_cache = ufps::BuildCache{cache_dir / "models"};
+        auto texture_cache = ufps::BuildCache{cache_dir / "textures"};
+
+        // chunks that have not changed since the last run are copied from it rather than compressed again
+        auto previous_pack = std::optional<ufps::Pack>{};
+        if (std::filesystem::exists(pack_path))
+        {
+            try
+            {
+                previous_pack.emplace(std::make_unique<ufps::File>(pack_path));
+            }
+            catch (const ufps::Exception &e)
+            {
+                ufps::log::warn("ignoring previous pack: {}", e.what());
+            }
+        }
+
+        // packing is offline so spend the time on the smallest output
+        auto pack = ufps::PackWriter{
+            ufps::pack_default_alignment,
+            {.level = 19, .long_distance_matching = true},
+            previous_pack ? std::addressof(*previous_pack) : nullptr};
 
-        const auto output_configs_dir = output_asset_dir / "configs";
-        std::filesystem::create_directories(output_configs_dir);
+        auto pool = ufps::ThreadPool{};
 
         ufps::log::info("packing resources fbx files");
 
         auto resource_loader = ufps::FileResourceLoader{resource_dirs};
-        auto models = resource_loader.resources("models") |
-                      std::views::filter([](const auto &e)
-                                         { return e.ends_with(".fbx"); });
+
+        // sorted so the pack is laid out the same way every run
+        auto model_resources = resource_loader.resources("models") |
+                               std::views::filter([](const auto &e)
+                                                  { return e.ends_with(".fbx"); }) |
+                               std::ranges::to<std::vector>();
+        std::ranges::sort(model_resources);
+
+        auto models = std::vector<ufps::ImportedModel>(model_resources.size());
+        build_all(
+            pool,
+            models.size(),
+            [&](std::size_t i)
+            {
+                ufps::log::debug("found model resource: {}", model_resources[i]);
+                models[i] = import_model(resource_loader, model_resources[i], model_cache);
+            });
+
+        timer.end("import models");
 
         auto vertex_offset = 0zu;
         auto index_offset = 0zu;
-        auto vertex_data = std::vector<ufps::VertexData>{};
+        auto meshlet_offset = 0zu;
+        auto vertex_data = std::vector<ufps::CompactVertex>{};
         auto index_data = std::vector<std::uint32_t>{};
+        auto meshlet_data = std::vector<ufps::Meshlet>{};
 
         auto texture_names = std::unordered_set<std::string>{
             // "textures/default_BaseColor.dds",
             // "textures/default_Normal.dds",
             // "textures/default_Metallic.dds",
         };
+        auto normal_names = std::unordered_set<std::string>{};
 
         {
             auto manifest = ufps::ModelManifestDescription{};
 
-            for (const auto &m : models)
+            for (const auto &[name, sub_models] : models)
             {
-                ufps::log::debug("found model resource: {}", m);
-                const auto path = std::filesystem::path{m};
-
-                const auto &[name, sub_models] = ufps::load_model(path.filename().string(), resource_loader.load_data_buffer(m), "fbx");
 
                 if (sub_models.empty())
                 {
@@ -146,12 +396,14 @@ auto main(int argc, char **argv) -> int
 
                             const auto albedo_name = model.albedo && !model.albedo->ends_with(".psd") ? get_real_texture_file_name(resource_loader, *model.albedo) : ""; // "textures/default_BaseColor.dds";
 
+                            // every normal map is packed as BC5, whether authored that way or encoded below
                             auto normal_name = std::string{};
                             auto normal_compressed = false;
                             if (model.normal)
                             {
                                 normal_name = get_real_texture_file_name(resource_loader, *model.normal);
-                                normal_compressed = !resource_loader.has_resource(*model.normal);
+                                normal_compressed = true;
+                                normal_names.insert(normal_name);
                             }
                             // else
                             // {
@@ -178,6 +430,8 @@ auto main(int argc, char **argv) -> int
                                         .vertex_count = static_cast<std::uint32_t>(mesh_data.vertices.size()),
                                         .index_offset = static_cast<std::uint32_t>(index_offset),
                                         .index_count = static_cast<std::uint32_t>(mesh_data.indices.size()),
+                                        .meshlet_offset = static_cast<std::uint32_t>(meshlet_offset),
+                                        .meshlet_count = static_cast<std::uint32_t>(model.meshlets.size()),
                                     },
                                 .albedo_texture = albedo_name,
                                 .normal_texture = normal_name,
@@ -189,96 +443,112 @@ auto main(int argc, char **argv) -> int
                                 .opacity = model.opacity,
                                 .emissive_intensity = model.emissive_intensity};
 
-                            vertex_data.append_range(mesh_data.vertices);
+                            vertex_data.append_range(mesh_data.vertices | std::views::transform(ufps::encode_vertex));
                             index_data.append_range(mesh_data.indices);
+                            meshlet_data.append_range(model.meshlets);
 
                             vertex_offset += vertex_count;
                             index_offset += index_count;
+                            meshlet_offset += model.meshlets.size();
 
                             return res;
                         }) |
                     std::ranges::to<std::vector>();
             }
 
-            const auto manifest_path = output_configs_dir / "model_manifest.yaml";
-            auto manifest_file = std::ofstream{manifest_path};
-            manifest_file << ufps::yaml::serialize(manifest);
+            const auto manifest_str = ufps::yaml::serialize(manifest);
+            pack.add("configs/model_manifest.yaml", std::as_bytes(std::span{manifest_str}), ufps::PackCompression::ZSTD);
         }
 
-        ufps::log::info("finished packing models, packing textures");
-        auto texture_blob = ufps::DataBuffer{};
-
-        {
-            auto manifest = ufps::TextureManifestDescription{};
+        ufps::log::info(
+            "finished packing models ({} imported, {} cached), packing textures", model_cache.misses(), model_cache.hits());
+        timer.end("model manifest");
 
-            auto offset = 0zu;
+        auto texture_size = 0zu;
 
-            for (const auto &t : texture_names)
-            {
-                if (t.ends_with(".psd"))
+        {
+            auto textures = texture_names |
+                            std::views::filter(
+                                [](const auto &t)
+                                {
+                                    if (t.ends_with(".psd"))
+                                    {
+                                        ufps::log::debug("skipping Photoshop file {}", t);
+                                        return false;
+                                    }
+
+                                    return true;
+                                }) |
+                            std::ranges::to<std::vector>();
+            std::ranges::sort(textures);
+
+            auto texture_data = std::vector<ufps::DataBuffer>(textures.size());
+            build_all(
+                pool,
+                textures.size(),
+                [&](std::size_t i)
                 {
-                    ufps::log::debug("skipping Photoshop file {}", t);
-                    continue;
-                }
+                    const auto &t = textures[i];
+                    texture_data[i] = prepare_texture(
+                        resource_loader.load_data_buffer(get_real_texture_file_name(resource_loader, t)),
+                        is_srgb_texture(t),
+                        normal_names.contains(t),
+                        pool,
+                        texture_cache);
+                });
 
-                auto real_t = get_real_texture_file_name(resource_loader, t);
-                const auto texture_data = resource_loader.load_data_buffer(real_t);
-                const auto size = texture_data.size();
+            timer.end("encode textures");
 
-                texture_blob.append_range(std::as_bytes(std::span{texture_data.data(), size}));
+            auto manifest = ufps::TextureManifestDescription{};
+
+            for (const auto &[t, data] : std::views::zip(textures, texture_data))
+            {
+                // stored uncompressed so the renderer can read it straight out of the mapped pack
+                pack.add(t, data, ufps::PackCompression::NONE);
 
                 manifest.textures[t] = {
-                    .offset = static_cast<std::uint32_t>(offset),
-                    .size = static_cast<std::uint32_t>(size),
-                    .is_srgb = t.contains("BaseColor") || t.contains("_BC"),
+                    .is_srgb = is_srgb_texture(t),
                 };
 
-                offset += size;
+                texture_size += data.size();
             }
 
-            const auto manifest_path = output_configs_dir / "texture_manifest.yaml";
-            auto manifest_file = std::ofstream{manifest_path};
+            const auto manifest_str = ufps::yaml::serialize(manifest);
+            pack.add("configs/texture_manifest.yaml", std::as_bytes(std::span{manifest_str}), ufps::PackCompression::ZSTD);
 
-            manifest_file << ufps::yaml::serialize(manifest);
+            ufps::log::info("finished packing textures ({} encoded, {} cached)", texture_cache.misses(), texture_cache.hits());
         }
 
-        ufps::log::info("finished packing textures, writing to disk");
+        pack.add("vertex_data", std::as_bytes(std::span{vertex_data}), ufps::PackCompression::NONE);
+        pack.add("index_data", std::as_bytes(std::span{index_data}), ufps::PackCompression::NONE);
+        pack.add("meshlet_data", std::as_bytes(std::span{meshlet_data}), ufps::PackCompression::NONE);
 
-        const auto compressed_vertex_data = ufps::compress(std::as_bytes(std::span{vertex_data.data(), vertex_data.size()}));
+        ufps::log::info("{} chunks unchanged since the previous pack, writing to disk", pack.reused_count());
+        timer.end("assemble pack");
 
-        const auto vertex_data_path = output_blobs_dir / "vertex_data.bin";
-        auto vertex_data_file = std::ofstream{vertex_data_path, std::ios::binary};
-        vertex_data_file.write(reinterpret_cast<const char *>(compressed_vertex_data.data()), compressed_vertex_data.size());
-
-        ufps::log::info(
-            "wrote vertex data: {} vertices, {} bytes, compression ratio: {:.2f}%",
-            format_size(vertex_data.size()),
-            format_file_size(compressed_vertex_data.size()),
-            100.f * compressed_vertex_data.size() / (vertex_data.size() * sizeof(ufps::VertexData)));
+        // written to the side and renamed over the old pack, which is still mapped until now
+        const auto temp_pack_path = std::filesystem::path{pack_path}.replace_extension(".pack.tmp");
+        {
+            auto pack_file = std::ofstream{temp_pack_path, std::ios::binary};
+            pack.write(pack_file);
+        }
 
-        const auto compressed_index_data = ufps::compress(std::as_bytes(std::span{index_data.data(), index_data.size()}));
+        previous_pack.reset();
+        std::filesystem::rename(temp_pack_path, pack_path);
 
-        const auto index_data_path = output_blobs_dir / "index_data.bin";
-        auto index_data_file = std::ofstream{index_data_path, std::ios::binary};
-        index_data_file.write(reinterpret_cast<const char *>(compressed_index_data.data()), compressed_index_data.size());
+        timer.end("write pack");
 
         ufps::log::info(
-            "wrote index data: {} indices, {} bytes, compression ratio: {:.2f}%",
+            "wrote pack: {} vertices, {} indices, {} meshlets, {} textures ({} bytes), {} bytes total",
+            format_size(vertex_data.size()),
             format_size(index_data.size()),
-            format_file_size(compressed_index_data.size()),
-            100.f * compressed_index_data.size() / (index_data.size() * sizeof(std::uint32_t)));
-
-        const auto compressed_texture_blob = ufps::compress(texture_blob);
-
-        const auto texture_blob_path = output_blobs_dir / "texture_data.bin";
-        auto texture_blob_file = std::ofstream{texture_blob_path, std::ios::binary};
-        texture_blob_file.write(reinterpret_cast<const char *>(compressed_texture_blob.data()), compressed_texture_blob.size());
-
-        ufps::log::info(
-            "wrote texture blob: {} textures, {} bytes, compression ratio: {:.2f}%",
+            format_size(meshlet_data.size()),
             format_size(texture_names.size()),
-            format_file_size(compressed_texture_blob.size()),
-            100.f * compressed_texture_blob.size() / texture_blob.size());
+            format_file_size(texture_size),
+            format_file_size(std::filesystem::file_size(pack_path)));
+
+        ufps::log::info("stage timings:");
+        timer.log();
     }
     catch (const ufps::Exception &e)
     {